@@ -0,0 +1,532 @@
+/**
+ * \file bench.c
+ * \brief Functions declared in bench.h are implemented in this file.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ */
+
+
+#if defined(__linux__)
+#define _POSIX_C_SOURCE 200112L
+#define BENCH_MONOTONIC
+#define BENCH_PTHREADS
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef BENCH_PTHREADS
+#include <pthread.h>
+#endif
+
+#include "bench.h"
+#include "classifier.h"
+#include "parts.h"
+#include "structures/hashtable.h"
+#include "structures/shtab.h"
+
+
+/** \brief Size of the buffer of a generated key. */
+#define BENCH_KEY_SIZE 32
+/** \brief Number of counted words (occurrences) per distinct word of the synthetic vocabulary. */
+#define BENCH_TOKENS_PER_WORD 16
+/** \brief Number of shards of the benchmarked shared counts. */
+#define BENCH_SHARDS_CNT 64
+/** \brief Number of counts of a row of the benchmarked shared counts (classes). */
+#define BENCH_ROW_LEN 2
+/** \brief Number of random bits drawn by bench_random. */
+#define BENCH_RANDOM_BITS 30
+/** \brief Number of documents scored by a run of the partitioned scoring benchmark. */
+#define BENCH_DOCS_CNT 2000
+/** \brief Number of words of a document scored by the partitioned scoring benchmark. */
+#define BENCH_DOC_WORDS 256
+/** \brief Maximal relative difference of the scores of a document by the runs (sums are rounded differently). */
+#define BENCH_SCORES_EPS 1e-9
+
+
+/**
+ * \struct bench_counts
+ * \brief Struct representing the synthetic words counted into shared counts.
+ */
+typedef struct bench_counts_ {
+    shtab *st;                      /**< Shared counts. */
+    const char *keys;               /**< Keys of the vocabulary, BENCH_KEY_SIZE bytes each. */
+    const unsigned long *hashes;    /**< Hashes of the keys of the vocabulary. */
+    size_t words_cnt;               /**< Number of words of the vocabulary. */
+    const size_t *tokens;           /**< Indices of the counted words to the vocabulary. */
+} bench_counts;
+
+
+/**
+ * \struct bench_part
+ * \brief Struct representing the part of the counted words of a thread.
+ */
+typedef struct bench_part_ {
+    const bench_counts *bc;         /**< Counted words. */
+    size_t from;                    /**< Index of the first word of the part. */
+    size_t to;                      /**< Index after the last word of the part. */
+    int failed;                     /**< Flag whether counting of a word failed. */
+#ifdef BENCH_PTHREADS
+    pthread_t thread;               /**< Thread of the part. */
+#endif
+} bench_part;
+
+
+/**
+ * \brief bench_now Returns the current time of the monotonic (or processor) clock.
+ * \return Seconds.
+ */
+double bench_now() {
+#ifdef BENCH_MONOTONIC
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#else
+    return (double) clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+
+/**
+ * \brief bench_record Adds the latency of an operation to the results of a benchmark.
+ * \param stats Pointer to the results.
+ * \param latency Latency of the operation in seconds.
+ */
+void bench_record(bench_stats *stats, const double latency) {
+    double ns;
+    size_t bin;
+
+    for (bin = 0, ns = latency * 1e9; ns >= 1 && bin < BENCH_HIST_SIZE - 1; bin++) {
+        ns /= 2;
+    }
+    stats->hist[bin]++;
+
+    stats->ops_cnt++;
+    stats->seconds += latency;
+    if (latency > stats->max) {
+        stats->max = latency;
+    }
+}
+
+
+int bench_htab_add(const size_t keys_cnt, const int full_rehash, bench_stats *stats) {
+    htab *ht = NULL;
+    char key[BENCH_KEY_SIZE];
+    double start;
+    size_t k;
+    int added;
+
+    if (!stats) {
+        return 0;
+    }
+    memset(stats, 0, sizeof(bench_stats));
+
+    ht = htab_create(sizeof(size_t), NULL);
+    if (!ht) {
+        return 0;
+    }
+
+    for (k = 0; k < keys_cnt; k++) {
+        sprintf(key, "w%lu", (unsigned long) k);
+
+        start = bench_now();
+        /* the addition which would start the expansion rehashes all the entries first */
+        added = (!full_rehash || htab_items_cnt(ht) != ht->buckets_cnt * H_ITEMS_PER_BUCKET ||
+                 htab_reserve(ht, htab_items_cnt(ht) + 1)) && htab_add(ht, key, &k);
+        bench_record(stats, bench_now() - start);
+
+        if (!added) {
+            htab_free(&ht);
+            return 0;
+        }
+    }
+
+    htab_free(&ht);
+    return 1;
+}
+
+
+/**
+ * \brief bench_random Draws BENCH_RANDOM_BITS random bits by a linear congruential generator.
+ * \param state Pointer to the state of the generator.
+ * \return Random number.
+ */
+unsigned long bench_random(unsigned long *state) {
+    unsigned long hi, lo;
+
+    *state = (*state * 1103515245UL + 12345UL) & 0xffffffffUL;
+    hi = (*state >> 16) & 0x7fff;
+    *state = (*state * 1103515245UL + 12345UL) & 0xffffffffUL;
+    lo = (*state >> 16) & 0x7fff;
+
+    return hi << 15 | lo;
+}
+
+
+/**
+ * \brief bench_zipf_tokens Draws the words of Zipfian frequencies (exponent 1, the word of rank r
+ *                          is drawn with probability proportional to 1 / r) by the inverse of their distribution.
+ * \param tokens Array where the indices of the drawn words (ranks - 1) will be stored.
+ * \param tokens_cnt Number of words to be drawn.
+ * \param words_cnt Number of words of the vocabulary.
+ * \return 1 if operation was successful, else 0.
+ */
+int bench_zipf_tokens(size_t tokens[], const size_t tokens_cnt, const size_t words_cnt) {
+    double *cdf = NULL, u;
+    unsigned long state = 1;
+    size_t t, w, lo, hi;
+
+    cdf = (double *) malloc(words_cnt * sizeof(double));
+    if (!cdf) {
+        return 0;
+    }
+    for (w = 0; w < words_cnt; w++) {
+        cdf[w] = (w ? cdf[w - 1] : 0) + 1.0 / (w + 1);
+    }
+
+    for (t = 0; t < tokens_cnt; t++) {
+        u = (bench_random(&state) + 0.5) / (1UL << BENCH_RANDOM_BITS) * cdf[words_cnt - 1];
+        for (lo = 0, hi = words_cnt - 1; lo < hi; ) {
+            w = lo + (hi - lo) / 2;
+            if (cdf[w] < u) {
+                lo = w + 1;
+            }
+            else {
+                hi = w;
+            }
+        }
+        tokens[t] = lo;
+    }
+
+    free(cdf);
+    return 1;
+}
+
+
+/**
+ * \brief bench_part_run Counts the words of the part into the shared counts.
+ * \param arg Pointer to a part.
+ * \return NULL.
+ */
+void *bench_part_run(void *arg) {
+    bench_part *part = (bench_part *) arg;
+    const bench_counts *bc = part->bc;
+    size_t *row = NULL;
+    size_t t, w;
+
+    for (t = part->from; t < part->to; t++) {
+        w = bc->tokens[t];
+        row = shtab_row(bc->st, bc->keys + w * BENCH_KEY_SIZE, bc->hashes[w]);
+        if (!row) {
+            part->failed = 1;
+            break;
+        }
+        shtab_row_add(row, t % BENCH_ROW_LEN, 1);
+    }
+
+    return NULL;
+}
+
+
+/**
+ * \brief bench_count_run Counts all the words into empty shared counts by the threads.
+ * \param bc Pointer to the counted words (the shared counts are created and freed).
+ * \param tokens_cnt Number of the counted words.
+ * \param threads_cnt Number of threads.
+ * \param seconds Pointer to where the duration of the counting will be stored.
+ * \return 1 if operation was successful (and all the words were counted), else 0.
+ */
+int bench_count_run(bench_counts *bc, const size_t tokens_cnt, const size_t threads_cnt, double *seconds) {
+    bench_part *parts = NULL;
+    size_t p, started, s, i, counted;
+    size_t *row = NULL;
+    double start;
+    int failed = 0;
+
+    parts = (bench_part *) malloc(threads_cnt * sizeof(bench_part));
+    bc->st = shtab_create(BENCH_ROW_LEN, BENCH_SHARDS_CNT, bc->words_cnt);
+    if (!parts || !bc->st) {
+        goto fail;
+    }
+    for (p = 0; p < threads_cnt; p++) {
+        parts[p].bc = bc;
+        parts[p].from = p * (tokens_cnt / threads_cnt);
+        parts[p].to = p + 1 < threads_cnt ? parts[p].from + tokens_cnt / threads_cnt : tokens_cnt;
+        parts[p].failed = 0;
+    }
+
+    start = bench_now();
+    started = 0;
+#ifdef BENCH_PTHREADS
+    for ( ; started < threads_cnt; started++) {
+        if (pthread_create(&parts[started].thread, NULL, bench_part_run, &parts[started]) != 0) {
+            break;
+        }
+    }
+#endif
+    /* parts of the threads which could not be started are counted by the calling thread */
+    for (p = started; p < threads_cnt; p++) {
+        bench_part_run(&parts[p]);
+    }
+#ifdef BENCH_PTHREADS
+    for (p = 0; p < started; p++) {
+        pthread_join(parts[p].thread, NULL);
+    }
+#endif
+    *seconds = bench_now() - start;
+
+    for (p = 0; p < threads_cnt; p++) {
+        failed |= parts[p].failed;
+    }
+    for (s = 0, counted = 0; s < bc->st->shards_cnt; s++) {
+        for (i = 0; i < shtab_shard_items_cnt(bc->st, s); i++) {
+            row = shtab_row_at(bc->st, s, i);
+            for (p = 0; p < BENCH_ROW_LEN; p++) {
+                counted += row[p];
+            }
+        }
+    }
+    if (failed || counted != tokens_cnt) {
+        goto fail;
+    }
+
+    shtab_free(&bc->st);
+    free(parts);
+    return 1;
+
+fail:
+    shtab_free(&bc->st);
+    free(parts);
+    return 0;
+}
+
+
+int bench_shtab_count(const size_t tokens_cnt, const size_t threads_cnt[], const size_t runs_cnt, double seconds[]) {
+    bench_counts bc;
+    char *keys = NULL;
+    unsigned long *hashes = NULL;
+    size_t *tokens = NULL;
+    size_t w, r;
+
+    if (!tokens_cnt || !threads_cnt || !seconds) {
+        return 0;
+    }
+    for (r = 0; r < runs_cnt; r++) {
+        if (!threads_cnt[r]) {
+            return 0;
+        }
+    }
+
+    bc.st = NULL;
+    bc.words_cnt = tokens_cnt / BENCH_TOKENS_PER_WORD + 1;
+    keys = (char *) malloc(bc.words_cnt * BENCH_KEY_SIZE);
+    hashes = (unsigned long *) malloc(bc.words_cnt * sizeof(unsigned long));
+    tokens = (size_t *) malloc(tokens_cnt * sizeof(size_t));
+    if (!keys || !hashes || !tokens || !bench_zipf_tokens(tokens, tokens_cnt, bc.words_cnt)) {
+        goto fail;
+    }
+    for (w = 0; w < bc.words_cnt; w++) {
+        sprintf(keys + w * BENCH_KEY_SIZE, "w%lu", (unsigned long) w);
+        hashes[w] = htab_hash(keys + w * BENCH_KEY_SIZE);
+    }
+    bc.keys = keys;
+    bc.hashes = hashes;
+    bc.tokens = tokens;
+
+    for (r = 0; r < runs_cnt; r++) {
+        if (!bench_count_run(&bc, tokens_cnt, threads_cnt[r], &seconds[r])) {
+            goto fail;
+        }
+    }
+
+    free(tokens);
+    free(hashes);
+    free(keys);
+    return 1;
+
+fail:
+    free(tokens);
+    free(hashes);
+    free(keys);
+    return 0;
+}
+
+
+/**
+ * \brief bench_words_text Writes the words of the indices as a text of words separated by spaces.
+ * \param text Buffer of at least BENCH_KEY_SIZE bytes per word.
+ * \param words Indices of the words.
+ * \param words_cnt Number of the words.
+ * \return Size of the text.
+ */
+size_t bench_words_text(char *text, const size_t words[], const size_t words_cnt) {
+    size_t w, size;
+
+    for (w = 0, size = 0; w < words_cnt; w++) {
+        size += sprintf(text + size, "w%lu ", (unsigned long) words[w]);
+    }
+
+    return size;
+}
+
+
+/**
+ * \brief bench_nbc_learn Creates a classifier of two classes, which learns all the words in the first class
+ *                        and a random half of them in the second one.
+ * \param words_cnt Number of words of the classifier.
+ * \return Pointer to a learnt classifier, or NULL on failure.
+ */
+nbc *bench_nbc_learn(const size_t words_cnt) {
+    nbc *cl = NULL;
+    char *text = NULL;
+    size_t *words = NULL;
+    size_t w, half_cnt;
+    unsigned long state = 2;
+
+    cl = nbc_create(2, NULL);
+    text = (char *) malloc(words_cnt * BENCH_KEY_SIZE);
+    words = (size_t *) malloc(words_cnt * sizeof(size_t));
+    if (!cl || !text || !words) {
+        goto fail;
+    }
+
+    for (w = 0, half_cnt = 0; w < words_cnt; w++) {
+        words[w] = w;
+        if (bench_random(&state) & 1) {
+            words[half_cnt++] = w;
+        }
+    }
+    if (!nbc_learn_buffer(cl, text, bench_words_text(text, words, half_cnt), 1)) {
+        goto fail;
+    }
+    for (w = 0; w < words_cnt; w++) {
+        words[w] = w;
+    }
+    if (!nbc_learn_buffer(cl, text, bench_words_text(text, words, words_cnt), 0) || !nbc_learn_finish(cl)) {
+        goto fail;
+    }
+
+    free(words);
+    free(text);
+    return cl;
+
+fail:
+    free(words);
+    free(text);
+    nbc_free(&cl);
+    return NULL;
+}
+
+
+/**
+ * \brief bench_nbc_score Scores the documents by the classifier, by the scoring thread alone or by the partitions.
+ * \param cl Pointer to a learnt classifier.
+ * \param texts Texts of the documents.
+ * \param offsets Offsets of the documents in the texts (docs_cnt + 1 items).
+ * \param docs_cnt Number of the documents.
+ * \param parts_cnt Number of partitions (0 for the scoring thread alone).
+ * \param scores Array where the scores of the classes of the documents will be stored.
+ * \param seconds Pointer to where the duration of the scoring will be stored (without partitioning the vocabulary).
+ * \return 1 if operation was successful, else 0.
+ */
+int bench_nbc_score(const nbc *cl, const char *texts, const size_t offsets[], const size_t docs_cnt,
+                    const size_t parts_cnt, double scores[], double *seconds) {
+    nbc_scratch *scratch = NULL;
+    nbc_parts *parts = NULL;
+    double start;
+    size_t d;
+    int scored = 1;
+
+    if (parts_cnt) {
+        parts = nbc_parts_create(cl, parts_cnt);
+    }
+    else {
+        scratch = nbc_scratch_create(cl);
+    }
+    if (!parts && !scratch) {
+        return 0;
+    }
+
+    start = bench_now();
+    for (d = 0; d < docs_cnt && scored; d++) {
+        if (parts) {
+            scored = nbc_parts_score_buffer(parts, texts + offsets[d], offsets[d + 1] - offsets[d], scores + 2 * d);
+        }
+        else {
+            scored = nbc_score_buffer_r(cl, scratch, texts + offsets[d], offsets[d + 1] - offsets[d], scores + 2 * d);
+        }
+    }
+    *seconds = bench_now() - start;
+
+    nbc_parts_free(&parts);
+    nbc_scratch_free(&scratch);
+    return scored;
+}
+
+
+int bench_nbc_parts(const size_t words_cnt, const size_t parts_cnt[], const size_t runs_cnt, size_t *docs_cnt,
+                    double seconds[]) {
+    nbc *cl = NULL;
+    char *texts = NULL;
+    size_t *tokens = NULL, offsets[BENCH_DOCS_CNT + 1];
+    double *scores = NULL, *run_scores = NULL, diff;
+    size_t d, r, i;
+
+    if (!words_cnt || !parts_cnt || !docs_cnt || !seconds) {
+        return 0;
+    }
+    for (r = 0; r < runs_cnt; r++) {
+        if (parts_cnt[r] > NBC_MAX_PARTS) {
+            return 0;
+        }
+    }
+
+    cl = bench_nbc_learn(words_cnt);
+    texts = (char *) malloc(BENCH_DOCS_CNT * BENCH_DOC_WORDS * BENCH_KEY_SIZE);
+    tokens = (size_t *) malloc(BENCH_DOCS_CNT * BENCH_DOC_WORDS * sizeof(size_t));
+    scores = (double *) malloc(2 * BENCH_DOCS_CNT * sizeof(double));
+    run_scores = (double *) malloc(2 * BENCH_DOCS_CNT * sizeof(double));
+    if (!cl || !texts || !tokens || !scores || !run_scores
+        || !bench_zipf_tokens(tokens, BENCH_DOCS_CNT * BENCH_DOC_WORDS, words_cnt)) {
+        goto fail;
+    }
+    for (d = 0, offsets[0] = 0; d < BENCH_DOCS_CNT; d++) {
+        offsets[d + 1] = offsets[d] + bench_words_text(texts + offsets[d], tokens + d * BENCH_DOC_WORDS,
+                                                       BENCH_DOC_WORDS);
+    }
+
+    /* scores of every run are checked against the ones of the scoring thread alone */
+    if (!bench_nbc_score(cl, texts, offsets, BENCH_DOCS_CNT, 0, scores, &diff)) {
+        goto fail;
+    }
+    for (r = 0; r < runs_cnt; r++) {
+        if (!bench_nbc_score(cl, texts, offsets, BENCH_DOCS_CNT, parts_cnt[r], run_scores, &seconds[r])) {
+            goto fail;
+        }
+        for (i = 0; i < 2 * BENCH_DOCS_CNT; i++) {
+            diff = run_scores[i] - scores[i];
+            if ((diff < 0 ? -diff : diff) > BENCH_SCORES_EPS * (scores[i] < 0 ? -scores[i] : scores[i]) + 1e-12) {
+                goto fail;
+            }
+        }
+    }
+    *docs_cnt = BENCH_DOCS_CNT;
+
+    free(run_scores);
+    free(scores);
+    free(tokens);
+    free(texts);
+    nbc_free(&cl);
+    return 1;
+
+fail:
+    free(run_scores);
+    free(scores);
+    free(tokens);
+    free(texts);
+    nbc_free(&cl);
+    return 0;
+}
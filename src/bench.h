@@ -0,0 +1,80 @@
+/**
+ * \file bench.h
+ * \brief Header file related to the latency benchmarks of the data structures.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Latency of every measured operation is sorted into a histogram of powers of two of nanoseconds,
+ * so that rare stalls (e.g. expansions of a hashtable) are not hidden by the average.
+ * Operations are timed by the monotonic clock on Linux, else by the much coarser processor clock.
+ * Scaling of the shared counts (see shtab) is measured on synthetic words of Zipfian frequencies,
+ * counted by POSIX threads on Linux (elsewhere the parts of the threads are counted one after another).
+ * Partitioned scoring (see nbc_parts) is measured against the scoring thread alone on a synthetic classifier
+ * of a given number of words, scoring synthetic documents of words of Zipfian frequencies.
+ */
+
+
+#ifndef BENCH_H
+#define BENCH_H
+
+
+#include <stddef.h>
+
+
+/** \brief Number of bins of a latency histogram, the last one counts all the longer latencies. */
+#define BENCH_HIST_SIZE 32
+
+
+/**
+ * \struct bench_stats
+ * \brief Struct representing the results of a benchmark.
+ */
+typedef struct bench_stats_ {
+    size_t ops_cnt;                 /**< Number of measured operations. */
+    double seconds;                 /**< Duration of all the measured operations. */
+    double max;                     /**< Maximal latency of an operation in seconds. */
+    size_t hist[BENCH_HIST_SIZE];   /**< Numbers of operations of latencies [2^(i - 1), 2^i) ns (bin 0 below 1 ns). */
+} bench_stats;
+
+
+/**
+ * \brief bench_htab_add Adds distinct keys to an empty hashtable and measures the latency of every addition.
+ *                       Baseline rehashes all the entries at the addition expanding the buckets (see htab_reserve),
+ *                       as the hashtable did before its buckets were expanded incrementally.
+ * \param keys_cnt Number of keys.
+ * \param full_rehash Flag whether the baseline is measured (else the incremental expansion).
+ * \param stats Pointer to where the results will be stored.
+ * \return 1 if operation was successful, else 0.
+ */
+int bench_htab_add(const size_t keys_cnt, const int full_rehash, bench_stats *stats);
+
+
+/**
+ * \brief bench_shtab_count Counts the same synthetic words of Zipfian frequencies (exponent 1) into empty shared counts
+ *                          by each provided number of threads and measures the duration of every run.
+ * \param tokens_cnt Number of words (occurrences) counted by a run.
+ * \param threads_cnt Numbers of threads of the runs.
+ * \param runs_cnt Number of runs.
+ * \param seconds Array where the durations of the runs will be stored.
+ * \return 1 if operation was successful (and all the words were counted), else 0.
+ */
+int bench_shtab_count(const size_t tokens_cnt, const size_t threads_cnt[], const size_t runs_cnt, double seconds[]);
+
+
+/**
+ * \brief bench_nbc_parts Scores the same synthetic documents of words of Zipfian frequencies (exponent 1)
+ *                        by a synthetic classifier of the provided number of words, by the scoring thread alone
+ *                        or by each provided number of partitions of its vocabulary (see nbc_parts),
+ *                        and measures the duration of every run.
+ * \param words_cnt Number of words of the classifier.
+ * \param parts_cnt Numbers of partitions of the runs (0 for the scoring thread alone).
+ * \param runs_cnt Number of runs.
+ * \param docs_cnt Pointer to where the number of documents scored by a run will be stored.
+ * \param seconds Array where the durations of the runs will be stored.
+ * \return 1 if operation was successful (and the scores of all the runs agree), else 0.
+ */
+int bench_nbc_parts(const size_t words_cnt, const size_t parts_cnt[], const size_t runs_cnt, size_t *docs_cnt,
+                    double seconds[]);
+
+
+#endif
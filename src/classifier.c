@@ -5,144 +5,204 @@
  * \author Stanislav Kafara, skafara@students.zcu.cz
  *
  * Represents a general naive Bayes classifier.
- * Classifier has variable count of classes and uses the bag-of-words model.
+ * Classifier has variable count of classes and uses the bag-of-words model
+ * with either the multinomial or the Bernoulli event model.
+ * Partitioned classifier (see parts.h) dispatches the scoring of documents to the owners of the partitions.
+ * Placed rows of probabilities (see nbc_placement) are mapped by placement.h,
+ * replicated ones are copied after the policy of their node is set, so their pages are allocated on the node.
  */
 
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
 
 #include "classifier.h"
+#include "counts.h"
+#include "parts.h"
+#include "tokenizer.h"
 #include "structures/vector.h"
 #include "utilities/arrays.h"
+#include "utilities/hashing.h"
+#include "utilities/mapping.h"
+#include "utilities/placement.h"
+#include "utilities/vecmath.h"
+
+
+/** \brief Prefix of dictionary keys of word n-grams. */
+#define NBC_GRAM_KEY_PREFIX '\x01'
+/** \brief Number of features looked up in the dictionary at once. */
+#define NBC_BATCH_SIZE 16
+/** \brief Number of counters of a row of the sketch of features not in the dictionary yet. */
+#define NBC_SKETCH_WIDTH ((size_t) 1 << 21)
+/** \brief Number of shards of shared counts (see nbc_shared). */
+#define NBC_SHARED_SHARDS 64
+/** \brief Heaps' law coefficient of distinct words (K of K * words^beta). */
+#define NBC_HEAPS_K 12.0
+/** \brief Heaps' law exponent of distinct words. */
+#define NBC_HEAPS_BETA 0.6
+/** \brief Heaps' law coefficient of distinct n-grams of each order. */
+#define NBC_HEAPS_GRAM_K 3.0
+/** \brief Heaps' law exponent of distinct n-grams of each order (n-grams repeat much less than words). */
+#define NBC_HEAPS_GRAM_BETA 0.88
+
+#if defined(__GNUC__)
+/** \brief Prefetches the memory at the address into the cache for reading. */
+#define NBC_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+/** \brief Prefetches the memory at the address into the cache for reading (not supported by the compiler). */
+#define NBC_PREFETCH(addr) ((void) (addr))
+#endif
 
 
 /**
- * \brief f_next_str Reads next string from the file stream.
- *                   Allocates a memory for the string and returns the pointer to the string.
- *                   Allocated memory must later be released.
- * \param fp File handle.
- * \return Pointer to the newly allocated memory, where the string is stored,
- *         or NULL if there is not any more.
+ * \struct nbc_batch
+ * \brief Struct representing features of consecutive words of a document, which are looked up at once,
+ *        so that the memory accesses of the lookups overlap.
  */
-char *f_next_str(FILE *fp) {
-    vector *v = NULL;
-    char *str = NULL;
-    int c;
+typedef struct nbc_batch_ {
+    int cnt;                                            /**< Number of features in the batch. */
+    const char *keys[NBC_BATCH_SIZE];                   /**< Dictionary keys of the features. */
+    unsigned long hashes[NBC_BATCH_SIZE];               /**< Hashes of the features (of their dictionary keys). */
+    char gram_keys[NBC_BATCH_SIZE][NBC_GRAM_KEY_SIZE];  /**< Dictionary keys of the n-grams. */
+    size_t *values[NBC_BATCH_SIZE];                     /**< Dictionary values of the features. */
+    size_t ids[NBC_BATCH_SIZE];                         /**< Identifiers of the features. */
+    int found[NBC_BATCH_SIZE];                          /**< Whether the features are known. */
+    int words_cnt;                                      /**< Number of words in the batch. */
+    char *words[NBC_BATCH_SIZE];                        /**< Words of the batch (owned). */
+} nbc_batch;
 
-    if (!fp) {
-        return NULL;
-    }
-
-    v = vector_create(sizeof(char), NULL);
-    if (!v) {
-        return NULL;
-    }
-
-    c = fgetc(fp);
-    if (c == EOF || c == '\r' || c == '\n') {
-        goto fail;
-    }
 
-    while (c != EOF || c != '\r' || c != '\n') {
-        if (c == ' ') {
-            break;
-        }
+/**
+ * \struct nbc_shared_item
+ * \brief Struct representing a feature of a shard of shared counts, sorted before it is given an identifier
+ *        (or a learnt feature sorted before it is written to a counts file or before the most frequent
+ *        features are kept).
+ */
+typedef struct nbc_shared_item_ {
+    unsigned long hash;                                 /**< Hash of the feature (of its dictionary key). */
+    const char *key;                                    /**< Dictionary key of the feature. */
+    size_t *row;                                        /**< Counts of the feature in classes. */
+    size_t total;                                       /**< Total count of the feature (see nbc_keep_words). */
+} nbc_shared_item;
 
-        if (!vector_push_back(v, &c)) {
-            goto fail;
-        }
 
-        c = fgetc(fp);
-    }
+/**
+ * \brief nbc_words_prob_free Releases the memory held by the rows of probabilities of words (and their placed copies).
+ * \param cl Pointer to a classifier.
+ */
+void nbc_words_prob_free(nbc *cl) {
+    size_t node;
 
-    if (!vector_count(v)) {
-        goto fail;
+    if (!cl->words_prob_nodes) {
+        array_free_aligned((void **) &cl->words_prob);
+        return;
     }
 
-    c = '\x00';
-    if (!vector_push_back(v, &c) || !vector_shrink(v)) {
-        goto fail;
+    for (node = 0; node < cl->words_prob_nodes_cnt; node++) {
+        place_free(cl->words_prob_nodes[node], cl->words_prob_rows * cl->cls_stride * sizeof(double));
     }
-
-    str = (char *) vector_give_up_data(v);
-
-    vector_free(&v);
-    return str;
-
-fail:
-    vector_free(&v);
-    return NULL;
+    array_free((void **) &cl->words_prob_nodes);
+    cl->words_prob_nodes_cnt = 0;
+    cl->words_prob = NULL;
 }
 
 
 /**
- * \brief cmp_double_greater Performs a comparison of the two provided values.
- * \param value1 Pointer to the first value.
- * \param value2 Pointer to the second value.
- * \return 1 if value1 is greater than value2, -1 if value1 is less than value2,
- *         0 if value1 is equal to value2.
+ * \brief nbc_arrays_htabs_free Releases the memory held by the classifier's arrays, vectors and hashtables
+ *                              and NULLs the pointers to the arrays, vectors and hashtables.
+ * \param cl Pointer to a classifier.
  */
-int cmp_double_greater(const void *value1, const void *value2) {
-    if (*((double *) value1) > *((double *) value2)) {
-        return 1;
-    }
-    else if (*((double *) value1) < *((double *) value2)) {
-        return -1;
-    }
-    else {
-        return 0;
+void nbc_arrays_htabs_free(nbc *cl) {
+    if (!cl) {
+        return;
     }
+    
+    array_free((void **) &cl->cls_prob); array_free((void **) &cl->cls_docs_cnt);
+    array_free((void **) &cl->cls_words_cnt); array_free((void **) &cl->cls_absent_prob);
+    /* owners of the partitions read the rows of probabilities until they are stopped */
+    nbc_parts_free(&cl->parts);
+    htab_size_free(&cl->words_id); vector_free(&cl->words_cnt); nbc_words_prob_free(cl);
+    vector_free(&cl->words_seen); cms_free(&cl->sketch); nbc_scratch_free(&cl->scratch);
+
+    cl->cls_prob = cl->cls_absent_prob = NULL; cl->cls_docs_cnt = cl->cls_words_cnt = NULL;
+    cl->words_id = NULL; cl->words_cnt = cl->words_seen = NULL; cl->words_prob = NULL;
 }
 
 
 /**
- * \brief nbc_arrays_htabs_free Releases the memory held by the classifier's arrays and hashtables
- *                              and NULLs the pointers to the arrays and hashtables.
- * \param cl Pointer to a classifier.
+ * \brief nbc_reset_slots Creates zero rows of counts of all the feature hashing slots (and their seen epochs).
+ *                        Does not check arguments validity.
+ * \param cl Pointer to a classifier using feature hashing.
+ * \param words_cnt Vector of rows of counts of words.
+ * \param words_seen Vector of epochs of documents where the words were seen last.
+ * \return 1 if operation was successful, else 0.
  */
-void nbc_arrays_htabs_free(nbc *cl) {
-    if (!cl) {
-        return;
+int nbc_reset_slots(const nbc *cl, vector *words_cnt, vector *words_seen) {
+    size_t slots_cnt;
+
+    slots_cnt = (size_t) 1 << cl->params.hash_bits;
+    if (!vector_resize(words_cnt, slots_cnt)) {
+        return 0;
+    }
+    if (cl->params.model == NBC_BERNOULLI && !vector_resize(words_seen, slots_cnt)) {
+        return 0;
     }
-    
-    array_free((void **) &cl->cls_prob); array_free((void **) &cl->cls_words_cnt);
-    htab_free(&cl->words_cnt); htab_free(&cl->words_prob);
 
-    cl->cls_prob = NULL; cl->cls_words_cnt = NULL;
-    cl->words_cnt = cl->words_prob = NULL;
+    return 1;
 }
 
 
 /**
- * \brief nbc_reset Frees and creates new classifier's arrays and hashtables and sets dictionary size to 0.
+ * \brief nbc_reset Frees and creates new classifier's arrays, vectors and hashtables and sets dictionary size to 0.
  * \param cl Pointer to a classifier.
  * \return 1 if operation was successful, else 0.
  */
 int nbc_reset(nbc *cl) {
-    double *new_cls_prob = NULL;
-    size_t *new_cls_words_cnt = NULL;
-    htab *new_words_cnt = NULL, *new_words_prob = NULL;
+    double *new_cls_prob = NULL, *new_cls_absent_prob = NULL;
+    size_t *new_cls_docs_cnt = NULL, *new_cls_words_cnt = NULL;
+    htab_size *new_words_id = NULL;
+    vector *new_words_cnt = NULL, *new_words_seen = NULL;
+    cms *new_sketch = NULL;
 
     if (!cl) {
         return 0;
     }
 
     new_cls_prob = (double *) array_create(cl->cls_cnt, sizeof(double));
+    new_cls_absent_prob = (double *) array_create(cl->cls_cnt, sizeof(double));
+    new_cls_docs_cnt = (size_t *) array_create(cl->cls_cnt, sizeof(size_t));
     new_cls_words_cnt = (size_t *) array_create(cl->cls_cnt, sizeof(size_t));
-    new_words_cnt = htab_create(sizeof(size_t *), (htab_item_value_deallocator) array_free);
-    new_words_prob = htab_create(sizeof(size_t *), (htab_item_value_deallocator) array_free);
+    if (!cl->params.hash_bits) {
+        new_words_id = htab_size_create(0);
+    }
+    new_words_cnt = vector_create(cl->cls_cnt * sizeof(size_t), NULL);
+    new_words_seen = vector_create(sizeof(size_t), NULL);
+    if (cl->params.min_count > 1) {
+        new_sketch = cms_create(NBC_SKETCH_WIDTH, CMS_DEF_DEPTH, cl->params.min_count);
+    }
 
-    if (!new_cls_prob || !new_cls_words_cnt || !new_words_cnt || !new_words_prob) {
-        array_free((void **) &new_cls_prob); array_free((void **) &new_cls_words_cnt);
-        htab_free(&new_words_cnt); htab_free(&new_words_prob);
+    if (!new_cls_prob || !new_cls_absent_prob || !new_cls_docs_cnt || !new_cls_words_cnt ||
+        (!cl->params.hash_bits && !new_words_id) || !new_words_cnt || !new_words_seen ||
+        (cl->params.hash_bits && !nbc_reset_slots(cl, new_words_cnt, new_words_seen)) ||
+        (cl->params.min_count > 1 && !new_sketch)) {
+        array_free((void **) &new_cls_prob); array_free((void **) &new_cls_absent_prob);
+        array_free((void **) &new_cls_docs_cnt); array_free((void **) &new_cls_words_cnt);
+        htab_size_free(&new_words_id); vector_free(&new_words_cnt); vector_free(&new_words_seen);
+        cms_free(&new_sketch);
         return 0;
     }
 
     nbc_arrays_htabs_free(cl);
-    cl->cls_prob = new_cls_prob; cl->cls_words_cnt = new_cls_words_cnt;
-    cl->words_cnt = new_words_cnt; cl->words_prob = new_words_prob;
+    cl->cls_prob = new_cls_prob; cl->cls_absent_prob = new_cls_absent_prob;
+    cl->cls_docs_cnt = new_cls_docs_cnt; cl->cls_words_cnt = new_cls_words_cnt;
+    cl->words_id = new_words_id; cl->words_cnt = new_words_cnt; cl->words_seen = new_words_seen;
+    cl->sketch = new_sketch;
+    cl->sketched = 0;
+    cl->words_prob = NULL;
+    cl->words_prob_rows = 0;
+    cl->epoch = 0;
     cl->dict_size = 0;
 
     return 1;
@@ -150,20 +210,46 @@ int nbc_reset(nbc *cl) {
 
 
 /**
- * \brief nbc_initialize Initializes the classifier to provided number of classes.
+ * \brief nbc_initialize Initializes the classifier to provided number of classes and parameters.
  * \param cl Pointer to a classifier.
  * \param cls_cnt Number of classes.
+ * \param params Pointer to parameters of the classifier, or NULL for the default ones.
  * \return 1 if operation was successful, else 0.
  */
-int nbc_initialize(nbc *cl, const int cls_cnt) {
+int nbc_initialize(nbc *cl, const int cls_cnt, const nbc_params *params) {
+    nbc_params def_params;
+
     if (!cl || nbc_is_learnt(cl) || cls_cnt == 0) {
         return 0;
     }
 
+    if (!params) {
+        def_params.model = NBC_MULTINOMIAL;
+        def_params.hash_bits = 0;
+        def_params.ngram = 1;
+        def_params.threads = 1;
+        def_params.min_count = 1;
+        def_params.max_words = 0;
+        def_params.placement = NBC_PLACE_DEFAULT;
+        def_params.parts = 0;
+        params = &def_params;
+    }
+    if (params->hash_bits > NBC_MAX_HASH_BITS || params->ngram < 1 || params->ngram > NBC_MAX_NGRAM ||
+        params->threads < 1 || params->threads > NBC_MAX_THREADS ||
+        params->min_count < 1 || params->min_count > NBC_MAX_MIN_COUNT ||
+        (params->hash_bits && (params->min_count > 1 || params->max_words)) ||
+        params->placement > NBC_PLACE_REPLICATE || params->parts > NBC_MAX_PARTS) {
+        return 0;
+    }
+
     *((int *) &cl->cls_cnt) = cls_cnt;
+    *((size_t *) &cl->cls_stride) = vec_padded(cls_cnt);
+    *((nbc_params *) &cl->params) = *params;
 
-    cl->cls_prob = NULL; cl->cls_words_cnt = NULL;
-    cl->words_cnt = cl->words_prob = NULL;
+    cl->cls_prob = cl->cls_absent_prob = NULL; cl->cls_docs_cnt = cl->cls_words_cnt = NULL;
+    cl->words_id = NULL; cl->words_cnt = cl->words_seen = NULL; cl->words_prob = NULL;
+    cl->words_prob_nodes = NULL; cl->words_prob_nodes_cnt = 0; cl->words_prob_rows = 0;
+    cl->sketch = NULL; cl->scratch = NULL; cl->parts = NULL;
 
     if (!nbc_reset(cl)) {
         return 0;
@@ -173,7 +259,7 @@ int nbc_initialize(nbc *cl, const int cls_cnt) {
 }
 
 
-nbc *nbc_create(const int cls_cnt) {
+nbc *nbc_create(const int cls_cnt, const nbc_params *params) {
     nbc *cl = NULL;
 
     if (cls_cnt == 0) {
@@ -186,7 +272,7 @@ nbc *nbc_create(const int cls_cnt) {
     }
 
     cl->dict_size = 0;
-    if (!nbc_initialize(cl, cls_cnt)) {
+    if (!nbc_initialize(cl, cls_cnt, params)) {
         nbc_free(&cl);
         return NULL;
     }
@@ -210,288 +296,2250 @@ void nbc_free(nbc **cl) {
  * \brief nbc_set_cls_prob Sets aprior probabilities of classes in learnt files.
  *                         Does not check arguments validity.
  * \param cl Pointer to a classifier.
- * \param f_counts Array of counts of files of the same class.
  */
-void nbc_set_cls_prob(nbc *cl, const size_t f_counts[]) {
-    size_t f_counts_sum;
+void nbc_set_cls_prob(nbc *cl) {
+    size_t docs_cnt_sum;
     int cls;
 
-    f_counts_sum = 0;
+    docs_cnt_sum = 0;
     for (cls = 0; cls < cl->cls_cnt; cls++) {
-        f_counts_sum += f_counts[cls];
+        docs_cnt_sum += cl->cls_docs_cnt[cls];
     }
 
     for (cls = 0; cls < cl->cls_cnt; cls++) {
-        cl->cls_prob[cls] = 1 - ((double) (f_counts_sum - f_counts[cls]) / f_counts_sum);
+        cl->cls_prob[cls] = 1 - ((double) (docs_cnt_sum - cl->cls_docs_cnt[cls]) / docs_cnt_sum);
     }
 }
 
 
+void nbc_features_reset(nbc_features *f) {
+    f->words_cnt = 0;
+    f->cnt = 0;
+}
+
+
 /**
- * \brief nbc_add_words_cnt Adds the counts of the words in the file of the provided class.
- * \param cl Pointer to a classifier.
- * \param fp File handle.
- * \param cls Class to which the file belongs to.
- * \return 1 if counts of words were successfuly added.
+ * \brief nbc_gram_key_make Makes the dictionary key of a word n-gram from its hash.
+ * \param key Buffer of NBC_GRAM_KEY_SIZE chars.
+ * \param hash Hash of the n-gram.
  */
-int nbc_add_words_cnt(nbc *cl, FILE *fp, const int cls) {
-    char *word = NULL;
-    size_t *word_cnt = NULL;
+void nbc_gram_key_make(char key[], unsigned long hash) {
+    const char *digits = "0123456789abcdef";
+    size_t c;
 
-    while ((word = f_next_str(fp))) {
-        if (htab_contains(cl->words_cnt, word)) {
-            if (!htab_get(cl->words_cnt, word, &word_cnt)) {
-                goto fail;
-            }
-            word_cnt[cls]++;
-        }
-        else {
-            word_cnt = (size_t *) array_create(cl->cls_cnt, sizeof(size_t));
-            if (!word_cnt) {
-                goto fail;
-            }
-            word_cnt[cls] = 1;
-            if (!htab_add(cl->words_cnt, word, &word_cnt)) {
-                array_free((void **) &word_cnt);
-                goto fail;
-            }
-        }
-        free(word);
+    key[0] = NBC_GRAM_KEY_PREFIX;
+    for (c = 1; c < NBC_GRAM_KEY_SIZE - 1; c++, hash >>= 4) {
+        key[c] = digits[hash & 0xF];
     }
+    key[NBC_GRAM_KEY_SIZE - 1] = '\x00';
+}
 
-    return 1;
 
-fail:
-    free(word);
-    return 0;
+unsigned long nbc_word_hash(const nbc *cl, const char *word) {
+    (void) cl;
+
+    return htab_hash(word);
+}
+
+
+void nbc_features_next(const nbc *cl, nbc_features *f, const char *word, const unsigned long word_hash) {
+    unsigned long bigram_hash;
+    int n;
+
+    bigram_hash = 0;
+    f->cnt = 0;
+    f->keys[f->cnt] = word;
+    f->hashes[f->cnt++] = word_hash;
+    if (cl->params.ngram >= 2 && f->words_cnt >= 1) {
+        bigram_hash = hash_combine(f->word_hash, word_hash);
+        f->hashes[f->cnt++] = bigram_hash;
+    }
+    if (cl->params.ngram >= 3 && f->words_cnt >= 2) {
+        f->hashes[f->cnt++] = hash_combine(f->bigram_hash, word_hash);
+    }
+
+    if (!cl->params.hash_bits) {
+        for (n = 1; n < f->cnt; n++) {
+            nbc_gram_key_make(f->gram_keys[n], f->hashes[n]);
+            f->keys[n] = f->gram_keys[n];
+            f->hashes[n] = htab_hash(f->keys[n]);
+        }
+    }
+
+    f->word_hash = word_hash;
+    f->bigram_hash = bigram_hash;
+    f->words_cnt++;
 }
 
 
 /**
- * \brief nbc_set_words_cnt Sets counts of words in provided files of classifier's classes.
+ * \brief nbc_word_find Finds out the identifier of the word (feature) in the learnt data.
+ *                      Does not check arguments validity.
  * \param cl Pointer to a classifier.
- * \param f_paths Array of paths to files to be learnt.
- * \param f_counts Array of counts of file paths for each class.
- * \return 1 if classifier learnt all the provided files, else 0.
+ * \param word Word or dictionary key of an n-gram.
+ * \param hash Hash of the word or dictionary key of an n-gram (hash of the n-gram with feature hashing).
+ * \param id Pointer to where the word identifier will be stored.
+ * \return 1 if the word (its slot with feature hashing) is known, else 0.
  */
-int nbc_set_words_cnt(nbc *cl, const char *f_paths[], const size_t f_counts[]) {
-    size_t f, f_offset;
-    FILE *fp = NULL;
-    int cls;
+int nbc_word_find(const nbc *cl, const char *word, const unsigned long hash, size_t *id) {
+    size_t *word_id = NULL;
 
-    f_offset = 0;
-    for (cls = 0; cls < cl->cls_cnt; cls++) {
-        for (f = 0; f < f_counts[cls]; f++) {
-            fp = fopen(f_paths[f_offset + f], "r");
-            if (!fp) {
-                return 0;
-            }
-            
-            if (!nbc_add_words_cnt(cl, fp, cls)) {
-                fclose(fp);
-                return 0;
-            }
-            
-            if (fclose(fp) == EOF) {
-                return 0;
-            }
-        }
-        
-        f_offset += f_counts[cls];
+    if (cl->params.hash_bits) {
+        *id = hash & (((size_t) 1 << cl->params.hash_bits) - 1);
+        return 1;
+    }
+
+    word_id = htab_size_ptrget_hashed(cl->words_id, word, hash);
+    if (!word_id) {
+        return 0;
     }
 
+    *id = *word_id;
     return 1;
 }
 
 
 /**
- * \brief nbc_set_cls_words_cnt Sets count of learnt words (counting duplicities) for each class.
- *                              Does not check arguments validity.
+ * \brief nbc_word_id Finds out the identifier of the word (feature).
+ *                    Adds the word to the dictionary (with a new row of zero counts) if it is not there yet.
+ *                    Does not check arguments validity.
  * \param cl Pointer to a classifier.
+ * \param word Word or dictionary key of an n-gram.
+ * \param hash Hash of the word or dictionary key of an n-gram (hash of the n-gram with feature hashing).
+ * \param id Pointer to where the word identifier will be stored.
  * \return 1 if operation was successful, else 0.
  */
-int nbc_set_cls_words_cnt(nbc *cl) {
-    size_t *words_cnt = NULL;
-    htl_iter *it = NULL;
-    htab_link *htl = NULL;
-    int cls;
+int nbc_word_id(nbc *cl, const char *word, const unsigned long hash, size_t *id) {
+    if (nbc_word_find(cl, word, hash, id)) {
+        return 1;
+    }
 
-    words_cnt = array_create(cl->cls_cnt, sizeof(size_t));
-    it = htl_iter_create(cl->words_cnt);
-    if (!words_cnt || !it) {
-        array_free((void **) &words_cnt);
-        htl_iter_free(&it);
+    *id = htab_size_items_cnt(cl->words_id);
+    if (!vector_resize(cl->words_cnt, *id + 1)) {
         return 0;
     }
-
-    while ((htl = htl_iter_next(it))) {
-        for (cls = 0; cls < cl->cls_cnt; cls++) {
-            words_cnt[cls] += (*((size_t **) (htl->value)))[cls];
-        }
+    if (cl->params.model == NBC_BERNOULLI && !vector_resize(cl->words_seen, *id + 1)) {
+        return 0;
     }
-    for (cls = 0; cls < cl->cls_cnt; cls++) {
-        cl->cls_words_cnt[cls] = words_cnt[cls];
+    if (!htab_size_add_hashed(cl->words_id, word, hash, *id)) {
+        return 0;
     }
 
-    array_free((void **) &words_cnt);
-    htl_iter_free(&it);
     return 1;
 }
 
 
 /**
- * \brief nbc_set_dict_size Sets classifier dictionary size (number of distinct learnt words).
+ * \brief nbc_word_admitted Finds out whether the feature not in the dictionary yet is to be added to it
+ *                          (see nbc_params), by its count estimated in the first pass of learning.
  *                          Does not check arguments validity.
- * \param cl Pointer to a classifier.
+ * \param cl Pointer to a classifier not using feature hashing.
+ * \param hash Hash of the feature (see nbc_features).
+ * \return 1 if the feature is to be added, else 0.
  */
-void nbc_set_dict_size(nbc *cl) {
-    cl->dict_size = htab_items_cnt(cl->words_cnt);
+int nbc_word_admitted(const nbc *cl, const unsigned long hash) {
+    return !cl->sketch || cms_estimate(cl->sketch, hash) >= cl->params.min_count;
 }
 
 
 /**
- * \brief nbc_set_words_prob Sets words probabilities.
- *                           Does not check arguments validity.
+ * \brief nbc_sketching Finds out whether the classifier is in the first pass of learning,
+ *                      where the documents are only counted by the sketch (see nbc_sketch_finish).
+ *                      Does not check arguments validity.
  * \param cl Pointer to a classifier.
- * \return 1 if operation was successful, else 0.
+ * \return 1 if the documents are counted by the sketch, else 0.
  */
-int nbc_set_words_prob(nbc *cl) {
-    htl_iter *it = NULL;
-    htab_link *htl = NULL;
-    double *word_prob = NULL;
-    size_t *word_cnt = NULL;
-    int cls;
+int nbc_sketching(const nbc *cl) {
+    return cl->sketch && !cl->sketched;
+}
 
-    it = htl_iter_create(cl->words_cnt);
-    if (!it) {
-        return 0;
-    }
 
-    while ((htl = htl_iter_next(it))) {
-        if (!htab_contains(cl->words_prob, htl->key)) {
-            word_prob = (double *) array_create(cl->cls_cnt, sizeof(double));
-            if (!word_prob) {
-                return 0;
-            }
-            if (!htab_add(cl->words_prob, htl->key, &word_prob)) {
-                array_free((void **) &word_prob);
-                return 0;
-            }
-        }
-    }
+/**
+ * \brief nbc_sketch_word Counts the features of the next word of a document by the sketch
+ *                        (all of them, before the Bernoulli model counts them once per document).
+ *                        Does not check arguments validity.
+ * \param cl Pointer to a classifier in the first pass of learning (see nbc_sketching).
+ * \param f Pointer to features of the document.
+ * \param word Next word of the document.
+ * \param hash Hash of the word.
+ * \param atomic 1 if the counters are added atomically (see nbc_shared), else 0.
+ */
+void nbc_sketch_word(const nbc *cl, nbc_features *f, const char *word, const unsigned long hash, const int atomic) {
+    int n;
 
-    htl_iter_reset(it);
-    while ((htl = htl_iter_next(it))) {
-        for (cls = 0; cls < cl->cls_cnt; cls++) {
-            if (!htab_get(cl->words_prob, htl->key, &word_prob)) {
-                return 0;
-            }
-            if (!htab_get(cl->words_cnt, htl->key, &word_cnt)) {
-                return 0;
-            }
-            word_prob[cls] = (double) (1 + word_cnt[cls]) / (cl->cls_words_cnt[cls] + cl->dict_size);
+    nbc_features_next(cl, f, word, hash);
+    for (n = 0; n < f->cnt; n++) {
+        if (atomic) {
+            cms_add_atomic(cl->sketch, f->hashes[n]);
+        }
+        else {
+            cms_add(cl->sketch, f->hashes[n]);
         }
     }
-
-    htl_iter_free(&it);
-
-    return 1;
 }
 
 
-int nbc_learn(nbc *cl, const char *f_paths[], const size_t f_counts[]) {
-    if (!cl || nbc_is_learnt(cl) || !f_paths || !f_counts) {
-        return 0;
-    }
-
-    nbc_set_cls_prob(cl, f_counts);
-    if (!nbc_set_words_cnt(cl, f_paths, f_counts)) {
-        goto fail;
-    }
-    if (!nbc_set_cls_words_cnt(cl)) {
-        goto fail;
+/**
+ * \brief nbc_word_admit Finds out the identifier of the learnt word (feature).
+ *                       Adds the word to the dictionary (see nbc_word_id) once it is admitted (see nbc_word_admitted).
+ *                       Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param word Word or dictionary key of an n-gram.
+ * \param hash Hash of the word or dictionary key of an n-gram (hash of the n-gram with feature hashing).
+ * \param id Pointer to where the word identifier will be stored.
+ * \return 1 if the word is in the dictionary, 0 if it is not admitted yet, -1 on failure.
+ */
+int nbc_word_admit(nbc *cl, const char *word, const unsigned long hash, size_t *id) {
+    if (nbc_word_find(cl, word, hash, id)) {
+        return 1;
     }
-    nbc_set_dict_size(cl);
-    if (!nbc_set_words_prob(cl)) {
-        goto fail;
+    if (!nbc_word_admitted(cl, hash)) {
+        return 0;
     }
 
-    return 1;
-
-fail:
-    nbc_reset(cl);
-    return 0;
+    return nbc_word_id(cl, word, hash, id) ? 1 : -1;
 }
 
 
-int nbc_is_learnt(const nbc *cl) {
-    if (!cl) {
+/**
+ * \brief nbc_word_first_seen Stamps the word as seen in the current document epoch.
+ *                            Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param id Word identifier.
+ * \return 1 if the word was not seen in the current document epoch yet, else 0.
+ */
+int nbc_word_first_seen(nbc *cl, const size_t id) {
+    size_t *seen = NULL;
+
+    seen = (size_t *) vector_at(cl->words_seen, id);
+    if (*seen == cl->epoch) {
         return 0;
     }
 
-    return cl->dict_size > 0;
+    *seen = cl->epoch;
+    return 1;
 }
 
 
-int nbc_classify(const nbc *cl, const char f_path[]) {
-    FILE *fp = NULL;
-    double *probs = NULL;
-    int cls;
-    char *word = NULL;
-    double *word_prob = NULL;
-    double *max_prob = NULL;
+/**
+ * \brief nbc_batch_clear Releases the words of the batch and empties it.
+ * \param b Pointer to a batch.
+ */
+void nbc_batch_clear(nbc_batch *b) {
+    int w;
 
-    if (!nbc_is_learnt(cl)) {
-        return -1;
+    for (w = 0; w < b->words_cnt; w++) {
+        free(b->words[w]);
     }
+    b->words_cnt = 0;
+    b->cnt = 0;
+}
 
-    fp = fopen(f_path, "r");
-    if (!fp) {
-        return -1;
+
+/**
+ * \brief nbc_batch_full Finds out whether the batch could not take the features of another word.
+ * \param b Pointer to a batch.
+ * \return 1 if the batch is full, else 0.
+ */
+int nbc_batch_full(const nbc_batch *b) {
+    return b->cnt + NBC_MAX_NGRAM > NBC_BATCH_SIZE;
+}
+
+
+/**
+ * \brief nbc_batch_push Appends the features of the word to the batch, which takes the ownership of the word.
+ *                       Batch must not be full (see nbc_batch_full).
+ *                       Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param b Pointer to a batch.
+ * \param f Pointer to the features of the word.
+ * \param word Word (allocated).
+ */
+void nbc_batch_push(const nbc *cl, nbc_batch *b, const nbc_features *f, char *word) {
+    int n;
+
+    b->words[b->words_cnt++] = word;
+    for (n = 0; n < f->cnt; n++, b->cnt++) {
+        b->hashes[b->cnt] = f->hashes[n];
+        if (n == 0) {
+            b->keys[b->cnt] = word;
+        }
+        else if (!cl->params.hash_bits) {
+            memcpy(b->gram_keys[b->cnt], f->gram_keys[n], NBC_GRAM_KEY_SIZE);
+            b->keys[b->cnt] = b->gram_keys[b->cnt];
+        }
+        else {
+            b->keys[b->cnt] = NULL;
+        }
     }
+}
 
-    probs = array_create(cl->cls_cnt, sizeof(double));
-    if (!probs) {
-        goto fail;
+
+/**
+ * \brief nbc_batch_find Finds out the identifiers of the features of the batch in the learnt data,
+ *                       looking all of them up in the dictionary at once.
+ *                       Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param b Pointer to a batch.
+ */
+void nbc_batch_find(const nbc *cl, nbc_batch *b) {
+    size_t mask;
+    int i;
+
+    if (cl->params.hash_bits) {
+        mask = ((size_t) 1 << cl->params.hash_bits) - 1;
+        for (i = 0; i < b->cnt; i++) {
+            b->ids[i] = b->hashes[i] & mask;
+            b->found[i] = 1;
+        }
+        return;
     }
-    for (cls = 0; cls < cl->cls_cnt; cls++) {
-        probs[cls] = log10(cl->cls_prob[cls]);
+
+    htab_size_ptrget_batch(cl->words_id, b->keys, b->hashes, (size_t) b->cnt, b->values);
+    for (i = 0; i < b->cnt; i++) {
+        b->found[i] = b->values[i] != NULL;
+        if (b->found[i]) {
+            b->ids[i] = *b->values[i];
+        }
     }
-    while ((word = f_next_str(fp))) {
-        if (!htab_contains(cl->words_prob, word)) {
-            free(word);
-            continue;
+}
+
+
+/**
+ * \brief nbc_batch_id Finds out the identifiers of the features of the batch,
+ *                     adding the unknown ones to the dictionary in the order of the features.
+ *                     Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param b Pointer to a batch.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_batch_id(nbc *cl, nbc_batch *b) {
+    int i;
+
+    nbc_batch_find(cl, b);
+    for (i = 0; i < b->cnt; i++) {
+        /* the feature may have been added by an earlier feature of the batch */
+        if (!b->found[i] && !nbc_word_id(cl, b->keys[i], b->hashes[i], &b->ids[i])) {
+            return 0;
         }
-        if (!htab_get(cl->words_prob, word, &word_prob)) {
-            free(word);
-            goto fail;
+    }
+
+    return 1;
+}
+
+
+/**
+ * \brief nbc_batch_count Adds the counts of the features of the batch of the document of the provided class,
+ *                        adding the admitted unknown ones to the dictionary in the order of the features.
+ *                        Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param b Pointer to a batch.
+ * \param cls Class to which the document belongs to.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_batch_count(nbc *cl, nbc_batch *b, const int cls) {
+    int i, admitted;
+
+    nbc_batch_find(cl, b);
+    for (i = 0; i < b->cnt; i++) {
+        /* the feature may have been added by an earlier feature of the batch */
+        if (!b->found[i]) {
+            admitted = nbc_word_admit(cl, b->keys[i], b->hashes[i], &b->ids[i]);
+            if (admitted == -1) {
+                return 0;
+            }
+            if (!admitted) {
+                continue;
+            }
         }
-        for (cls = 0; cls < cl->cls_cnt; cls++) {
-            probs[cls] += log10(word_prob[cls]);
+        if (cl->params.model == NBC_BERNOULLI && !nbc_word_first_seen(cl, b->ids[i])) {
+            continue;
         }
-        free(word);
-    }
-    if (fclose(fp) == EOF) {
-        fp = NULL;
-        goto fail;
+        ((size_t *) vector_at(cl->words_cnt, b->ids[i]))[cls]++;
     }
-    fp = NULL;
 
-    max_prob = array_extreme(probs, (cmp_func) cmp_double_greater, cl->cls_cnt, sizeof(double));
-    if (!max_prob) {
-        goto fail;
-    }
+    return 1;
+}
 
-    cls = max_prob - probs;
-    array_free((void **) &probs);
 
-    return cls;
+/**
+ * \brief nbc_vocab_features_find Sets the features of the next word of a pre-tokenized document
+ *                                and finds out the identifiers of the known ones.
+ *                                Identifier of the word itself is resolved once per vocabulary.
+ *                                Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param vocab Pointer to a vocabulary of the classifier.
+ * \param f Pointer to features.
+ * \param word Index of the next word of the document to the vocabulary.
+ * \param ids Array of NBC_MAX_NGRAM items, where the identifiers of known features will be stored.
+ * \return Number of known features.
+ */
+int nbc_vocab_features_find(const nbc *cl, nbc_vocab *vocab, nbc_features *f, const unsigned word, size_t ids[]) {
+    int n, ids_cnt;
 
-fail:
-    if (fp) {
-        fclose(fp);
-        fp = NULL;
+    nbc_features_next(cl, f, vocab->words[word], vocab->hashes[word]);
+    ids_cnt = 0;
+    if (vocab->ids[word] != NBC_NO_ID || nbc_word_find(cl, f->keys[0], f->hashes[0], &vocab->ids[word])) {
+        ids[ids_cnt++] = vocab->ids[word];
     }
+    for (n = 1; n < f->cnt; n++) {
+        if (nbc_word_find(cl, f->keys[n], f->hashes[n], &ids[ids_cnt])) {
+            ids_cnt++;
+        }
+    }
+
+    return ids_cnt;
+}
+
+
+/**
+ * \brief nbc_vocab_features_id Sets the features of the next word of a pre-tokenized document
+ *                              and finds out their identifiers, adding them to the dictionary if needed.
+ *                              Identifier of the word itself is resolved once per vocabulary.
+ *                              Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param vocab Pointer to a vocabulary of the classifier.
+ * \param f Pointer to features.
+ * \param word Index of the next word of the document to the vocabulary.
+ * \param ids Array of NBC_MAX_NGRAM items, where the identifiers of the features will be stored.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_vocab_features_id(nbc *cl, nbc_vocab *vocab, nbc_features *f, const unsigned word, size_t ids[]) {
+    int n;
+
+    nbc_features_next(cl, f, vocab->words[word], vocab->hashes[word]);
+    if (vocab->ids[word] == NBC_NO_ID && !nbc_word_id(cl, f->keys[0], f->hashes[0], &vocab->ids[word])) {
+        return 0;
+    }
+    ids[0] = vocab->ids[word];
+    for (n = 1; n < f->cnt; n++) {
+        if (!nbc_word_id(cl, f->keys[n], f->hashes[n], &ids[n])) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+/**
+ * \brief nbc_vocab_features_admit Sets the features of the next learnt word of a pre-tokenized document
+ *                                 and finds out the identifiers of the features in the dictionary,
+ *                                 adding the admitted ones to it (see nbc_word_admit).
+ *                                 Identifier of the word itself is resolved once per vocabulary.
+ *                                 Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param vocab Pointer to a vocabulary of the classifier.
+ * \param f Pointer to features.
+ * \param word Index of the next word of the document to the vocabulary.
+ * \param ids Array of NBC_MAX_NGRAM items, where the identifiers of the features in the dictionary will be stored.
+ * \return Number of features in the dictionary, or -1 on failure.
+ */
+int nbc_vocab_features_admit(nbc *cl, nbc_vocab *vocab, nbc_features *f, const unsigned word, size_t ids[]) {
+    int n, ids_cnt, admitted;
+
+    nbc_features_next(cl, f, vocab->words[word], vocab->hashes[word]);
+    ids_cnt = 0;
+    for (n = 0; n < f->cnt; n++) {
+        if (n == 0 && vocab->ids[word] != NBC_NO_ID) {
+            ids[ids_cnt++] = vocab->ids[word];
+            continue;
+        }
+
+        admitted = nbc_word_admit(cl, f->keys[n], f->hashes[n], &ids[ids_cnt]);
+        if (admitted == -1) {
+            return -1;
+        }
+        if (admitted) {
+            if (n == 0) {
+                vocab->ids[word] = ids[ids_cnt];
+            }
+            ids_cnt++;
+        }
+    }
+
+    return ids_cnt;
+}
+
+
+/**
+ * \brief nbc_add_words_cnt Adds the counts of the words (and n-grams) of the document of the provided class.
+ *                          In the Bernoulli model each word is counted at most once.
+ * \param cl Pointer to a classifier.
+ * \param t Pointer to a source of words of the document (file or buffer).
+ * \param cls Class to which the document belongs to.
+ * \return 1 if counts of words were successfuly added.
+ */
+int nbc_add_words_cnt(nbc *cl, tokens *t, const int cls) {
+    nbc_features f;
+    nbc_batch b;
+    char *word = NULL;
+
+    nbc_features_reset(&f);
+    if (nbc_sketching(cl)) {
+        while ((word = tokens_next(t))) {
+            nbc_sketch_word(cl, &f, word, nbc_word_hash(cl, word), 0);
+            free(word);
+        }
+        return 1;
+    }
+
+    cl->epoch++;
+    b.cnt = b.words_cnt = 0;
+    while ((word = tokens_next(t))) {
+        nbc_features_next(cl, &f, word, nbc_word_hash(cl, word));
+        nbc_batch_push(cl, &b, &f, word);
+        if (nbc_batch_full(&b)) {
+            if (!nbc_batch_count(cl, &b, cls)) {
+                goto fail;
+            }
+            nbc_batch_clear(&b);
+        }
+    }
+    if (!nbc_batch_count(cl, &b, cls)) {
+        goto fail;
+    }
+    nbc_batch_clear(&b);
+    cl->cls_docs_cnt[cls]++;
+
+    return 1;
+
+fail:
+    nbc_batch_clear(&b);
+    return 0;
+}
+
+
+/**
+ * \brief nbc_add_ids_cnt Adds or subtracts the counts of the words of a document of the provided class
+ *                        given by the identifiers of its words.
+ *                        In the Bernoulli model each word is counted at most once.
+ *                        Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param ids Array of identifiers of words of the document.
+ * \param ids_cnt Number of identifiers.
+ * \param cls Class to which the document belongs to.
+ * \param subtract 1 if the counts are to be subtracted, 0 if added.
+ * \return 1 if counts of words were successfuly added (subtracted), else 0.
+ */
+int nbc_add_ids_cnt(nbc *cl, const size_t ids[], const size_t ids_cnt, const int cls, const int subtract) {
+    size_t *word_cnt = NULL;
+    size_t i;
+
+    if (subtract && !cl->cls_docs_cnt[cls]) {
+        return 0;
+    }
+
+    cl->epoch++;
+    for (i = 0; i < ids_cnt; i++) {
+        word_cnt = (size_t *) vector_at(cl->words_cnt, ids[i]);
+        if (!word_cnt) {
+            return 0;
+        }
+
+        if (cl->params.model == NBC_BERNOULLI && !nbc_word_first_seen(cl, ids[i])) {
+            continue;
+        }
+        if (!subtract) {
+            word_cnt[cls]++;
+        }
+        else if (word_cnt[cls]) {
+            word_cnt[cls]--;
+        }
+        else {
+            return 0;
+        }
+    }
+
+    if (!subtract) {
+        cl->cls_docs_cnt[cls]++;
+    }
+    else {
+        cl->cls_docs_cnt[cls]--;
+    }
+
+    return 1;
+}
+
+
+/**
+ * \brief nbc_features_estimate Estimates the number of distinct features (words and n-grams)
+ *                              of documents of the total number of words by Heaps' law
+ *                              (at most the maximal number of features of the dictionary).
+ *                              Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param words_cnt Total number of words of the documents.
+ * \return Estimated number of distinct features.
+ */
+size_t nbc_features_estimate(const nbc *cl, const size_t words_cnt) {
+    double features_cnt, grams_cnt;
+    unsigned n;
+
+    features_cnt = NBC_HEAPS_K * pow((double) words_cnt, NBC_HEAPS_BETA);
+    if (features_cnt > words_cnt) {
+        features_cnt = (double) words_cnt;
+    }
+    for (n = 2; n <= cl->params.ngram; n++) {
+        grams_cnt = NBC_HEAPS_GRAM_K * pow((double) words_cnt, NBC_HEAPS_GRAM_BETA);
+        features_cnt += grams_cnt < words_cnt ? grams_cnt : (double) words_cnt;
+    }
+    if (cl->params.max_words && features_cnt > cl->params.max_words) {
+        features_cnt = (double) cl->params.max_words;
+    }
+
+    return (size_t) features_cnt;
+}
+
+
+/**
+ * \brief nbc_reserve_features Presizes the dictionary and counts of words of the classifier
+ *                             for the number of distinct features.
+ *                             Does not check arguments validity.
+ * \param cl Pointer to a classifier not using feature hashing.
+ * \param features_cnt Number of distinct features.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_reserve_features(nbc *cl, const size_t features_cnt) {
+    if (!htab_size_reserve(cl->words_id, features_cnt)) {
+        return 0;
+    }
+    if (vector_capacity(cl->words_cnt) < features_cnt && !vector_realloc(cl->words_cnt, features_cnt)) {
+        return 0;
+    }
+    if (cl->params.model == NBC_BERNOULLI && vector_capacity(cl->words_seen) < features_cnt &&
+        !vector_realloc(cl->words_seen, features_cnt)) {
+        return 0;
+    }
+
+    return 1;
+}
+
+
+int nbc_reserve(nbc *cl, const size_t words_cnt) {
+    if (!cl) {
+        return 0;
+    }
+
+    /* feature hashing slots are allocated at once */
+    if (cl->params.hash_bits) {
+        return 1;
+    }
+
+    return nbc_reserve_features(cl, nbc_features_estimate(cl, words_cnt));
+}
+
+
+/**
+ * \brief nbc_set_words_cnt Sets counts of words in provided files of classifier's classes.
+ *                          Classifier is presized for the total size of the files first.
+ * \param cl Pointer to a classifier.
+ * \param f_paths Array of paths to files to be learnt.
+ * \param f_counts Array of counts of file paths for each class.
+ * \return 1 if classifier learnt all the provided files, else 0.
+ */
+int nbc_set_words_cnt(nbc *cl, const char *f_paths[], const size_t f_counts[]) {
+    size_t f, f_offset, size;
+    int cls, pass;
+
+    size = 0;
+    for (cls = 0, f_offset = 0; cls < cl->cls_cnt; f_offset += f_counts[cls++]) {
+        for (f = 0; f < f_counts[cls]; f++) {
+            size += f_size(f_paths[f_offset + f]);
+        }
+    }
+    if (!nbc_reserve(cl, size / NBC_BYTES_PER_WORD)) {
+        return 0;
+    }
+
+    /* files are counted by the sketch first, if any (see nbc_sketch_finish) */
+    for (pass = nbc_sketching(cl) ? 0 : 1; pass < 2; pass++) {
+        f_offset = 0;
+        for (cls = 0; cls < cl->cls_cnt; cls++) {
+            for (f = 0; f < f_counts[cls]; f++) {
+                if (!nbc_learn_file(cl, f_paths[f_offset + f], cls)) {
+                    return 0;
+                }
+            }
+
+            f_offset += f_counts[cls];
+        }
+        if (!pass && !nbc_sketch_finish(cl)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+/**
+ * \brief nbc_set_cls_words_cnt Sets count of learnt words (counting duplicities) for each class.
+ *                              Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ */
+void nbc_set_cls_words_cnt(nbc *cl) {
+    size_t *word_cnt = NULL;
+    size_t id;
+    int cls;
+
+    array_clear(cl->cls_words_cnt, cl->cls_cnt, sizeof(size_t));
+    for (id = 0; id < vector_count(cl->words_cnt); id++) {
+        word_cnt = (size_t *) vector_at(cl->words_cnt, id);
+        for (cls = 0; cls < cl->cls_cnt; cls++) {
+            cl->cls_words_cnt[cls] += word_cnt[cls];
+        }
+    }
+}
+
+
+/**
+ * \brief nbc_word_is_learnt Finds out whether the word (row of its counts) occured in learnt data.
+ *                           Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param word_cnt Row of counts of the word.
+ * \return 1 if the word occured in learnt data, else 0.
+ */
+int nbc_word_is_learnt(const nbc *cl, const size_t word_cnt[]) {
+    int cls;
+
+    for (cls = 0; cls < cl->cls_cnt; cls++) {
+        if (word_cnt[cls]) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+/**
+ * \brief nbc_set_dict_size Sets classifier dictionary size (number of distinct learnt words,
+ *                          number of used slots with feature hashing).
+ *                          Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ */
+void nbc_set_dict_size(nbc *cl) {
+    size_t id;
+
+    cl->dict_size = 0;
+    for (id = 0; id < vector_count(cl->words_cnt); id++) {
+        if (nbc_word_is_learnt(cl, (size_t *) vector_at(cl->words_cnt, id))) {
+            cl->dict_size++;
+        }
+    }
+}
+
+
+/**
+ * \brief nbc_set_absent_prob Sets sums of log10 probabilities of absence of all learnt words in classes
+ *                            (Bernoulli model, else 0). Words of the same count are summed at once,
+ *                            in the order of their counts, so the sums depend neither on the order
+ *                            nor on the identifiers of the words (see nbc_shared_finish).
+ *                            Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_set_absent_prob(nbc *cl) {
+    size_t *words_of_cnt = NULL, *word_cnt = NULL;
+    size_t id, cnt, max_cnt;
+    double prob;
+    int cls;
+
+    array_clear(cl->cls_absent_prob, cl->cls_cnt, sizeof(double));
+    if (cl->params.model != NBC_BERNOULLI) {
+        return 1;
+    }
+
+    for (id = 0, max_cnt = 0; id < vector_count(cl->words_cnt); id++) {
+        word_cnt = (size_t *) vector_at(cl->words_cnt, id);
+        for (cls = 0; cls < cl->cls_cnt; cls++) {
+            if (word_cnt[cls] > max_cnt) {
+                max_cnt = word_cnt[cls];
+            }
+        }
+    }
+    words_of_cnt = (size_t *) array_create(max_cnt + 1, sizeof(size_t));
+    if (!words_of_cnt) {
+        return 0;
+    }
+
+    for (cls = 0; cls < cl->cls_cnt; cls++) {
+        array_clear(words_of_cnt, max_cnt + 1, sizeof(size_t));
+        for (id = 0; id < vector_count(cl->words_cnt); id++) {
+            word_cnt = (size_t *) vector_at(cl->words_cnt, id);
+            if (nbc_word_is_learnt(cl, word_cnt)) {
+                words_of_cnt[word_cnt[cls]]++;
+            }
+        }
+        for (cnt = 0; cnt <= max_cnt; cnt++) {
+            if (words_of_cnt[cnt]) {
+                prob = (double) (1 + cnt) / (cl->cls_docs_cnt[cls] + 2);
+                cl->cls_absent_prob[cls] += words_of_cnt[cnt] * log10(1 - prob);
+            }
+        }
+    }
+
+    array_free((void **) &words_of_cnt);
+    return 1;
+}
+
+
+/**
+ * \brief nbc_set_words_prob Sets log10 probabilities of words.
+ *                           In the Bernoulli model sets log10 odds of word presence
+ *                           and sums of log10 probabilities of absence of all words (see nbc_set_absent_prob).
+ *                           Rows of words not occuring in learnt data (unused slots) are left 0,
+ *                           so such words do not affect the classification.
+ *                           Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_set_words_prob(nbc *cl) {
+    double *word_prob = NULL;
+    size_t *word_cnt = NULL;
+    double prob;
+    size_t id;
+    int cls;
+
+    nbc_words_prob_free(cl);
+    cl->words_prob_rows = 0;
+    cl->words_prob = (double *) array_create_aligned(vector_count(cl->words_cnt) * cl->cls_stride, sizeof(double),
+                                                     VEC_ALIGNMENT);
+    if (!cl->words_prob) {
+        return 0;
+    }
+    cl->words_prob_rows = vector_count(cl->words_cnt);
+
+    if (!nbc_set_absent_prob(cl)) {
+        return 0;
+    }
+    for (id = 0; id < vector_count(cl->words_cnt); id++) {
+        word_cnt = (size_t *) vector_at(cl->words_cnt, id);
+        word_prob = cl->words_prob + (id * cl->cls_stride);
+        if (!nbc_word_is_learnt(cl, word_cnt)) {
+            continue;
+        }
+        for (cls = 0; cls < cl->cls_cnt; cls++) {
+            if (cl->params.model == NBC_BERNOULLI) {
+                prob = (double) (1 + word_cnt[cls]) / (cl->cls_docs_cnt[cls] + 2);
+                word_prob[cls] = log10(prob) - log10(1 - prob);
+            }
+            else {
+                word_prob[cls] = log10((double) (1 + word_cnt[cls]) / (cl->cls_words_cnt[cls] + cl->dict_size));
+            }
+        }
+    }
+
+    return 1;
+}
+
+
+/**
+ * \brief nbc_place_words_prob Moves the rows of probabilities of words to the memory of their placement
+ *                             (see nbc_placement), they are copied to each NUMA node when replicated.
+ *                             Does not check arguments validity.
+ * \param cl Pointer to a classifier with set rows of probabilities.
+ * \return 1 if operation was successful (or the rows are not placed), else 0.
+ */
+int nbc_place_words_prob(nbc *cl) {
+    double **nodes = NULL;
+    size_t size, nodes_cnt, node;
+
+    if (cl->params.placement == NBC_PLACE_DEFAULT) {
+        return 1;
+    }
+
+    size = cl->words_prob_rows * cl->cls_stride * sizeof(double);
+    nodes_cnt = cl->params.placement == NBC_PLACE_REPLICATE ? place_nodes_cnt() : 1;
+    nodes = (double **) array_create(nodes_cnt, sizeof(double *));
+    if (!nodes) {
+        return 0;
+    }
+
+    for (node = 0; node < nodes_cnt; node++) {
+        nodes[node] = (double *) place_alloc(size);
+        if (!nodes[node]) {
+            goto fail;
+        }
+        /* policies are advisory, the rows are placed anywhere if they could not be set */
+        if (cl->params.placement == NBC_PLACE_REPLICATE) {
+            place_bind(nodes[node], size, node);
+        }
+        else if (cl->params.placement == NBC_PLACE_INTERLEAVE) {
+            place_interleave(nodes[node], size);
+        }
+        memcpy(nodes[node], cl->words_prob, size);
+    }
+
+    array_free_aligned((void **) &cl->words_prob);
+    cl->words_prob = nodes[0];
+    cl->words_prob_nodes = nodes;
+    cl->words_prob_nodes_cnt = nodes_cnt;
+
+    return 1;
+
+fail:
+    while (node-- > 0) {
+        place_free(nodes[node], size);
+    }
+    array_free((void **) &nodes);
+    return 0;
+}
+
+
+const double *nbc_words_prob_node(const nbc *cl, const size_t node) {
+    if (!cl->words_prob_nodes) {
+        return cl->words_prob;
+    }
+
+    return cl->words_prob_nodes[node % cl->words_prob_nodes_cnt];
+}
+
+
+/**
+ * \brief nbc_counts_total Sums the counts of a word in all the classes.
+ *                         Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param counts Counts of the word in classes.
+ * \return Total count of the word.
+ */
+size_t nbc_counts_total(const nbc *cl, const size_t counts[]) {
+    size_t total;
+    int cls;
+
+    for (cls = 0, total = 0; cls < cl->cls_cnt; cls++) {
+        total += counts[cls];
+    }
+
+    return total;
+}
+
+
+/**
+ * \brief nbc_cmp_items_total Compares two features by their total counts in the descending order,
+ *                            then by their keys (qsort comparator).
+ * \param a Pointer to the first feature.
+ * \param b Pointer to the second feature.
+ * \return Negative, zero or positive if the first one is more frequent, equal or less frequent.
+ */
+int nbc_cmp_items_total(const void *a, const void *b) {
+    const nbc_shared_item *x = (const nbc_shared_item *) a, *y = (const nbc_shared_item *) b;
+
+    if (x->total != y->total) {
+        return (x->total < y->total) - (x->total > y->total);
+    }
+
+    return strcmp(x->key, y->key);
+}
+
+
+/**
+ * \brief nbc_keep_words Keeps the counts of the max_words most frequent learnt features only (see nbc_params),
+ *                       the counts of the others are cleared. Equally frequent features are told apart
+ *                       by their keys, so the kept features depend neither on the order of the documents
+ *                       nor on the identifiers of the features.
+ *                       Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_keep_words(nbc *cl) {
+    nbc_shared_item *items = NULL;
+    size_t id, i, items_cnt;
+
+    if (!cl->params.max_words || cl->params.hash_bits) {
+        return 1;
+    }
+
+    items = (nbc_shared_item *) malloc((vector_count(cl->words_cnt) + 1) * sizeof(nbc_shared_item));
+    if (!items) {
+        return 0;
+    }
+    for (id = 0, items_cnt = 0; id < vector_count(cl->words_cnt); id++) {
+        items[items_cnt].row = (size_t *) vector_at(cl->words_cnt, id);
+        if (nbc_word_is_learnt(cl, items[items_cnt].row)) {
+            items[items_cnt].key = htab_size_key_at(cl->words_id, id);
+            items[items_cnt].total = nbc_counts_total(cl, items[items_cnt].row);
+            items_cnt++;
+        }
+    }
+
+    if (items_cnt > cl->params.max_words) {
+        qsort(items, items_cnt, sizeof(nbc_shared_item), nbc_cmp_items_total);
+        for (i = cl->params.max_words; i < items_cnt; i++) {
+            array_clear(items[i].row, cl->cls_cnt, sizeof(size_t));
+        }
+    }
+
+    free(items);
+    return 1;
+}
+
+
+int nbc_sketch_finish(nbc *cl) {
+    if (!cl || !nbc_sketching(cl)) {
+        return 0;
+    }
+
+    cl->sketched = 1;
+    return 1;
+}
+
+
+int nbc_learn_finish(nbc *cl) {
+    int cls;
+
+    if (!cl) {
+        return 0;
+    }
+    for (cls = 0; cls < cl->cls_cnt && !cl->cls_docs_cnt[cls]; cls++) {
+        ;
+    }
+    if (cls == cl->cls_cnt) {
+        return 0;
+    }
+
+    /* owners of the partitions are stopped before the rows they read are replaced */
+    nbc_parts_free(&cl->parts);
+    if (!nbc_keep_words(cl)) {
+        cl->dict_size = 0;
+        return 0;
+    }
+    nbc_set_cls_prob(cl);
+    nbc_set_cls_words_cnt(cl);
+    nbc_set_dict_size(cl);
+    if (!nbc_set_words_prob(cl) || !nbc_place_words_prob(cl)) {
+        cl->dict_size = 0;
+        return 0;
+    }
+    if (!cl->scratch) {
+        cl->scratch = nbc_scratch_create(cl);
+        if (!cl->scratch) {
+            cl->dict_size = 0;
+            return 0;
+        }
+    }
+    if (cl->params.parts) {
+        cl->parts = nbc_parts_create(cl, cl->params.parts);
+        if (!cl->parts) {
+            cl->dict_size = 0;
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+int nbc_learn(nbc *cl, const char *f_paths[], const size_t f_counts[]) {
+    if (!cl || nbc_is_learnt(cl) || !f_paths || !f_counts) {
+        return 0;
+    }
+
+    if (!nbc_set_words_cnt(cl, f_paths, f_counts)) {
+        goto fail;
+    }
+    if (!nbc_learn_finish(cl)) {
+        goto fail;
+    }
+
+    return 1;
+
+fail:
+    nbc_reset(cl);
+    return 0;
+}
+
+
+int nbc_learn_file(nbc *cl, const char f_path[], const int cls) {
+    tokens t;
+    FILE *fp = NULL;
+
+    if (!cl || !f_path || cls < 0 || cls >= cl->cls_cnt) {
+        return 0;
+    }
+
+    fp = fopen(f_path, "r");
+    if (!fp) {
+        return 0;
+    }
+
+    tokens_file(&t, fp);
+    if (!nbc_add_words_cnt(cl, &t, cls)) {
+        fclose(fp);
+        return 0;
+    }
+
+    return fclose(fp) != EOF;
+}
+
+
+int nbc_learn_buffer(nbc *cl, const char *buf, const size_t size, const int cls) {
+    tokens t;
+
+    if (!cl || (!buf && size) || cls < 0 || cls >= cl->cls_cnt) {
+        return 0;
+    }
+
+    tokens_buffer(&t, buf, size);
+    return nbc_add_words_cnt(cl, &t, cls);
+}
+
+
+nbc_shared *nbc_shared_create(const nbc *cl, const size_t words_cnt) {
+    nbc_shared *sh = NULL;
+
+    if (!cl || nbc_is_learnt(cl)) {
+        return NULL;
+    }
+
+    sh = (nbc_shared *) malloc(sizeof(nbc_shared));
+    if (!sh) {
+        return NULL;
+    }
+
+    sh->counts = NULL;
+    sh->cls_docs_cnt = (size_t *) array_create(cl->cls_cnt, sizeof(size_t));
+    if (!cl->params.hash_bits) {
+        sh->counts = shtab_create(cl->cls_cnt, NBC_SHARED_SHARDS, nbc_features_estimate(cl, words_cnt));
+    }
+    if (!sh->cls_docs_cnt || (!cl->params.hash_bits && !sh->counts)) {
+        nbc_shared_free(&sh);
+        return NULL;
+    }
+
+    return sh;
+}
+
+
+void nbc_shared_free(nbc_shared **sh) {
+    if (!sh || !(*sh)) {
+        return;
+    }
+
+    shtab_free(&(*sh)->counts);
+    array_free((void **) &(*sh)->cls_docs_cnt);
+    free(*sh);
+    *sh = NULL;
+}
+
+
+/**
+ * \brief nbc_shared_first_seen Finds out whether the feature occurs in the learnt document for the first time.
+ *                              Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param seen Hashtable of the features of the document seen so far.
+ * \param key Dictionary key of the feature (NULL for an n-gram with feature hashing).
+ * \param hash Hash of the feature (see nbc_features).
+ * \param first Pointer to where 1 will be stored if the feature is seen for the first time, else 0.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_shared_first_seen(const nbc *cl, htab_size *seen, const char *key, const unsigned long hash, int *first) {
+    char slot_key[NBC_GRAM_KEY_SIZE];
+    unsigned long key_hash;
+
+    /* features hashed into the same slot are the same one */
+    key_hash = hash;
+    if (cl->params.hash_bits) {
+        nbc_gram_key_make(slot_key, hash & (((unsigned long) 1 << cl->params.hash_bits) - 1));
+        key = slot_key;
+        key_hash = htab_hash(key);
+    }
+
+    *first = !htab_size_ptrget_hashed(seen, key, key_hash);
+    if (*first && !htab_size_add_hashed(seen, key, key_hash, 0)) {
+        return 0;
+    }
+
+    return 1;
+}
+
+
+/**
+ * \brief nbc_shared_row Finds the row of the feature of the shared counts, adds it to the counts
+ *                       if it is admitted (see nbc_word_admitted).
+ *                       Does not check arguments validity.
+ * \param cl Pointer to a classifier not using feature hashing.
+ * \param sh Pointer to shared counts.
+ * \param key Dictionary key of the feature.
+ * \param hash Hash of the feature (see nbc_features).
+ * \param row Pointer to where the row of the feature (NULL if it is not admitted yet) will be stored.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_shared_row(const nbc *cl, nbc_shared *sh, const char *key, const unsigned long hash, size_t **row) {
+    if (cl->sketch) {
+        *row = shtab_row_find(sh->counts, key, hash);
+        if (*row || !nbc_word_admitted(cl, hash)) {
+            return 1;
+        }
+    }
+
+    *row = shtab_row(sh->counts, key, hash);
+    return *row != NULL;
+}
+
+
+/**
+ * \brief nbc_shared_add_word Adds the counts of the next word of a document and of the n-grams ending with it
+ *                            to the shared counts.
+ *                            Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param sh Pointer to shared counts.
+ * \param f Pointer to features of the document.
+ * \param word Next word of the document.
+ * \param cls Class to which the document belongs to.
+ * \param seen Hashtable of the features of the document seen so far (Bernoulli model), else NULL.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_shared_add_word(const nbc *cl, nbc_shared *sh, nbc_features *f, const char *word, const int cls,
+                        htab_size *seen) {
+    size_t *word_cnt = NULL;
+    int n, first;
+
+    if (nbc_sketching(cl)) {
+        nbc_sketch_word(cl, f, word, nbc_word_hash(cl, word), 1);
+        return 1;
+    }
+
+    nbc_features_next(cl, f, word, nbc_word_hash(cl, word));
+    for (n = 0; n < f->cnt; n++) {
+        if (seen) {
+            if (!nbc_shared_first_seen(cl, seen, f->keys[n], f->hashes[n], &first)) {
+                return 0;
+            }
+            if (!first) {
+                continue;
+            }
+        }
+
+        if (cl->params.hash_bits) {
+            word_cnt = (size_t *) vector_at(cl->words_cnt,
+                                            f->hashes[n] & (((size_t) 1 << cl->params.hash_bits) - 1));
+        }
+        else {
+            if (!nbc_shared_row(cl, sh, f->keys[n], f->hashes[n], &word_cnt)) {
+                return 0;
+            }
+            if (!word_cnt) {
+                continue;
+            }
+        }
+        shtab_row_add(word_cnt, cls, 1);
+    }
+
+    return 1;
+}
+
+
+/**
+ * \brief nbc_shared_add_words Adds the counts of the words (and n-grams) of the document of the provided class
+ *                             to the shared counts, the words are read either from the source of words
+ *                             or from the vocabulary.
+ *                             In the Bernoulli model each word is counted at most once.
+ *                             Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param sh Pointer to shared counts.
+ * \param scratch Pointer to a scratch of the calling thread.
+ * \param t Pointer to a source of words of the document (file or buffer), or NULL for a pre-tokenized document.
+ * \param vocab_words Words of the vocabulary of a pre-tokenized document.
+ * \param words Array of indices of words of a pre-tokenized document to the vocabulary.
+ * \param words_cnt Number of words of a pre-tokenized document.
+ * \param cls Class to which the document belongs to.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_shared_add_words(const nbc *cl, nbc_shared *sh, nbc_shared_scratch *scratch, tokens *t,
+                         const char *vocab_words[], const unsigned words[], const size_t words_cnt, const int cls) {
+    nbc_features f;
+    htab_size *seen = NULL;
+    char *word = NULL;
+    size_t w;
+
+    if (cl->params.model == NBC_BERNOULLI && !nbc_sketching(cl)) {
+        seen = scratch->seen;
+        htab_size_clear(seen);
+    }
+
+    nbc_features_reset(&f);
+    if (t) {
+        while ((word = tokens_next(t))) {
+            if (!nbc_shared_add_word(cl, sh, &f, word, cls, seen)) {
+                goto fail;
+            }
+            free(word);
+        }
+    }
+    else {
+        for (w = 0; w < words_cnt; w++) {
+            if (!nbc_shared_add_word(cl, sh, &f, vocab_words[words[w]], cls, seen)) {
+                goto fail;
+            }
+        }
+    }
+
+    /* documents are counted once they are learnt again after the first pass */
+    if (!nbc_sketching(cl)) {
+        shtab_row_add(sh->cls_docs_cnt, cls, 1);
+    }
+    return 1;
+
+fail:
+    free(word);
+    return 0;
+}
+
+
+nbc_shared_scratch *nbc_shared_scratch_create(const nbc *cl) {
+    nbc_shared_scratch *scratch = NULL;
+
+    if (!cl) {
+        return NULL;
+    }
+
+    scratch = (nbc_shared_scratch *) malloc(sizeof(nbc_shared_scratch));
+    if (!scratch) {
+        return NULL;
+    }
+
+    scratch->seen = NULL;
+    if (cl->params.model == NBC_BERNOULLI) {
+        scratch->seen = htab_size_create(0);
+        if (!scratch->seen) {
+            free(scratch);
+            return NULL;
+        }
+    }
+
+    return scratch;
+}
+
+
+void nbc_shared_scratch_free(nbc_shared_scratch **scratch) {
+    if (!scratch || !(*scratch)) {
+        return;
+    }
+
+    htab_size_free(&(*scratch)->seen);
+    free(*scratch);
+    *scratch = NULL;
+}
+
+
+/**
+ * \brief nbc_shared_scratch_fits Finds out whether the scratch may be used for learning into shared counts
+ *                                of the classifier.
+ *                                Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param scratch Pointer to a scratch, or NULL.
+ * \return 1 if the scratch fits the classifier, else 0.
+ */
+int nbc_shared_scratch_fits(const nbc *cl, const nbc_shared_scratch *scratch) {
+    return scratch && (cl->params.model != NBC_BERNOULLI || scratch->seen);
+}
+
+
+int nbc_shared_learn_file(const nbc *cl, nbc_shared *sh, nbc_shared_scratch *scratch, const char f_path[],
+                          const int cls) {
+    tokens t;
+    FILE *fp = NULL;
+
+    if (!cl || !sh || !nbc_shared_scratch_fits(cl, scratch) || !f_path || cls < 0 || cls >= cl->cls_cnt) {
+        return 0;
+    }
+
+    fp = fopen(f_path, "r");
+    if (!fp) {
+        return 0;
+    }
+
+    tokens_file(&t, fp);
+    if (!nbc_shared_add_words(cl, sh, scratch, &t, NULL, NULL, 0, cls)) {
+        fclose(fp);
+        return 0;
+    }
+
+    return fclose(fp) != EOF;
+}
+
+
+int nbc_shared_learn_buffer(const nbc *cl, nbc_shared *sh, nbc_shared_scratch *scratch, const char *buf,
+                            const size_t size, const int cls) {
+    tokens t;
+
+    if (!cl || !sh || !nbc_shared_scratch_fits(cl, scratch) || (!buf && size) || cls < 0 || cls >= cl->cls_cnt) {
+        return 0;
+    }
+
+    tokens_buffer(&t, buf, size);
+    return nbc_shared_add_words(cl, sh, scratch, &t, NULL, NULL, 0, cls);
+}
+
+
+int nbc_shared_learn_words(const nbc *cl, nbc_shared *sh, nbc_shared_scratch *scratch, const char *vocab_words[],
+                           const unsigned words[], const size_t words_cnt, const int cls) {
+    if (!cl || !sh || !nbc_shared_scratch_fits(cl, scratch) || !vocab_words || (!words && words_cnt) ||
+        cls < 0 || cls >= cl->cls_cnt) {
+        return 0;
+    }
+
+    return nbc_shared_add_words(cl, sh, scratch, NULL, vocab_words, words, words_cnt, cls);
+}
+
+
+/**
+ * \brief nbc_shared_cmp_items Compares two features of shared counts by their hashes, then by their keys
+ *                             (qsort comparator).
+ * \param a Pointer to the first feature.
+ * \param b Pointer to the second feature.
+ * \return Negative, zero or positive if the first one is lower, equal or greater.
+ */
+int nbc_shared_cmp_items(const void *a, const void *b) {
+    const nbc_shared_item *x = (const nbc_shared_item *) a, *y = (const nbc_shared_item *) b;
+
+    if (x->hash != y->hash) {
+        return (x->hash > y->hash) - (x->hash < y->hash);
+    }
+
+    return strcmp(x->key, y->key);
+}
+
+
+int nbc_shared_finish(nbc *cl, nbc_shared *sh) {
+    nbc_shared_item *items = NULL;
+    size_t *word_cnt = NULL;
+    size_t s, i, items_cnt, max_items_cnt, id;
+    int cls;
+
+    if (!cl || !sh || nbc_is_learnt(cl)) {
+        return 0;
+    }
+
+    /* features of a shard are given identifiers in the order of their hashes (and keys), not of their learning
+       by the threads, so the identifiers (and the order of the sums over them) do not depend on the threads */
+    if (!cl->params.hash_bits) {
+        for (s = 0, max_items_cnt = 1; s < sh->counts->shards_cnt; s++) {
+            if (shtab_shard_items_cnt(sh->counts, s) > max_items_cnt) {
+                max_items_cnt = shtab_shard_items_cnt(sh->counts, s);
+            }
+        }
+        items = (nbc_shared_item *) malloc(max_items_cnt * sizeof(nbc_shared_item));
+        if (!items || !nbc_reserve_features(cl, htab_size_items_cnt(cl->words_id) + shtab_items_cnt(sh->counts))) {
+            goto fail;
+        }
+
+        for (s = 0; s < sh->counts->shards_cnt; s++) {
+            items_cnt = shtab_shard_items_cnt(sh->counts, s);
+            for (i = 0; i < items_cnt; i++) {
+                items[i].key = shtab_key_at(sh->counts, s, i, &items[i].hash);
+                items[i].row = shtab_row_at(sh->counts, s, i);
+            }
+            qsort(items, items_cnt, sizeof(nbc_shared_item), nbc_shared_cmp_items);
+
+            for (i = 0; i < items_cnt; i++) {
+                if (!nbc_word_id(cl, items[i].key, items[i].hash, &id)) {
+                    goto fail;
+                }
+                word_cnt = (size_t *) vector_at(cl->words_cnt, id);
+                for (cls = 0; cls < cl->cls_cnt; cls++) {
+                    word_cnt[cls] += items[i].row[cls];
+                }
+            }
+        }
+        free(items);
+        items = NULL;
+    }
+    for (cls = 0; cls < cl->cls_cnt; cls++) {
+        cl->cls_docs_cnt[cls] += sh->cls_docs_cnt[cls];
+    }
+
+    return nbc_learn_finish(cl);
+
+fail:
+    free(items);
+    return 0;
+}
+
+
+size_t nbc_counts_size(const nbc *cl) {
+    size_t size;
+
+    if (!cl) {
+        return 0;
+    }
+
+    size = vector_capacity(cl->words_cnt) * cl->words_cnt->item_size +
+           vector_capacity(cl->words_seen) * cl->words_seen->item_size;
+    if (cl->words_id) {
+        size += (cl->words_id->buckets_cnt + cl->words_id->old_buckets_cnt) * sizeof(size_t) +
+                cl->words_id->chunks_cap * sizeof(char *) +
+                cl->words_id->chunks_cnt * H_CHUNK_ENTRIES * sizeof(htab_size_entry) + cl->words_id->keys.cap;
+    }
+
+    return size;
+}
+
+
+/**
+ * \brief nbc_counts_cmp_items Compares two features by their keys (qsort comparator).
+ * \param a Pointer to the first feature.
+ * \param b Pointer to the second feature.
+ * \return Negative, zero or positive if the first one is lower, equal or greater.
+ */
+int nbc_counts_cmp_items(const void *a, const void *b) {
+    return strcmp(((const nbc_shared_item *) a)->key, ((const nbc_shared_item *) b)->key);
+}
+
+
+int nbc_write_counts(const nbc *cl, const char f_path[]) {
+    nbc_shared_item *items = NULL;
+    counts_file *cf = NULL;
+    size_t id, i, items_cnt;
+
+    if (!cl || !f_path || cl->params.hash_bits) {
+        return 0;
+    }
+
+    items = (nbc_shared_item *) malloc((vector_count(cl->words_cnt) + 1) * sizeof(nbc_shared_item));
+    if (!items) {
+        return 0;
+    }
+    for (id = 0, items_cnt = 0; id < vector_count(cl->words_cnt); id++) {
+        items[items_cnt].row = (size_t *) vector_at(cl->words_cnt, id);
+        if (nbc_word_is_learnt(cl, items[items_cnt].row)) {
+            items[items_cnt++].key = htab_size_key_at(cl->words_id, id);
+        }
+    }
+    qsort(items, items_cnt, sizeof(nbc_shared_item), nbc_counts_cmp_items);
+
+    cf = counts_create(f_path, cl->cls_cnt, cl->params.model, cl->params.ngram, cl->cls_docs_cnt);
+    if (!cf) {
+        goto fail;
+    }
+    for (i = 0; i < items_cnt; i++) {
+        if (!counts_write(cf, items[i].key, items[i].row)) {
+            goto fail;
+        }
+    }
+
+    free(items);
+    return counts_close(&cf);
+
+fail:
+    free(items);
+    counts_close(&cf);
+    return 0;
+}
+
+
+/**
+ * \brief nbc_cmp_totals_desc Compares two total counts in the descending order (qsort comparator).
+ * \param a Pointer to the first total count.
+ * \param b Pointer to the second total count.
+ * \return Negative, zero or positive if the first one is greater, equal or lower.
+ */
+int nbc_cmp_totals_desc(const void *a, const void *b) {
+    const size_t x = *((const size_t *) a), y = *((const size_t *) b);
+
+    return (x < y) - (x > y);
+}
+
+
+/**
+ * \brief nbc_counts_threshold Finds out which words of the counts file are admitted to the dictionary
+ *                             (see nbc_params): words of a total count above the threshold are admitted,
+ *                             words of the threshold total count only up to the number of ties.
+ *                             With max_words the file is read once to find the max_words most frequent words.
+ *                             Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param f_path Path to a counts file.
+ * \param threshold Pointer to where the threshold total count will be stored.
+ * \param ties_cnt Pointer to where the number of admitted words of the threshold total count will be stored.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_counts_threshold(const nbc *cl, const char f_path[], size_t *threshold, size_t *ties_cnt) {
+    counts_file *cf = NULL;
+    vector *totals = NULL;
+    size_t *sorted = NULL;
+    size_t total, above_cnt;
+    int read;
+
+    *threshold = cl->params.min_count;
+    *ties_cnt = (size_t) -1;
+    if (!cl->params.max_words) {
+        return 1;
+    }
+
+    cf = counts_open(f_path);
+    totals = vector_create(sizeof(size_t), NULL);
+    if (!cf || !totals) {
+        goto fail;
+    }
+    while ((read = counts_next(cf)) == 1) {
+        total = nbc_counts_total(cl, cf->counts);
+        if (total >= cl->params.min_count && !vector_push_back(totals, &total)) {
+            goto fail;
+        }
+    }
+    if (read == -1) {
+        goto fail;
+    }
+
+    if (vector_count(totals) > cl->params.max_words) {
+        sorted = (size_t *) totals->data;
+        qsort(sorted, vector_count(totals), sizeof(size_t), nbc_cmp_totals_desc);
+        *threshold = sorted[cl->params.max_words - 1];
+        for (above_cnt = 0; sorted[above_cnt] > *threshold; above_cnt++) {
+            ;
+        }
+        *ties_cnt = cl->params.max_words - above_cnt;
+    }
+
+    vector_free(&totals);
+    counts_close(&cf);
+    return 1;
+
+fail:
+    vector_free(&totals);
+    counts_close(&cf);
+    return 0;
+}
+
+
+int nbc_learn_counts(nbc *cl, const char f_path[]) {
+    counts_file *cf = NULL;
+    size_t *word_cnt = NULL;
+    size_t threshold, ties_cnt, total, id;
+    int cls, read;
+
+    if (!cl || !f_path || nbc_is_learnt(cl) || cl->params.hash_bits) {
+        return 0;
+    }
+
+    if (!nbc_counts_threshold(cl, f_path, &threshold, &ties_cnt)) {
+        return 0;
+    }
+    cf = counts_open(f_path);
+    if (!cf || cf->header.cls_cnt != (size_t) cl->cls_cnt || cf->header.model != (size_t) cl->params.model ||
+        cf->header.ngram != cl->params.ngram ||
+        !nbc_reserve_features(cl, cl->params.max_words && cl->params.max_words < cf->header.words_cnt ?
+                                  cl->params.max_words : cf->header.words_cnt)) {
+        goto fail;
+    }
+
+    while ((read = counts_next(cf)) == 1) {
+        total = nbc_counts_total(cl, cf->counts);
+        if (total < threshold || (total == threshold && !ties_cnt)) {
+            continue;
+        }
+        if (total == threshold) {
+            ties_cnt--;
+        }
+
+        if (!nbc_word_id(cl, cf->word, htab_hash(cf->word), &id)) {
+            goto fail;
+        }
+        word_cnt = (size_t *) vector_at(cl->words_cnt, id);
+        for (cls = 0; cls < cl->cls_cnt; cls++) {
+            word_cnt[cls] += cf->counts[cls];
+        }
+    }
+    if (read == -1) {
+        goto fail;
+    }
+    for (cls = 0; cls < cl->cls_cnt; cls++) {
+        cl->cls_docs_cnt[cls] += cf->cls_docs_cnt[cls];
+    }
+
+    counts_close(&cf);
+    return nbc_learn_finish(cl);
+
+fail:
+    counts_close(&cf);
+    return 0;
+}
+
+
+/**
+ * \brief nbc_tokenize_tokens Converts the words (and n-grams) of the document to their identifiers.
+ *                            Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param t Pointer to a source of words of the document (file or buffer).
+ * \param ids Vector of identifiers (of size_t items), where the identifiers of words will be appended.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_tokenize_tokens(nbc *cl, tokens *t, vector *ids) {
+    nbc_features f;
+    nbc_batch b;
+    char *word = NULL;
+    int i;
+
+    nbc_features_reset(&f);
+    b.cnt = b.words_cnt = 0;
+    while ((word = tokens_next(t)) || b.cnt) {
+        if (word) {
+            nbc_features_next(cl, &f, word, nbc_word_hash(cl, word));
+            nbc_batch_push(cl, &b, &f, word);
+            if (!nbc_batch_full(&b)) {
+                continue;
+            }
+        }
+
+        if (!nbc_batch_id(cl, &b)) {
+            goto fail;
+        }
+        for (i = 0; i < b.cnt; i++) {
+            if (!vector_push_back(ids, &b.ids[i])) {
+                goto fail;
+            }
+        }
+        nbc_batch_clear(&b);
+    }
+
+    return 1;
+
+fail:
+    nbc_batch_clear(&b);
+    return 0;
+}
+
+
+int nbc_tokenize(nbc *cl, const char f_path[], vector *ids) {
+    tokens t;
+    FILE *fp = NULL;
+
+    if (!cl || !f_path || !ids || ids->item_size != sizeof(size_t)) {
+        return 0;
+    }
+
+    fp = fopen(f_path, "r");
+    if (!fp) {
+        return 0;
+    }
+
+    tokens_file(&t, fp);
+    if (!nbc_tokenize_tokens(cl, &t, ids)) {
+        fclose(fp);
+        return 0;
+    }
+
+    return fclose(fp) != EOF;
+}
+
+
+int nbc_tokenize_buffer(nbc *cl, const char *buf, const size_t size, vector *ids) {
+    tokens t;
+
+    if (!cl || (!buf && size) || !ids || ids->item_size != sizeof(size_t)) {
+        return 0;
+    }
+
+    tokens_buffer(&t, buf, size);
+    return nbc_tokenize_tokens(cl, &t, ids);
+}
+
+
+nbc_vocab *nbc_vocab_create(const nbc *cl, const char *words[], const size_t words_cnt) {
+    nbc_vocab *vocab = NULL;
+    size_t w;
+
+    if (!cl || (!words && words_cnt)) {
+        return NULL;
+    }
+
+    vocab = (nbc_vocab *) calloc(1, sizeof(nbc_vocab));
+    if (!vocab) {
+        return NULL;
+    }
+
+    vocab->words_cnt = words_cnt;
+    vocab->words = words;
+    vocab->hashes = (unsigned long *) malloc((words_cnt ? words_cnt : 1) * sizeof(unsigned long));
+    vocab->ids = (size_t *) malloc((words_cnt ? words_cnt : 1) * sizeof(size_t));
+    if (!vocab->hashes || !vocab->ids) {
+        nbc_vocab_free(&vocab);
+        return NULL;
+    }
+
+    for (w = 0; w < words_cnt; w++) {
+        vocab->hashes[w] = nbc_word_hash(cl, words[w]);
+        vocab->ids[w] = NBC_NO_ID;
+    }
+
+    return vocab;
+}
+
+
+void nbc_vocab_free(nbc_vocab **vocab) {
+    if (!vocab || !(*vocab)) {
+        return;
+    }
+
+    free((*vocab)->hashes);
+    free((*vocab)->ids);
+    free(*vocab);
+    *vocab = NULL;
+}
+
+
+int nbc_tokenize_words(nbc *cl, nbc_vocab *vocab, const unsigned words[], const size_t words_cnt, vector *ids) {
+    nbc_features f;
+    size_t word_ids[NBC_MAX_NGRAM];
+    size_t w;
+    int n;
+
+    if (!cl || !vocab || (!words && words_cnt) || !ids || ids->item_size != sizeof(size_t)) {
+        return 0;
+    }
+
+    nbc_features_reset(&f);
+    for (w = 0; w < words_cnt; w++) {
+        if (words[w] >= vocab->words_cnt || !nbc_vocab_features_id(cl, vocab, &f, words[w], word_ids)) {
+            return 0;
+        }
+        for (n = 0; n < f.cnt; n++) {
+            if (!vector_push_back(ids, &word_ids[n])) {
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
+
+int nbc_learn_words(nbc *cl, nbc_vocab *vocab, const unsigned words[], const size_t words_cnt, const int cls) {
+    nbc_features f;
+    size_t word_ids[NBC_MAX_NGRAM];
+    size_t w;
+    int n, ids_cnt;
+
+    if (!cl || !vocab || (!words && words_cnt) || cls < 0 || cls >= cl->cls_cnt) {
+        return 0;
+    }
+
+    nbc_features_reset(&f);
+    if (nbc_sketching(cl)) {
+        for (w = 0; w < words_cnt; w++) {
+            if (words[w] >= vocab->words_cnt) {
+                return 0;
+            }
+            nbc_sketch_word(cl, &f, vocab->words[words[w]], vocab->hashes[words[w]], 0);
+        }
+        return 1;
+    }
+
+    cl->epoch++;
+    for (w = 0; w < words_cnt; w++) {
+        if (words[w] >= vocab->words_cnt) {
+            return 0;
+        }
+        ids_cnt = nbc_vocab_features_admit(cl, vocab, &f, words[w], word_ids);
+        if (ids_cnt == -1) {
+            return 0;
+        }
+        for (n = 0; n < ids_cnt; n++) {
+            if (cl->params.model == NBC_BERNOULLI && !nbc_word_first_seen(cl, word_ids[n])) {
+                continue;
+            }
+            ((size_t *) vector_at(cl->words_cnt, word_ids[n]))[cls]++;
+        }
+    }
+    cl->cls_docs_cnt[cls]++;
+
+    return 1;
+}
+
+
+int nbc_learn_ids(nbc *cl, const size_t ids[], const size_t ids_cnt, const int cls) {
+    if (!cl || (!ids && ids_cnt) || cls < 0 || cls >= cl->cls_cnt) {
+        return 0;
+    }
+
+    return nbc_add_ids_cnt(cl, ids, ids_cnt, cls, 0);
+}
+
+
+int nbc_unlearn_ids(nbc *cl, const size_t ids[], const size_t ids_cnt, const int cls) {
+    if (!cl || (!ids && ids_cnt) || cls < 0 || cls >= cl->cls_cnt) {
+        return 0;
+    }
+
+    return nbc_add_ids_cnt(cl, ids, ids_cnt, cls, 1);
+}
+
+
+int nbc_is_learnt(const nbc *cl) {
+    if (!cl) {
+        return 0;
+    }
+
+    return cl->dict_size > 0;
+}
+
+
+/**
+ * \brief nbc_scratch_fit Makes the accumulator of the scratch hold cls_stride scores
+ *                        and its seen-array hold an epoch of every row of words_prob.
+ *                        Does not check arguments validity.
+ * \param cl Pointer to a learnt classifier.
+ * \param scratch Pointer to a scratch.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_scratch_fit(const nbc *cl, nbc_scratch *scratch) {
+    double *new_acc = NULL;
+    size_t *new_seen = NULL;
+
+    if (scratch->acc_cnt < cl->cls_stride) {
+        new_acc = (double *) array_create_aligned(cl->cls_stride, sizeof(double), VEC_ALIGNMENT);
+        if (!new_acc) {
+            return 0;
+        }
+        array_free_aligned((void **) &scratch->acc);
+        scratch->acc = new_acc;
+        scratch->acc_cnt = cl->cls_stride;
+    }
+
+    if (cl->params.model != NBC_BERNOULLI || scratch->seen_cnt >= cl->words_prob_rows) {
+        return 1;
+    }
+
+    new_seen = (size_t *) realloc(scratch->seen, cl->words_prob_rows * sizeof(size_t));
+    if (!new_seen) {
+        return 0;
+    }
+    memset(new_seen + scratch->seen_cnt, 0, (cl->words_prob_rows - scratch->seen_cnt) * sizeof(size_t));
+    scratch->seen = new_seen;
+    scratch->seen_cnt = cl->words_prob_rows;
+
+    return 1;
+}
+
+
+nbc_scratch *nbc_scratch_create(const nbc *cl) {
+    nbc_scratch *scratch = NULL;
+
+    if (!cl) {
+        return NULL;
+    }
+
+    scratch = (nbc_scratch *) calloc(1, sizeof(nbc_scratch));
+    if (!scratch) {
+        return NULL;
+    }
+
+    if (!nbc_scratch_fit(cl, scratch)) {
+        nbc_scratch_free(&scratch);
+        return NULL;
+    }
+
+    return scratch;
+}
+
+
+void nbc_scratch_free(nbc_scratch **scratch) {
+    if (!scratch || !(*scratch)) {
+        return;
+    }
+
+    array_free_aligned((void **) &(*scratch)->acc);
+    free((*scratch)->seen);
+    free(*scratch);
+    *scratch = NULL;
+}
+
+
+/**
+ * \brief nbc_scores_init Sets the accumulator of scores of classes of the scratch to the scores of an empty document
+ *                        and starts a new document epoch of the scratch, which reads the rows of its node.
+ *                        Accumulator has cls_stride items aligned for vectorized addition of rows of words_prob.
+ *                        Does not check arguments validity.
+ * \param cl Pointer to a learnt classifier.
+ * \param scratch Pointer to a scratch of the classifier.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_scores_init(const nbc *cl, nbc_scratch *scratch) {
+    int cls;
+
+    if (!nbc_scratch_fit(cl, scratch)) {
+        return 0;
+    }
+
+    array_clear(scratch->acc, cl->cls_stride, sizeof(double));
+    for (cls = 0; cls < cl->cls_cnt; cls++) {
+        scratch->acc[cls] = log10(cl->cls_prob[cls]) + cl->cls_absent_prob[cls];
+    }
+    scratch->words_prob = nbc_words_prob_node(cl, scratch->node);
+    scratch->epoch++;
+
+    return 1;
+}
+
+
+/**
+ * \brief nbc_scores_add Adds the log10 probabilities of the word to the accumulator of scores of classes,
+ *                       the whole padded row at once.
+ *                       In the Bernoulli model each word is added at most once per document epoch.
+ *                       Words learnt after nbc_learn_finish are ignored.
+ *                       Does not check arguments validity.
+ * \param cl Pointer to a learnt classifier.
+ * \param scratch Pointer to a scratch of the classifier.
+ * \param id Word identifier.
+ */
+void nbc_scores_add(const nbc *cl, nbc_scratch *scratch, const size_t id) {
+    if (id >= cl->words_prob_rows) {
+        return;
+    }
+    if (cl->params.model == NBC_BERNOULLI) {
+        if (scratch->seen[id] == scratch->epoch) {
+            return;
+        }
+        scratch->seen[id] = scratch->epoch;
+    }
+
+    vec_add(scratch->acc, scratch->words_prob + (id * cl->cls_stride), cl->cls_stride);
+}
+
+
+/**
+ * \brief nbc_batch_scores_add Adds the log10 probabilities of the known features of the batch
+ *                             to the accumulator of scores of classes in the order of the features.
+ *                             Rows of probabilities are prefetched before any of them is added.
+ *                             Does not check arguments validity.
+ * \param cl Pointer to a learnt classifier.
+ * \param scratch Pointer to a scratch of the classifier.
+ * \param b Pointer to a batch.
+ */
+void nbc_batch_scores_add(const nbc *cl, nbc_scratch *scratch, nbc_batch *b) {
+    int i;
+
+    nbc_batch_find(cl, b);
+    for (i = 0; i < b->cnt; i++) {
+        if (b->found[i] && b->ids[i] < cl->words_prob_rows) {
+            NBC_PREFETCH(scratch->words_prob + (b->ids[i] * cl->cls_stride));
+        }
+    }
+    for (i = 0; i < b->cnt; i++) {
+        if (b->found[i]) {
+            nbc_scores_add(cl, scratch, b->ids[i]);
+        }
+    }
+}
+
+
+/**
+ * \brief nbc_scores_finish Stores the accumulated scores of classes.
+ *                          Does not check arguments validity.
+ * \param cl Pointer to a learnt classifier.
+ * \param scratch Pointer to a scratch of the classifier.
+ * \param scores Array of scores of classes.
+ */
+void nbc_scores_finish(const nbc *cl, const nbc_scratch *scratch, double scores[]) {
+    memcpy(scores, scratch->acc, cl->cls_cnt * sizeof(double));
+}
+
+
+/**
+ * \brief nbc_score_tokens Computes scores of the document for each class.
+ *                         Does not check arguments validity.
+ * \param cl Pointer to a learnt classifier.
+ * \param scratch Pointer to a scratch of the classifier.
+ * \param t Pointer to a source of words of the document (file or buffer).
+ * \param scores Array of cls_cnt items, where the scores of classes will be stored.
+ * \return 1 if the document was successfully scored, 0 otherwise.
+ */
+int nbc_score_tokens(const nbc *cl, nbc_scratch *scratch, tokens *t, double scores[]) {
+    nbc_features f;
+    nbc_batch b;
+    char *word = NULL;
+
+    if (!nbc_scores_init(cl, scratch)) {
+        return 0;
+    }
+    nbc_features_reset(&f);
+    b.cnt = b.words_cnt = 0;
+    while ((word = tokens_next(t)) || b.cnt) {
+        if (word) {
+            nbc_features_next(cl, &f, word, nbc_word_hash(cl, word));
+            nbc_batch_push(cl, &b, &f, word);
+            if (!nbc_batch_full(&b)) {
+                continue;
+            }
+        }
+
+        nbc_batch_scores_add(cl, scratch, &b);
+        nbc_batch_clear(&b);
+    }
+    nbc_scores_finish(cl, scratch, scores);
+
+    return 1;
+}
+
+
+int nbc_score(const nbc *cl, const char f_path[], double scores[]) {
+    tokens t;
+    FILE *fp = NULL;
+
+    if (!nbc_is_learnt(cl) || !f_path || !scores) {
+        return 0;
+    }
+
+    if (cl->parts) {
+        return nbc_parts_score(cl->parts, f_path, scores);
+    }
+
+    fp = fopen(f_path, "r");
+    if (!fp) {
+        return 0;
+    }
+
+    tokens_file(&t, fp);
+    if (!nbc_score_tokens(cl, cl->scratch, &t, scores)) {
+        fclose(fp);
+        return 0;
+    }
+
+    return fclose(fp) != EOF;
+}
+
+
+int nbc_score_buffer(const nbc *cl, const char *buf, const size_t size, double scores[]) {
+    if (cl && cl->parts) {
+        return nbc_parts_score_buffer(cl->parts, buf, size, scores);
+    }
+
+    return nbc_score_buffer_r(cl, cl ? cl->scratch : NULL, buf, size, scores);
+}
+
+
+int nbc_score_buffer_r(const nbc *cl, nbc_scratch *scratch, const char *buf, const size_t size, double scores[]) {
+    tokens t;
+
+    if (!nbc_is_learnt(cl) || !scratch || (!buf && size) || !scores) {
+        return 0;
+    }
+
+    tokens_buffer(&t, buf, size);
+    return nbc_score_tokens(cl, scratch, &t, scores);
+}
+
+
+int nbc_score_ids(const nbc *cl, const size_t ids[], const size_t ids_cnt, double scores[]) {
+    size_t i;
+
+    if (!nbc_is_learnt(cl) || (!ids && ids_cnt) || !scores) {
+        return 0;
+    }
+
+    if (!nbc_scores_init(cl, cl->scratch)) {
+        return 0;
+    }
+    for (i = 0; i < ids_cnt; i++) {
+        nbc_scores_add(cl, cl->scratch, ids[i]);
+    }
+    nbc_scores_finish(cl, cl->scratch, scores);
+
+    return 1;
+}
+
+
+int nbc_score_words(const nbc *cl, nbc_vocab *vocab, const unsigned words[], const size_t words_cnt, double scores[]) {
+    nbc_features f;
+    size_t word_ids[NBC_MAX_NGRAM];
+    size_t w;
+    int n, ids_cnt;
+
+    if (!nbc_is_learnt(cl) || !vocab || (!words && words_cnt) || !scores) {
+        return 0;
+    }
+
+    if (!nbc_scores_init(cl, cl->scratch)) {
+        return 0;
+    }
+    nbc_features_reset(&f);
+    for (w = 0; w < words_cnt; w++) {
+        if (words[w] >= vocab->words_cnt) {
+            return 0;
+        }
+        ids_cnt = nbc_vocab_features_find(cl, vocab, &f, words[w], word_ids);
+        for (n = 0; n < ids_cnt; n++) {
+            nbc_scores_add(cl, cl->scratch, word_ids[n]);
+        }
+    }
+    nbc_scores_finish(cl, cl->scratch, scores);
+
+    return 1;
+}
+
+
+int nbc_classify_scores(const nbc *cl, const double scores[]) {
+    if (!cl || !scores) {
+        return -1;
+    }
+
+    return (int) vec_argmax(scores, cl->cls_cnt);
+}
+
+
+int nbc_classify(const nbc *cl, const char f_path[]) {
+    double *probs = NULL;
+    int cls;
+
+    if (!nbc_is_learnt(cl)) {
+        return -1;
+    }
+
+    probs = array_create(cl->cls_cnt, sizeof(double));
+    if (!probs) {
+        return -1;
+    }
+    if (!nbc_score(cl, f_path, probs)) {
+        array_free((void **) &probs);
+        return -1;
+    }
+
+    cls = nbc_classify_scores(cl, probs);
     array_free((void **) &probs);
-    return -1;
+
+    return cls;
+}
+
+
+int nbc_classify_buffer(const nbc *cl, const char *buf, const size_t size) {
+    double *probs = NULL;
+    int cls;
+
+    if (!nbc_is_learnt(cl)) {
+        return -1;
+    }
+
+    probs = array_create(cl->cls_cnt, sizeof(double));
+    if (!probs) {
+        return -1;
+    }
+    if (!nbc_score_buffer(cl, buf, size, probs)) {
+        array_free((void **) &probs);
+        return -1;
+    }
+
+    cls = nbc_classify_scores(cl, probs);
+    array_free((void **) &probs);
+
+    return cls;
+}
+
+
+double nbc_hash_collisions(const nbc *cl, double *features_cnt) {
+    double slots_cnt;
+
+    if (!nbc_is_learnt(cl) || !cl->params.hash_bits || !features_cnt) {
+        return -1;
+    }
+
+    /* n features fill m slots to m * (1 - e^(-n/m)) used slots on average */
+    slots_cnt = (double) ((size_t) 1 << cl->params.hash_bits);
+    if (cl->dict_size == slots_cnt) {
+        *features_cnt = 0;
+        return 1;
+    }
+    *features_cnt = -slots_cnt * log(1 - cl->dict_size / slots_cnt);
+
+    return 1 - (cl->dict_size / *features_cnt);
 }
@@ -5,39 +5,230 @@
  * \author Stanislav Kafara, skafara@students.zcu.cz
  *
  * Represents a general naive Bayes classifier.
- * Classifier has variable count of classes and uses the bag-of-words model.
+ * Classifier has variable count of classes and uses the bag-of-words model
+ * with either the multinomial or the Bernoulli event model.
  */
 
 
 #ifndef CLASSIFIER_H
 #define CLASSIFIER_H
 
-#include "structures/hashtable.h"
+#include "structures/cms.h"
+#include "structures/htabs.h"
+#include "structures/shtab.h"
+#include "structures/vector.h"
+
+
+/** \brief Maximal number of bits of feature hashing slots. */
+#define NBC_MAX_HASH_BITS 30
+/** \brief Maximal order of word n-grams used as features. */
+#define NBC_MAX_NGRAM 3
+/** \brief Maximal number of occurences of a feature after which it is added to the dictionary. */
+#define NBC_MAX_MIN_COUNT CMS_MAX_LIMIT
+/** \brief Maximal number of threads learning documents into shared counts. */
+#define NBC_MAX_THREADS 64
+/** \brief Maximal number of partitions of the vocabulary scored by threads of their own (see nbc_parts). */
+#define NBC_MAX_PARTS 64
+/** \brief Average size of a word of a text including its separators (estimates the number of words of texts). */
+#define NBC_BYTES_PER_WORD 7
+
+
+/**
+ * \brief Event models of a naive Bayes classifier.
+ */
+typedef enum nbc_model_ {
+    NBC_MULTINOMIAL,    /**< Every occurence of a word in a document counts. */
+    NBC_BERNOULLI       /**< Word counts at most once per document (document presence). */
+} nbc_model;
+
+
+/**
+ * \brief Placements of the learnt rows of probabilities of words (words_prob) in memory.
+ *        Placed rows lie on transparent huge pages (fewer TLB misses on a large model),
+ *        on a host of more NUMA nodes they are interleaved over the nodes or copied to each one of them.
+ *        Dictionary of words is not placed.
+ */
+typedef enum nbc_placement_ {
+    NBC_PLACE_DEFAULT,      /**< Rows are allocated as any other memory. */
+    NBC_PLACE_HUGE,         /**< Rows lie on huge pages. */
+    NBC_PLACE_INTERLEAVE,   /**< Rows lie on huge pages interleaved over the NUMA nodes. */
+    NBC_PLACE_REPLICATE     /**< Rows are copied to huge pages of every NUMA node,
+                                 each scratch reads the copy of its node (see nbc_scratch). */
+} nbc_placement;
+
+
+/**
+ * \struct nbc_params
+ * \brief Struct representing parameters of a classifier chosen at its creation.
+ */
+typedef struct nbc_params_ {
+    nbc_model model;        /**< Event model of the classifier. */
+    unsigned hash_bits;     /**< Words are hashed into 2^hash_bits slots instead of the dictionary of words,
+                                 if not 0 (feature hashing). */
+    unsigned ngram;         /**< Maximal order of word n-grams used as features besides words (1 for words only). */
+    unsigned threads;       /**< Number of threads learning the documents of a corpus into shared counts
+                                 (see nbc_shared), 1 learns them one by one. */
+    unsigned min_count;     /**< Only features occuring at least min_count times in the learnt documents
+                                 (estimated by a count-min sketch) are added to the dictionary, the documents
+                                 are learnt twice then (see nbc_sketch_finish), 1 adds every feature (no sketch).
+                                 Not with feature hashing. */
+    size_t max_words;       /**< Maximal number of learnt features, only the most frequent ones are kept
+                                 by nbc_learn_finish, if not 0. The dictionary holds all the admitted features
+                                 until then, so it does not bound the memory of learning documents
+                                 (nbc_learn_counts adds the kept ones only). Not with feature hashing. */
+    nbc_placement placement; /**< Placement of the learnt rows of probabilities of words in memory,
+                                  applied by nbc_learn_finish. */
+    unsigned parts;         /**< Number of partitions of the vocabulary (see nbc_parts) made by nbc_learn_finish,
+                                 which score the documents of nbc_score and nbc_score_buffer, if not 0. */
+} nbc_params;
+
+
+/**
+ * \struct nbc_scratch
+ * \brief Struct representing the working memory of scoring of documents by a classifier.
+ *        Learnt classifier is only read while scoring, so it may score documents concurrently,
+ *        each thread using its own scratch.
+ */
+typedef struct nbc_scratch_ {
+    double *acc;                /**< Aligned accumulator of cls_stride scores of classes. */
+    size_t acc_cnt;             /**< Number of items of acc. */
+    size_t *seen;               /**< Epochs of documents where the words were seen last (Bernoulli model, else NULL). */
+    size_t seen_cnt;            /**< Number of items of seen. */
+    size_t epoch;               /**< Epoch of the currently scored document. */
+    size_t node;                /**< NUMA node of the thread using the scratch (0 unless set),
+                                     its copy of replicated rows of probabilities is read. */
+    const double *words_prob;   /**< Rows of probabilities read while scoring the current document. */
+} nbc_scratch;
 
 
 /**
  * \struct nbc
  * \brief Struct representing a naive Bayes classifier.
+ *
+ * Each distinct learnt word is assigned an identifier (index of its row),
+ * counts and probabilities of words are stored in rows of cls_cnt items indexed by the word identifier.
+ * Rows of probabilities are padded to the SIMD vector width, so a word is scored by whole vector additions.
+ * With feature hashing the identifier is the slot the word hashes to and no words are stored.
+ * Word n-grams are features identified by hashes rolled over the hashes of their words,
+ * they are put in the dictionary by a short key made of the hash or hashed into the slots.
+ * Rare features may be left out of the dictionary (see nbc_params), the documents are then counted by a sketch
+ * of a fixed size first and only the features frequent enough are admitted to the dictionary once the documents
+ * are learnt again, so the dictionary does not depend on the order of the documents. Number of learnt features
+ * may be limited too, only the most frequent ones are kept once the documents are learnt
+ * (the memory of learning is bounded by the admitted features, not by their limit).
  */
 typedef struct nbc_ {
-    const int cls_cnt;      /**< Number of classes. */
+    const int cls_cnt;          /**< Number of classes. */
+    const size_t cls_stride;    /**< Number of items of a row of words_prob, cls_cnt padded to the SIMD vector width. */
+    const nbc_params params;    /**< Parameters of the classifier. */
 
-    double *cls_prob;       /**< Aprior probabilities of occurences of classes in learnt data. */
-    size_t *cls_words_cnt;  /**< Number of words in classes of learnt data. */
+    double *cls_prob;           /**< Aprior probabilities of occurences of classes in learnt data. */
+    size_t *cls_docs_cnt;       /**< Number of documents in classes of learnt data. */
+    size_t *cls_words_cnt;      /**< Number of words in classes of learnt data. */
+    double *cls_absent_prob;    /**< Sums of log10 probabilities of absence of all words in classes
+                                     (Bernoulli model, else 0). */
 
-    htab *words_cnt;        /**< Number of occurences of words in learnt data. */
-    htab *words_prob;       /**< Probabilities of words occurences in learnt data. */
-    
-    size_t dict_size;       /**< Number of distinct words in learnt data. */
+    htab_size *words_id;        /**< Identifiers of distinct words in learnt data (NULL with feature hashing). */
+    vector *words_cnt;          /**< Rows of numbers of occurences of words (documents with the word
+                                     in the Bernoulli model) in classes of learnt data. */
+    double *words_prob;         /**< Aligned rows of cls_stride log10 probabilities of words in classes
+                                     (log10 odds of word presence in the Bernoulli model), padded by zeros. */
+    size_t words_prob_rows;     /**< Number of rows of words_prob (words known at the last nbc_learn_finish). */
+    double **words_prob_nodes;  /**< Copies of words_prob placed on the NUMA nodes (the first one is words_prob),
+                                     or NULL if the rows are not placed (see nbc_placement). */
+    size_t words_prob_nodes_cnt; /**< Number of placed copies of words_prob (1 unless replicated). */
+
+    vector *words_seen;         /**< Epochs of learnt documents where the words were seen last (Bernoulli model). */
+    size_t epoch;               /**< Epoch of the currently learnt document. */
+    cms *sketch;                /**< Estimated numbers of occurences of features in the learnt documents
+                                     (if params.min_count > 1, else NULL). */
+    int sketched;               /**< 1 once the documents counted by the sketch are learnt again
+                                     (see nbc_sketch_finish), else 0. */
+    nbc_scratch *scratch;       /**< Scratch of the scoring functions not given one (created by nbc_learn_finish). */
+    struct nbc_parts_ *parts;   /**< Partitions (see parts.h) scoring the documents of nbc_score and nbc_score_buffer
+                                     (made by nbc_learn_finish if params.parts, else NULL). */
+
+    size_t dict_size;           /**< Number of distinct words (used slots with feature hashing) in learnt data. */
 } nbc;
 
 
+/** \brief Identifier of a vocabulary word not resolved to a classifier word identifier yet. */
+#define NBC_NO_ID ((size_t) -1)
+
+
+/** \brief Size of a dictionary key of a word n-gram (prefix, hexadecimal hash and terminator). */
+#define NBC_GRAM_KEY_SIZE (2 + 2 * sizeof(unsigned long))
+
+
+/**
+ * \struct nbc_features
+ * \brief Struct representing features of a word of a document, the word and word n-grams ending with it.
+ *        Hashes of n-grams are rolled over the words of the document, no n-gram strings are made.
+ *        Features are made by nbc_features_next (shared with the partitions, see parts.h).
+ */
+typedef struct nbc_features_ {
+    size_t words_cnt;                                   /**< Number of already processed words of the document. */
+    unsigned long word_hash;                            /**< Hash of the previous word. */
+    unsigned long bigram_hash;                          /**< Hash of the previous bigram. */
+    int cnt;                                            /**< Number of features of the current word. */
+    const char *keys[NBC_MAX_NGRAM];                    /**< Dictionary keys of the features. */
+    unsigned long hashes[NBC_MAX_NGRAM];                /**< Hashes of the features (of their dictionary keys). */
+    char gram_keys[NBC_MAX_NGRAM][NBC_GRAM_KEY_SIZE];   /**< Dictionary keys of the n-grams. */
+} nbc_features;
+
+
+/**
+ * \struct nbc_vocab
+ * \brief Struct representing a vocabulary of pre-tokenized documents, whose words are given by indices
+ *        to the vocabulary instead of strings.
+ *
+ * Hashes of the words are computed once at the creation, identifiers of the words
+ * are resolved once on the first occurence of the word. Vocabulary is bound to one classifier.
+ */
+typedef struct nbc_vocab_ {
+    size_t words_cnt;           /**< Number of words of the vocabulary. */
+    const char **words;         /**< Words of the vocabulary (not owned by the vocabulary). */
+    unsigned long *hashes;      /**< Hashes of the words (see nbc_features). */
+    size_t *ids;                /**< Classifier identifiers of the words, or NBC_NO_ID if not resolved yet. */
+} nbc_vocab;
+
+
+/**
+ * \struct nbc_shared
+ * \brief Struct representing counts of words shared by threads learning documents at once.
+ *
+ * Threads count the words of their documents into one table of rows of counts (see shtab.h)
+ * instead of each one into its own classifier, the dictionary of the classifier is made of the table
+ * once all the documents are learnt (see nbc_shared_finish).
+ * With feature hashing the threads add to the slots of the classifier directly.
+ * Counts (and counters of the sketch) are added atomically, so the learnt counts do not depend on the order
+ * of the documents, the dictionary of frequent features is learnt in two passes like by one thread
+ * (see nbc_sketch_finish).
+ */
+typedef struct nbc_shared_ {
+    shtab *counts;              /**< Rows of counts of words in classes (NULL with feature hashing). */
+    size_t *cls_docs_cnt;       /**< Number of learnt documents in classes. */
+} nbc_shared;
+
+
+/**
+ * \struct nbc_shared_scratch
+ * \brief Struct representing the working memory of a thread learning documents into shared counts,
+ *        reused for all of its documents.
+ */
+typedef struct nbc_shared_scratch_ {
+    htab_size *seen;            /**< Features of the learnt document seen so far, emptied for every document
+                                     (Bernoulli model, else NULL). */
+} nbc_shared_scratch;
+
+
 /**
  * \brief nbc_create Creates an untaught classifier ready to work with provided number of classes.
  * \param cls_cnt Number of classes.
+ * \param params Pointer to parameters of the classifier, or NULL for the multinomial model.
  * \return Pointer to an yet untaught classifier with provided number of classes.
  */
-nbc *nbc_create(const int cls_cnt);
+nbc *nbc_create(const int cls_cnt, const nbc_params *params);
 
 
 /**
@@ -50,6 +241,18 @@ nbc *nbc_create(const int cls_cnt);
 void nbc_free(nbc **cl);
 
 
+/**
+ * \brief nbc_reserve Prepares the classifier for learning documents of the total number of words.
+ *                    Dictionary and counts of words are presized for the number of distinct features
+ *                    estimated by Heaps' law, so that they are not grown (rehashed) while learning.
+ *                    Estimate is only a hint, learning is correct whatever the number of features is.
+ * \param cl Pointer to a classifier.
+ * \param words_cnt Total number of words of the documents (size of texts / NBC_BYTES_PER_WORD).
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_reserve(nbc *cl, const size_t words_cnt);
+
+
 /**
  * \brief nbc_learn Classifier learns the provided files.
  *                  Classifier may be successfully taught only once,
@@ -62,6 +265,270 @@ void nbc_free(nbc **cl);
 int nbc_learn(nbc *cl, const char *f_paths[], const size_t f_counts[]);
 
 
+/**
+ * \brief nbc_learn_file Adds the counts of the words (and n-grams) of the provided file of the provided class.
+ *                       Learnt counts take effect after nbc_learn_finish.
+ * \param cl Pointer to a classifier.
+ * \param f_path Path to the file to be learnt.
+ * \param cls Class to which the file belongs to.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_learn_file(nbc *cl, const char f_path[], const int cls);
+
+
+/**
+ * \brief nbc_learn_buffer Adds the counts of the words (and n-grams) of the document held in memory
+ *                         (e.g. in a mapped pack) of the provided class, words are split as in a file.
+ *                         Learnt counts take effect after nbc_learn_finish.
+ * \param cl Pointer to a classifier.
+ * \param buf Buffer holding the document.
+ * \param size Size of the buffer.
+ * \param cls Class to which the document belongs to.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_learn_buffer(nbc *cl, const char *buf, const size_t size, const int cls);
+
+
+/**
+ * \brief nbc_shared_create Creates empty shared counts of an untaught classifier
+ *                          for documents of the total number of words (see nbc_reserve).
+ * \param cl Pointer to an untaught classifier.
+ * \param words_cnt Total number of words of the documents (a hint, 0 if not known).
+ * \return Pointer to new empty shared counts, or NULL on failure.
+ */
+nbc_shared *nbc_shared_create(const nbc *cl, const size_t words_cnt);
+
+
+/**
+ * \brief nbc_shared_free Releases the memory held by the shared counts and NULLs the pointer to them.
+ * \param sh Pointer to a pointer to shared counts.
+ */
+void nbc_shared_free(nbc_shared **sh);
+
+
+/**
+ * \brief nbc_shared_scratch_create Creates a scratch for learning of documents into shared counts in one thread.
+ * \param cl Pointer to the classifier of the shared counts.
+ * \return Pointer to a new scratch, or NULL on failure.
+ */
+nbc_shared_scratch *nbc_shared_scratch_create(const nbc *cl);
+
+
+/**
+ * \brief nbc_shared_scratch_free Releases the memory held by the scratch and NULLs the pointer to it.
+ * \param scratch Pointer to a pointer to a scratch.
+ */
+void nbc_shared_scratch_free(nbc_shared_scratch **scratch);
+
+
+/**
+ * \brief nbc_shared_learn_file Adds the counts of the words (and n-grams) of the provided file of the provided class
+ *                              to the shared counts (see nbc_learn_file).
+ *                              Thread-safe, any number of threads may learn documents at once.
+ * \param cl Pointer to the classifier of the shared counts.
+ * \param sh Pointer to shared counts.
+ * \param scratch Pointer to a scratch of the calling thread.
+ * \param f_path Path to the file to be learnt.
+ * \param cls Class to which the file belongs to.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_shared_learn_file(const nbc *cl, nbc_shared *sh, nbc_shared_scratch *scratch, const char f_path[],
+                          const int cls);
+
+
+/**
+ * \brief nbc_shared_learn_buffer Adds the counts of the words (and n-grams) of the document held in memory
+ *                                of the provided class to the shared counts (see nbc_learn_buffer).
+ *                                Thread-safe, any number of threads may learn documents at once.
+ * \param cl Pointer to the classifier of the shared counts.
+ * \param sh Pointer to shared counts.
+ * \param scratch Pointer to a scratch of the calling thread.
+ * \param buf Buffer holding the document.
+ * \param size Size of the buffer.
+ * \param cls Class to which the document belongs to.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_shared_learn_buffer(const nbc *cl, nbc_shared *sh, nbc_shared_scratch *scratch, const char *buf,
+                            const size_t size, const int cls);
+
+
+/**
+ * \brief nbc_shared_learn_words Adds the counts of the words (and n-grams) of the pre-tokenized document
+ *                               of the provided class to the shared counts.
+ *                               Thread-safe, any number of threads may learn documents at once.
+ * \param cl Pointer to the classifier of the shared counts.
+ * \param sh Pointer to shared counts.
+ * \param scratch Pointer to a scratch of the calling thread.
+ * \param vocab_words Words of the vocabulary of the document (e.g. of a corpus cache).
+ * \param words Array of indices of words of the document to the vocabulary.
+ * \param words_cnt Number of words of the document.
+ * \param cls Class to which the document belongs to.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_shared_learn_words(const nbc *cl, nbc_shared *sh, nbc_shared_scratch *scratch, const char *vocab_words[],
+                           const unsigned words[], const size_t words_cnt, const int cls);
+
+
+/**
+ * \brief nbc_shared_finish Adds the shared counts (learnt by threads which have finished)
+ *                          to the untaught classifier and finishes its learning (see nbc_learn_finish).
+ * \param cl Pointer to the classifier of the shared counts.
+ * \param sh Pointer to shared counts.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_shared_finish(nbc *cl, nbc_shared *sh);
+
+
+/**
+ * \brief nbc_counts_size Computes the memory held by the learnt counts of the classifier
+ *                        (dictionary, rows of counts and seen epochs of words).
+ * \param cl Pointer to a classifier.
+ * \return Size of the counts in bytes.
+ */
+size_t nbc_counts_size(const nbc *cl);
+
+
+/**
+ * \brief nbc_write_counts Writes the learnt counts of the classifier (learnt words and documents of classes)
+ *                         to the counts file sorted by the words (see counts.h), so that counts too large
+ *                         to be held in memory may be learnt in parts and merged (see counts_merge).
+ *                         Classifier must not use feature hashing.
+ * \param cl Pointer to a classifier.
+ * \param f_path Path to the counts file.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_write_counts(const nbc *cl, const char f_path[]);
+
+
+/**
+ * \brief nbc_learn_counts Teaches the untaught classifier the counts of the counts file
+ *                         (of the classifier's classes, model and n-grams) and finishes its learning.
+ *                         Bounds of the dictionary (see nbc_params) apply to the total counts of the words exactly:
+ *                         words counted less than min_count times are left out and only the max_words
+ *                         most frequent words are kept (the file is read twice then).
+ *                         Classifier must not use feature hashing.
+ * \param cl Pointer to an untaught classifier.
+ * \param f_path Path to the counts file.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_learn_counts(nbc *cl, const char f_path[]);
+
+
+/**
+ * \brief nbc_tokenize Converts the words (and n-grams) of the provided file to their identifiers,
+ *                     words not present in the dictionary yet are added to it (with zero counts).
+ * \param cl Pointer to a classifier.
+ * \param f_path Path to the file to be tokenized.
+ * \param ids Vector of identifiers (of size_t items), where the identifiers of words will be appended.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_tokenize(nbc *cl, const char f_path[], vector *ids);
+
+
+/**
+ * \brief nbc_tokenize_buffer Converts the words (and n-grams) of the document held in memory to their identifiers
+ *                            (see nbc_tokenize).
+ * \param cl Pointer to a classifier.
+ * \param buf Buffer holding the document.
+ * \param size Size of the buffer.
+ * \param ids Vector of identifiers (of size_t items), where the identifiers of words will be appended.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_tokenize_buffer(nbc *cl, const char *buf, const size_t size, vector *ids);
+
+
+/**
+ * \brief nbc_vocab_create Creates a vocabulary of pre-tokenized documents for the classifier.
+ * \param cl Pointer to a classifier.
+ * \param words Array of words of the vocabulary, which must outlive the vocabulary.
+ * \param words_cnt Number of words.
+ * \return Pointer to a vocabulary with no word identifiers resolved yet.
+ */
+nbc_vocab *nbc_vocab_create(const nbc *cl, const char *words[], const size_t words_cnt);
+
+
+/**
+ * \brief nbc_vocab_free Releases the memory held by the vocabulary and NULLs the pointer to it.
+ * \param vocab Pointer to a pointer to a vocabulary.
+ */
+void nbc_vocab_free(nbc_vocab **vocab);
+
+
+/**
+ * \brief nbc_tokenize_words Converts the words (and n-grams) of a pre-tokenized document to their identifiers,
+ *                           words not present in the dictionary yet are added to it (with zero counts).
+ * \param cl Pointer to a classifier.
+ * \param vocab Pointer to a vocabulary of the classifier.
+ * \param words Array of indices of words of the document to the vocabulary.
+ * \param words_cnt Number of words of the document.
+ * \param ids Vector of identifiers (of size_t items), where the identifiers of words will be appended.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_tokenize_words(nbc *cl, nbc_vocab *vocab, const unsigned words[], const size_t words_cnt, vector *ids);
+
+
+/**
+ * \brief nbc_learn_words Adds the counts of the words (and n-grams) of a pre-tokenized document of the provided class.
+ *                        Learnt counts take effect after nbc_learn_finish.
+ * \param cl Pointer to a classifier.
+ * \param vocab Pointer to a vocabulary of the classifier.
+ * \param words Array of indices of words of the document to the vocabulary.
+ * \param words_cnt Number of words of the document.
+ * \param cls Class to which the document belongs to.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_learn_words(nbc *cl, nbc_vocab *vocab, const unsigned words[], const size_t words_cnt, const int cls);
+
+
+/**
+ * \brief nbc_learn_ids Adds the counts of the words of a document of the provided class
+ *                      given by the identifiers of its words (see nbc_tokenize).
+ *                      Learnt counts take effect after nbc_learn_finish.
+ * \param cl Pointer to a classifier.
+ * \param ids Array of identifiers of words of the document.
+ * \param ids_cnt Number of identifiers.
+ * \param cls Class to which the document belongs to.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_learn_ids(nbc *cl, const size_t ids[], const size_t ids_cnt, const int cls);
+
+
+/**
+ * \brief nbc_unlearn_ids Subtracts the counts of the words of a previously learnt document of the provided class
+ *                        given by the identifiers of its words.
+ *                        Unlearnt counts take effect after nbc_learn_finish.
+ * \param cl Pointer to a classifier.
+ * \param ids Array of identifiers of words of the document.
+ * \param ids_cnt Number of identifiers.
+ * \param cls Class to which the document belongs to.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_unlearn_ids(nbc *cl, const size_t ids[], const size_t ids_cnt, const int cls);
+
+
+/**
+ * \brief nbc_sketch_finish Ends the first pass of learning of a classifier with params.min_count > 1.
+ *                          Documents learnt until now (one by one or by threads, see nbc_shared) were only
+ *                          counted by the sketch, the same documents are to be learnt again then, counting
+ *                          all the occurences of the features estimated to occur at least min_count times.
+ * \param cl Pointer to a classifier.
+ * \return 1 if the first pass was ended, 0 if the classifier has no sketch or the first pass has ended already.
+ */
+int nbc_sketch_finish(nbc *cl);
+
+
+/**
+ * \brief nbc_learn_finish Computes the probabilities of classes and words from the actual learnt counts
+ *                         (and partitions the vocabulary if params.parts, see nbc_parts).
+ *                         Only the max_words most frequent features (of the lowest keys among the equally
+ *                         frequent ones) keep their counts, the others are left unlearnt.
+ *                         May be called repeatedly, whenever the learnt counts change.
+ * \param cl Pointer to a classifier.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_learn_finish(nbc *cl);
+
+
 /**
  * \brief nbc_is_learnt Finds out whether classifier was successfully taught.
  * \return 1 if classifier was already successfully taught, else 0.
@@ -70,7 +537,141 @@ int nbc_is_learnt(const nbc *cl);
 
 
 /**
- * \brief nbc_classify Classifies the provided file.
+ * \brief nbc_score Computes scores of the provided file for each class,
+ *                  log10 of the (not normalized) posterior probabilities of the classes.
+ *                  Classifier's own scratch is used, so one classifier must not score more files concurrently
+ *                  (see nbc_score_buffer_r). Partitioned classifier (params.parts) scores it by its partitions
+ *                  (see nbc_parts_score).
+ * \param cl Pointer to the classifier to score the file.
+ * \param f_path Path to the file to be scored.
+ * \param scores Array of cls_cnt items, where the scores of classes will be stored.
+ * \return 1 if provided file was successfully scored, 0 otherwise.
+ */
+int nbc_score(const nbc *cl, const char f_path[], double scores[]);
+
+
+/**
+ * \brief nbc_score_buffer Computes scores of the document held in memory for each class (see nbc_score).
+ * \param cl Pointer to the classifier to score the document.
+ * \param buf Buffer holding the document.
+ * \param size Size of the buffer.
+ * \param scores Array of cls_cnt items, where the scores of classes will be stored.
+ * \return 1 if the document was successfully scored, 0 otherwise.
+ */
+int nbc_score_buffer(const nbc *cl, const char *buf, const size_t size, double scores[]);
+
+
+/**
+ * \brief nbc_scratch_create Creates a scratch for scoring of documents by the classifier in one thread.
+ *                            Scratch grows to fit any other classifier it is used with (e.g. a reloaded one).
+ * \param cl Pointer to a classifier.
+ * \return Pointer to a scratch, or NULL on failure.
+ */
+nbc_scratch *nbc_scratch_create(const nbc *cl);
+
+
+/**
+ * \brief nbc_scratch_free Releases the memory held by the scratch and NULLs the pointer to it.
+ * \param scratch Pointer to a pointer to a scratch.
+ */
+void nbc_scratch_free(nbc_scratch **scratch);
+
+
+/**
+ * \brief nbc_score_buffer_r Computes scores of the document held in memory for each class (see nbc_score_buffer)
+ *                           using the provided scratch. Threads holding their own scratches may score documents
+ *                           by one classifier concurrently, as long as it is not taught meanwhile.
+ * \param cl Pointer to the classifier to score the document.
+ * \param scratch Pointer to a scratch of the classifier used by one thread only.
+ * \param buf Buffer holding the document.
+ * \param size Size of the buffer.
+ * \param scores Array of cls_cnt items, where the scores of classes will be stored.
+ * \return 1 if the document was successfully scored, 0 otherwise.
+ */
+int nbc_score_buffer_r(const nbc *cl, nbc_scratch *scratch, const char *buf, const size_t size, double scores[]);
+
+
+/**
+ * \brief nbc_features_reset Prepares the features for the first word of a document.
+ * \param f Pointer to features.
+ */
+void nbc_features_reset(nbc_features *f);
+
+
+/**
+ * \brief nbc_word_hash Computes the hash of the word.
+ *                      It is the hash of the dictionary key as well as the seed of the n-gram hashes.
+ *                      Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param word Word.
+ * \return Hash of the word.
+ */
+unsigned long nbc_word_hash(const nbc *cl, const char *word);
+
+
+/**
+ * \brief nbc_features_next Sets the features of the next word of a document,
+ *                          the word and (according to the classifier) bigram and trigram ending with it.
+ *                          Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param f Pointer to features.
+ * \param word Next word of the document.
+ * \param word_hash Hash of the word (see nbc_word_hash).
+ */
+void nbc_features_next(const nbc *cl, nbc_features *f, const char *word, const unsigned long word_hash);
+
+
+/**
+ * \brief nbc_words_prob_node Returns the rows of probabilities of words read by the threads of the NUMA node
+ *                            (e.g. the owners of the partitions, see parts.h).
+ *                            Does not check arguments validity.
+ * \param cl Pointer to a learnt classifier.
+ * \param node NUMA node.
+ * \return Copy of the rows of the node if they are replicated, else words_prob.
+ */
+const double *nbc_words_prob_node(const nbc *cl, const size_t node);
+
+
+/**
+ * \brief nbc_score_ids Computes scores of a document given by the identifiers of its words for each class.
+ *                      Words not occuring in learnt data do not affect the scores.
+ *                      Classifier's own scratch is used, so one classifier must not score more documents
+ *                      concurrently.
+ * \param cl Pointer to the classifier to score the document.
+ * \param ids Array of identifiers of words of the document.
+ * \param ids_cnt Number of identifiers.
+ * \param scores Array of cls_cnt items, where the scores of classes will be stored.
+ * \return 1 if the document was successfully scored, 0 otherwise.
+ */
+int nbc_score_ids(const nbc *cl, const size_t ids[], const size_t ids_cnt, double scores[]);
+
+
+/**
+ * \brief nbc_score_words Computes scores of a pre-tokenized document for each class.
+ *                        Classifier's own scratch and the vocabulary are used,
+ *                        so one classifier must not score more documents concurrently.
+ * \param cl Pointer to the classifier to score the document.
+ * \param vocab Pointer to a vocabulary of the classifier.
+ * \param words Array of indices of words of the document to the vocabulary.
+ * \param words_cnt Number of words of the document.
+ * \param scores Array of cls_cnt items, where the scores of classes will be stored.
+ * \return 1 if the document was successfully scored, 0 otherwise.
+ */
+int nbc_score_words(const nbc *cl, nbc_vocab *vocab, const unsigned words[], const size_t words_cnt, double scores[]);
+
+
+/**
+ * \brief nbc_classify_scores Finds out the class of the highest score.
+ * \param cl Pointer to a classifier.
+ * \param scores Array of scores of cls_cnt classes (see nbc_score).
+ * \return Class of the highest score, or -1 on failure.
+ */
+int nbc_classify_scores(const nbc *cl, const double scores[]);
+
+
+/**
+ * \brief nbc_classify Classifies the provided file (to the class of the highest score).
+ *                     Classifier's own scratch is used, so one classifier must not classify more files concurrently.
  * \param cl Pointer to the classifier to classify the file.
  * \param f_path Path to the file to be classified.
  * \return Class if provided file was successfully classified, -1 otherwise.
@@ -78,4 +679,28 @@ int nbc_is_learnt(const nbc *cl);
 int nbc_classify(const nbc *cl, const char f_path[]);
 
 
+/**
+ * \brief nbc_classify_buffer Classifies the document held in memory (to the class of the highest score),
+ *                            as if the buffer was the content of a file (see nbc_classify).
+ *                            Classifier's own scratch is used, so one classifier must not classify more documents
+ *                            concurrently (see nbc_score_buffer_r).
+ * \param cl Pointer to the classifier to classify the document.
+ * \param buf Buffer holding the document.
+ * \param size Size of the buffer.
+ * \return Class if provided document was successfully classified, -1 otherwise.
+ */
+int nbc_classify_buffer(const nbc *cl, const char *buf, const size_t size);
+
+
+/**
+ * \brief nbc_hash_collisions Estimates the collisions of feature hashing from the number of used slots.
+ * \param cl Pointer to a learnt classifier using feature hashing.
+ * \param features_cnt Pointer to where the estimated number of distinct learnt words will be stored
+ *                     (0 if all the slots are used, the number cannot be estimated then).
+ * \return Estimated ratio of distinct learnt words sharing a slot with another word (1 if all the slots are used),
+ *         or -1 on failure.
+ */
+double nbc_hash_collisions(const nbc *cl, double *features_cnt);
+
+
 #endif
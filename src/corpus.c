@@ -0,0 +1,923 @@
+/**
+ * \file corpus.c
+ * \brief Functions declared in corpus.h are implemented in this file.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Corpus is a sequence of text files given by numbered file patterns, directory trees of classes
+ * or a manifest of (path, label) lines, or a pack or pre-tokenized cache file mapped into memory,
+ * or a counts file without documents.
+ */
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+#include "corpus.h"
+#include "counts.h"
+#include "tokenizer.h"
+#include "structures/htabs.h"
+#include "structures/vector.h"
+#include "utilities/mapping.h"
+#include "utilities/utils.h"
+
+
+/** \brief Size of the buffer of copying of texts of files into a pack. */
+#define CORPUS_PACK_COPY_SIZE 65536
+
+
+/**
+ * \brief corpus_cache_padded Rounds the size of a pack or cache section up to a multiple of sizeof(size_t).
+ * \param size Size of the section.
+ * \return Padded size of the section.
+ */
+size_t corpus_cache_padded(const size_t size) {
+    return (size + sizeof(size_t) - 1) / sizeof(size_t) * sizeof(size_t);
+}
+
+
+/**
+ * \brief corpus_strs_index Sets the pointers to the '\0' terminated strings stored one after another.
+ *                          Does not check arguments validity.
+ * \param strs Array of pointers to be set.
+ * \param strs_cnt Expected number of strings.
+ * \param data Stored strings.
+ * \param size Size of the stored strings.
+ * \return 1 if exactly strs_cnt strings are stored, else 0.
+ */
+int corpus_strs_index(const char *strs[], const size_t strs_cnt, const char *data, const size_t size) {
+    const char *end = NULL;
+    size_t s, offset;
+
+    offset = 0;
+    for (s = 0; s < strs_cnt; s++) {
+        end = offset < size ? (const char *) memchr(data + offset, '\0', size - offset) : NULL;
+        if (!end) {
+            return 0;
+        }
+        strs[s] = data + offset;
+        offset = end - data + 1;
+    }
+
+    return offset == size;
+}
+
+
+/**
+ * \brief corpus_create Creates an empty corpus of the kind.
+ * \param type Kind of the corpus.
+ * \param cls_cnt Number of classes.
+ * \return Pointer to a corpus, or NULL on failure.
+ */
+corpus *corpus_create(const corpus_type type, const int cls_cnt) {
+    corpus *c = NULL;
+
+    c = (corpus *) calloc(1, sizeof(corpus));
+    if (!c) {
+        return NULL;
+    }
+
+    c->type = type;
+    c->cls_cnt = cls_cnt;
+
+    return c;
+}
+
+
+/**
+ * \brief corpus_sources_create Sets the file patterns or directories of classes of the corpus to their copies.
+ *                              Does not check arguments validity.
+ * \param c Pointer to a corpus.
+ * \param sources Array of cls_cnt file patterns or directories.
+ * \return 1 if operation was successful, else 0.
+ */
+int corpus_sources_create(corpus *c, const char *sources[]) {
+    int cls;
+
+    c->sources = (char **) calloc(c->cls_cnt, sizeof(char *));
+    if (!c->sources) {
+        return 0;
+    }
+
+    for (cls = 0; cls < c->cls_cnt; cls++) {
+        c->sources[cls] = strdup(sources[cls]);
+        if (!c->sources[cls]) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+corpus *corpus_create_files(const char dir[], const char *f_patterns[], const size_t f_counts[],
+                            const int f_patterns_cnt, const char suffix[]) {
+    corpus *c = NULL;
+    int cls;
+
+    if (!f_patterns || !f_counts || f_patterns_cnt <= 0) {
+        return NULL;
+    }
+
+    c = corpus_create(CORPUS_FILES, f_patterns_cnt);
+    if (!c) {
+        return NULL;
+    }
+
+    c->sources_cnt = (size_t *) malloc(f_patterns_cnt * sizeof(size_t));
+    c->path = vector_create(sizeof(char), NULL);
+    if (!c->sources_cnt || !c->path || !corpus_sources_create(c, f_patterns) ||
+        (dir && !(c->dir = strdup(dir))) || (suffix && !(c->suffix = strdup(suffix)))) {
+        corpus_free(&c);
+        return NULL;
+    }
+
+    for (cls = 0; cls < f_patterns_cnt; cls++) {
+        c->sources_cnt[cls] = f_counts[cls];
+        c->docs_cnt += f_counts[cls];
+    }
+
+    return c;
+}
+
+
+corpus *corpus_create_dirs(const char *dirs[], const int dirs_cnt) {
+    corpus *c = NULL;
+
+    if (!dirs || dirs_cnt <= 0) {
+        return NULL;
+    }
+
+    c = corpus_create(CORPUS_DIRS, dirs_cnt);
+    if (!c) {
+        return NULL;
+    }
+
+    if (!corpus_sources_create(c, dirs)) {
+        corpus_free(&c);
+        return NULL;
+    }
+
+    return c;
+}
+
+
+corpus *corpus_open_manifest(const char f_path[], const char *labels[], const int cls_cnt) {
+    corpus *c = NULL;
+
+    if (!f_path || !labels || cls_cnt <= 0) {
+        return NULL;
+    }
+
+    c = corpus_create(CORPUS_MANIFEST, cls_cnt);
+    if (!c) {
+        return NULL;
+    }
+
+    c->labels = labels;
+    c->path = vector_create(sizeof(char), NULL);
+    c->fp = strcmp(f_path, "-") == 0 ? stdin : fopen(f_path, "r");
+    if (!c->path || !c->fp) {
+        corpus_free(&c);
+        return NULL;
+    }
+
+    return c;
+}
+
+
+/**
+ * \brief corpus_index_check Checks the offsets and classes of documents of a pack or a cache.
+ *                           Does not check arguments validity.
+ * \param c Pointer to a corpus with set offsets and classes of documents.
+ * \param end Offset of the end of the last document.
+ * \return 1 if offsets are ascending from 0 to end and classes are valid, else 0.
+ */
+int corpus_index_check(const corpus *c, const size_t end) {
+    size_t d;
+
+    if (c->docs_offsets[0] != 0 || c->docs_offsets[c->docs_cnt] != end) {
+        return 0;
+    }
+    for (d = 0; d < c->docs_cnt; d++) {
+        if (c->docs_offsets[d] > c->docs_offsets[d + 1] || c->docs_cls[d] >= (size_t) c->cls_cnt) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+corpus *corpus_open_pack(const char f_path[]) {
+    corpus *c = NULL;
+    const corpus_pack_header *header = NULL;
+    const char *data = NULL;
+    size_t offset;
+
+    if (!f_path) {
+        return NULL;
+    }
+
+    c = corpus_create(CORPUS_PACK, 0);
+    if (!c) {
+        return NULL;
+    }
+
+    c->data = f_map(f_path, &c->size);
+    if (!c->data || c->size < sizeof(corpus_pack_header)) {
+        goto fail;
+    }
+    data = (const char *) c->data;
+    header = (const corpus_pack_header *) data;
+    if (memcmp(header->magic, CORPUS_PACK_MAGIC, sizeof(CORPUS_PACK_MAGIC)) != 0 ||
+        header->version != CORPUS_PACK_VERSION || header->cls_cnt == 0 || header->cls_cnt > INT_MAX) {
+        goto fail;
+    }
+
+    /* every section must fit into the file, so that the offsets below do not overflow */
+    if (header->texts_size > c->size || header->names_size > c->size || header->docs_cnt >= c->size / sizeof(size_t)) {
+        goto fail;
+    }
+    offset = sizeof(corpus_pack_header) + corpus_cache_padded(header->texts_size) + corpus_cache_padded(header->names_size);
+    if (offset > c->size || (c->size - offset) / sizeof(size_t) < 2 * header->docs_cnt + 1) {
+        goto fail;
+    }
+
+    c->cls_cnt = (int) header->cls_cnt;
+    c->docs_cnt = header->docs_cnt;
+    c->texts = data + sizeof(corpus_pack_header);
+    c->docs_offsets = (const size_t *) (data + offset);
+    c->docs_cls = c->docs_offsets + c->docs_cnt + 1;
+
+    c->names = (const char **) malloc((c->docs_cnt ? c->docs_cnt : 1) * sizeof(char *));
+    if (!c->names) {
+        goto fail;
+    }
+    offset = sizeof(corpus_pack_header) + corpus_cache_padded(header->texts_size);
+    if (!corpus_strs_index(c->names, c->docs_cnt, data + offset, header->names_size) ||
+        !corpus_index_check(c, header->texts_size)) {
+        goto fail;
+    }
+
+    return c;
+
+fail:
+    corpus_free(&c);
+    return NULL;
+}
+
+
+corpus *corpus_open_cache(const char f_path[]) {
+    corpus *c = NULL;
+    const corpus_cache_header *header = NULL;
+    const char *data = NULL;
+    size_t offset;
+
+    if (!f_path) {
+        return NULL;
+    }
+
+    c = corpus_create(CORPUS_CACHE, 0);
+    if (!c) {
+        return NULL;
+    }
+
+    c->data = f_map(f_path, &c->size);
+    if (!c->data || c->size < sizeof(corpus_cache_header)) {
+        goto fail;
+    }
+    data = (const char *) c->data;
+    header = (const corpus_cache_header *) data;
+    if (memcmp(header->magic, CORPUS_CACHE_MAGIC, sizeof(CORPUS_CACHE_MAGIC)) != 0 ||
+        header->version != CORPUS_CACHE_VERSION || header->cls_cnt == 0 || header->cls_cnt > INT_MAX ||
+        header->words_cnt > UINT_MAX) {
+        goto fail;
+    }
+
+    /* every section must fit into the file, so that the offsets below do not overflow */
+    if (header->words_size > c->size || header->names_size > c->size ||
+        header->docs_cnt >= c->size / sizeof(size_t) || header->ids_cnt > c->size / sizeof(unsigned)) {
+        goto fail;
+    }
+    offset = sizeof(corpus_cache_header) + corpus_cache_padded(header->words_size) + corpus_cache_padded(header->names_size);
+    if (offset > c->size || (c->size - offset) / sizeof(size_t) < 2 * header->docs_cnt + 1 ||
+        (c->size - offset - (2 * header->docs_cnt + 1) * sizeof(size_t)) / sizeof(unsigned) < header->ids_cnt) {
+        goto fail;
+    }
+
+    c->cls_cnt = (int) header->cls_cnt;
+    c->docs_cnt = header->docs_cnt;
+    c->words_cnt = header->words_cnt;
+    c->docs_offsets = (const size_t *) (data + offset);
+    c->docs_cls = c->docs_offsets + c->docs_cnt + 1;
+    c->ids = (const unsigned *) (c->docs_cls + c->docs_cnt);
+
+    c->words = (const char **) malloc((c->words_cnt ? c->words_cnt : 1) * sizeof(char *));
+    c->names = (const char **) malloc((c->docs_cnt ? c->docs_cnt : 1) * sizeof(char *));
+    if (!c->words || !c->names) {
+        goto fail;
+    }
+    offset = sizeof(corpus_cache_header);
+    if (!corpus_strs_index(c->words, c->words_cnt, data + offset, header->words_size)) {
+        goto fail;
+    }
+    offset += corpus_cache_padded(header->words_size);
+    if (!corpus_strs_index(c->names, c->docs_cnt, data + offset, header->names_size) ||
+        !corpus_index_check(c, header->ids_cnt)) {
+        goto fail;
+    }
+
+    return c;
+
+fail:
+    corpus_free(&c);
+    return NULL;
+}
+
+
+corpus *corpus_open_counts(const char f_path[]) {
+    corpus *c = NULL;
+    counts_file *cf = NULL;
+
+    cf = counts_open(f_path);
+    if (!cf || cf->header.cls_cnt > INT_MAX) {
+        counts_close(&cf);
+        return NULL;
+    }
+
+    c = corpus_create(CORPUS_COUNTS, (int) cf->header.cls_cnt);
+    counts_close(&cf);
+    if (!c) {
+        return NULL;
+    }
+
+    c->counts = strdup(f_path);
+    if (!c->counts) {
+        corpus_free(&c);
+        return NULL;
+    }
+
+    return c;
+}
+
+
+void corpus_free(corpus **c) {
+    int cls;
+
+    if (!c || !(*c)) {
+        return;
+    }
+
+    for (cls = 0; (*c)->sources && cls < (*c)->cls_cnt; cls++) {
+        free((*c)->sources[cls]);
+    }
+    free((*c)->sources);
+    free((*c)->sources_cnt);
+    free((*c)->dir);
+    free((*c)->suffix);
+    vector_free(&(*c)->path);
+    dirwalk_close(&(*c)->walk);
+    if ((*c)->fp && (*c)->fp != stdin) {
+        fclose((*c)->fp);
+    }
+    if ((*c)->data) {
+        f_unmap((*c)->data, (*c)->size);
+    }
+    free((void *) (*c)->names);
+    free((void *) (*c)->words);
+    free((*c)->counts);
+    free(*c);
+    *c = NULL;
+}
+
+
+int corpus_is_cache(const corpus *c) {
+    if (!c) {
+        return 0;
+    }
+
+    return c->type == CORPUS_CACHE;
+}
+
+
+int corpus_is_counts(const corpus *c) {
+    if (!c) {
+        return 0;
+    }
+
+    return c->type == CORPUS_COUNTS;
+}
+
+
+/**
+ * \brief corpus_files_path Makes the path of the numbered file of the class (into the path of the corpus).
+ *                          Does not check arguments validity.
+ * \param c Pointer to a corpus of numbered files.
+ * \param cls Class of the file.
+ * \param number Number of the file.
+ * \return 1 if operation was successful, else 0.
+ */
+int corpus_files_path(corpus *c, const int cls, const size_t number) {
+    char digits[3 * sizeof(size_t) + 1];
+    const char sep = '/', end = '\0';
+
+    sprintf(digits, "%lu", (unsigned long) number);
+    c->path->count = 0;
+    if ((c->dir && (!vector_push_back_many(c->path, c->dir, strlen(c->dir)) || !vector_push_back(c->path, &sep))) ||
+        !vector_push_back_many(c->path, c->sources[cls], strlen(c->sources[cls])) ||
+        !vector_push_back_many(c->path, digits, strlen(digits)) ||
+        (c->suffix && !vector_push_back_many(c->path, c->suffix, strlen(c->suffix))) ||
+        !vector_push_back(c->path, &end)) {
+        return 0;
+    }
+
+    return 1;
+}
+
+
+/**
+ * \brief corpus_files_next Makes the path of the next numbered file.
+ *                          Does not check arguments validity.
+ * \param c Pointer to a corpus of numbered files.
+ * \param doc Pointer to where the document will be stored.
+ * \return 1 if the next document was read, 0 if there is not any more, -1 on failure.
+ */
+int corpus_files_next(corpus *c, corpus_doc *doc) {
+    size_t name_offset;
+
+    while (c->cls_next < c->cls_cnt && c->file_next >= c->sources_cnt[c->cls_next]) {
+        c->cls_next++;
+        c->file_next = 0;
+    }
+    if (c->cls_next == c->cls_cnt) {
+        return 0;
+    }
+
+    if (!corpus_files_path(c, c->cls_next, ++c->file_next)) {
+        return -1;
+    }
+    name_offset = c->dir ? strlen(c->dir) + 1 : 0;
+
+    doc->cls = c->cls_next;
+    doc->path = (char *) c->path->data;
+    doc->name = doc->path + name_offset;
+
+    return 1;
+}
+
+
+/**
+ * \brief corpus_dirs_next Finds the next regular file of the directory trees.
+ *                         Does not check arguments validity.
+ * \param c Pointer to a corpus of directory trees.
+ * \param doc Pointer to where the document will be stored.
+ * \return 1 if the next document was read, 0 if there is not any more, -1 on failure.
+ */
+int corpus_dirs_next(corpus *c, corpus_doc *doc) {
+    const char *f_path = NULL;
+    int found;
+
+    while (c->cls_next < c->cls_cnt) {
+        if (!c->walk) {
+            c->walk = dirwalk_open(c->sources[c->cls_next]);
+            if (!c->walk) {
+                return -1;
+            }
+        }
+
+        found = dirwalk_next(c->walk, &f_path);
+        if (found) {
+            doc->cls = c->cls_next;
+            doc->path = doc->name = f_path;
+            return found;
+        }
+
+        dirwalk_close(&c->walk);
+        c->cls_next++;
+    }
+
+    return 0;
+}
+
+
+/**
+ * \brief corpus_manifest_next Reads the next non-empty line "<path>\t<label>" of the manifest.
+ *                             Does not check arguments validity.
+ * \param c Pointer to a corpus of a manifest.
+ * \param doc Pointer to where the document will be stored.
+ * \return 1 if the next document was read, 0 if there is not any more, -1 on failure (or unknown label).
+ */
+int corpus_manifest_next(corpus *c, corpus_doc *doc) {
+    char *line = NULL, *label = NULL;
+    char byte;
+    int ch, cls;
+
+    c->path->count = 0;
+    while ((ch = fgetc(c->fp)) != EOF) {
+        if (ch == '\n' || ch == '\r') {
+            if (vector_count(c->path)) {
+                break;
+            }
+            continue;
+        }
+        byte = (char) ch;
+        if (!vector_push_back(c->path, &byte)) {
+            return -1;
+        }
+    }
+    if (ferror(c->fp)) {
+        return -1;
+    }
+    if (!vector_count(c->path)) {
+        return 0;
+    }
+
+    byte = '\0';
+    if (!vector_push_back(c->path, &byte)) {
+        return -1;
+    }
+    line = (char *) c->path->data;
+
+    doc->cls = -1;
+    label = strrchr(line, '\t');
+    if (label) {
+        *label++ = '\0';
+        for (cls = 0; cls < c->cls_cnt && strcmp(label, c->labels[cls]) != 0; cls++) {
+            ;
+        }
+        if (cls == c->cls_cnt) {
+            return -1;
+        }
+        doc->cls = cls;
+    }
+    doc->path = doc->name = line;
+
+    return 1;
+}
+
+
+size_t corpus_text_size(corpus *c) {
+    size_t size, f;
+    int cls;
+
+    if (!c) {
+        return 0;
+    }
+
+    switch (c->type) {
+        case CORPUS_PACK:
+            return c->docs_offsets[c->docs_cnt];
+        case CORPUS_FILES:
+            size = 0;
+            for (cls = 0; cls < c->cls_cnt; cls++) {
+                for (f = 1; f <= c->sources_cnt[cls]; f++) {
+                    if (!corpus_files_path(c, cls, f)) {
+                        return 0;
+                    }
+                    size += f_size((const char *) c->path->data);
+                }
+            }
+            return size;
+        default:
+            return 0;
+    }
+}
+
+
+int corpus_next(corpus *c, corpus_doc *doc) {
+    int found;
+
+    if (!c || !doc) {
+        return -1;
+    }
+
+    doc->path = doc->text = NULL;
+    doc->text_size = 0;
+    doc->words = NULL;
+    doc->words_cnt = 0;
+    switch (c->type) {
+        case CORPUS_FILES:
+            found = corpus_files_next(c, doc);
+            break;
+        case CORPUS_DIRS:
+            found = corpus_dirs_next(c, doc);
+            break;
+        case CORPUS_MANIFEST:
+            found = corpus_manifest_next(c, doc);
+            break;
+        default:
+            found = c->docs_next < c->docs_cnt;
+            if (!found) {
+                break;
+            }
+            doc->cls = (int) c->docs_cls[c->docs_next];
+            doc->name = c->names[c->docs_next];
+            if (c->type == CORPUS_PACK) {
+                doc->text = c->texts + c->docs_offsets[c->docs_next];
+                doc->text_size = c->docs_offsets[c->docs_next + 1] - c->docs_offsets[c->docs_next];
+            }
+            else {
+                doc->words = c->ids + c->docs_offsets[c->docs_next];
+                doc->words_cnt = c->docs_offsets[c->docs_next + 1] - c->docs_offsets[c->docs_next];
+            }
+    }
+
+    if (found == 1) {
+        c->docs_next++;
+    }
+    return found;
+}
+
+
+int corpus_rewind(corpus *c) {
+    if (!c || c->type == CORPUS_COUNTS) {
+        return 0;
+    }
+
+    if (c->type == CORPUS_MANIFEST && fseek(c->fp, 0L, SEEK_SET) != 0) {
+        return 0;
+    }
+    dirwalk_close(&c->walk);
+    c->docs_next = 0;
+    c->cls_next = 0;
+    c->file_next = 0;
+
+    return 1;
+}
+
+
+/**
+ * \brief corpus_tokenize_doc Appends the indices of words of the document (text file or text of a pack)
+ *                            to the vocabulary, words not present in the vocabulary yet are added to it.
+ *                            Does not check arguments validity.
+ * \param doc Pointer to a document of text file or of a pack.
+ * \param words_index Hashtable of indices (of unsigned values) of words of the vocabulary.
+ * \param words Vector of chars, where new '\0' terminated words of the vocabulary will be appended.
+ * \param ids Vector of unsigned indices, where the indices of words of the document will be appended.
+ * \return 1 if operation was successful, else 0.
+ */
+int corpus_tokenize_doc(const corpus_doc *doc, htab_uint *words_index, vector *words, vector *ids) {
+    tokens t;
+    FILE *fp = NULL;
+    char *word = NULL;
+    unsigned *index = NULL;
+    unsigned new_index;
+
+    if (doc->path) {
+        fp = fopen(doc->path, "r");
+        if (!fp) {
+            return 0;
+        }
+        tokens_file(&t, fp);
+    }
+    else {
+        tokens_buffer(&t, doc->text, doc->text_size);
+    }
+
+    while ((word = tokens_next(&t))) {
+        index = htab_uint_ptrget(words_index, word);
+        if (!index) {
+            if (htab_uint_items_cnt(words_index) >= UINT_MAX) {
+                goto fail;
+            }
+            new_index = (unsigned) htab_uint_items_cnt(words_index);
+            if (!htab_uint_add(words_index, word, new_index) ||
+                !vector_push_back_many(words, word, strlen(word) + 1)) {
+                goto fail;
+            }
+            index = &new_index;
+        }
+        if (!vector_push_back(ids, index)) {
+            goto fail;
+        }
+        free(word);
+    }
+
+    return !fp || fclose(fp) != EOF;
+
+fail:
+    free(word);
+    if (fp) {
+        fclose(fp);
+    }
+    return 0;
+}
+
+
+/**
+ * \brief corpus_cache_section_write Writes the pack or cache section padded to a multiple of sizeof(size_t) bytes.
+ * \param fp File handle.
+ * \param data Section data.
+ * \param size Size of the section.
+ * \return 1 if operation was successful, else 0.
+ */
+int corpus_cache_section_write(FILE *fp, const void *data, const size_t size) {
+    const char padding[sizeof(size_t)] = {0};
+
+    if (size && fwrite(data, size, 1, fp) != 1) {
+        return 0;
+    }
+    if (corpus_cache_padded(size) > size && fwrite(padding, corpus_cache_padded(size) - size, 1, fp) != 1) {
+        return 0;
+    }
+
+    return 1;
+}
+
+
+int corpus_write_cache(corpus *c, const char f_path[]) {
+    corpus_cache_header header;
+    corpus_doc doc;
+    htab_uint *words_index = NULL;
+    vector *words = NULL, *names = NULL, *ids = NULL, *docs_offsets = NULL, *docs_cls = NULL;
+    FILE *fp = NULL;
+    size_t offset, cls;
+    int found;
+
+    if (!c || corpus_is_cache(c) || corpus_is_counts(c) || !f_path) {
+        return 0;
+    }
+
+    words_index = htab_uint_create(0);
+    words = vector_create(sizeof(char), NULL);
+    names = vector_create(sizeof(char), NULL);
+    ids = vector_create(sizeof(unsigned), NULL);
+    docs_offsets = vector_create(sizeof(size_t), NULL);
+    docs_cls = vector_create(sizeof(size_t), NULL);
+    if (!words_index || !words || !names || !ids || !docs_offsets || !docs_cls) {
+        goto fail;
+    }
+
+    while ((found = corpus_next(c, &doc)) == 1) {
+        offset = vector_count(ids);
+        cls = doc.cls;
+        if (doc.cls < 0 || !vector_push_back(docs_offsets, &offset) || !vector_push_back(docs_cls, &cls) ||
+            !corpus_tokenize_doc(&doc, words_index, words, ids) ||
+            !vector_push_back_many(names, doc.name, strlen(doc.name) + 1)) {
+            goto fail;
+        }
+    }
+    offset = vector_count(ids);
+    if (found == -1 || !vector_push_back(docs_offsets, &offset)) {
+        goto fail;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CORPUS_CACHE_MAGIC, sizeof(CORPUS_CACHE_MAGIC));
+    header.version = CORPUS_CACHE_VERSION;
+    header.cls_cnt = c->cls_cnt;
+    header.docs_cnt = vector_count(docs_cls);
+    header.words_cnt = htab_uint_items_cnt(words_index);
+    header.words_size = vector_count(words);
+    header.names_size = vector_count(names);
+    header.ids_cnt = vector_count(ids);
+
+    fp = fopen(f_path, "wb");
+    if (!fp ||
+        !corpus_cache_section_write(fp, &header, sizeof(header)) ||
+        !corpus_cache_section_write(fp, words->data, vector_count(words)) ||
+        !corpus_cache_section_write(fp, names->data, vector_count(names)) ||
+        !corpus_cache_section_write(fp, docs_offsets->data, vector_count(docs_offsets) * sizeof(size_t)) ||
+        !corpus_cache_section_write(fp, docs_cls->data, vector_count(docs_cls) * sizeof(size_t)) ||
+        !corpus_cache_section_write(fp, ids->data, vector_count(ids) * sizeof(unsigned))) {
+        goto fail;
+    }
+    if (fclose(fp) == EOF) {
+        fp = NULL;
+        goto fail;
+    }
+
+    vector_free(&docs_cls); vector_free(&docs_offsets);
+    vector_free(&ids); vector_free(&names); vector_free(&words);
+    htab_uint_free(&words_index);
+    return 1;
+
+fail:
+    if (fp) {
+        fclose(fp);
+    }
+    vector_free(&docs_cls); vector_free(&docs_offsets);
+    vector_free(&ids); vector_free(&names); vector_free(&words);
+    htab_uint_free(&words_index);
+    return 0;
+}
+
+
+/**
+ * \brief corpus_pack_text_write Writes the text of the document (text file or text of a pack) into the pack.
+ *                              Does not check arguments validity.
+ * \param fp Pack file handle.
+ * \param doc Pointer to a document of text file or of a pack.
+ * \param buf Buffer of CORPUS_PACK_COPY_SIZE bytes, through which the text file is copied.
+ * \param size Pointer to where the size of the text will be stored.
+ * \return 1 if operation was successful, else 0.
+ */
+int corpus_pack_text_write(FILE *fp, const corpus_doc *doc, char *buf, size_t *size) {
+    FILE *f_in = NULL;
+    size_t read;
+
+    if (!doc->path) {
+        *size = doc->text_size;
+        return !doc->text_size || fwrite(doc->text, doc->text_size, 1, fp) == 1;
+    }
+
+    f_in = fopen(doc->path, "rb");
+    if (!f_in) {
+        return 0;
+    }
+
+    *size = 0;
+    while ((read = fread(buf, 1, CORPUS_PACK_COPY_SIZE, f_in)) > 0) {
+        if (fwrite(buf, read, 1, fp) != 1) {
+            fclose(f_in);
+            return 0;
+        }
+        *size += read;
+    }
+    if (ferror(f_in)) {
+        fclose(f_in);
+        return 0;
+    }
+
+    return fclose(f_in) != EOF;
+}
+
+
+int corpus_write_pack(corpus *c, const char f_path[]) {
+    corpus_pack_header header;
+    corpus_doc doc;
+    vector *names = NULL, *docs_offsets = NULL, *docs_cls = NULL;
+    FILE *fp = NULL;
+    char *buf = NULL;
+    size_t offset, size, cls;
+    int found;
+
+    if (!c || corpus_is_cache(c) || corpus_is_counts(c) || !f_path) {
+        return 0;
+    }
+
+    names = vector_create(sizeof(char), NULL);
+    docs_offsets = vector_create(sizeof(size_t), NULL);
+    docs_cls = vector_create(sizeof(size_t), NULL);
+    buf = (char *) malloc(CORPUS_PACK_COPY_SIZE);
+    if (!names || !docs_offsets || !docs_cls || !buf) {
+        goto fail;
+    }
+
+    /* texts are streamed right after the header, which is rewritten once their sizes are known */
+    memset(&header, 0, sizeof(header));
+    fp = fopen(f_path, "wb");
+    if (!fp || !corpus_cache_section_write(fp, &header, sizeof(header))) {
+        goto fail;
+    }
+
+    offset = 0;
+    while ((found = corpus_next(c, &doc)) == 1) {
+        cls = doc.cls;
+        if (doc.cls < 0 || !vector_push_back(docs_offsets, &offset) || !vector_push_back(docs_cls, &cls) ||
+            !corpus_pack_text_write(fp, &doc, buf, &size) ||
+            !vector_push_back_many(names, doc.name, strlen(doc.name) + 1)) {
+            goto fail;
+        }
+        offset += size;
+    }
+    if (found == -1 || !vector_push_back(docs_offsets, &offset)) {
+        goto fail;
+    }
+
+    memcpy(header.magic, CORPUS_PACK_MAGIC, sizeof(CORPUS_PACK_MAGIC));
+    header.version = CORPUS_PACK_VERSION;
+    header.cls_cnt = c->cls_cnt;
+    header.docs_cnt = vector_count(docs_cls);
+    header.texts_size = offset;
+    header.names_size = vector_count(names);
+
+    memset(buf, 0, sizeof(size_t));
+    if ((corpus_cache_padded(offset) > offset && fwrite(buf, corpus_cache_padded(offset) - offset, 1, fp) != 1) ||
+        !corpus_cache_section_write(fp, names->data, vector_count(names)) ||
+        !corpus_cache_section_write(fp, docs_offsets->data, vector_count(docs_offsets) * sizeof(size_t)) ||
+        !corpus_cache_section_write(fp, docs_cls->data, vector_count(docs_cls) * sizeof(size_t)) ||
+        fseek(fp, 0, SEEK_SET) != 0 ||
+        !corpus_cache_section_write(fp, &header, sizeof(header))) {
+        goto fail;
+    }
+    if (fclose(fp) == EOF) {
+        fp = NULL;
+        goto fail;
+    }
+
+    free(buf);
+    vector_free(&docs_cls); vector_free(&docs_offsets); vector_free(&names);
+    return 1;
+
+fail:
+    if (fp) {
+        fclose(fp);
+    }
+    free(buf);
+    vector_free(&docs_cls); vector_free(&docs_offsets); vector_free(&names);
+    return 0;
+}
@@ -0,0 +1,278 @@
+/**
+ * \file corpus.h
+ * \brief Header file related to corpora of labeled documents.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Corpus is a sequence of text files given by numbered file patterns, directory trees of classes
+ * or a manifest of (path, label) lines, or a pack or pre-tokenized cache file mapped into memory.
+ * Documents are read one by one, paths of text files are made (read) only when the document is reached.
+ * Pack holds the texts of all documents concatenated into one blob, together with their offsets,
+ * classes and names, so that no file is opened per document.
+ * Cache holds the vocabulary of the corpus and the documents as arrays of indices
+ * of their words to the vocabulary, together with their classes and names.
+ * Counts file holds the counts of words of documents already learnt (see counts.h), but not the documents.
+ */
+
+
+#ifndef CORPUS_H
+#define CORPUS_H
+
+
+#include <stdio.h>
+
+#include "structures/vector.h"
+#include "utilities/dirwalk.h"
+
+
+/** \brief Magic bytes at the start of a corpus pack file. */
+#define CORPUS_PACK_MAGIC "SPAMIDP"
+/** \brief Version of the corpus pack file format. */
+#define CORPUS_PACK_VERSION 1
+/** \brief Magic bytes at the start of a corpus cache file. */
+#define CORPUS_CACHE_MAGIC "SPAMIDC"
+/** \brief Version of the corpus cache file format. */
+#define CORPUS_CACHE_VERSION 1
+
+
+/**
+ * \struct corpus_pack_header
+ * \brief Struct representing the header of a corpus pack file.
+ *
+ * Header is followed by the sections, each padded to a multiple of sizeof(size_t) bytes:
+ * texts (texts_size bytes of texts of all documents one after another), names (names_size bytes
+ * of '\0' terminated names), offsets of documents to the texts (docs_cnt + 1 of size_t)
+ * and classes of documents (docs_cnt of size_t).
+ * Numbers are stored in the native byte order, pack is not meant to be portable.
+ */
+typedef struct corpus_pack_header_ {
+    char magic[8];          /**< CORPUS_PACK_MAGIC. */
+    size_t version;         /**< CORPUS_PACK_VERSION. */
+    size_t cls_cnt;         /**< Number of classes. */
+    size_t docs_cnt;        /**< Number of documents. */
+    size_t texts_size;      /**< Size of the texts section. */
+    size_t names_size;      /**< Size of the names section. */
+} corpus_pack_header;
+
+
+/**
+ * \struct corpus_cache_header
+ * \brief Struct representing the header of a corpus cache file.
+ *
+ * Header is followed by the sections, each padded to a multiple of sizeof(size_t) bytes:
+ * words (words_size bytes of '\0' terminated words), names (names_size bytes of '\0' terminated names),
+ * offsets of documents to the indices (docs_cnt + 1 of size_t), classes of documents (docs_cnt of size_t)
+ * and indices of words of all documents to the vocabulary (ids_cnt of unsigned).
+ * Numbers are stored in the native byte order, cache is not meant to be portable.
+ */
+typedef struct corpus_cache_header_ {
+    char magic[8];          /**< CORPUS_CACHE_MAGIC. */
+    size_t version;         /**< CORPUS_CACHE_VERSION. */
+    size_t cls_cnt;         /**< Number of classes. */
+    size_t docs_cnt;        /**< Number of documents. */
+    size_t words_cnt;       /**< Number of words of the vocabulary. */
+    size_t words_size;      /**< Size of the words section. */
+    size_t names_size;      /**< Size of the names section. */
+    size_t ids_cnt;         /**< Number of indices of words of all documents. */
+} corpus_cache_header;
+
+
+/**
+ * \brief Kinds of corpora.
+ */
+typedef enum corpus_type_ {
+    CORPUS_FILES,       /**< Numbered text files of file patterns of classes. */
+    CORPUS_DIRS,        /**< Text files of directory trees of classes. */
+    CORPUS_MANIFEST,    /**< Text files of lines "<path>\t<label>" of a manifest file. */
+    CORPUS_PACK,        /**< Pack file of texts of documents. */
+    CORPUS_CACHE,       /**< Pre-tokenized cache file. */
+    CORPUS_COUNTS       /**< Counts file of words of documents (no documents are read). */
+} corpus_type;
+
+
+/**
+ * \struct corpus_doc
+ * \brief Struct representing a document of a corpus.
+ *        Strings and words of the document are valid until the next document is read.
+ */
+typedef struct corpus_doc_ {
+    int cls;                    /**< Class of the document, or -1 if it is not labeled (manifest). */
+    const char *name;           /**< Name of the document (file name without dir prefix, path otherwise). */
+    const char *path;           /**< Path to the text file of the document (NULL in a pack or a cache). */
+    const char *text;           /**< Text of the document (NULL if not in a pack). */
+    size_t text_size;           /**< Size of the text of the document (0 if not in a pack). */
+    const unsigned *words;      /**< Indices of words of the document to the vocabulary (NULL if not in a cache). */
+    size_t words_cnt;           /**< Number of words of the document (0 if not in a cache). */
+} corpus_doc;
+
+
+/**
+ * \struct corpus
+ * \brief Struct representing a corpus of labeled documents.
+ */
+typedef struct corpus_ {
+    corpus_type type;           /**< Kind of the corpus. */
+    int cls_cnt;                /**< Number of classes. */
+    size_t docs_cnt;            /**< Number of documents if known in advance (numbered files, pack, cache), else 0. */
+    size_t docs_next;           /**< Index of the next document. */
+
+    const char **words;         /**< Vocabulary of a cache (NULL if not a cache). */
+    size_t words_cnt;           /**< Number of words of the vocabulary. */
+
+    char **sources;             /**< File patterns or directories of classes (numbered files, directory trees). */
+    size_t *sources_cnt;        /**< Numbers of files of file patterns (numbered files). */
+    char *dir;                  /**< Directory of numbered files, or NULL. */
+    char *suffix;               /**< Suffix of numbered files, or NULL. */
+    int cls_next;               /**< Class of the next document (numbered files, directory trees). */
+    size_t file_next;           /**< Number of the next file of the class minus 1 (numbered files). */
+    vector *path;               /**< Path to the current text file (numbered files, manifest). */
+    dirwalk *walk;              /**< Walk through the directory tree of the current class (directory trees). */
+
+    FILE *fp;                   /**< Manifest file handle. */
+    const char **labels;        /**< Labels of classes in the manifest. */
+
+    void *data;                 /**< Mapped pack or cache file (NULL if neither). */
+    size_t size;                /**< Size of the mapped pack or cache file. */
+    const char **names;         /**< Names of documents of a pack or a cache. */
+    const size_t *docs_offsets; /**< Offsets of documents to the texts of a pack or to the indices of words of a cache. */
+    const size_t *docs_cls;     /**< Classes of documents of a pack or a cache. */
+    const char *texts;          /**< Texts of all documents of a pack. */
+    const unsigned *ids;        /**< Indices of words of all documents of a cache. */
+
+    char *counts;               /**< Path to a counts file (NULL if not a counts file). */
+} corpus;
+
+
+/**
+ * \brief corpus_create_files Creates a corpus of text files "dir/<pattern><number><suffix>",
+ *                            numbered from 1 to the count of the pattern.
+ *                            Documents of the pattern p belong to the class p.
+ * \param dir Directory, or NULL.
+ * \param f_patterns Array of file patterns.
+ * \param f_counts Array of numbers of files of a pattern.
+ * \param f_patterns_cnt Number of file patterns (classes).
+ * \param suffix File suffix, or NULL.
+ * \return Pointer to a corpus, or NULL on failure.
+ */
+corpus *corpus_create_files(const char dir[], const char *f_patterns[], const size_t f_counts[],
+                            const int f_patterns_cnt, const char suffix[]);
+
+
+/**
+ * \brief corpus_create_dirs Creates a corpus of regular files of directory trees (e.g. maildirs).
+ *                           Documents of the directory tree d belong to the class d.
+ * \param dirs Array of root directories.
+ * \param dirs_cnt Number of root directories (classes).
+ * \return Pointer to a corpus, or NULL on failure.
+ */
+corpus *corpus_create_dirs(const char *dirs[], const int dirs_cnt);
+
+
+/**
+ * \brief corpus_open_manifest Opens a corpus of text files listed by the manifest file,
+ *                             one "<path>\t<label>" line per file (label is optional).
+ *                             Lines are read one by one, while the documents are reached.
+ * \param f_path Path to the manifest file, or "-" for the standard input.
+ * \param labels Array of labels of classes, which must outlive the corpus.
+ * \param cls_cnt Number of classes.
+ * \return Pointer to a corpus, or NULL if the manifest could not be opened.
+ */
+corpus *corpus_open_manifest(const char f_path[], const char *labels[], const int cls_cnt);
+
+
+/**
+ * \brief corpus_open_pack Maps the corpus pack file into memory and checks its consistency.
+ * \param f_path Path to the pack file.
+ * \return Pointer to a corpus, or NULL if the pack could not be mapped or is not valid.
+ */
+corpus *corpus_open_pack(const char f_path[]);
+
+
+/**
+ * \brief corpus_open_cache Maps the corpus cache file into memory and checks its consistency.
+ * \param f_path Path to the cache file.
+ * \return Pointer to a corpus, or NULL if the cache could not be mapped or is not valid.
+ */
+corpus *corpus_open_cache(const char f_path[]);
+
+
+/**
+ * \brief corpus_open_counts Opens the corpus of the counts file, which has no documents to be read,
+ *                           its counts are learnt by the classifier at once (see nbc_learn_counts).
+ * \param f_path Path to the counts file.
+ * \return Pointer to a corpus, or NULL if the counts file could not be opened or is not valid.
+ */
+corpus *corpus_open_counts(const char f_path[]);
+
+
+/**
+ * \brief corpus_free Releases the memory held by the corpus (closes its files, unmaps the cache)
+ *                    and NULLs the pointer to it.
+ * \param c Pointer to a pointer to a corpus.
+ */
+void corpus_free(corpus **c);
+
+
+/**
+ * \brief corpus_text_size Finds out the total size of the texts of the documents without reading them
+ *                         (sizes of the numbered files, texts of a pack). Call it before reading the documents.
+ * \param c Pointer to a corpus.
+ * \return Total size of the texts, or 0 if it is not known in advance (directory trees, manifest, cache).
+ */
+size_t corpus_text_size(corpus *c);
+
+
+/**
+ * \brief corpus_is_cache Finds out whether the corpus is a pre-tokenized cache.
+ * \param c Pointer to a corpus.
+ * \return 1 if the corpus is a cache, else 0.
+ */
+int corpus_is_cache(const corpus *c);
+
+
+/**
+ * \brief corpus_is_counts Finds out whether the corpus is a counts file.
+ * \param c Pointer to a corpus.
+ * \return 1 if the corpus is a counts file, else 0.
+ */
+int corpus_is_counts(const corpus *c);
+
+
+/**
+ * \brief corpus_next Reads the next document of the corpus.
+ * \param c Pointer to a corpus.
+ * \param doc Pointer to where the document will be stored.
+ * \return 1 if the next document was read, 0 if there is not any more, -1 on failure.
+ */
+int corpus_next(corpus *c, corpus_doc *doc);
+
+
+/**
+ * \brief corpus_rewind Makes the corpus read its documents again from the first one.
+ * \param c Pointer to a corpus of documents (not a counts file).
+ * \return 1 if the corpus was rewound, 0 if it could not be (e.g. a manifest of the standard input pipe).
+ */
+int corpus_rewind(corpus *c);
+
+
+/**
+ * \brief corpus_write_pack Writes the texts of the documents of the corpus one after another into the pack file,
+ *                          followed by their names, offsets and classes. Documents must be labeled.
+ * \param c Pointer to a corpus of text files or a pack, not read yet.
+ * \param f_path Path to the pack file.
+ * \return 1 if operation was successful, else 0.
+ */
+int corpus_write_pack(corpus *c, const char f_path[]);
+
+
+/**
+ * \brief corpus_write_cache Tokenizes the documents of the corpus and writes them into the cache file.
+ *                           Documents must be labeled.
+ * \param c Pointer to a corpus of text files or a pack, not read yet.
+ * \param f_path Path to the cache file.
+ * \return 1 if operation was successful, else 0.
+ */
+int corpus_write_cache(corpus *c, const char f_path[]);
+
+
+#endif
@@ -0,0 +1,562 @@
+/**
+ * \file counts.c
+ * \brief Functions declared in counts.h are implemented in this file.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Merged files are kept in a binary heap ordered by their current words,
+ * the counts of the least word are summed over the files at the top of the heap.
+ * Groups of files of a merge pass are merged by POSIX threads on Unix, elsewhere by the calling thread.
+ */
+
+
+#if defined(__unix__)
+#define _POSIX_C_SOURCE 200112L
+#define COUNTS_PTHREADS
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef COUNTS_PTHREADS
+#include <pthread.h>
+#endif
+
+#include "counts.h"
+#include "utilities/arrays.h"
+
+
+/** \brief Size of the stdio buffer of a counts file. */
+#define COUNTS_BUFFER_SIZE 65536
+/** \brief Default capacity of the buffer of a word. */
+#define COUNTS_DEF_WORD_CAP 64
+
+
+/**
+ * \struct counts_pass
+ * \brief Struct representing a merge pass of groups of files into temporary files, shared by its threads.
+ */
+typedef struct counts_pass_ {
+    const char **paths;         /**< Paths to the merged files. */
+    size_t paths_cnt;           /**< Number of the merged files. */
+    size_t group_size;          /**< Number of files of a group (but the last one). */
+    char **temp_paths;          /**< Paths to the temporary files of the groups. */
+    size_t groups_cnt;          /**< Number of the groups. */
+    size_t group_next;          /**< Index of the next group to be merged. */
+#ifdef COUNTS_PTHREADS
+    pthread_mutex_t lock;       /**< Lock of the next group and of the failure flag. */
+#endif
+    int failed;                 /**< Flag whether a merge of a group failed. */
+} counts_pass;
+
+
+/**
+ * \brief counts_file_create Creates a counts file struct of the classes, not open yet.
+ * \param cls_cnt Number of classes.
+ * \return Pointer to a counts file struct, or NULL on failure.
+ */
+counts_file *counts_file_create(const size_t cls_cnt) {
+    counts_file *cf = NULL;
+
+    cf = (counts_file *) calloc(1, sizeof(counts_file));
+    if (!cf) {
+        return NULL;
+    }
+
+    cf->word_cap = COUNTS_DEF_WORD_CAP;
+    cf->word = (char *) array_create(cf->word_cap, sizeof(char));
+    cf->cls_docs_cnt = (size_t *) array_create(cls_cnt, sizeof(size_t));
+    cf->counts = (size_t *) array_create(cls_cnt, sizeof(size_t));
+    if (!cf->word || !cf->cls_docs_cnt || !cf->counts) {
+        counts_close(&cf);
+        return NULL;
+    }
+
+    return cf;
+}
+
+
+/**
+ * \brief counts_word_fit Grows the buffer of a word to hold the size.
+ * \param word Pointer to the buffer of a word.
+ * \param cap Pointer to the capacity of the buffer.
+ * \param size Size to be held.
+ * \return 1 if operation was successful, else 0.
+ */
+int counts_word_fit(char **word, size_t *cap, const size_t size) {
+    char *new_word = NULL;
+    size_t new_cap;
+
+    if (size <= *cap) {
+        return 1;
+    }
+
+    for (new_cap = *cap ? *cap : COUNTS_DEF_WORD_CAP; new_cap < size; new_cap *= 2) {
+        ;
+    }
+    new_word = (char *) realloc(*word, new_cap);
+    if (!new_word) {
+        return 0;
+    }
+
+    *word = new_word;
+    *cap = new_cap;
+    return 1;
+}
+
+
+counts_file *counts_open(const char f_path[]) {
+    counts_header header;
+    counts_file *cf = NULL;
+    FILE *fp = NULL;
+
+    if (!f_path) {
+        return NULL;
+    }
+
+    fp = fopen(f_path, "rb");
+    if (!fp) {
+        return NULL;
+    }
+    if (fread(&header, sizeof(header), 1, fp) != 1 ||
+        memcmp(header.magic, COUNTS_MAGIC, sizeof(COUNTS_MAGIC)) != 0 || header.version != COUNTS_VERSION ||
+        header.cls_cnt == 0) {
+        fclose(fp);
+        return NULL;
+    }
+
+    cf = counts_file_create(header.cls_cnt);
+    if (!cf) {
+        fclose(fp);
+        return NULL;
+    }
+    cf->fp = fp;
+    cf->header = header;
+    setvbuf(cf->fp, NULL, _IOFBF, COUNTS_BUFFER_SIZE);
+    if (fread(cf->cls_docs_cnt, sizeof(size_t), header.cls_cnt, cf->fp) != header.cls_cnt) {
+        counts_close(&cf);
+        return NULL;
+    }
+
+    return cf;
+}
+
+
+counts_file *counts_create(const char f_path[], const size_t cls_cnt, const size_t model, const size_t ngram,
+                           const size_t cls_docs_cnt[]) {
+    counts_file *cf = NULL;
+
+    if (!f_path || !cls_cnt || !cls_docs_cnt) {
+        return NULL;
+    }
+
+    cf = counts_file_create(cls_cnt);
+    if (!cf) {
+        return NULL;
+    }
+
+    memset(&cf->header, 0, sizeof(cf->header));
+    memcpy(cf->header.magic, COUNTS_MAGIC, sizeof(COUNTS_MAGIC));
+    cf->header.version = COUNTS_VERSION;
+    cf->header.cls_cnt = cls_cnt;
+    cf->header.model = model;
+    cf->header.ngram = ngram;
+    memcpy(cf->cls_docs_cnt, cls_docs_cnt, cls_cnt * sizeof(size_t));
+
+    cf->writing = 1;
+    cf->fp = fopen(f_path, "wb");
+    if (!cf->fp) {
+        counts_close(&cf);
+        return NULL;
+    }
+    setvbuf(cf->fp, NULL, _IOFBF, COUNTS_BUFFER_SIZE);
+    if (fwrite(&cf->header, sizeof(cf->header), 1, cf->fp) != 1 ||
+        fwrite(cf->cls_docs_cnt, sizeof(size_t), cls_cnt, cf->fp) != cls_cnt) {
+        counts_close(&cf);
+        return NULL;
+    }
+
+    return cf;
+}
+
+
+int counts_next(counts_file *cf) {
+    size_t len;
+    int c;
+
+    if (!cf || cf->writing) {
+        return -1;
+    }
+    if (cf->words_next == cf->header.words_cnt) {
+        return 0;
+    }
+
+    for (len = 0; ; len++) {
+        c = getc(cf->fp);
+        if (c == EOF || !counts_word_fit(&cf->word, &cf->word_cap, len + 1)) {
+            return -1;
+        }
+        cf->word[len] = (char) c;
+        if (c == '\0') {
+            break;
+        }
+    }
+    if (fread(cf->counts, sizeof(size_t), cf->header.cls_cnt, cf->fp) != cf->header.cls_cnt) {
+        return -1;
+    }
+
+    cf->words_next++;
+    return 1;
+}
+
+
+int counts_write(counts_file *cf, const char *word, const size_t counts[]) {
+    size_t size;
+
+    if (!cf || !cf->writing || !word || !counts) {
+        return 0;
+    }
+
+    /* the previous word is kept in the buffer of the current word to check the order */
+    size = strlen(word) + 1;
+    if ((cf->header.words_cnt && strcmp(cf->word, word) >= 0) ||
+        fwrite(word, size, 1, cf->fp) != 1 ||
+        fwrite(counts, sizeof(size_t), cf->header.cls_cnt, cf->fp) != cf->header.cls_cnt ||
+        !counts_word_fit(&cf->word, &cf->word_cap, size)) {
+        return 0;
+    }
+    memcpy(cf->word, word, size);
+
+    cf->header.words_cnt++;
+    return 1;
+}
+
+
+int counts_close(counts_file **cf) {
+    int closed;
+
+    if (!cf || !(*cf)) {
+        return 0;
+    }
+
+    closed = 1;
+    if ((*cf)->fp) {
+        if ((*cf)->writing && (fseek((*cf)->fp, 0, SEEK_SET) != 0 ||
+                               fwrite(&(*cf)->header, sizeof((*cf)->header), 1, (*cf)->fp) != 1)) {
+            closed = 0;
+        }
+        if (fclose((*cf)->fp) == EOF) {
+            closed = 0;
+        }
+    }
+    else {
+        closed = 0;
+    }
+
+    array_free((void **) &(*cf)->word);
+    array_free((void **) &(*cf)->cls_docs_cnt);
+    array_free((void **) &(*cf)->counts);
+    free(*cf);
+    *cf = NULL;
+
+    return closed;
+}
+
+
+/**
+ * \brief counts_heap_down Moves the file at the position down the heap of files ordered by their current words.
+ * \param in Array of counts files.
+ * \param heap Heap of indices of the files.
+ * \param heap_cnt Number of files of the heap.
+ * \param pos Position of the moved file.
+ */
+void counts_heap_down(counts_file *in[], size_t heap[], const size_t heap_cnt, size_t pos) {
+    size_t child, tmp;
+
+    while ((child = 2 * pos + 1) < heap_cnt) {
+        if (child + 1 < heap_cnt && strcmp(in[heap[child + 1]]->word, in[heap[child]]->word) < 0) {
+            child++;
+        }
+        if (strcmp(in[heap[pos]]->word, in[heap[child]]->word) <= 0) {
+            break;
+        }
+        tmp = heap[pos]; heap[pos] = heap[child]; heap[child] = tmp;
+        pos = child;
+    }
+}
+
+
+/**
+ * \brief counts_merge_files Merges the open counts files into the counts file.
+ * \param in Array of counts files open for reading (at most COUNTS_MERGE_WAYS).
+ * \param in_cnt Number of the merged counts files.
+ * \param out_path Path to the merged counts file.
+ * \return 1 if operation was successful, else 0.
+ */
+int counts_merge_files(counts_file *in[], const size_t in_cnt, const char out_path[]) {
+    counts_file *out = NULL;
+    size_t heap[COUNTS_MERGE_WAYS];
+    size_t *docs_cnt = NULL, *sums = NULL;
+    char *word = NULL;
+    size_t f, cls, cls_cnt, heap_cnt, word_cap;
+    int read;
+
+    cls_cnt = in[0]->header.cls_cnt;
+    docs_cnt = (size_t *) array_create(cls_cnt, sizeof(size_t));
+    sums = (size_t *) array_create(cls_cnt, sizeof(size_t));
+    if (!docs_cnt || !sums) {
+        goto fail;
+    }
+    for (f = 0; f < in_cnt; f++) {
+        if (in[f]->header.cls_cnt != cls_cnt || in[f]->header.model != in[0]->header.model ||
+            in[f]->header.ngram != in[0]->header.ngram) {
+            goto fail;
+        }
+        for (cls = 0; cls < cls_cnt; cls++) {
+            docs_cnt[cls] += in[f]->cls_docs_cnt[cls];
+        }
+    }
+
+    out = counts_create(out_path, cls_cnt, in[0]->header.model, in[0]->header.ngram, docs_cnt);
+    if (!out) {
+        goto fail;
+    }
+
+    for (f = 0, heap_cnt = 0; f < in_cnt; f++) {
+        read = counts_next(in[f]);
+        if (read == -1) {
+            goto fail;
+        }
+        if (read) {
+            heap[heap_cnt++] = f;
+        }
+    }
+    for (f = heap_cnt / 2; f > 0; f--) {
+        counts_heap_down(in, heap, heap_cnt, f - 1);
+    }
+
+    word_cap = 0;
+    while (heap_cnt) {
+        if (!counts_word_fit(&word, &word_cap, strlen(in[heap[0]]->word) + 1)) {
+            goto fail;
+        }
+        strcpy(word, in[heap[0]]->word);
+        memset(sums, 0, cls_cnt * sizeof(size_t));
+
+        while (heap_cnt && strcmp(in[heap[0]]->word, word) == 0) {
+            for (cls = 0; cls < cls_cnt; cls++) {
+                sums[cls] += in[heap[0]]->counts[cls];
+            }
+            read = counts_next(in[heap[0]]);
+            if (read == -1) {
+                goto fail;
+            }
+            if (!read) {
+                heap[0] = heap[--heap_cnt];
+            }
+            counts_heap_down(in, heap, heap_cnt, 0);
+        }
+
+        if (!counts_write(out, word, sums)) {
+            goto fail;
+        }
+    }
+
+    free(word);
+    array_free((void **) &sums);
+    array_free((void **) &docs_cnt);
+    return counts_close(&out);
+
+fail:
+    free(word);
+    array_free((void **) &sums);
+    array_free((void **) &docs_cnt);
+    counts_close(&out);
+    return 0;
+}
+
+
+/**
+ * \brief counts_merge_group Merges at most COUNTS_MERGE_WAYS counts files into one at once.
+ * \param in_paths Paths to the merged counts files.
+ * \param in_cnt Number of the merged counts files.
+ * \param out_path Path to the merged counts file.
+ * \return 1 if operation was successful, else 0.
+ */
+int counts_merge_group(const char *in_paths[], const size_t in_cnt, const char out_path[]) {
+    counts_file *in[COUNTS_MERGE_WAYS];
+    size_t f;
+    int merged;
+
+    for (f = 0; f < in_cnt; f++) {
+        in[f] = counts_open(in_paths[f]);
+        if (!in[f]) {
+            break;
+        }
+    }
+    merged = f == in_cnt && counts_merge_files(in, in_cnt, out_path);
+    while (f > 0) {
+        counts_close(&in[--f]);
+    }
+
+    return merged;
+}
+
+
+/**
+ * \brief counts_temps_free Removes the temporary counts files of a merge pass and releases their paths.
+ * \param temp_paths Pointer to an array of paths to the temporary files (or NULLs).
+ * \param temps_cnt Number of the temporary files.
+ */
+void counts_temps_free(char ***temp_paths, const size_t temps_cnt) {
+    size_t f;
+
+    if (!(*temp_paths)) {
+        return;
+    }
+
+    for (f = 0; f < temps_cnt; f++) {
+        if ((*temp_paths)[f]) {
+            remove((*temp_paths)[f]);
+        }
+        free((*temp_paths)[f]);
+    }
+    free(*temp_paths);
+    *temp_paths = NULL;
+}
+
+
+/**
+ * \brief counts_pass_next Takes the next group of the merge pass, unless the pass has failed.
+ * \param pass Pointer to a merge pass.
+ * \param failed Flag whether the merge of the previous group failed.
+ * \return Index of the group, or the number of the groups if there are no more.
+ */
+size_t counts_pass_next(counts_pass *pass, const int failed) {
+    size_t group;
+
+#ifdef COUNTS_PTHREADS
+    pthread_mutex_lock(&pass->lock);
+#endif
+    if (failed) {
+        pass->failed = 1;
+    }
+    group = pass->failed ? pass->groups_cnt : pass->group_next++;
+    if (group > pass->groups_cnt) {
+        group = pass->groups_cnt;
+    }
+#ifdef COUNTS_PTHREADS
+    pthread_mutex_unlock(&pass->lock);
+#endif
+
+    return group;
+}
+
+
+/**
+ * \brief counts_pass_run Merges the groups of the merge pass until there are none left.
+ * \param arg Pointer to a merge pass.
+ * \return NULL.
+ */
+void *counts_pass_run(void *arg) {
+    counts_pass *pass = (counts_pass *) arg;
+    size_t group, group_cnt;
+    int failed;
+
+    failed = 0;
+    while ((group = counts_pass_next(pass, failed)) < pass->groups_cnt) {
+        group_cnt = group + 1 < pass->groups_cnt ? pass->group_size : pass->paths_cnt - group * pass->group_size;
+        failed = !counts_merge_group(pass->paths + group * pass->group_size, group_cnt, pass->temp_paths[group]);
+    }
+
+    return NULL;
+}
+
+
+/**
+ * \brief counts_pass_merge Merges the groups of the merge pass by the threads.
+ *                          Does not check arguments validity.
+ * \param pass Pointer to a merge pass.
+ * \param threads_cnt Number of threads.
+ * \return 1 if operation was successful, else 0.
+ */
+int counts_pass_merge(counts_pass *pass, const size_t threads_cnt) {
+#ifdef COUNTS_PTHREADS
+    pthread_t threads[COUNTS_MAX_THREADS];
+    size_t t, started;
+
+    if (pthread_mutex_init(&pass->lock, NULL) != 0) {
+        return 0;
+    }
+    for (started = 0; started < threads_cnt && started < pass->groups_cnt; started++) {
+        if (pthread_create(&threads[started], NULL, counts_pass_run, pass) != 0) {
+            break;
+        }
+    }
+    /* groups are merged by the calling thread if no thread could be started */
+    if (!started) {
+        counts_pass_run(pass);
+    }
+    for (t = 0; t < started; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    pthread_mutex_destroy(&pass->lock);
+#else
+    (void) threads_cnt;
+    counts_pass_run(pass);
+#endif
+
+    return !pass->failed;
+}
+
+
+int counts_merge(const char *in_paths[], const size_t in_cnt, const char out_path[], const size_t threads_cnt) {
+    counts_pass pass;
+    const char **paths = NULL;
+    char **temp_paths = NULL;
+    size_t f, paths_cnt, pass_number;
+    int merged;
+
+    if (!in_paths || !in_cnt || !out_path || !threads_cnt || threads_cnt > COUNTS_MAX_THREADS) {
+        return 0;
+    }
+
+    /* each pass merges groups of the files of the previous one into temporary files "<out-file>.<pass>.<group>",
+       with more threads the files are split into a group per thread, so that the last merge is threads-way */
+    paths = in_paths;
+    paths_cnt = in_cnt;
+    merged = 1;
+    for (pass_number = 0;
+         merged && (paths_cnt > COUNTS_MERGE_WAYS || (threads_cnt > 1 && paths_cnt >= 2 * threads_cnt));
+         pass_number++) {
+        pass.paths = paths;
+        pass.paths_cnt = paths_cnt;
+        pass.group_size = threads_cnt > 1 ? (paths_cnt + threads_cnt - 1) / threads_cnt : COUNTS_MERGE_WAYS;
+        if (pass.group_size > COUNTS_MERGE_WAYS) {
+            pass.group_size = COUNTS_MERGE_WAYS;
+        }
+        pass.groups_cnt = (paths_cnt + pass.group_size - 1) / pass.group_size;
+        pass.group_next = 0;
+        pass.failed = 0;
+        pass.temp_paths = (char **) calloc(pass.groups_cnt, sizeof(char *));
+        merged = pass.temp_paths != NULL;
+        for (f = 0; f < pass.groups_cnt && merged; f++) {
+            pass.temp_paths[f] = (char *) malloc(strlen(out_path) + 48);
+            merged = pass.temp_paths[f] != NULL;
+            if (merged) {
+                sprintf(pass.temp_paths[f], "%s.%lu.%lu", out_path, (unsigned long) pass_number, (unsigned long) f);
+            }
+        }
+        merged = merged && counts_pass_merge(&pass, threads_cnt);
+
+        counts_temps_free(&temp_paths, paths_cnt);
+        temp_paths = pass.temp_paths;
+        paths = (const char **) temp_paths;
+        paths_cnt = pass.groups_cnt;
+    }
+    merged = merged && counts_merge_group(paths, paths_cnt, out_path);
+
+    counts_temps_free(&temp_paths, paths_cnt);
+    return merged;
+}
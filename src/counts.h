@@ -0,0 +1,131 @@
+/**
+ * \file counts.h
+ * \brief Header file related to counts files of words of documents of classes.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Counts file holds what a classifier learns of documents: numbers of documents of classes
+ * and numbers of occurences of words (dictionary keys of features) in classes, sorted by the words.
+ * It is written and read record by record, so it may hold more words than fit in memory.
+ * Sorted counts files (e.g. runs of counts spilled to disk while counting a large corpus)
+ * are merged into one by a k-way merge, the counts of the same word are summed.
+ */
+
+
+#ifndef COUNTS_H
+#define COUNTS_H
+
+
+#include <stdio.h>
+
+
+/** \brief Magic bytes at the start of a counts file. */
+#define COUNTS_MAGIC "SPAMIDN"
+/** \brief Version of the counts file format. */
+#define COUNTS_VERSION 1
+/** \brief Maximal number of counts files merged at once, more are merged in several passes. */
+#define COUNTS_MERGE_WAYS 64
+/** \brief Maximal number of threads of a merge. */
+#define COUNTS_MAX_THREADS 64
+
+
+/**
+ * \struct counts_header
+ * \brief Struct representing the header of a counts file.
+ *
+ * Header is followed by the numbers of documents of classes (cls_cnt of size_t)
+ * and by words_cnt records of a '\0' terminated word and its counts in classes (cls_cnt of size_t),
+ * in the ascending order of the words (strcmp).
+ * Numbers are stored in the native byte order, counts file is not meant to be portable.
+ */
+typedef struct counts_header_ {
+    char magic[8];          /**< COUNTS_MAGIC. */
+    size_t version;         /**< COUNTS_VERSION. */
+    size_t cls_cnt;         /**< Number of classes. */
+    size_t model;           /**< Event model of the counts (see nbc_model). */
+    size_t ngram;           /**< Maximal order of word n-grams counted besides words. */
+    size_t words_cnt;       /**< Number of words (records). */
+} counts_header;
+
+
+/**
+ * \struct counts_file
+ * \brief Struct representing a counts file open for reading or writing.
+ */
+typedef struct counts_file_ {
+    FILE *fp;                   /**< File handle. */
+    int writing;                /**< Flag whether the file is written. */
+    counts_header header;       /**< Header of the file (words_cnt counts the written words while writing). */
+    size_t *cls_docs_cnt;       /**< Numbers of documents of classes. */
+    size_t words_next;          /**< Index of the next word to be read. */
+    char *word;                 /**< Current word (read). */
+    size_t word_cap;            /**< Capacity of the buffer of the current word. */
+    size_t *counts;             /**< Counts of the current word in classes (read). */
+} counts_file;
+
+
+/**
+ * \brief counts_open Opens the counts file for reading and reads its header.
+ * \param f_path Path to the counts file.
+ * \return Pointer to an open counts file, or NULL if it could not be opened or is not valid.
+ */
+counts_file *counts_open(const char f_path[]);
+
+
+/**
+ * \brief counts_create Creates the counts file for writing and writes its header.
+ * \param f_path Path to the counts file.
+ * \param cls_cnt Number of classes.
+ * \param model Event model of the counts.
+ * \param ngram Maximal order of word n-grams counted besides words.
+ * \param cls_docs_cnt Numbers of documents of classes.
+ * \return Pointer to a counts file open for writing, or NULL on failure.
+ */
+counts_file *counts_create(const char f_path[], const size_t cls_cnt, const size_t model, const size_t ngram,
+                           const size_t cls_docs_cnt[]);
+
+
+/**
+ * \brief counts_next Reads the next word and its counts (into word and counts of the counts file).
+ * \param cf Pointer to a counts file open for reading.
+ * \return 1 if the next word was read, 0 if there is not any more, -1 on failure.
+ */
+int counts_next(counts_file *cf);
+
+
+/**
+ * \brief counts_write Writes the word and its counts, words must be written in the ascending order.
+ * \param cf Pointer to a counts file open for writing.
+ * \param word Word.
+ * \param counts Counts of the word in classes.
+ * \return 1 if operation was successful, else 0.
+ */
+int counts_write(counts_file *cf, const char *word, const size_t counts[]);
+
+
+/**
+ * \brief counts_close Closes the counts file (a written one gets the final number of words in its header),
+ *                     releases the memory held by it and NULLs the pointer to it.
+ * \param cf Pointer to a pointer to a counts file.
+ * \return 1 if the file was written and closed successfully, else 0.
+ */
+int counts_close(counts_file **cf);
+
+
+/**
+ * \brief counts_merge Merges the counts files (of the same classes, model and n-grams) into one,
+ *                     summing the counts of the same words and the numbers of documents.
+ *                     More than COUNTS_MERGE_WAYS files are merged in passes through temporary files
+ *                     "<out-file>.<pass>.<number>", which are removed.
+ *                     With more threads, the groups of files of a pass are merged by the threads at once
+ *                     (at least two files per thread, Unix only), the last pass merges the results of the threads.
+ * \param in_paths Paths to the merged counts files.
+ * \param in_cnt Number of the merged counts files.
+ * \param out_path Path to the merged counts file.
+ * \param threads_cnt Number of threads (at most COUNTS_MAX_THREADS).
+ * \return 1 if operation was successful, else 0.
+ */
+int counts_merge(const char *in_paths[], const size_t in_cnt, const char out_path[], const size_t threads_cnt);
+
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * \file evaluation.c
+ * \brief Functions declared in evaluation.h are implemented in this file.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Documents scored once by a margin (log10 odds of the positive class)
+ * are evaluated for all decision thresholds in one sweep over the sorted margins.
+ */
+
+
+#include <stdlib.h>
+
+#include "evaluation.h"
+
+
+/** \brief Header of the table of evaluated thresholds. */
+#define EVAL_HEADER "threshold\tprecision\trecall\tfpr\ttp\tfp\tfn\ttn\n"
+/** \brief Format of one line of the table of evaluated thresholds. */
+#define EVAL_LINE_FORMAT "%.6f\t%.6f\t%.6f\t%.6f\t%lu\t%lu\t%lu\t%lu\n"
+
+
+/**
+ * \brief cmp_eval_score_desc Compares the scored documents by margin in descending order.
+ * \param value1 Pointer to the first scored document.
+ * \param value2 Pointer to the second scored document.
+ * \return -1 if value1 has greater margin than value2, 1 if lower, 0 if equal.
+ */
+int cmp_eval_score_desc(const void *value1, const void *value2) {
+    if (((eval_score *) value1)->margin > ((eval_score *) value2)->margin) {
+        return -1;
+    }
+    else if (((eval_score *) value1)->margin < ((eval_score *) value2)->margin) {
+        return 1;
+    }
+    else {
+        return 0;
+    }
+}
+
+
+/**
+ * \brief eval_ratio Computes the ratio of the numbers.
+ * \param num Numerator.
+ * \param den Denominator.
+ * \return num / den, or 0 if den is 0.
+ */
+double eval_ratio(const size_t num, const size_t den) {
+    return den ? (double) num / den : 0;
+}
+
+
+int eval_sweep(eval_score scores[], const size_t scores_cnt, FILE *fp) {
+    size_t positives_cnt, tp, fp_cnt;
+    size_t s;
+
+    if (!scores || !fp) {
+        return 0;
+    }
+
+    qsort(scores, scores_cnt, sizeof(eval_score), cmp_eval_score_desc);
+
+    positives_cnt = 0;
+    for (s = 0; s < scores_cnt; s++) {
+        positives_cnt += scores[s].positive ? 1 : 0;
+    }
+
+    if (fprintf(fp, EVAL_HEADER) < 0) {
+        return 0;
+    }
+
+    tp = fp_cnt = 0;
+    for (s = 0; s < scores_cnt; s++) {
+        if (scores[s].positive) {
+            tp++;
+        }
+        else {
+            fp_cnt++;
+        }
+        if (s + 1 < scores_cnt && scores[s + 1].margin == scores[s].margin) {
+            continue;
+        }
+
+        if (fprintf(fp, EVAL_LINE_FORMAT, scores[s].margin,
+                    eval_ratio(tp, tp + fp_cnt), eval_ratio(tp, positives_cnt), eval_ratio(fp_cnt, scores_cnt - positives_cnt),
+                    (unsigned long) tp, (unsigned long) fp_cnt,
+                    (unsigned long) (positives_cnt - tp), (unsigned long) (scores_cnt - positives_cnt - fp_cnt)) < 0) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
@@ -0,0 +1,43 @@
+/**
+ * \file evaluation.h
+ * \brief Header file related to evaluation of a binary classification.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Documents scored once by a margin (log10 odds of the positive class)
+ * are evaluated for all decision thresholds in one sweep over the sorted margins.
+ */
+
+
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+
+#include <stdio.h>
+
+
+/**
+ * \struct eval_score
+ * \brief Struct representing a scored labeled document.
+ */
+typedef struct eval_score_ {
+    double margin;      /**< Score of the positive class minus the score of the negative class. */
+    int positive;       /**< 1 if the document belongs to the positive class, else 0. */
+} eval_score;
+
+
+/**
+ * \brief eval_sweep Evaluates the scored documents for every distinct margin taken as a threshold
+ *                   (document is classified as positive, if its margin >= threshold)
+ *                   and prints the precision, recall and false positive rate of each threshold
+ *                   as a tab separated table to the file.
+ *                   Sorts the scored documents by margin in descending order.
+ * \param scores Array of scored documents.
+ * \param scores_cnt Number of scored documents.
+ * \param fp File handle.
+ * \return 1 if operation was successful, else 0.
+ */
+int eval_sweep(eval_score scores[], const size_t scores_cnt, FILE *fp);
+
+
+#endif
@@ -0,0 +1,277 @@
+/**
+ * \file loadgen.c
+ * \brief Functions declared in loadgen.h are implemented in this file.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Every connection is served by its own thread using a blocking socket.
+ */
+
+
+#if defined(__linux__)
+#define _POSIX_C_SOURCE 200112L
+#define LOADGEN_SOCKETS
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef LOADGEN_SOCKETS
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#include "loadgen.h"
+
+
+#ifdef LOADGEN_SOCKETS
+
+/** \brief Size of the buffer of the header of a request. */
+#define LOADGEN_HEADER_SIZE 32
+/** \brief Size of the buffer of the responses of a connection. */
+#define LOADGEN_RESPONSE_SIZE 256
+
+
+/**
+ * \struct loadgen
+ * \brief Struct representing a load generation shared by its connections.
+ */
+typedef struct loadgen_ {
+    const char *f_path;     /**< Path to the socket file. */
+    size_t conns_cnt;       /**< Number of connections. */
+    size_t requests_cnt;    /**< Number of requests of all connections. */
+    const char *texts;      /**< Texts of the requests. */
+    const size_t *offsets;  /**< Offsets of the texts. */
+    size_t texts_cnt;       /**< Number of texts. */
+    double *latencies;      /**< Latencies of the requests, negative if a request was not answered. */
+} loadgen;
+
+
+/**
+ * \struct loadgen_conn
+ * \brief Struct representing a connection of a load generation.
+ */
+typedef struct loadgen_conn_ {
+    loadgen *lg;            /**< Load generation. */
+    size_t index;           /**< Index of the connection, it sends the requests index, index + conns_cnt ... */
+    pthread_t thread;       /**< Thread of the connection. */
+} loadgen_conn;
+
+
+/**
+ * \brief loadgen_now Returns the current time of the monotonic clock.
+ * \return Seconds.
+ */
+double loadgen_now() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+/**
+ * \brief loadgen_write Writes all the bytes to the socket.
+ * \param fd Socket.
+ * \param data Bytes.
+ * \param size Number of bytes.
+ * \return 1 if operation was successful, else 0.
+ */
+int loadgen_write(const int fd, const char data[], size_t size) {
+    ssize_t written;
+
+    while (size) {
+        written = write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return 0;
+        }
+        data += written;
+        size -= written;
+    }
+
+    return 1;
+}
+
+
+/**
+ * \brief loadgen_connect Connects to the Unix domain socket.
+ * \param f_path Path to the socket file.
+ * \return Connected socket, or -1 on failure.
+ */
+int loadgen_connect(const char f_path[]) {
+    struct sockaddr_un addr;
+    int fd;
+
+    if (strlen(f_path) >= sizeof(addr.sun_path)) {
+        return -1;
+    }
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1) {
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, f_path);
+    if (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) == -1) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+
+/**
+ * \brief loadgen_conn_run Sends the requests of the connection one by one, each once the previous one was answered.
+ * \param arg Pointer to the connection.
+ * \return NULL.
+ */
+void *loadgen_conn_run(void *arg) {
+    loadgen_conn *conn = (loadgen_conn *) arg;
+    loadgen *lg = conn->lg;
+    char header[LOADGEN_HEADER_SIZE], response[LOADGEN_RESPONSE_SIZE];
+    size_t r, text, size, received;
+    ssize_t read_cnt;
+    double start;
+    int fd;
+
+    fd = loadgen_connect(lg->f_path);
+    if (fd == -1) {
+        return NULL;
+    }
+
+    /* responses are single lines, bytes following the line break of one are not expected */
+    for (r = conn->index; r < lg->requests_cnt; r += lg->conns_cnt) {
+        text = r % lg->texts_cnt;
+        size = lg->offsets[text + 1] - lg->offsets[text];
+        sprintf(header, "%lu\n", (unsigned long) size);
+
+        start = loadgen_now();
+        if (!loadgen_write(fd, header, strlen(header)) || !loadgen_write(fd, lg->texts + lg->offsets[text], size)) {
+            break;
+        }
+        received = 0;
+        while (received < sizeof(response)) {
+            read_cnt = read(fd, response + received, sizeof(response) - received);
+            if (read_cnt < 0 && errno == EINTR) {
+                continue;
+            }
+            if (read_cnt <= 0) {
+                break;
+            }
+            received += read_cnt;
+            if (response[received - 1] == '\n') {
+                break;
+            }
+        }
+        if (received == 0 || response[received - 1] != '\n') {
+            break;
+        }
+        lg->latencies[r] = loadgen_now() - start;
+    }
+
+    close(fd);
+    return NULL;
+}
+
+
+/**
+ * \brief loadgen_cmp_double Compares two doubles (qsort comparator).
+ * \param a Pointer to the first double.
+ * \param b Pointer to the second double.
+ * \return Negative, zero or positive if the first one is lower, equal or greater.
+ */
+int loadgen_cmp_double(const void *a, const void *b) {
+    const double x = *(const double *) a, y = *(const double *) b;
+
+    return (x > y) - (x < y);
+}
+
+
+int loadgen_run(const char f_path[], const size_t conns_cnt, const size_t requests_cnt,
+                const char texts[], const size_t offsets[], const size_t texts_cnt, loadgen_stats *stats) {
+    loadgen lg;
+    loadgen_conn *conns = NULL;
+    size_t c, r, started;
+    double start;
+
+    if (!f_path || !conns_cnt || !requests_cnt || !texts || !offsets || !texts_cnt || !stats) {
+        return 0;
+    }
+
+    lg.f_path = f_path;
+    lg.conns_cnt = conns_cnt;
+    lg.requests_cnt = requests_cnt;
+    lg.texts = texts;
+    lg.offsets = offsets;
+    lg.texts_cnt = texts_cnt;
+    lg.latencies = (double *) malloc(requests_cnt * sizeof(double));
+    conns = (loadgen_conn *) malloc(conns_cnt * sizeof(loadgen_conn));
+    if (!lg.latencies || !conns) {
+        goto fail;
+    }
+    for (r = 0; r < requests_cnt; r++) {
+        lg.latencies[r] = -1;
+    }
+
+    start = loadgen_now();
+    for (started = 0; started < conns_cnt; started++) {
+        conns[started].lg = &lg;
+        conns[started].index = started;
+        if (pthread_create(&conns[started].thread, NULL, loadgen_conn_run, &conns[started]) != 0) {
+            break;
+        }
+    }
+    for (c = 0; c < started; c++) {
+        pthread_join(conns[c].thread, NULL);
+    }
+    stats->seconds = loadgen_now() - start;
+    if (started < conns_cnt) {
+        goto fail;
+    }
+
+    /* answered latencies are moved to the front and sorted */
+    stats->requests_cnt = 0;
+    for (r = 0; r < requests_cnt; r++) {
+        if (lg.latencies[r] >= 0) {
+            lg.latencies[stats->requests_cnt++] = lg.latencies[r];
+        }
+    }
+    stats->failed_cnt = requests_cnt - stats->requests_cnt;
+    stats->p50 = stats->p99 = stats->max = 0;
+    if (stats->requests_cnt) {
+        qsort(lg.latencies, stats->requests_cnt, sizeof(double), loadgen_cmp_double);
+        stats->p50 = lg.latencies[(stats->requests_cnt - 1) / 2];
+        stats->p99 = lg.latencies[(stats->requests_cnt - 1) * 99 / 100];
+        stats->max = lg.latencies[stats->requests_cnt - 1];
+    }
+
+    free(conns);
+    free(lg.latencies);
+    return 1;
+
+fail:
+    free(conns);
+    free(lg.latencies);
+    return 0;
+}
+
+#else
+
+int loadgen_run(const char f_path[], const size_t conns_cnt, const size_t requests_cnt,
+                const char texts[], const size_t offsets[], const size_t texts_cnt, loadgen_stats *stats) {
+    (void) f_path; (void) conns_cnt; (void) requests_cnt; (void) texts; (void) offsets; (void) texts_cnt; (void) stats;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,50 @@
+/**
+ * \file loadgen.h
+ * \brief Header file related to the load generator of the classification daemon.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Every connection of the load generator sends its next request once the response of the previous one
+ * has been received (closed loop), latency of a request is the time between sending it and receiving its response.
+ * Load generation is supported on Linux only (see server.h).
+ */
+
+
+#ifndef LOADGEN_H
+#define LOADGEN_H
+
+
+#include <stddef.h>
+
+
+/**
+ * \struct loadgen_stats
+ * \brief Struct representing the results of a load generation.
+ */
+typedef struct loadgen_stats_ {
+    size_t requests_cnt;    /**< Number of requests answered. */
+    size_t failed_cnt;      /**< Number of requests not answered (connection failed). */
+    double seconds;         /**< Duration of the load generation. */
+    double p50;             /**< Median latency of the answered requests in seconds. */
+    double p99;             /**< 99th percentile latency of the answered requests in seconds. */
+    double max;             /**< Maximal latency of the answered requests in seconds. */
+} loadgen_stats;
+
+
+/**
+ * \brief loadgen_run Sends the requests to the daemon listening on the Unix domain socket over concurrent connections.
+ *                    Requests carry the texts in turns.
+ * \param f_path Path to the socket file.
+ * \param conns_cnt Number of connections.
+ * \param requests_cnt Number of requests of all connections.
+ * \param texts Texts of the requests.
+ * \param offsets Offsets of the texts (texts_cnt + 1 of them, the last one is the end of the last text).
+ * \param texts_cnt Number of texts (all of them non-empty).
+ * \param stats Pointer to where the results will be stored.
+ * \return 1 if operation was successful (even if some requests were not answered), else 0.
+ */
+int loadgen_run(const char f_path[], const size_t conns_cnt, const size_t requests_cnt,
+                const char texts[], const size_t offsets[], const size_t texts_cnt, loadgen_stats *stats);
+
+
+#endif
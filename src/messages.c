@@ -0,0 +1,220 @@
+/**
+ * \file messages.c
+ * \brief Functions declared in messages.h are implemented in this file.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Messages are read one by one from an mbox or from length-prefixed frames.
+ */
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "messages.h"
+#include "structures/vector.h"
+
+
+/** \brief Line starting a message of an mbox. */
+#define MESSAGES_MBOX_FROM "From "
+/** \brief Size of a chunk of a frame read at once. */
+#define MESSAGES_CHUNK_SIZE 65536
+
+
+messages *messages_open(FILE *fp, const messages_format format) {
+    messages *m = NULL;
+
+    if (!fp) {
+        return NULL;
+    }
+
+    m = (messages *) calloc(1, sizeof(messages));
+    if (!m) {
+        return NULL;
+    }
+
+    m->format = format;
+    m->fp = fp;
+    m->text = vector_create(sizeof(char), NULL);
+    m->line = vector_create(sizeof(char), NULL);
+    if (!m->text || !m->line || (format == MESSAGES_FRAMED && !vector_realloc(m->line, MESSAGES_CHUNK_SIZE))) {
+        messages_free(&m);
+        return NULL;
+    }
+
+    return m;
+}
+
+
+void messages_free(messages **m) {
+    if (!m || !(*m)) {
+        return;
+    }
+
+    vector_free(&(*m)->text);
+    vector_free(&(*m)->line);
+    free(*m);
+    *m = NULL;
+}
+
+
+int messages_text_append(vector *text, int *space, const char str[], const size_t len) {
+    const char sep = ' ';
+    size_t i;
+
+    if (!text || !space || (!str && len)) {
+        return 0;
+    }
+
+    for (i = 0; i < len; i++) {
+        if (isspace((unsigned char) str[i])) {
+            *space = vector_count(text) > 0;
+            continue;
+        }
+        if ((*space && !vector_push_back(text, &sep)) || !vector_push_back(text, &str[i])) {
+            return 0;
+        }
+        *space = 0;
+    }
+
+    return 1;
+}
+
+
+/**
+ * \brief messages_line_read Reads the next line of the stream without the line break.
+ *                           Does not check arguments validity.
+ * \param m Pointer to a stream of messages.
+ * \return 1 if the next line was read, 0 if there is not any more, -1 on failure.
+ */
+int messages_line_read(messages *m) {
+    char ch;
+    int c;
+
+    m->line->count = 0;
+    while ((c = getc(m->fp)) != EOF && c != '\n') {
+        ch = (char) c;
+        if (!vector_push_back(m->line, &ch)) {
+            return -1;
+        }
+    }
+    if (ferror(m->fp)) {
+        return -1;
+    }
+
+    return c != EOF || vector_count(m->line) ? 1 : 0;
+}
+
+
+/**
+ * \brief messages_mbox_next Reads the next message of the mbox, up to the next "From " line.
+ *                           Does not check arguments validity.
+ * \param m Pointer to a stream of messages of an mbox.
+ * \return 1 if the next message was read, 0 if there is not any more, -1 on failure.
+ */
+int messages_mbox_next(messages *m) {
+    const char *line = NULL;
+    size_t len, from_len, quotes;
+    int found;
+
+    from_len = strlen(MESSAGES_MBOX_FROM);
+    while ((found = messages_line_read(m)) == 1) {
+        line = (const char *) m->line->data;
+        len = vector_count(m->line);
+
+        if (len >= from_len && strncmp(line, MESSAGES_MBOX_FROM, from_len) == 0) {
+            if (m->started) {
+                return 1;
+            }
+            m->started = 1;
+            continue;
+        }
+
+        /* content before the first "From " line is taken as a message too */
+        m->started = 1;
+
+        /* quoted ">From ", ">>From " ... lines are unquoted once */
+        for (quotes = 0; quotes < len && line[quotes] == '>'; quotes++) {
+            ;
+        }
+        if (quotes && len - quotes >= from_len && strncmp(line + quotes, MESSAGES_MBOX_FROM, from_len) == 0) {
+            line++;
+            len--;
+        }
+        if (!messages_text_append(m->text, &m->space, line, len) ||
+            !messages_text_append(m->text, &m->space, "\n", 1)) {
+            return -1;
+        }
+    }
+    if (found == -1) {
+        return -1;
+    }
+
+    found = m->started;
+    m->started = 0;
+    return found;
+}
+
+
+/**
+ * \brief messages_framed_next Reads the next frame "<size>\n<size bytes>" of the stream.
+ *                             Does not check arguments validity.
+ * \param m Pointer to a stream of messages of frames.
+ * \return 1 if the next message was read, 2 if an empty frame was read,
+ *         0 if there is not any more, -1 on failure (or malformed frame).
+ */
+int messages_framed_next(messages *m) {
+    size_t size, chunk, digits;
+    int c;
+
+    size = digits = 0;
+    while ((c = getc(m->fp)) != EOF && isdigit(c)) {
+        if (size > ((size_t) -1 - 9) / 10) {
+            return -1;
+        }
+        size = 10 * size + (c - '0');
+        digits++;
+    }
+    if (c == '\r') {
+        c = getc(m->fp);
+    }
+    if (c == EOF && !digits && !ferror(m->fp)) {
+        return 0;
+    }
+    if (c != '\n' || !digits) {
+        return -1;
+    }
+    if (!size) {
+        return 2;
+    }
+
+    while (size) {
+        chunk = size < MESSAGES_CHUNK_SIZE ? size : MESSAGES_CHUNK_SIZE;
+        if (fread(m->line->data, 1, chunk, m->fp) != chunk ||
+            !messages_text_append(m->text, &m->space, (const char *) m->line->data, chunk)) {
+            return -1;
+        }
+        size -= chunk;
+    }
+
+    return 1;
+}
+
+
+int messages_next(messages *m, const char **text, size_t *size) {
+    int found;
+
+    if (!m || !text || !size) {
+        return -1;
+    }
+
+    m->text->count = 0;
+    m->space = 0;
+    found = m->format == MESSAGES_MBOX ? messages_mbox_next(m) : messages_framed_next(m);
+
+    *text = (const char *) m->text->data;
+    *size = vector_count(m->text);
+    return found;
+}
@@ -0,0 +1,86 @@
+/**
+ * \file messages.h
+ * \brief Header file related to streams of messages to be classified.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Messages are read one by one from a file stream (e.g. the standard input of a mail filter),
+ * either from an mbox, where every message starts with a "From " line,
+ * or from length-prefixed frames "<size>\n<size bytes of the message>".
+ * Text of a message is converted to a document of words separated by single spaces
+ * (see tokenizer.h), runs of white space including line breaks are replaced by one space.
+ */
+
+
+#ifndef MESSAGES_H
+#define MESSAGES_H
+
+
+#include <stdio.h>
+
+#include "structures/vector.h"
+
+
+/**
+ * \brief Kinds of framing of messages of a stream.
+ */
+typedef enum messages_format_ {
+    MESSAGES_MBOX,      /**< Mbox, "From " lines separate messages, ">From " lines are unescaped. */
+    MESSAGES_FRAMED     /**< Frames "<size>\n" followed by size bytes, empty frame requests flushing of results. */
+} messages_format;
+
+
+/**
+ * \struct messages
+ * \brief Struct representing a stream of messages.
+ */
+typedef struct messages_ {
+    messages_format format; /**< Framing of the messages. */
+    FILE *fp;               /**< File handle of the stream. */
+    vector *text;           /**< Document of the current message, words separated by single spaces. */
+    vector *line;           /**< Current line of an mbox, or the chunk of a frame. */
+    int space;              /**< 1 if white space precedes the next char of the document, else 0. */
+    int started;            /**< 1 if the next message of an mbox has already started, else 0. */
+} messages;
+
+
+/**
+ * \brief messages_open Creates a stream of messages read from the file stream.
+ * \param fp File handle, which must outlive the stream (it is not closed by the stream).
+ * \param format Framing of the messages.
+ * \return Pointer to a stream of messages, or NULL on failure.
+ */
+messages *messages_open(FILE *fp, const messages_format format);
+
+
+/**
+ * \brief messages_free Releases the memory held by the stream of messages and NULLs the pointer to it.
+ * \param m Pointer to a pointer to a stream of messages.
+ */
+void messages_free(messages **m);
+
+
+/**
+ * \brief messages_text_append Appends the text of a message to its document,
+ *                             runs of white space are replaced by one space, leading white space is skipped.
+ * \param text Vector of chars of the document.
+ * \param space Pointer to the flag whether white space precedes the next char, 0 at the start of the message.
+ * \param str Text.
+ * \param len Length of the text.
+ * \return 1 if operation was successful, else 0.
+ */
+int messages_text_append(vector *text, int *space, const char str[], const size_t len);
+
+
+/**
+ * \brief messages_next Reads the next message of the stream.
+ * \param m Pointer to a stream of messages.
+ * \param text Pointer to where the document of the message (valid until the next message is read) will be stored.
+ * \param size Pointer to where the size of the document will be stored.
+ * \return 1 if the next message was read, 2 if an empty frame (flush request) was read,
+ *         0 if there is not any more, -1 on failure (or malformed frame).
+ */
+int messages_next(messages *m, const char **text, size_t *size);
+
+
+#endif
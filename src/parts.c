@@ -0,0 +1,744 @@
+/**
+ * \file parts.c
+ * \brief Functions declared in parts.h are implemented in this file.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Owners of partitions of the vocabulary are POSIX threads on Unix.
+ * Queues of the partitions are single producer, single consumer (see spsc.h): the scoring thread
+ * routes the features, the owner scores them. Done counts and states of the owners are published
+ * by the GCC atomic builtins (release, acquire).
+ */
+
+
+#if defined(__unix__)
+#define _POSIX_C_SOURCE 200112L
+#define NBC_PTHREADS
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef NBC_PTHREADS
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#endif
+
+#include "parts.h"
+#include "tokenizer.h"
+#include "structures/spsc.h"
+#include "structures/vector.h"
+#include "utilities/arrays.h"
+#include "utilities/placement.h"
+#include "utilities/vecmath.h"
+
+
+/** \brief Hash bits below the ones selecting the partition of a feature (the low bits select the buckets). */
+#define NBC_PARTS_SHIFT 16
+/** \brief Capacity of the queue of features routed to a partition. */
+#define NBC_PARTS_QUEUE 1024
+/** \brief Number of polls of an idle thread yielding the processor before an owner blocks until a batch is routed
+           (the scoring thread starts to sleep between the polls). */
+#define NBC_PARTS_SPINS 256
+/** \brief Sleep of the scoring thread between polls in nanoseconds. */
+#define NBC_PARTS_SLEEP_NS 50000
+/** \brief Alignment of partitions (cache line size). */
+#define NBC_PART_ALIGNMENT 64
+/** \brief Size of padding rounding the part of a partition of the type up to the next cache line boundary. */
+#define NBC_PART_PADDING(type) (NBC_PART_ALIGNMENT - sizeof(type) % NBC_PART_ALIGNMENT)
+/** \brief Number of items staged for a partition before they are routed, and popped by its owner at once. */
+#define NBC_PARTS_BATCH 16
+
+#if defined(__GNUC__)
+/** \brief Prefetches the memory at the address into the cache for reading. */
+#define NBC_PARTS_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+/** \brief Prefetches the memory at the address into the cache for reading (not supported by the compiler). */
+#define NBC_PARTS_PREFETCH(addr) ((void) (addr))
+#endif
+
+
+/**
+ * \brief States of the owner of a partition.
+ */
+typedef enum nbc_part_state_ {
+    NBC_PART_STARTING = 0,      /**< Owner copies the probabilities of the partition. */
+    NBC_PART_READY,             /**< Owner scores the features routed to it. */
+    NBC_PART_FAILED             /**< Owner could not copy the probabilities. */
+} nbc_part_state;
+
+
+/**
+ * \struct nbc_part_item
+ * \brief Struct representing an item routed to the owner of a partition, a feature or the end of a document.
+ */
+typedef struct nbc_part_item_ {
+    const char *key;                                    /**< Dictionary key of a word (NULL for an n-gram). */
+    unsigned long hash;                                 /**< Hash of the feature (of its dictionary key). */
+    int end;                                            /**< Flag whether the item ends a document. */
+    char gram_key[NBC_GRAM_KEY_SIZE];                   /**< Dictionary key of an n-gram (not with feature hashing). */
+} nbc_part_item;
+
+
+/**
+ * \struct nbc_part_owner
+ * \brief Struct representing the part of a partition written by its owner.
+ */
+typedef struct nbc_part_owner_ {
+    const nbc *cl;              /**< Partitioned classifier. */
+    size_t index;               /**< Index of the partition. */
+    size_t parts_cnt;           /**< Number of partitions. */
+    size_t node;                /**< NUMA node of the owner (pinned to it if the classifier's rows are placed). */
+    spsc *queue;                /**< Items routed to the partition. */
+    htab_size *rows;            /**< Rows of the features of the partition (NULL with feature hashing). */
+    double *prob;               /**< Aligned rows of cls_stride log10 probabilities of the features of the partition
+                                     (NULL with feature hashing). */
+    const double *slots;        /**< Rows of the slots of the classifier read with feature hashing
+                                     (the copy of the node of the owner). */
+    size_t first;               /**< First slot of the partition (feature hashing). */
+    size_t rows_cnt;            /**< Number of rows (slots) of the partition. */
+    size_t *seen;               /**< Epochs of documents where the rows were seen last (Bernoulli model, else NULL). */
+    size_t epoch;               /**< Epoch of the currently scored document. */
+    double *acc;                /**< Aligned accumulator of cls_stride partial scores of classes. */
+    double *partial;            /**< Partial scores of classes of the last ended document. */
+    size_t done;                /**< Number of ended documents (atomic). */
+    size_t state;               /**< State of the owner (see nbc_part_state, atomic). */
+    size_t stop;                /**< Flag whether the owner stops once idle (atomic). */
+#ifdef NBC_PTHREADS
+    pthread_t thread;           /**< Owner thread. */
+    int started;                /**< Flag whether the owner thread was started. */
+    pthread_mutex_t lock;       /**< Lock of the blocked owner. */
+    pthread_cond_t wake;        /**< Signalled when a batch is routed to the blocked owner or it is stopped. */
+    int synced;                 /**< Flag whether the lock and the condition were initialized. */
+    size_t blocked;             /**< Flag whether the owner is about to block or blocked (atomic). */
+#endif
+} nbc_part_owner;
+
+
+/**
+ * \struct nbc_part_stage
+ * \brief Struct representing the items staged for a partition by the scoring thread before they are routed.
+ */
+typedef struct nbc_part_stage_ {
+    nbc_part_item items[NBC_PARTS_BATCH];               /**< Staged items. */
+    size_t cnt;                                         /**< Number of staged items. */
+} nbc_part_stage;
+
+
+/**
+ * \struct nbc_part
+ * \brief Struct representing a partition of the vocabulary, its parts written by different threads
+ *        do not share cache lines.
+ */
+typedef struct nbc_part_ {
+    nbc_part_owner o;                                           /**< Part written by the owner. */
+    char o_padding[NBC_PART_PADDING(nbc_part_owner)];
+    nbc_part_stage s;                                           /**< Part written by the scoring thread. */
+    char s_padding[NBC_PART_PADDING(nbc_part_stage)];
+} nbc_part;
+
+
+/**
+ * \brief nbc_parts_load Loads a value written by another thread (acquire).
+ * \param value Pointer to a value.
+ * \return Value.
+ */
+size_t nbc_parts_load(const size_t *value) {
+#if defined(__GNUC__)
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#else
+    return *value;
+#endif
+}
+
+
+/**
+ * \brief nbc_parts_store Stores a value read by another thread (release).
+ * \param value Pointer to a value.
+ * \param new_value New value.
+ */
+void nbc_parts_store(size_t *value, const size_t new_value) {
+#if defined(__GNUC__)
+    __atomic_store_n(value, new_value, __ATOMIC_RELEASE);
+#else
+    *value = new_value;
+#endif
+}
+
+
+/**
+ * \brief nbc_parts_fence Orders the preceding stores before the following loads (sequentially consistent fence).
+ */
+void nbc_parts_fence() {
+#if defined(__GNUC__)
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+}
+
+
+/**
+ * \brief nbc_parts_idle Lets the other threads run while the thread has nothing to do,
+ *                       it yields the processor at first and sleeps between the polls later.
+ * \param idle Pointer to the number of polls the thread has been idle for.
+ */
+void nbc_parts_idle(size_t *idle) {
+#ifdef NBC_PTHREADS
+    struct timespec ts;
+
+    if ((*idle)++ < NBC_PARTS_SPINS) {
+        sched_yield();
+        return;
+    }
+    ts.tv_sec = 0;
+    ts.tv_nsec = NBC_PARTS_SLEEP_NS;
+    nanosleep(&ts, NULL);
+#else
+    (void) idle;
+#endif
+}
+
+
+/**
+ * \brief nbc_parts_slots Returns the number of slots of a partition with feature hashing.
+ *                        Does not check arguments validity.
+ * \param cl Pointer to a classifier using feature hashing.
+ * \param parts_cnt Number of partitions.
+ * \return Number of slots of a partition (the last one may have less).
+ */
+size_t nbc_parts_slots(const nbc *cl, const size_t parts_cnt) {
+    return (((size_t) 1 << cl->params.hash_bits) + parts_cnt - 1) / parts_cnt;
+}
+
+
+/**
+ * \brief nbc_parts_owner Returns the partition of the feature.
+ *                        Does not check arguments validity.
+ * \param cl Pointer to a classifier.
+ * \param parts_cnt Number of partitions.
+ * \param hash Hash of the feature (of its dictionary key).
+ * \return Index of the partition.
+ */
+size_t nbc_parts_owner(const nbc *cl, const size_t parts_cnt, const unsigned long hash) {
+    if (cl->params.hash_bits) {
+        return (hash & (((size_t) 1 << cl->params.hash_bits) - 1)) / nbc_parts_slots(cl, parts_cnt);
+    }
+
+    return (hash >> NBC_PARTS_SHIFT) % parts_cnt;
+}
+
+
+/**
+ * \brief nbc_part_build Copies the probabilities of the features of the partition into its own rows
+ *                       and prepares its accumulators (slots of the classifier are read with feature hashing).
+ *                       Does not check arguments validity.
+ * \param o Pointer to the owner of a partition.
+ * \return 1 if operation was successful, else 0.
+ */
+int nbc_part_build(nbc_part_owner *o) {
+    const nbc *cl = o->cl;
+    unsigned long hash;
+    size_t id, row;
+
+    o->acc = (double *) array_create_aligned(cl->cls_stride, sizeof(double), VEC_ALIGNMENT);
+    o->partial = (double *) array_create(cl->cls_cnt, sizeof(double));
+    if (!o->acc || !o->partial) {
+        return 0;
+    }
+
+    if (cl->params.hash_bits) {
+        o->slots = nbc_words_prob_node(cl, o->node);
+        row = nbc_parts_slots(cl, o->parts_cnt);
+        o->first = o->index * row < cl->words_prob_rows ? o->index * row : cl->words_prob_rows;
+        o->rows_cnt = cl->words_prob_rows - o->first < row ? cl->words_prob_rows - o->first : row;
+    }
+    else {
+        for (id = 0, o->rows_cnt = 0; id < cl->words_prob_rows; id++) {
+            if (nbc_parts_owner(cl, o->parts_cnt, htab_size_hash_at(cl->words_id, id)) == o->index) {
+                o->rows_cnt++;
+            }
+        }
+        o->rows = htab_size_create(o->rows_cnt);
+        o->prob = (double *) array_create_aligned((o->rows_cnt ? o->rows_cnt : 1) * cl->cls_stride, sizeof(double),
+                                                  VEC_ALIGNMENT);
+        if (!o->rows || !o->prob) {
+            return 0;
+        }
+        for (id = 0, row = 0; id < cl->words_prob_rows; id++) {
+            hash = htab_size_hash_at(cl->words_id, id);
+            if (nbc_parts_owner(cl, o->parts_cnt, hash) != o->index) {
+                continue;
+            }
+            if (!htab_size_add_hashed(o->rows, htab_size_key_at(cl->words_id, id), hash, row)) {
+                return 0;
+            }
+            memcpy(o->prob + row * cl->cls_stride, cl->words_prob + id * cl->cls_stride,
+                   cl->cls_stride * sizeof(double));
+            row++;
+        }
+    }
+
+    if (cl->params.model == NBC_BERNOULLI) {
+        o->seen = (size_t *) array_create(o->rows_cnt ? o->rows_cnt : 1, sizeof(size_t));
+        if (!o->seen) {
+            return 0;
+        }
+    }
+    o->epoch = 1;
+
+    return 1;
+}
+
+
+/**
+ * \brief nbc_part_add Adds the log10 probabilities of the row of the partition to its partial scores
+ *                     (in the Bernoulli model at most once per document epoch).
+ *                     Does not check arguments validity.
+ * \param o Pointer to the owner of a partition.
+ * \param row Row of the partition.
+ */
+void nbc_part_add(nbc_part_owner *o, const size_t row) {
+    const nbc *cl = o->cl;
+
+    if (cl->params.model == NBC_BERNOULLI) {
+        if (o->seen[row] == o->epoch) {
+            return;
+        }
+        o->seen[row] = o->epoch;
+    }
+
+    vec_add(o->acc, o->prob ? o->prob + row * cl->cls_stride : o->slots + (o->first + row) * cl->cls_stride,
+            cl->cls_stride);
+}
+
+
+/**
+ * \brief nbc_part_end Publishes the partial scores of the ended document and starts a new document epoch.
+ *                     Does not check arguments validity.
+ * \param o Pointer to the owner of a partition.
+ */
+void nbc_part_end(nbc_part_owner *o) {
+    memcpy(o->partial, o->acc, o->cl->cls_cnt * sizeof(double));
+    array_clear(o->acc, o->cl->cls_stride, sizeof(double));
+    o->epoch++;
+    nbc_parts_store(&o->done, o->done + 1);
+}
+
+
+/**
+ * \brief nbc_part_drain Scores a batch of the items routed to the partition, looking all of its features up at once.
+ *                       Does not check arguments validity.
+ * \param o Pointer to the owner of a partition.
+ * \return Number of the scored items (0 if there were not any).
+ */
+size_t nbc_part_drain(nbc_part_owner *o) {
+    nbc_part_item items[NBC_PARTS_BATCH];
+    const char *keys[NBC_PARTS_BATCH];
+    unsigned long hashes[NBC_PARTS_BATCH];
+    size_t *values[NBC_PARTS_BATCH];
+    size_t rows[NBC_PARTS_BATCH];
+    size_t cnt, i, mask;
+
+    cnt = spsc_pop(o->queue, items, NBC_PARTS_BATCH);
+    if (o->cl->params.hash_bits) {
+        mask = ((size_t) 1 << o->cl->params.hash_bits) - 1;
+        for (i = 0; i < cnt; i++) {
+            rows[i] = (items[i].hash & mask) - o->first;
+        }
+    }
+    else {
+        for (i = 0; i < cnt; i++) {
+            keys[i] = items[i].key ? items[i].key : items[i].gram_key;
+            hashes[i] = items[i].hash;
+        }
+        htab_size_ptrget_batch(o->rows, keys, hashes, cnt, values);
+        for (i = 0; i < cnt; i++) {
+            rows[i] = values[i] ? *values[i] : NBC_NO_ID;
+        }
+    }
+
+    for (i = 0; i < cnt; i++) {
+        if (!items[i].end && rows[i] < o->rows_cnt) {
+            NBC_PARTS_PREFETCH(o->prob ? o->prob + rows[i] * o->cl->cls_stride
+                                 : o->slots + (o->first + rows[i]) * o->cl->cls_stride);
+        }
+    }
+    for (i = 0; i < cnt; i++) {
+        if (items[i].end) {
+            nbc_part_end(o);
+        }
+        else if (rows[i] < o->rows_cnt) {
+            nbc_part_add(o, rows[i]);
+        }
+    }
+
+    return cnt;
+}
+
+
+/**
+ * \brief nbc_part_block Blocks the idle owner until a batch is routed to it or it is stopped.
+ *                       The flag is raised before the queue is polled once more and the router checks it
+ *                       after pushing, so a batch routed meanwhile is either drained here or signalled.
+ *                       Does not check arguments validity.
+ * \param o Pointer to the owner of a partition.
+ */
+void nbc_part_block(nbc_part_owner *o) {
+#ifdef NBC_PTHREADS
+    pthread_mutex_lock(&o->lock);
+    nbc_parts_store(&o->blocked, 1);
+    nbc_parts_fence();
+    if (!nbc_parts_load(&o->stop) && !nbc_part_drain(o)) {
+        pthread_cond_wait(&o->wake, &o->lock);
+    }
+    nbc_parts_store(&o->blocked, 0);
+    pthread_mutex_unlock(&o->lock);
+#else
+    (void) o;
+#endif
+}
+
+
+/**
+ * \brief nbc_part_wake Wakes the owner if it is blocked.
+ *                      Does not check arguments validity.
+ * \param o Pointer to the owner of a partition.
+ */
+void nbc_part_wake(nbc_part_owner *o) {
+#ifdef NBC_PTHREADS
+    nbc_parts_fence();
+    if (nbc_parts_load(&o->blocked)) {
+        pthread_mutex_lock(&o->lock);
+        pthread_cond_signal(&o->wake);
+        pthread_mutex_unlock(&o->lock);
+    }
+#else
+    (void) o;
+#endif
+}
+
+
+/**
+ * \brief nbc_part_run Copies the probabilities of the partition and scores the items routed to it until stopped.
+ *                     Owner of placed rows is pinned to its node first, so the copies are allocated on the node.
+ * \param arg Pointer to the owner of a partition.
+ * \return NULL.
+ */
+void *nbc_part_run(void *arg) {
+    nbc_part_owner *o = (nbc_part_owner *) arg;
+    size_t idle = 0;
+
+    if (o->cl->params.placement != NBC_PLACE_DEFAULT) {
+        place_pin(o->node);
+    }
+    if (!nbc_part_build(o)) {
+        nbc_parts_store(&o->state, NBC_PART_FAILED);
+        return NULL;
+    }
+    nbc_parts_store(&o->state, NBC_PART_READY);
+
+    while (1) {
+        if (nbc_part_drain(o)) {
+            idle = 0;
+            continue;
+        }
+        if (nbc_parts_load(&o->stop)) {
+            break;
+        }
+        if (idle < NBC_PARTS_SPINS) {
+            nbc_parts_idle(&idle);
+        }
+        else {
+            nbc_part_block(o);
+            idle = 0;
+        }
+    }
+
+    return NULL;
+}
+
+
+/**
+ * \brief nbc_parts_wait Waits a while for the owner of the partition
+ *                       (without threads, the scoring thread scores the routed items itself).
+ * \param part Pointer to a partition.
+ * \param idle Pointer to the number of polls the scoring thread has been waiting for.
+ */
+void nbc_parts_wait(nbc_part *part, size_t *idle) {
+#ifdef NBC_PTHREADS
+    (void) part;
+    nbc_parts_idle(idle);
+#else
+    (void) idle;
+    nbc_part_drain(&part->o);
+#endif
+}
+
+
+/**
+ * \brief nbc_parts_flush Routes the items staged for the partition, waiting while its queue is full.
+ *                        Does not check arguments validity.
+ * \param part Pointer to a partition.
+ */
+void nbc_parts_flush(nbc_part *part) {
+    size_t routed, pushed, idle;
+
+    for (routed = 0, idle = 0; routed < part->s.cnt; routed += pushed) {
+        pushed = spsc_push(part->o.queue, part->s.items + routed, part->s.cnt - routed);
+        if (!pushed) {
+            nbc_parts_wait(part, &idle);
+        }
+        else {
+            nbc_part_wake(&part->o);
+        }
+    }
+    part->s.cnt = 0;
+}
+
+
+/**
+ * \brief nbc_parts_route Stages the feature for its partition, the staged features are routed once there is a batch.
+ *                        Does not check arguments validity.
+ * \param parts Pointer to partitions.
+ * \param f Pointer to the features of a word.
+ * \param n Index of the feature.
+ */
+void nbc_parts_route(nbc_parts *parts, const nbc_features *f, const int n) {
+    nbc_part *part = NULL;
+    nbc_part_item *item = NULL;
+
+    part = &parts->parts[nbc_parts_owner(parts->cl, parts->parts_cnt, f->hashes[n])];
+    item = &part->s.items[part->s.cnt++];
+    item->key = n ? NULL : f->keys[0];
+    item->hash = f->hashes[n];
+    item->end = 0;
+    if (n && !parts->cl->params.hash_bits) {
+        memcpy(item->gram_key, f->keys[n], NBC_GRAM_KEY_SIZE);
+    }
+
+    if (part->s.cnt == NBC_PARTS_BATCH) {
+        nbc_parts_flush(part);
+    }
+}
+
+
+/**
+ * \brief nbc_parts_end Routes the end of the document with the features staged for the partition.
+ *                      Does not check arguments validity.
+ * \param part Pointer to a partition.
+ */
+void nbc_parts_end(nbc_part *part) {
+    nbc_part_item *item = NULL;
+
+    item = &part->s.items[part->s.cnt++];
+    item->key = NULL;
+    item->hash = 0;
+    item->end = 1;
+    item->gram_key[0] = '\x00';
+    nbc_parts_flush(part);
+}
+
+
+nbc_parts *nbc_parts_create(const nbc *cl, const size_t parts_cnt) {
+    nbc_parts *parts = NULL;
+    nbc_part_owner *o = NULL;
+    size_t p, idle, nodes_cnt;
+
+    if (!nbc_is_learnt(cl) || !parts_cnt || parts_cnt > NBC_MAX_PARTS) {
+        return NULL;
+    }
+
+    parts = (nbc_parts *) malloc(sizeof(nbc_parts));
+    if (!parts) {
+        return NULL;
+    }
+
+    parts->cl = cl;
+    parts->parts_cnt = 0;
+    parts->docs_cnt = 0;
+    parts->words = vector_create(sizeof(char *), NULL);
+    parts->parts = (nbc_part *) array_create_aligned(parts_cnt, sizeof(nbc_part), NBC_PART_ALIGNMENT);
+    if (!parts->words || !parts->parts) {
+        goto fail;
+    }
+
+    /* partitions are cleared, the ones not started yet are freed as well */
+    parts->parts_cnt = parts_cnt;
+    nodes_cnt = place_nodes_cnt();
+    for (p = 0; p < parts_cnt; p++) {
+        o = &parts->parts[p].o;
+        o->cl = cl;
+        o->index = p;
+        o->parts_cnt = parts_cnt;
+        o->node = p % nodes_cnt;
+        o->queue = spsc_create(sizeof(nbc_part_item), NBC_PARTS_QUEUE);
+        if (!o->queue) {
+            goto fail;
+        }
+#ifdef NBC_PTHREADS
+        if (pthread_mutex_init(&o->lock, NULL) != 0) {
+            goto fail;
+        }
+        if (pthread_cond_init(&o->wake, NULL) != 0) {
+            pthread_mutex_destroy(&o->lock);
+            goto fail;
+        }
+        o->synced = 1;
+        if (pthread_create(&o->thread, NULL, nbc_part_run, o) != 0) {
+            goto fail;
+        }
+        o->started = 1;
+#else
+        nbc_parts_store(&o->state, nbc_part_build(o) ? NBC_PART_READY : NBC_PART_FAILED);
+#endif
+    }
+
+    for (p = 0; p < parts_cnt; p++) {
+        o = &parts->parts[p].o;
+        for (idle = 0; nbc_parts_load(&o->state) == NBC_PART_STARTING; ) {
+            nbc_parts_idle(&idle);
+        }
+        if (nbc_parts_load(&o->state) == NBC_PART_FAILED) {
+            goto fail;
+        }
+    }
+
+    return parts;
+
+fail:
+    nbc_parts_free(&parts);
+    return NULL;
+}
+
+
+void nbc_parts_free(nbc_parts **parts) {
+    nbc_part_owner *o = NULL;
+    size_t p;
+
+    if (!parts || !(*parts)) {
+        return;
+    }
+
+    for (p = 0; p < (*parts)->parts_cnt; p++) {
+        nbc_parts_store(&(*parts)->parts[p].o.stop, 1);
+        nbc_part_wake(&(*parts)->parts[p].o);
+    }
+    for (p = 0; p < (*parts)->parts_cnt; p++) {
+        o = &(*parts)->parts[p].o;
+#ifdef NBC_PTHREADS
+        if (o->started) {
+            pthread_join(o->thread, NULL);
+        }
+        if (o->synced) {
+            pthread_cond_destroy(&o->wake);
+            pthread_mutex_destroy(&o->lock);
+        }
+#endif
+        spsc_free(&o->queue);
+        htab_size_free(&o->rows);
+        array_free_aligned((void **) &o->prob);
+        array_free((void **) &o->seen);
+        array_free_aligned((void **) &o->acc);
+        array_free((void **) &o->partial);
+    }
+
+    array_free_aligned((void **) &(*parts)->parts);
+    vector_free(&(*parts)->words);
+    free(*parts);
+    *parts = NULL;
+}
+
+
+/**
+ * \brief nbc_parts_score_tokens Computes scores of the document of the tokenizer for each class
+ *                               by the owners of the partitions.
+ *                               Does not check arguments validity.
+ * \param parts Pointer to partitions of a classifier.
+ * \param t Pointer to a tokenizer over the document.
+ * \param scores Array of cls_cnt items, where the scores of classes will be stored.
+ * \return 1 if the document was successfully scored, 0 otherwise.
+ */
+int nbc_parts_score_tokens(nbc_parts *parts, tokens *t, double scores[]) {
+    const nbc *cl = parts->cl;
+    nbc_part *part = NULL;
+    nbc_features f;
+    char *word = NULL;
+    size_t p, w, idle;
+    int n, cls, tokenized;
+
+    nbc_features_reset(&f);
+    tokenized = 1;
+    while ((word = tokens_next(t))) {
+        if (!vector_push_back(parts->words, &word)) {
+            free(word);
+            tokenized = 0;
+            break;
+        }
+        nbc_features_next(cl, &f, word, nbc_word_hash(cl, word));
+        for (n = 0; n < f.cnt; n++) {
+            nbc_parts_route(parts, &f, n);
+        }
+    }
+
+    /* document is ended even if it was not tokenized, so that the owners start the next one afresh */
+    parts->docs_cnt++;
+    for (p = 0; p < parts->parts_cnt; p++) {
+        nbc_parts_end(&parts->parts[p]);
+    }
+
+    for (cls = 0; cls < cl->cls_cnt; cls++) {
+        scores[cls] = log10(cl->cls_prob[cls]) + cl->cls_absent_prob[cls];
+    }
+    for (p = 0; p < parts->parts_cnt; p++) {
+        part = &parts->parts[p];
+        for (idle = 0; nbc_parts_load(&part->o.done) < parts->docs_cnt; ) {
+            nbc_parts_wait(part, &idle);
+        }
+        for (cls = 0; cls < cl->cls_cnt; cls++) {
+            scores[cls] += part->o.partial[cls];
+        }
+    }
+
+    for (w = 0; w < vector_count(parts->words); w++) {
+        free(*(char **) vector_at(parts->words, w));
+    }
+    vector_resize(parts->words, 0);
+
+    return tokenized;
+}
+
+
+int nbc_parts_score(nbc_parts *parts, const char f_path[], double scores[]) {
+    tokens t;
+    FILE *fp = NULL;
+    int scored;
+
+    if (!parts || !f_path || !scores) {
+        return 0;
+    }
+
+    fp = fopen(f_path, "r");
+    if (!fp) {
+        return 0;
+    }
+
+    tokens_file(&t, fp);
+    scored = nbc_parts_score_tokens(parts, &t, scores);
+
+    return fclose(fp) != EOF && scored;
+}
+
+
+int nbc_parts_score_buffer(nbc_parts *parts, const char *buf, const size_t size, double scores[]) {
+    tokens t;
+
+    if (!parts || (!buf && size) || !scores) {
+        return 0;
+    }
+
+    tokens_buffer(&t, buf, size);
+
+    return nbc_parts_score_tokens(parts, &t, scores);
+}
@@ -0,0 +1,88 @@
+/**
+ * \file parts.h
+ * \brief Header file related to the partitions of the vocabulary of a learnt classifier scored by owner threads.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Partitioned classifier (params.parts) scores the documents of nbc_score and nbc_score_buffer by its partitions,
+ * made by nbc_learn_finish, the partitions may also be made for a learnt classifier by nbc_parts_create.
+ */
+
+
+#ifndef PARTS_H
+#define PARTS_H
+
+
+#include <stddef.h>
+
+#include "classifier.h"
+#include "structures/vector.h"
+
+
+/**
+ * \struct nbc_parts
+ * \brief Struct representing the vocabulary of a learnt classifier partitioned among owner threads,
+ *        which score the features of documents falling into their partitions.
+ *
+ * Features are assigned to the partitions by the hashes of their dictionary keys (with feature hashing,
+ * each partition owns a range of the slots). Owner of a partition keeps its own compact copy of the rows
+ * of probabilities of its features, so a model larger than the cache of a core is spread over the caches
+ * of the owners instead of every scoring thread going through all of it.
+ * Scoring thread splits a document to features, routes them to their owners in batches through lock-free
+ * queues (see spsc.h) and sums the partial scores of the owners once they have seen the end of the document.
+ * Routing costs more than a lookup in a small model, partitions pay off only for large ones (see bench parts).
+ * Owners are POSIX threads on Unix, elsewhere the scoring thread scores the partitions itself.
+ */
+typedef struct nbc_parts_ {
+    const nbc *cl;              /**< Partitioned classifier (not to be taught while partitioned). */
+    struct nbc_part_ *parts;    /**< Partitions (defined in parts.c), each one on its own cache lines. */
+    size_t parts_cnt;           /**< Number of partitions. */
+    size_t docs_cnt;            /**< Number of scored documents. */
+    vector *words;              /**< Words of the scored document (owned until its partial scores are summed). */
+} nbc_parts;
+
+
+/**
+ * \brief nbc_parts_create Partitions the vocabulary of the learnt classifier and starts an owner thread
+ *                         of each partition, which copies the probabilities of its features.
+ * \param cl Pointer to a learnt classifier, which must outlive the partitions and not be taught meanwhile.
+ * \param parts_cnt Number of partitions (at most NBC_MAX_PARTS).
+ * \return Pointer to the partitions, or NULL on failure.
+ */
+nbc_parts *nbc_parts_create(const nbc *cl, const size_t parts_cnt);
+
+
+/**
+ * \brief nbc_parts_free Stops the owner threads, releases the memory held by the partitions
+ *                       and NULLs the pointer to them.
+ * \param parts Pointer to a pointer to partitions.
+ */
+void nbc_parts_free(nbc_parts **parts);
+
+
+/**
+ * \brief nbc_parts_score Computes scores of the provided file for each class (see nbc_score)
+ *                        by the owners of the partitions (see nbc_parts_score_buffer).
+ * \param parts Pointer to partitions of a classifier.
+ * \param f_path Path to the file to be scored.
+ * \param scores Array of cls_cnt items, where the scores of classes will be stored.
+ * \return 1 if provided file was successfully scored, 0 otherwise.
+ */
+int nbc_parts_score(nbc_parts *parts, const char f_path[], double scores[]);
+
+
+/**
+ * \brief nbc_parts_score_buffer Computes scores of the document held in memory for each class (see nbc_score_buffer)
+ *                               by the owners of the partitions. Scores equal the ones of nbc_score_buffer
+ *                               up to the rounding of the sums, which are added up in another order.
+ *                               Partitions score one document at a time, they are used by one thread only.
+ * \param parts Pointer to partitions of a classifier.
+ * \param buf Buffer holding the document.
+ * \param size Size of the buffer.
+ * \param scores Array of cls_cnt items, where the scores of classes will be stored.
+ * \return 1 if the document was successfully scored, 0 otherwise.
+ */
+int nbc_parts_score_buffer(nbc_parts *parts, const char *buf, const size_t size, double scores[]);
+
+
+#endif
@@ -0,0 +1,990 @@
+/**
+ * \file server.c
+ * \brief Functions declared in server.h are implemented in this file.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Main thread accepts the connections, reads the requests and writes the responses of all connections,
+ * waiting for their events by epoll (level-triggered) on non-blocking sockets.
+ * Each connection has at most one message being scored at a time, so its responses keep the order of its requests.
+ * Messages are passed to the workers through the queue of jobs, scored jobs are passed back through the queue
+ * of done jobs and the main thread is woken by a byte written to the wake pipe (also by the signal handler).
+ * Workers only read the classifier, each scores the messages using its own scratch,
+ * entering its section of the snapshots for every message.
+ * Workers of a classifier of placed rows of probabilities are pinned to the NUMA nodes in turn,
+ * each one reads the copy of its node of replicated rows.
+ * Reloading thread waits for the reload requests of the main thread, learns the new classifier and publishes it.
+ */
+
+
+#if defined(__linux__)
+#define _POSIX_C_SOURCE 200112L
+#define SERVER_EPOLL
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#ifdef SERVER_EPOLL
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#endif
+
+#include "server.h"
+#include "messages.h"
+#include "structures/vector.h"
+#include "utilities/placement.h"
+
+
+#ifdef SERVER_EPOLL
+
+/** \brief Maximal number of events handled after one wait. */
+#define SERVER_EVENTS_CNT 64
+/** \brief Number of bytes read from a connection at once. */
+#define SERVER_READ_SIZE 65536
+/** \brief Number of received bytes not processed yet, above which the connection is not read (backpressure). */
+#define SERVER_MAX_PENDING (2 * (size_t) SERVER_MAX_MESSAGE_SIZE)
+/** \brief Maximal number of digits of the size of a request. */
+#define SERVER_SIZE_DIGITS 20
+/** \brief Size of the buffer of the margin of a response. */
+#define SERVER_MARGIN_SIZE 64
+
+
+/**
+ * \struct server_conn
+ * \brief Struct representing a connection of a client.
+ */
+typedef struct server_conn_ {
+    int fd;                 /**< Socket of the connection, or -1 if it is closed. */
+    size_t index;           /**< Index of the connection in the open connections of the server. */
+    vector *in;             /**< Received bytes, not processed yet from in_start. */
+    size_t in_start;        /**< Offset of the first received byte not processed yet. */
+    vector *out;            /**< Responses, not sent yet from out_start. */
+    size_t out_start;       /**< Offset of the first byte of the responses not sent yet. */
+    unsigned events;        /**< Events of the connection watched by epoll. */
+    int watched;            /**< 1 if the connection is registered in epoll, else 0. */
+    int busy;               /**< 1 if a message of the connection is being scored, else 0. */
+    int eof;                /**< 1 if the client will not send any more requests, else 0. */
+    int failed;             /**< 1 if the connection is to be closed without sending the responses, else 0. */
+} server_conn;
+
+
+/**
+ * \struct server_job
+ * \brief Struct representing a message of a request to be scored by a worker.
+ */
+typedef struct server_job_ {
+    server_conn *conn;          /**< Connection of the request. */
+    vector *msg;                /**< Message of the request. */
+    int cls;                    /**< Class of the message, or -1 if it could not be scored. */
+    double margin;              /**< Margin of the message (see server.h). */
+    struct server_job_ *next;   /**< Next job of the queue. */
+} server_job;
+
+
+/**
+ * \struct server
+ * \brief Struct representing a running server.
+ */
+typedef struct server_ {
+    snapshots *models;          /**< Snapshots of the learnt classifier. */
+    const char **labels;        /**< Labels of classes. */
+    server_loader loader;       /**< Function learning the reloaded classifier, or NULL. */
+    void *loader_arg;           /**< Argument of the loader. */
+    int listen_fd;              /**< Listening socket. */
+    int epoll_fd;               /**< Epoll instance. */
+    vector *conns;              /**< Open connections (of server_conn pointers). */
+    vector *closed;             /**< Connections closed while handling the current events (of server_conn pointers). */
+    pthread_t *workers;         /**< Worker threads. */
+    struct server_worker_arg_ *workers_args; /**< Arguments of the worker threads. */
+    size_t workers_cnt;         /**< Number of started worker threads. */
+    pthread_t reloader;         /**< Reloading thread. */
+    int reloader_started;       /**< 1 if the reloading thread was started, else 0. */
+    pthread_mutex_t lock;       /**< Lock of the queues of jobs, of the reload and of the stop flag. */
+    pthread_cond_t jobs_cond;   /**< Condition signalled when a job is queued or the workers are to stop. */
+    pthread_cond_t reload_cond; /**< Condition signalled when a reload is requested or the reloader is to stop. */
+    server_job *jobs_head;      /**< First job to be scored. */
+    server_job *jobs_tail;      /**< Last job to be scored. */
+    server_job *done_head;      /**< First scored job. */
+    server_job *done_tail;      /**< Last scored job. */
+    int reload;                 /**< 1 if a reload was requested and not started yet, else 0. */
+    int stop;                   /**< 1 if the workers are to stop, else 0. */
+} server;
+
+
+/**
+ * \struct server_worker_arg
+ * \brief Struct representing the argument of a worker thread.
+ */
+typedef struct server_worker_arg_ {
+    server *srv;                /**< Server. */
+    size_t index;               /**< Index of the worker. */
+} server_worker_arg;
+
+
+/** \brief Wake pipe of the main thread, written by the workers and by the signal handler. */
+int server_wake_fds[2] = {-1, -1};
+/** \brief Signal ending the serving, or 0 if none was received yet. */
+volatile sig_atomic_t server_signalled = 0;
+/** \brief 1 if a reload was requested by SIGHUP and not passed to the reloading thread yet, else 0. */
+volatile sig_atomic_t server_reload_signalled = 0;
+
+
+/**
+ * \brief server_signal_handle Records the received signal and wakes the main thread.
+ * \param sig Received signal.
+ */
+void server_signal_handle(int sig) {
+    const char wake = 's';
+
+    if (sig == SIGHUP) {
+        server_reload_signalled = 1;
+    }
+    else {
+        server_signalled = sig;
+    }
+    if (write(server_wake_fds[1], &wake, 1) == -1) {
+        /* pipe is full, the main thread is going to wake anyway */
+    }
+}
+
+
+/**
+ * \brief server_nonblocking Switches the file descriptor to the non-blocking mode.
+ * \param fd File descriptor.
+ * \return 1 if operation was successful, else 0.
+ */
+int server_nonblocking(const int fd) {
+    int flags;
+
+    flags = fcntl(fd, F_GETFL, 0);
+    return flags != -1 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1;
+}
+
+
+/**
+ * \brief server_job_free Releases the memory held by the job and NULLs the pointer to it.
+ * \param job Pointer to a pointer to a job.
+ */
+void server_job_free(server_job **job) {
+    if (!job || !(*job)) {
+        return;
+    }
+
+    vector_free(&(*job)->msg);
+    free(*job);
+    *job = NULL;
+}
+
+
+/**
+ * \brief server_jobs_free Releases the memory held by the queue of jobs.
+ * \param head First job of the queue.
+ */
+void server_jobs_free(server_job *head) {
+    server_job *next = NULL;
+
+    while (head) {
+        next = head->next;
+        server_job_free(&head);
+        head = next;
+    }
+}
+
+
+/**
+ * \brief server_margin Computes the margin of the scores of classes (see server.h).
+ * \param cl Pointer to a learnt classifier.
+ * \param scores Array of scores of classes.
+ * \return Score of the first class minus the highest score of the others.
+ */
+double server_margin(const nbc *cl, const double scores[]) {
+    double best;
+    int cls;
+
+    if (cl->cls_cnt < 2) {
+        return 0;
+    }
+
+    best = scores[1];
+    for (cls = 2; cls < cl->cls_cnt; cls++) {
+        if (scores[cls] > best) {
+            best = scores[cls];
+        }
+    }
+
+    return scores[0] - best;
+}
+
+
+/**
+ * \brief server_worker Scores the queued messages until the server stops.
+ * \param arg Pointer to the argument of the worker.
+ * \return NULL.
+ */
+void *server_worker(void *arg) {
+    server *srv = ((server_worker_arg *) arg)->srv;
+    const size_t index = ((server_worker_arg *) arg)->index;
+    const nbc *cl = NULL;
+    nbc_scratch *scratch = NULL;
+    vector *text = NULL;
+    double *scores = NULL;
+    server_job *job = NULL;
+    const char wake = 'j';
+    size_t node = 0;
+    int space;
+
+    /* reloaded classifiers have the same classes and placement, the scratch grows to fit them */
+    cl = snapshots_enter(srv->models, index);
+    if (cl->params.placement != NBC_PLACE_DEFAULT) {
+        node = index % place_nodes_cnt();
+        place_pin(node);
+    }
+    scratch = nbc_scratch_create(cl);
+    if (scratch) {
+        scratch->node = node;
+    }
+    scores = (double *) malloc(cl->cls_cnt * sizeof(double));
+    snapshots_leave(srv->models, index);
+    text = vector_create(sizeof(char), NULL);
+
+    for (;;) {
+        pthread_mutex_lock(&srv->lock);
+        while (!srv->jobs_head && !srv->stop) {
+            pthread_cond_wait(&srv->jobs_cond, &srv->lock);
+        }
+        if (srv->stop) {
+            pthread_mutex_unlock(&srv->lock);
+            break;
+        }
+        job = srv->jobs_head;
+        srv->jobs_head = job->next;
+        if (!srv->jobs_head) {
+            srv->jobs_tail = NULL;
+        }
+        pthread_mutex_unlock(&srv->lock);
+
+        /* job of a failed worker (out of memory) is returned unscored, closing its connection */
+        job->cls = -1;
+        job->next = NULL;
+        if (scratch && text && scores) {
+            text->count = 0;
+            space = 0;
+            cl = snapshots_enter(srv->models, index);
+            if (messages_text_append(text, &space, (const char *) job->msg->data, vector_count(job->msg)) &&
+                nbc_score_buffer_r(cl, scratch, (const char *) text->data, vector_count(text), scores)) {
+                job->cls = nbc_classify_scores(cl, scores);
+                job->margin = server_margin(cl, scores);
+            }
+            snapshots_leave(srv->models, index);
+        }
+
+        pthread_mutex_lock(&srv->lock);
+        if (srv->done_tail) {
+            srv->done_tail->next = job;
+        }
+        else {
+            srv->done_head = job;
+        }
+        srv->done_tail = job;
+        pthread_mutex_unlock(&srv->lock);
+        if (write(server_wake_fds[1], &wake, 1) == -1) {
+            /* pipe is full, the main thread is going to wake anyway */
+        }
+    }
+
+    free(scores);
+    vector_free(&text);
+    nbc_scratch_free(&scratch);
+    return NULL;
+}
+
+
+/**
+ * \brief server_reloader Learns and publishes a new classifier on every reload request until the server stops.
+ * \param arg Pointer to the server.
+ * \return NULL.
+ */
+void *server_reloader(void *arg) {
+    server *srv = (server *) arg;
+    nbc *cl = NULL;
+
+    for (;;) {
+        pthread_mutex_lock(&srv->lock);
+        while (!srv->reload && !srv->stop) {
+            pthread_cond_wait(&srv->reload_cond, &srv->lock);
+        }
+        if (srv->stop) {
+            pthread_mutex_unlock(&srv->lock);
+            break;
+        }
+        srv->reload = 0;
+        pthread_mutex_unlock(&srv->lock);
+
+        /* requests arriving while learning are merged into this one */
+        cl = srv->loader(srv->loader_arg);
+        if (cl) {
+            snapshots_publish(srv->models, cl);
+        }
+    }
+
+    return NULL;
+}
+
+
+/**
+ * \brief server_conn_free Releases the memory held by the connection and NULLs the pointer to it.
+ * \param conn Pointer to a pointer to a connection.
+ */
+void server_conn_free(server_conn **conn) {
+    if (!conn || !(*conn)) {
+        return;
+    }
+
+    if ((*conn)->fd != -1) {
+        close((*conn)->fd);
+    }
+    vector_free(&(*conn)->in);
+    vector_free(&(*conn)->out);
+    free(*conn);
+    *conn = NULL;
+}
+
+
+/**
+ * \brief server_conn_close Closes the connection and moves it to the closed ones,
+ *                          it is released once the current events are handled.
+ *                          Does not check arguments validity.
+ * \param srv Pointer to a server.
+ * \param conn Pointer to an open connection, which is not busy.
+ * \return 1 if operation was successful, else 0.
+ */
+int server_conn_close(server *srv, server_conn *conn) {
+    server_conn *last = NULL;
+
+    if (conn->watched) {
+        epoll_ctl(srv->epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+        conn->watched = 0;
+    }
+    close(conn->fd);
+    conn->fd = -1;
+
+    last = *(server_conn **) vector_at(srv->conns, vector_count(srv->conns) - 1);
+    *(server_conn **) vector_at(srv->conns, conn->index) = last;
+    last->index = conn->index;
+    srv->conns->count--;
+
+    return vector_push_back(srv->closed, &conn);
+}
+
+
+/**
+ * \brief server_accept Accepts all the pending connections.
+ *                      Does not check arguments validity.
+ * \param srv Pointer to a server.
+ * \return 1 if operation was successful, else 0.
+ */
+int server_accept(server *srv) {
+    struct epoll_event event;
+    server_conn *conn = NULL;
+    int fd;
+
+    for (;;) {
+        fd = accept(srv->listen_fd, NULL, NULL);
+        if (fd == -1) {
+            /* the other failures concern the connection being accepted only */
+            return errno != ENOMEM && errno != EBADF && errno != EINVAL;
+        }
+
+        conn = (server_conn *) calloc(1, sizeof(server_conn));
+        if (!conn) {
+            close(fd);
+            return 0;
+        }
+        conn->fd = fd;
+        conn->index = vector_count(srv->conns);
+        conn->in = vector_create(sizeof(char), NULL);
+        conn->out = vector_create(sizeof(char), NULL);
+        if (!conn->in || !conn->out || !server_nonblocking(fd) || !vector_push_back(srv->conns, &conn)) {
+            server_conn_free(&conn);
+            return 0;
+        }
+
+        memset(&event, 0, sizeof(event));
+        event.events = conn->events = EPOLLIN;
+        event.data.ptr = conn;
+        if (epoll_ctl(srv->epoll_fd, EPOLL_CTL_ADD, fd, &event) == -1) {
+            srv->conns->count--;
+            server_conn_free(&conn);
+            return 0;
+        }
+        conn->watched = 1;
+    }
+}
+
+
+/**
+ * \brief server_conn_read Reads the received bytes of the connection, until there is not any more
+ *                         or too many of them are not processed yet.
+ *                         Does not check arguments validity.
+ * \param conn Pointer to an open connection.
+ */
+void server_conn_read(server_conn *conn) {
+    ssize_t read_cnt;
+
+    /* processed bytes are dropped before the buffer grows */
+    if (conn->in_start) {
+        memmove(conn->in->data, (char *) conn->in->data + conn->in_start, vector_count(conn->in) - conn->in_start);
+        conn->in->count -= conn->in_start;
+        conn->in_start = 0;
+    }
+
+    while (vector_count(conn->in) < SERVER_MAX_PENDING) {
+        if (vector_capacity(conn->in) - vector_count(conn->in) < SERVER_READ_SIZE &&
+            !vector_realloc(conn->in, vector_count(conn->in) + SERVER_READ_SIZE)) {
+            conn->failed = 1;
+            return;
+        }
+
+        read_cnt = read(conn->fd, (char *) conn->in->data + vector_count(conn->in), SERVER_READ_SIZE);
+        if (read_cnt > 0) {
+            conn->in->count += read_cnt;
+        }
+        else if (read_cnt == 0) {
+            conn->eof = 1;
+            return;
+        }
+        else if (errno != EINTR) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                conn->failed = 1;
+            }
+            return;
+        }
+    }
+}
+
+
+/**
+ * \brief server_conn_submit Queues the next complete non-empty request of the connection to be scored.
+ *                           Does not check arguments validity.
+ * \param srv Pointer to a server.
+ * \param conn Pointer to an open connection, which is not busy.
+ * \return 1 if a request was queued or is not complete yet, 0 if the request is malformed (or on failure).
+ */
+int server_conn_submit(server *srv, server_conn *conn) {
+    const char *data = NULL;
+    server_job *job = NULL;
+    size_t avail, pos, size, header_len;
+
+    for (;;) {
+        data = (const char *) conn->in->data + conn->in_start;
+        avail = vector_count(conn->in) - conn->in_start;
+
+        size = 0;
+        for (pos = 0; pos < avail && isdigit((unsigned char) data[pos]); pos++) {
+            size = 10 * size + (data[pos] - '0');
+            if (pos >= SERVER_SIZE_DIGITS || size > SERVER_MAX_MESSAGE_SIZE) {
+                return 0;
+            }
+        }
+        if (pos < avail && data[pos] == '\r') {
+            pos++;
+        }
+        if (pos == avail) {
+            return 1;
+        }
+        if (!pos || data[pos] != '\n') {
+            return 0;
+        }
+        header_len = pos + 1;
+        if (avail - header_len < size) {
+            return 1;
+        }
+
+        conn->in_start += header_len + size;
+        if (!size) {
+            continue;
+        }
+
+        job = (server_job *) calloc(1, sizeof(server_job));
+        if (!job) {
+            return 0;
+        }
+        job->conn = conn;
+        job->msg = vector_create(sizeof(char), NULL);
+        if (!job->msg || !vector_push_back_many(job->msg, data + header_len, size)) {
+            server_job_free(&job);
+            return 0;
+        }
+
+        pthread_mutex_lock(&srv->lock);
+        if (srv->jobs_tail) {
+            srv->jobs_tail->next = job;
+        }
+        else {
+            srv->jobs_head = job;
+        }
+        srv->jobs_tail = job;
+        pthread_cond_signal(&srv->jobs_cond);
+        pthread_mutex_unlock(&srv->lock);
+
+        conn->busy = 1;
+        return 1;
+    }
+}
+
+
+/**
+ * \brief server_conn_flush Sends the responses of the connection, until the socket would block.
+ *                          Does not check arguments validity.
+ * \param conn Pointer to an open connection.
+ */
+void server_conn_flush(server_conn *conn) {
+    ssize_t written;
+
+    while (conn->out_start < vector_count(conn->out)) {
+        written = write(conn->fd, (char *) conn->out->data + conn->out_start, vector_count(conn->out) - conn->out_start);
+        if (written >= 0) {
+            conn->out_start += written;
+        }
+        else if (errno != EINTR) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                conn->failed = 1;
+            }
+            return;
+        }
+    }
+
+    conn->out->count = conn->out_start = 0;
+}
+
+
+/**
+ * \brief server_conn_process Queues the next request of the connection, sends its responses
+ *                            and closes it, if it is done or failed, else updates its watched events.
+ *                            Does not check arguments validity.
+ * \param srv Pointer to a server.
+ * \param conn Pointer to an open connection.
+ * \return 1 if operation was successful, else 0.
+ */
+int server_conn_process(server *srv, server_conn *conn) {
+    struct epoll_event event;
+    unsigned events;
+
+    if (!conn->failed && !conn->busy && !server_conn_submit(srv, conn)) {
+        /* responses of the preceding requests are sent as far as the socket does not block */
+        server_conn_flush(conn);
+        conn->failed = 1;
+    }
+    if (!conn->failed) {
+        server_conn_flush(conn);
+    }
+
+    if (conn->busy) {
+        /* failed connection is not watched until its message is scored, so that its hang up does not spin */
+        if (conn->failed && conn->watched) {
+            epoll_ctl(srv->epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+            conn->watched = 0;
+        }
+        if (conn->failed) {
+            return 1;
+        }
+    }
+    else if (conn->failed || (conn->eof && conn->out_start == vector_count(conn->out))) {
+        return server_conn_close(srv, conn);
+    }
+
+    events = 0;
+    if (!conn->eof && vector_count(conn->in) - conn->in_start < SERVER_MAX_PENDING) {
+        events |= EPOLLIN;
+    }
+    if (conn->out_start < vector_count(conn->out)) {
+        events |= EPOLLOUT;
+    }
+    if (events == conn->events) {
+        return 1;
+    }
+
+    memset(&event, 0, sizeof(event));
+    event.events = conn->events = events;
+    event.data.ptr = conn;
+    return epoll_ctl(srv->epoll_fd, EPOLL_CTL_MOD, conn->fd, &event) != -1;
+}
+
+
+/**
+ * \brief server_conn_respond Appends the response of the scored job to the responses of its connection.
+ *                            Does not check arguments validity.
+ * \param srv Pointer to a server.
+ * \param job Pointer to a scored job.
+ * \return 1 if operation was successful, else 0.
+ */
+int server_conn_respond(server *srv, const server_job *job) {
+    char margin[SERVER_MARGIN_SIZE];
+    const char *label = NULL;
+
+    label = srv->labels[job->cls];
+    sprintf(margin, "\t%.6f\n", job->margin);
+
+    return vector_push_back_many(job->conn->out, label, strlen(label)) &&
+           vector_push_back_many(job->conn->out, margin, strlen(margin));
+}
+
+
+/**
+ * \brief server_wake Handles the wake up of the main thread, responds to all the scored jobs.
+ *                    Does not check arguments validity.
+ * \param srv Pointer to a server.
+ * \return 1 if operation was successful, else 0.
+ */
+int server_wake(server *srv) {
+    char drain[256];
+    server_job *job = NULL, *next = NULL;
+    server_conn *conn = NULL;
+
+    while (read(server_wake_fds[0], drain, sizeof(drain)) > 0) {
+        ;
+    }
+
+    if (server_reload_signalled && srv->loader) {
+        server_reload_signalled = 0;
+        pthread_mutex_lock(&srv->lock);
+        srv->reload = 1;
+        pthread_cond_signal(&srv->reload_cond);
+        pthread_mutex_unlock(&srv->lock);
+    }
+
+    pthread_mutex_lock(&srv->lock);
+    job = srv->done_head;
+    srv->done_head = srv->done_tail = NULL;
+    pthread_mutex_unlock(&srv->lock);
+
+    for (; job; job = next) {
+        next = job->next;
+        conn = job->conn;
+        conn->busy = 0;
+        if (job->cls < 0 || !server_conn_respond(srv, job)) {
+            conn->failed = 1;
+        }
+        server_job_free(&job);
+
+        if (!server_conn_process(srv, conn)) {
+            server_jobs_free(next);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+/**
+ * \brief server_loop Handles the events of the server until a signal is received.
+ *                    Does not check arguments validity.
+ * \param srv Pointer to a server.
+ * \return 1 if the loop ended by a signal, 0 on failure.
+ */
+int server_loop(server *srv) {
+    struct epoll_event events[SERVER_EVENTS_CNT];
+    server_conn *conn = NULL;
+    int events_cnt, e;
+
+    while (!server_signalled) {
+        events_cnt = epoll_wait(srv->epoll_fd, events, SERVER_EVENTS_CNT, -1);
+        if (events_cnt == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return 0;
+        }
+
+        for (e = 0; e < events_cnt; e++) {
+            if (events[e].data.ptr == srv) {
+                if (!server_accept(srv)) {
+                    return 0;
+                }
+                continue;
+            }
+            if (events[e].data.ptr == server_wake_fds) {
+                if (!server_wake(srv)) {
+                    return 0;
+                }
+                continue;
+            }
+
+            conn = (server_conn *) events[e].data.ptr;
+            if (conn->fd == -1) {
+                continue;
+            }
+            if (events[e].events & EPOLLIN) {
+                server_conn_read(conn);
+            }
+            if (events[e].events & (EPOLLERR | EPOLLHUP)) {
+                conn->failed = 1;
+            }
+            if (!server_conn_process(srv, conn)) {
+                return 0;
+            }
+        }
+
+        while (vector_count(srv->closed)) {
+            conn = *(server_conn **) vector_at(srv->closed, vector_count(srv->closed) - 1);
+            srv->closed->count--;
+            server_conn_free(&conn);
+        }
+    }
+
+    return 1;
+}
+
+
+/**
+ * \brief server_listen Creates the listening socket of the path, replacing a stale socket file.
+ * \param f_path Path to the socket file.
+ * \return Listening socket, or -1 on failure.
+ */
+int server_listen(const char f_path[]) {
+    struct sockaddr_un addr;
+    struct stat st;
+    int fd;
+
+    if (strlen(f_path) >= sizeof(addr.sun_path)) {
+        return -1;
+    }
+    if (lstat(f_path, &st) == 0 && S_ISSOCK(st.st_mode)) {
+        unlink(f_path);
+    }
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1) {
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, f_path);
+    if (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) == -1 || listen(fd, SOMAXCONN) == -1 ||
+        !server_nonblocking(fd)) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+
+/**
+ * \brief server_watch Registers the file descriptor of the server in epoll for reading.
+ * \param srv Pointer to a server.
+ * \param fd File descriptor.
+ * \param ptr Pointer identifying the file descriptor in the events.
+ * \return 1 if operation was successful, else 0.
+ */
+int server_watch(server *srv, const int fd, void *ptr) {
+    struct epoll_event event;
+
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.ptr = ptr;
+    return epoll_ctl(srv->epoll_fd, EPOLL_CTL_ADD, fd, &event) != -1;
+}
+
+
+/**
+ * \brief server_workers_start Starts the worker threads and the reloading thread (if there is a loader)
+ *                             with the signals blocked, so that they are handled by the main thread.
+ * \param srv Pointer to a server.
+ * \param workers_cnt Number of worker threads.
+ * \return 1 if all the threads were started, else 0.
+ */
+int server_workers_start(server *srv, const size_t workers_cnt) {
+    sigset_t blocked, old;
+
+    srv->workers = (pthread_t *) malloc(workers_cnt * sizeof(pthread_t));
+    srv->workers_args = (server_worker_arg *) malloc(workers_cnt * sizeof(server_worker_arg));
+    if (!srv->workers || !srv->workers_args) {
+        return 0;
+    }
+
+    sigemptyset(&blocked);
+    sigaddset(&blocked, SIGINT);
+    sigaddset(&blocked, SIGTERM);
+    sigaddset(&blocked, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &blocked, &old);
+    for (srv->workers_cnt = 0; srv->workers_cnt < workers_cnt; srv->workers_cnt++) {
+        srv->workers_args[srv->workers_cnt].srv = srv;
+        srv->workers_args[srv->workers_cnt].index = srv->workers_cnt;
+        if (pthread_create(&srv->workers[srv->workers_cnt], NULL, server_worker,
+                           &srv->workers_args[srv->workers_cnt]) != 0) {
+            break;
+        }
+    }
+    if (srv->loader && srv->workers_cnt == workers_cnt) {
+        srv->reloader_started = pthread_create(&srv->reloader, NULL, server_reloader, srv) == 0;
+    }
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    return srv->workers_cnt == workers_cnt && (!srv->loader || srv->reloader_started);
+}
+
+
+/**
+ * \brief server_workers_stop Stops and joins the started worker threads and the reloading thread,
+ *                            which finishes the reload in progress first.
+ * \param srv Pointer to a server.
+ */
+void server_workers_stop(server *srv) {
+    size_t w;
+
+    pthread_mutex_lock(&srv->lock);
+    srv->stop = 1;
+    pthread_cond_broadcast(&srv->jobs_cond);
+    pthread_cond_signal(&srv->reload_cond);
+    pthread_mutex_unlock(&srv->lock);
+
+    for (w = 0; w < srv->workers_cnt; w++) {
+        pthread_join(srv->workers[w], NULL);
+    }
+    if (srv->reloader_started) {
+        pthread_join(srv->reloader, NULL);
+        srv->reloader_started = 0;
+    }
+    free(srv->workers);
+    free(srv->workers_args);
+    srv->workers = NULL;
+    srv->workers_args = NULL;
+    srv->workers_cnt = 0;
+}
+
+
+/**
+ * \brief server_signals_set Sets the handler of the signals ending the serving (and reloading) and ignores SIGPIPE.
+ * \param handler Handler of SIGINT and SIGTERM (SIG_DFL to restore the default ones).
+ * \param reload 1 if the handler handles SIGHUP too, else 0.
+ */
+void server_signals_set(void (*handler)(int), const int reload) {
+    struct sigaction action;
+
+    memset(&action, 0, sizeof(action));
+    sigemptyset(&action.sa_mask);
+    action.sa_handler = handler;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    if (reload) {
+        sigaction(SIGHUP, &action, NULL);
+    }
+
+    action.sa_handler = handler == SIG_DFL ? SIG_DFL : SIG_IGN;
+    sigaction(SIGPIPE, &action, NULL);
+}
+
+
+int server_run(snapshots *models, const char *labels[], const char f_path[], const size_t workers_cnt,
+               server_loader loader, void *loader_arg) {
+    server srv;
+    server_conn *conn = NULL;
+    int result;
+
+    if (!models || !labels || !f_path || !workers_cnt || workers_cnt > models->readers_cnt) {
+        return 0;
+    }
+
+    memset(&srv, 0, sizeof(srv));
+    srv.models = models;
+    srv.labels = labels;
+    srv.loader = loader;
+    srv.loader_arg = loader_arg;
+    srv.listen_fd = srv.epoll_fd = -1;
+    if (pthread_mutex_init(&srv.lock, NULL) != 0) {
+        return 0;
+    }
+    if (pthread_cond_init(&srv.jobs_cond, NULL) != 0) {
+        pthread_mutex_destroy(&srv.lock);
+        return 0;
+    }
+    if (pthread_cond_init(&srv.reload_cond, NULL) != 0) {
+        pthread_cond_destroy(&srv.jobs_cond);
+        pthread_mutex_destroy(&srv.lock);
+        return 0;
+    }
+
+    result = 0;
+    server_signalled = 0;
+    server_reload_signalled = 0;
+    srv.conns = vector_create(sizeof(server_conn *), NULL);
+    srv.closed = vector_create(sizeof(server_conn *), NULL);
+    if (!srv.conns || !srv.closed || pipe(server_wake_fds) == -1) {
+        goto cleanup;
+    }
+    server_signals_set(server_signal_handle, loader != NULL);
+    if (!server_nonblocking(server_wake_fds[0]) || !server_nonblocking(server_wake_fds[1])) {
+        goto cleanup;
+    }
+
+    srv.listen_fd = server_listen(f_path);
+    srv.epoll_fd = epoll_create(SERVER_EVENTS_CNT);
+    if (srv.listen_fd == -1 || srv.epoll_fd == -1 ||
+        !server_watch(&srv, srv.listen_fd, &srv) || !server_watch(&srv, server_wake_fds[0], server_wake_fds)) {
+        goto cleanup;
+    }
+
+    if (server_workers_start(&srv, workers_cnt)) {
+        result = server_loop(&srv);
+    }
+
+cleanup:
+    server_workers_stop(&srv);
+    server_jobs_free(srv.jobs_head);
+    server_jobs_free(srv.done_head);
+    while (srv.conns && vector_count(srv.conns)) {
+        conn = *(server_conn **) vector_at(srv.conns, vector_count(srv.conns) - 1);
+        srv.conns->count--;
+        server_conn_free(&conn);
+    }
+    while (srv.closed && vector_count(srv.closed)) {
+        conn = *(server_conn **) vector_at(srv.closed, vector_count(srv.closed) - 1);
+        srv.closed->count--;
+        server_conn_free(&conn);
+    }
+    vector_free(&srv.conns);
+    vector_free(&srv.closed);
+
+    if (srv.epoll_fd != -1) {
+        close(srv.epoll_fd);
+    }
+    if (srv.listen_fd != -1) {
+        close(srv.listen_fd);
+        unlink(f_path);
+    }
+    server_signals_set(SIG_DFL, loader != NULL);
+    if (server_wake_fds[0] != -1) {
+        close(server_wake_fds[0]);
+        close(server_wake_fds[1]);
+        server_wake_fds[0] = server_wake_fds[1] = -1;
+    }
+    pthread_cond_destroy(&srv.reload_cond);
+    pthread_cond_destroy(&srv.jobs_cond);
+    pthread_mutex_destroy(&srv.lock);
+
+    return result;
+}
+
+#else
+
+int server_run(snapshots *models, const char *labels[], const char f_path[], const size_t workers_cnt,
+               server_loader loader, void *loader_arg) {
+    (void) models; (void) labels; (void) f_path; (void) workers_cnt; (void) loader; (void) loader_arg;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,55 @@
+/**
+ * \file server.h
+ * \brief Header file related to the classification daemon serving requests over a Unix domain socket.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Clients send requests as frames "<size>\n<size bytes of the message>" (see messages.h),
+ * any number of them over one connection, and receive one line "<class>\t<margin>\n" per non-empty request,
+ * in the order of the requests. Margin is the score of the first class minus the highest score of the others
+ * (log10 odds of the first class of two).
+ * One thread waits for the events of all connections (epoll), the messages are scored by a pool of workers.
+ * On SIGHUP a new classifier is learnt by another thread and published (see snapshots.h),
+ * scoring goes on meanwhile, the messages being scored keep the classifier they started with.
+ * Serving is supported on Linux only.
+ */
+
+
+#ifndef SERVER_H
+#define SERVER_H
+
+
+#include <stddef.h>
+
+#include "classifier.h"
+#include "snapshots.h"
+
+
+/** \brief Maximal size of a message of a request. */
+#define SERVER_MAX_MESSAGE_SIZE (16 * 1024 * 1024)
+
+
+/**
+ * \brief server_loader Learns a new classifier to replace the published one.
+ * \param arg Argument given to server_run.
+ * \return Pointer to a learnt classifier of the same classes, or NULL on failure (the published one is kept).
+ */
+typedef nbc *(*server_loader)(void *arg);
+
+
+/**
+ * \brief server_run Serves classification requests on the Unix domain socket until SIGINT or SIGTERM is received.
+ *                   Stale socket file of the path is replaced, the socket file is removed when serving ends.
+ * \param models Pointer to the snapshots of a learnt classifier, the workers are their readers 0 ... workers_cnt - 1.
+ * \param labels Array of labels of classes of the classifier.
+ * \param f_path Path to the socket file.
+ * \param workers_cnt Number of worker threads scoring the messages.
+ * \param loader Function learning the classifier published on SIGHUP, or NULL if it is not reloaded.
+ * \param loader_arg Argument of the loader.
+ * \return 1 if the serving ended by a signal, 0 on failure.
+ */
+int server_run(snapshots *models, const char *labels[], const char f_path[], const size_t workers_cnt,
+               server_loader loader, void *loader_arg);
+
+
+#endif
@@ -0,0 +1,112 @@
+/**
+ * \file snapshots.c
+ * \brief Functions declared in snapshots.h are implemented in this file.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Published classifier, the epoch and the slots are accessed by the GCC atomic builtins
+ * (sequentially consistent): a reader which read the replaced classifier had announced its epoch before,
+ * which is older than the advanced one, so the publisher does not miss it.
+ */
+
+
+#if defined(__unix__)
+#define _POSIX_C_SOURCE 200112L
+#define SNAPSHOTS_SCHED_YIELD
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#ifdef SNAPSHOTS_SCHED_YIELD
+#include <sched.h>
+#endif
+
+#include "snapshots.h"
+#include "utilities/arrays.h"
+
+
+/**
+ * \brief snapshots_yield Lets the other threads run while the publisher waits for the readers.
+ */
+void snapshots_yield() {
+#ifdef SNAPSHOTS_SCHED_YIELD
+    sched_yield();
+#endif
+}
+
+
+snapshots *snapshots_create(nbc *cl, const size_t readers_cnt) {
+    snapshots *s = NULL;
+
+    if (!nbc_is_learnt(cl) || !readers_cnt) {
+        nbc_free(&cl);
+        return NULL;
+    }
+
+    s = (snapshots *) malloc(sizeof(snapshots));
+    if (!s) {
+        nbc_free(&cl);
+        return NULL;
+    }
+
+    s->current = cl;
+    s->epoch = 1;
+    s->readers_cnt = readers_cnt;
+    s->slots = (snapshots_slot *) array_create_aligned(readers_cnt, sizeof(snapshots_slot), SNAPSHOTS_SLOT_SIZE);
+    if (!s->slots) {
+        snapshots_free(&s);
+        return NULL;
+    }
+    array_clear(s->slots, readers_cnt, sizeof(snapshots_slot));
+
+    return s;
+}
+
+
+void snapshots_free(snapshots **s) {
+    if (!s || !(*s)) {
+        return;
+    }
+
+    nbc_free(&(*s)->current);
+    array_free_aligned((void **) &(*s)->slots);
+    free(*s);
+    *s = NULL;
+}
+
+
+const nbc *snapshots_enter(snapshots *s, const size_t reader) {
+    __atomic_store_n(&s->slots[reader].epoch, __atomic_load_n(&s->epoch, __ATOMIC_SEQ_CST), __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&s->current, __ATOMIC_SEQ_CST);
+}
+
+
+void snapshots_leave(snapshots *s, const size_t reader) {
+    __atomic_store_n(&s->slots[reader].epoch, 0, __ATOMIC_RELEASE);
+}
+
+
+int snapshots_publish(snapshots *s, nbc *cl) {
+    nbc *old = NULL;
+    size_t epoch, reader, reader_epoch;
+
+    if (!s || !nbc_is_learnt(cl)) {
+        nbc_free(&cl);
+        return 0;
+    }
+
+    old = __atomic_exchange_n(&s->current, cl, __ATOMIC_SEQ_CST);
+    epoch = __atomic_add_fetch(&s->epoch, 1, __ATOMIC_SEQ_CST);
+
+    /* grace period, readers entering from now on may only read the published classifier */
+    for (reader = 0; reader < s->readers_cnt; reader++) {
+        while ((reader_epoch = __atomic_load_n(&s->slots[reader].epoch, __ATOMIC_SEQ_CST)) != 0 &&
+               reader_epoch < epoch) {
+            snapshots_yield();
+        }
+    }
+
+    nbc_free(&old);
+    return 1;
+}
@@ -0,0 +1,98 @@
+/**
+ * \file snapshots.h
+ * \brief Header file related to the published snapshots of a learnt classifier, which may be replaced while scoring.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Snapshots are reclaimed by epochs (read-copy-update): a reader enters a critical section by announcing
+ * the current epoch in its own slot and reading the published classifier, and leaves it by clearing the slot.
+ * Publisher replaces the classifier, advances the epoch and waits until no reader is in a section
+ * of an older epoch, then the replaced classifier is released.
+ * Readers neither lock nor wait, only the publisher waits (the grace period).
+ */
+
+
+#ifndef SNAPSHOTS_H
+#define SNAPSHOTS_H
+
+
+#include <stddef.h>
+
+#include "classifier.h"
+
+
+/** \brief Size of a slot of a reader, a cache line, so that the readers do not share the lines of their slots. */
+#define SNAPSHOTS_SLOT_SIZE 64
+
+
+/**
+ * \struct snapshots_slot
+ * \brief Struct representing the slot of a reader.
+ */
+typedef struct snapshots_slot_ {
+    size_t epoch;                                   /**< Epoch of the reader's section, 0 if it is not in any. */
+    char padding[SNAPSHOTS_SLOT_SIZE - sizeof(size_t)];
+} snapshots_slot;
+
+
+/**
+ * \struct snapshots
+ * \brief Struct representing the published snapshot of a classifier.
+ */
+typedef struct snapshots_ {
+    nbc *current;               /**< Published learnt classifier. */
+    size_t epoch;               /**< Current epoch, starting at 1. */
+    snapshots_slot *slots;      /**< Slots of the readers. */
+    size_t readers_cnt;         /**< Number of the readers. */
+} snapshots;
+
+
+/**
+ * \brief snapshots_create Creates the snapshots publishing the learnt classifier.
+ * \param cl Pointer to a learnt classifier, which is owned by the snapshots from now on (even on failure).
+ * \param readers_cnt Number of the readers, each identified by its index.
+ * \return Pointer to the snapshots, or NULL on failure.
+ */
+snapshots *snapshots_create(nbc *cl, const size_t readers_cnt);
+
+
+/**
+ * \brief snapshots_free Releases the memory held by the snapshots and the published classifier
+ *                       and NULLs the pointer to them. No reader may be in a section.
+ * \param s Pointer to a pointer to the snapshots.
+ */
+void snapshots_free(snapshots **s);
+
+
+/**
+ * \brief snapshots_enter Enters the reader's section and returns the published classifier,
+ *                        which stays valid until the reader leaves the section. Sections must not be nested.
+ *                        Does not check arguments validity.
+ * \param s Pointer to the snapshots.
+ * \param reader Index of the reader.
+ * \return Pointer to the published classifier.
+ */
+const nbc *snapshots_enter(snapshots *s, const size_t reader);
+
+
+/**
+ * \brief snapshots_leave Leaves the reader's section, the classifier returned by snapshots_enter must not be used anymore.
+ *                        Does not check arguments validity.
+ * \param s Pointer to the snapshots.
+ * \param reader Index of the reader.
+ */
+void snapshots_leave(snapshots *s, const size_t reader);
+
+
+/**
+ * \brief snapshots_publish Publishes the learnt classifier instead of the current one, waits until the readers
+ *                          of the replaced one leave their sections and releases it.
+ *                          Only one thread may publish at a time.
+ * \param s Pointer to the snapshots.
+ * \param cl Pointer to a learnt classifier, which is owned by the snapshots from now on (even on failure).
+ * \return 1 if operation was successful, else 0.
+ */
+int snapshots_publish(snapshots *s, nbc *cl);
+
+
+#endif
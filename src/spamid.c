@@ -15,13 +15,67 @@
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
-#include <math.h>
+#include <errno.h>
 
 #include "classifier.h"
+#include "corpus.h"
+#include "counts.h"
+#include "evaluation.h"
+#include "messages.h"
+#include "server.h"
+#include "snapshots.h"
+#include "loadgen.h"
+#include "training.h"
+#include "bench.h"
+#include "structures/vector.h"
 #include "utilities/utils.h"
 
-/** \brief Required program input arguments count. */
-#define REQUIRED_ARGS_CNT 7
+/** \brief Command evaluating the classifier on labeled tested files. */
+#define CMD_EVAL "eval"
+/** \brief Command cross-validating the classifier on labeled files. */
+#define CMD_KFOLD "kfold"
+/** \brief Command converting files into a pre-tokenized corpus cache file. */
+#define CMD_TOKENIZE "tokenize"
+/** \brief Command classifying a stream of messages of the standard input. */
+#define CMD_FILTER "filter"
+/** \brief Format of messages of the filter command given by an mbox. */
+#define FILTER_FORMAT_MBOX "mbox"
+/** \brief Format of messages of the filter command given by length-prefixed frames. */
+#define FILTER_FORMAT_FRAMED "framed"
+/** \brief Format of one verdict line of the filter command (message number, class, spam log10 odds). */
+#define FILTER_LINE_FORMAT "%lu\t%s\t%.6f\n"
+/** \brief Size of the buffers of the standard input and output of the filter command. */
+#define FILTER_BUFFER_SIZE 65536
+/** \brief Command serving classification requests over a Unix domain socket. */
+#define CMD_SERVE "serve"
+/** \brief Command generating load of classification requests for the serve command. */
+#define CMD_LOADGEN "loadgen"
+/** \brief Size of the buffer of a text file read by the loadgen command. */
+#define LOADGEN_BUFFER_SIZE 65536
+/** \brief Command benchmarking the latency of additions to the dictionary (hashtable). */
+#define CMD_BENCH "bench"
+/** \brief Benchmark of the scaling of the shared counts with the number of threads. */
+#define BENCH_COUNTS "counts"
+/** \brief Benchmark of the scoring by the partitions of the vocabulary. */
+#define BENCH_PARTS "parts"
+/** \brief Command counting the words of files into one counts file in a bounded memory. */
+#define CMD_COUNT "count"
+/** \brief Option of the count command counting a shard "<shard>/<shards>" of the files only. */
+#define COUNT_SHARD_OPTION "-s"
+/** \brief Command merging counts files (e.g. of shards of files) into one. */
+#define CMD_MERGE "merge"
+/** \brief Command packing files into one corpus pack file. */
+#define CMD_PACK "pack"
+/** \brief Prefix of an argument giving a corpus by a corpus pack file instead of file patterns and counts. */
+#define PACK_ARG_PREFIX "pack:"
+/** \brief Prefix of an argument giving a corpus by a corpus cache file instead of file patterns and counts. */
+#define CACHE_ARG_PREFIX "cache:"
+/** \brief Prefix of an argument giving a corpus by a manifest file ("-" for stdin) of "<path>\t<S|H>" lines. */
+#define MANIFEST_ARG_PREFIX "manifest:"
+/** \brief Prefix of an argument giving files of a class by a directory tree instead of file pattern and count. */
+#define DIR_ARG_PREFIX "dir:"
+/** \brief Prefix of an argument giving learnt files by a counts file of their words instead of the files. */
+#define COUNTS_ARG_PREFIX "counts:"
 /** \brief Spam, ham classifier classes count. */
 #define CLASSIFIER_CLS_CNT 2
 /** \brief Format of one line in classification result file. */
@@ -32,6 +86,17 @@
 /** \brief Suffix of files to be learnt and classified. */
 #define FILE_SUFFIX ".txt"
 
+/**
+ * \struct serve_source
+ * \brief Struct representing the arguments of the corpus learnt by the serve command, which is reopened on reload.
+ */
+typedef struct serve_source_ {
+    nbc_params params;      /**< Classifier parameters. */
+    int argc;               /**< Command input arguments count. */
+    char **argv;            /**< Command input arguments values. */
+    int arg;                /**< Index of the first argument of the corpus. */
+} serve_source;
+
 /** \brief class SPAM, HAM enum */
 typedef enum class_ {SPAM, HAM} class;
 /** \brief Class description put in the classification result file. */
@@ -64,6 +129,25 @@ void print_err(const char message[]) {
 }
 
 
+/**
+ * \brief print_info Prints an informative message.
+ * \param message Informative message.
+ */
+void print_info(const char message[]) {
+    printf("spamid[INFO]: %s\n", message);
+}
+
+
+/**
+ * \brief print_progress Prints an informative message about the progress to the standard error output,
+ *                       so that it is not mixed with the results.
+ * \param message Informative message.
+ */
+void print_progress(const char message[]) {
+    fprintf(stderr, "spamid[INFO]: %s\n", message);
+}
+
+
 /**
  * \brief print_man Prints a manual.
  */
@@ -74,7 +158,37 @@ void print_man() {
     printf("University of West Bohemia, Pilsen\n");
     print_nl();
     printf("Usage:\n");
-    print_indented("spamid <spam> <spam-cnt> <ham> <ham-cnt> <test> <test-cnt> <out-file>");
+    print_indented("spamid [options] <spam> <spam-cnt> <ham> <ham-cnt> <test> <test-cnt> <out-file>");
+    print_indented("spamid eval [options] <spam> <spam-cnt> <ham> <ham-cnt> <test-spam> <test-spam-cnt> <test-ham> <test-ham-cnt> <out-file>");
+    print_indented("spamid kfold [options] <k> <spam> <spam-cnt> <ham> <ham-cnt> <out-file>");
+    print_indented("spamid filter [options] <mbox|framed> <spam> <spam-cnt> <ham> <ham-cnt>");
+    print_indented("spamid serve [options] <socket> <workers> <spam> <spam-cnt> <ham> <ham-cnt>");
+    print_indented("spamid loadgen <socket> <connections> <requests> <test> <test-cnt>");
+    print_indented("spamid bench <words-cnt>");
+    print_indented("spamid bench counts <tokens-cnt>");
+    print_indented("spamid bench parts <words-cnt>");
+    print_indented("spamid tokenize <spam> <spam-cnt> <ham> <ham-cnt> <cache-file>");
+    print_indented("spamid tokenize <test> <test-cnt> <cache-file>");
+    print_indented("spamid tokenize manifest:<manifest-file> <cache-file>");
+    print_indented("spamid pack <spam> <spam-cnt> <ham> <ham-cnt> <pack-file>");
+    print_indented("spamid pack <test> <test-cnt> <pack-file>");
+    print_indented("spamid count [-s <shard>/<shards>] [options] <memory-mb> <spam> <spam-cnt> <ham> <ham-cnt> <counts-file>");
+    print_indented("spamid merge [-j <jobs>] <counts-file> ... <out-counts-file>");
+    print_nl();
+    print_indented("-b         - Use the Bernoulli (word presence) model instead of the multinomial one.");
+    print_indented("-H <bits>  - Hash words into 2^<bits> slots instead of the dictionary of words.");
+    print_indented("-n <order> - Use word n-grams up to the order (2 or 3) besides words.");
+    print_indented("-j <jobs>  - Learn the files by <jobs> threads updating shared counts.");
+    print_indented("-m <count> - Learn only words (and n-grams) occuring at least <count> times (at most 255), counted");
+    print_indented("             by a sketch of a fixed size first, the learnt files are read twice (not from a pipe).");
+    print_indented("-M <words> - Keep only the <words> most frequent distinct words (and n-grams) once the files are learnt,");
+    print_indented("             which trims the model, not the memory of learning (all the words are held until then),");
+    print_indented("             the dictionary is bounded only when a counts file is learnt (see count).");
+    print_indented("-P <place> - Place the learnt probabilities of words on huge pages (huge), interleave them over the NUMA");
+    print_indented("             nodes (interleave) or copy them to every node, each serving worker pinned to a node");
+    print_indented("             reads the copy of its node (replicate).");
+    print_indented("-p <parts> - Score the files and messages (not cached ones) by the owner threads of <parts> partitions");
+    print_indented("             of the vocabulary (at most 64), pays off only for a model larger than the cache (see bench parts).");
     print_nl();
     print_indented("<spam>     - Training spam files pattern.");
     print_indented("<spam-cnt> - Training spam files count.");
@@ -84,6 +198,43 @@ void print_man() {
     print_indented("<test-cnt> - Tested files count.");
     print_indented("<out-file> - Output file name.");
     print_nl();
+    print_indented("Files of each command may be given by \"pack:<pack-file>\" or \"cache:<cache-file>\" instead of their patterns and counts,");
+    print_indented("or by \"manifest:<manifest-file>\" of lines \"<path>\\t<S|H>\" read one by one (\"manifest:-\" reads stdin).");
+    print_indented("Files of a class may be given by \"dir:<directory>\" (all files of the directory tree, e.g. a maildir).");
+    print_indented("Learnt files may be given by \"counts:<counts-file>\" of the count command instead.");
+    print_nl();
+    print_indented("eval       - Scores labeled tested spam and ham files once and outputs precision, recall");
+    print_indented("             and false positive rate of every spam score threshold.");
+    print_indented("kfold      - Cross-validates the classifier on spam and ham files split into <k> folds");
+    print_indented("             and outputs the thresholds evaluation of all the files scored out of fold");
+    print_indented("             (progress of the folds to the standard error output, no -j, -m, -M, -P or -p).");
+    print_indented("filter     - Classifies the messages of the standard input, an mbox or frames \"<size>\\n<message>\",");
+    print_indented("             and writes lines \"<number>\\t<S|H>\\t<spam log10 odds>\" to the standard output");
+    print_indented("             (buffered, an empty frame \"0\\n\" flushes the written lines).");
+    print_indented("serve      - Serves frames \"<size>\\n<message>\" sent to the Unix domain socket, scored by <workers> threads,");
+    print_indented("             each one is answered by a line \"<S|H>\\t<spam log10 odds>\" (Linux only, ends on SIGINT/SIGTERM).");
+    print_indented("             On SIGHUP the files are learnt again and the new classifier replaces the served one.");
+    print_indented("loadgen    - Sends <requests> tested files over <connections> connections to the serve command");
+    print_indented("             and outputs the throughput and the latency percentiles (Linux only).");
+    print_indented("bench      - Adds <words-cnt> distinct words to an empty dictionary and outputs the histograms");
+    print_indented("             of latencies of the additions, rehashing all the words at once when the dictionary grows");
+    print_indented("             (baseline) and expanding it incrementally (without stalls).");
+    print_indented("             With \"counts\" it counts <tokens-cnt> words of Zipfian frequencies into the counts shared");
+    print_indented("             by 1, 2, 4 ... 64 threads and outputs the throughput of each number of threads.");
+    print_indented("             With \"parts\" it scores documents of words of Zipfian frequencies by a classifier of <words-cnt>");
+    print_indented("             words, by one thread and by 1, 2, 4 ... 64 partitions of its vocabulary scored by threads");
+    print_indented("             of their own, and outputs the throughput of each (partitions pay off for large classifiers).");
+    print_indented("tokenize   - Converts the files into one pre-tokenized corpus cache file");
+    print_indented("             (vocabulary, words of the files as indices to it and classes of the files).");
+    print_indented("pack       - Concatenates the files into one corpus pack file (texts, names and classes of the files),");
+    print_indented("             which is mapped into memory instead of opening every file.");
+    print_indented("count      - Counts the words of the files into one counts file in <memory-mb> MiB of counts,");
+    print_indented("             spilling sorted runs to disk whenever the counts fill it and merging them at the end");
+    print_indented("             (-m and -M apply when the counts file is learnt, not with -H or -j).");
+    print_indented("             With -s it counts every <shards>-th file only, starting with the <shard>-th one.");
+    print_indented("merge      - Merges the counts files (e.g. of all the shards) into one by <jobs> threads,");
+    print_indented("             learning it equals learning all the counted files at once.");
+    print_nl();
     printf("Example:\n");
     print_indented("spamid spam 1234 ham 1234 test 12 result.txt");
     print_nl();
@@ -91,6 +242,55 @@ void print_man() {
     print_indented("Classifier learns 1234 ham files (\"ham1.txt\" ... \"ham1234.txt\").");
     print_indented("Classifier classifies 12 tested files (\"test1.txt\" ... \"test12.txt\").");
     print_indented("Output is printed to file \"result.txt\".");
+    print_nl();
+    print_indented("spamid eval spam 1234 ham 1234 test-spam 12 test-ham 12 sweep.txt");
+    print_nl();
+    print_indented("Classifier learns the spam and ham files and scores 12 + 12 labeled tested files.");
+    print_indented("Table of thresholds of spam log10 odds is printed to file \"sweep.txt\".");
+    print_nl();
+    print_indented("spamid kfold 10 spam 1234 ham 1234 sweep.txt");
+    print_nl();
+    print_indented("Each file is scored by the classifier which learnt the files of the other 9 folds.");
+    print_indented("Table of thresholds of spam log10 odds is printed to file \"sweep.txt\".");
+    print_nl();
+    print_indented("spamid tokenize spam 1234 ham 1234 train.cache");
+    print_indented("spamid kfold 10 cache:train.cache sweep.txt");
+    print_nl();
+    print_indented("Spam and ham files are tokenized once, cross-validation reads the mapped cache file.");
+    print_nl();
+    print_indented("spamid pack spam 1234 ham 1234 train.pack");
+    print_indented("spamid pack:train.pack test 12 result.txt");
+    print_nl();
+    print_indented("Spam and ham files are packed once, classifier learns the texts of the mapped pack file.");
+    print_nl();
+    print_indented("find mail -type f | spamid spam 1234 ham 1234 manifest:- result.txt");
+    print_nl();
+    print_indented("Classifier classifies the files listed on the standard input, paths are printed to file \"result.txt\".");
+    print_nl();
+    print_indented("spamid filter mbox pack:train.pack < inbox.mbox");
+    print_nl();
+    print_indented("Classifier learns the packed files once and prints a verdict for every message of the mbox.");
+    print_nl();
+    print_indented("spamid serve /tmp/spamid.sock 4 pack:train.pack &");
+    print_indented("spamid loadgen /tmp/spamid.sock 16 100000 test 12");
+    print_nl();
+    print_indented("Classifier learns the packed files once and 4 workers answer 100000 requests of 16 clients.");
+    print_indented("After \"spamid pack ... train.pack\" and \"kill -HUP <pid>\" the new pack is served without a pause.");
+    print_nl();
+    print_indented("spamid eval dir:Maildir/.Junk dir:Maildir/cur manifest:labeled.txt sweep.txt");
+    print_nl();
+    print_indented("Classifier learns the files of the spam and ham directory trees and scores the files of the manifest.");
+    print_nl();
+    print_indented("spamid count -n 2 512 dir:Maildir/.Junk dir:Maildir/cur train.counts");
+    print_indented("spamid -n 2 -M 1000000 counts:train.counts test 12 result.txt");
+    print_nl();
+    print_indented("Words and bigrams of the directory trees are counted in 512 MiB, classifier learns the million");
+    print_indented("most frequent ones of the counts file.");
+    print_nl();
+    print_indented("spamid count -s 1/2 256 pack:train.pack part1.counts & spamid count -s 2/2 256 pack:train.pack part2.counts");
+    print_indented("spamid merge part1.counts part2.counts train.counts");
+    print_nl();
+    print_indented("Two processes (e.g. on two machines) count a half of the packed files each, the counts are merged.");
 }
 
 
@@ -121,106 +321,211 @@ int is_valid_count(const char *str) {
 
 
 /**
- * \brief f_paths_free Releases the memory held by the array of file paths and NULLs the pointer to it.
- * \param f_paths Pointer to an array of file paths.
- * \param f_paths_cnt Number of file paths.
+ * \brief load_count Converts provided string to a count.
+ * \param str String to be converted.
+ * \param cnt Pointer to where the count will be stored.
+ * \return 1 if string is a valid count (see is_valid_count) in the range of size_t, else 0.
  */
-void f_paths_free(char **f_paths[], size_t f_paths_cnt) {
-    size_t f;
+int load_count(const char *str, size_t *cnt) {
+    unsigned long value;
 
-    if (!f_paths || !(*f_paths) || f_paths_cnt == 0) {
-        return;
+    if (!is_valid_count(str)) {
+        return 0;
     }
 
-    for (f = 0; f < f_paths_cnt; f++) {
-        free((*f_paths)[f]);
+    errno = 0;
+    value = strtoul(str, NULL, 10);
+    if (errno == ERANGE || (size_t) value != value) {
+        return 0;
     }
-    free(*f_paths);
-    *f_paths = NULL;
+
+    *cnt = value;
+    return 1;
 }
 
 
 /**
- * \brief f_path_make Prints the file path to the provided buffer.
- * \param dest Buffer.
- * \param dir Directory.
- * \param pattern File pattern.
- * \param number File number.
- * \param suffix File suffix.
- * \return 1 if operation was successful, else 0.
+ * \brief load_placement Converts provided string to a placement of the learnt probabilities of words.
+ * \param str String to be converted ("huge", "interleave" or "replicate").
+ * \param placement Pointer to where the placement will be stored.
+ * \return 1 if string is a valid placement, else 0.
  */
-int f_path_make(char *dest, const char dir[], const char pattern[], const size_t number, const char suffix[]) {
-    if (!dest || !pattern || number <= 0) {
-        return 0;
+int load_placement(const char *str, nbc_placement *placement) {
+    if (strcmp(str, "huge") == 0) {
+        *placement = NBC_PLACE_HUGE;
     }
-    
-    if (dir) {
-        if (sprintf(dest, "%s/%s%lu%s", dir, pattern, number, suffix) <= 0) {
-            return 0;
-        }
+    else if (strcmp(str, "interleave") == 0) {
+        *placement = NBC_PLACE_INTERLEAVE;
+    }
+    else if (strcmp(str, "replicate") == 0) {
+        *placement = NBC_PLACE_REPLICATE;
     }
     else {
-        if (sprintf(dest, "%s%lu%s", pattern, number, suffix) <= 0) {
+        return 0;
+    }
+
+    return 1;
+}
+
+
+/**
+ * \brief load_options Loads program options preceding the positional arguments.
+ * \param argc Program input arguments count.
+ * \param argv Program input arguments values.
+ * \param params Pointer to classifier parameters to be set.
+ * \return Index of the first positional argument if all options are valid, else 0.
+ */
+int load_options(int argc, char **argv, nbc_params *params) {
+    size_t value;
+    int arg;
+
+    params->model = NBC_MULTINOMIAL;
+    params->hash_bits = 0;
+    params->ngram = 1;
+    params->threads = 1;
+    params->min_count = 1;
+    params->max_words = 0;
+    params->placement = NBC_PLACE_DEFAULT;
+    params->parts = 0;
+
+    for (arg = 1; arg < argc && argv[arg][0] == '-'; arg++) {
+        if (strcmp(argv[arg], "-b") == 0) {
+            params->model = NBC_BERNOULLI;
+        }
+        else if (strcmp(argv[arg], "-H") == 0 && arg + 1 < argc && load_count(argv[arg + 1], &value) &&
+                 value <= NBC_MAX_HASH_BITS) {
+            params->hash_bits = value;
+            arg++;
+        }
+        else if (strcmp(argv[arg], "-n") == 0 && arg + 1 < argc && load_count(argv[arg + 1], &value) &&
+                 value >= 1 && value <= NBC_MAX_NGRAM) {
+            params->ngram = value;
+            arg++;
+        }
+        else if (strcmp(argv[arg], "-j") == 0 && arg + 1 < argc && load_count(argv[arg + 1], &value) &&
+                 value >= 1 && value <= NBC_MAX_THREADS) {
+            params->threads = (unsigned) value;
+            arg++;
+        }
+        else if (strcmp(argv[arg], "-m") == 0 && arg + 1 < argc && load_count(argv[arg + 1], &value) &&
+                 value >= 1 && value <= NBC_MAX_MIN_COUNT) {
+            params->min_count = (unsigned) value;
+            arg++;
+        }
+        else if (strcmp(argv[arg], "-M") == 0 && arg + 1 < argc && load_count(argv[arg + 1], &value) && value) {
+            params->max_words = value;
+            arg++;
+        }
+        else if (strcmp(argv[arg], "-P") == 0 && arg + 1 < argc && load_placement(argv[arg + 1], &params->placement)) {
+            arg++;
+        }
+        else if (strcmp(argv[arg], "-p") == 0 && arg + 1 < argc && load_count(argv[arg + 1], &value) &&
+                 value >= 1 && value <= NBC_MAX_PARTS) {
+            params->parts = (unsigned) value;
+            arg++;
+        }
+        else {
             return 0;
         }
     }
+    /* feature hashing bounds the memory already */
+    if (params->hash_bits && (params->min_count > 1 || params->max_words)) {
+        return 0;
+    }
 
-    return 1;
+    return arg;
+}
+
+
+/**
+ * \brief has_prefix Checks whether provided string starts with the prefix.
+ * \param str String to be checked.
+ * \param prefix Prefix.
+ * \return 1 if the string starts with the prefix, else 0.
+ */
+int has_prefix(const char str[], const char prefix[]) {
+    return strncmp(str, prefix, strlen(prefix)) == 0;
 }
 
 
 /**
- * \brief f_paths_create Creates an array of file paths constructed from provided arguments.
- * \param dir Directory.
- * \param f_patterns Array of file patterns.
- * \param f_patterns_cnt Number of file patterns.
- * \param f_counts Array of numbers of file paths to be created for a pattern.
- * \param suffix File suffix.
- * \return Array of constructed file paths.
+ * \brief load_corpus Loads the corpus given by the input arguments starting at the provided one,
+ *                    either by "pack:<pack-file>", by "cache:<cache-file>", by "manifest:<manifest-file>",
+ *                    by "dir:<directory>" of each class or by the file pattern and files count of each class.
+ * \param argc Program input arguments count.
+ * \param argv Program input arguments values.
+ * \param arg Pointer to the index of the first argument of the corpus, moved past the arguments of the corpus.
+ * \param cls_cnt Number of classes (of file patterns or directories) of the corpus.
+ * \return Pointer to the corpus, or NULL if the arguments are not valid or the corpus could not be opened.
  */
-char **f_paths_create(const char dir[], const char *f_patterns[], const size_t f_patterns_cnt, const size_t f_counts[], const char suffix[]) {
-    char **f_paths = NULL;
-    char *f_path = NULL;
-    size_t f_path_len;
-    size_t f_count;
-    size_t p;
-    size_t f;
-    size_t f_offset;
+corpus *load_corpus(int argc, char **argv, int *arg, const int cls_cnt) {
+    const char *sources[CLASSIFIER_CLS_CNT];
+    size_t f_counts[CLASSIFIER_CLS_CNT];
+    int cls;
 
-    if (!f_patterns || f_patterns_cnt == 0 || !f_counts) {
+    if (*arg >= argc || cls_cnt <= 0 || cls_cnt > CLASSIFIER_CLS_CNT) {
         return NULL;
     }
 
-    f_count = 0;
-    for (p = 0; p < f_patterns_cnt; p++) {
-        f_count += f_counts[p];
+    if (has_prefix(argv[*arg], PACK_ARG_PREFIX)) {
+        return corpus_open_pack(argv[(*arg)++] + strlen(PACK_ARG_PREFIX));
     }
-    f_paths = (char **) calloc(f_count, sizeof(char *));
-    if (!f_paths) {
-        return NULL;
-    } 
-
-    f_offset = 0;
-    for (p = 0; p < f_patterns_cnt; p++) {
-        f_path_len = (dir ? strlen(dir) : 0) +
-                     strlen(f_patterns[p]) + (int) (ceil(log10(f_counts[p] + 1)) + 1) +
-                     (suffix ? strlen(suffix) : 0);
-        
-        f_path = calloc(f_path_len + 1, sizeof(char));
-        for (f = 0; f < f_counts[p]; f++) {
-            if (!f_path_make(f_path, dir, f_patterns[p], f + 1, suffix)) {
-                free(f_path);
-                f_paths_free(&f_paths, f_offset + f);
+    if (has_prefix(argv[*arg], CACHE_ARG_PREFIX)) {
+        return corpus_open_cache(argv[(*arg)++] + strlen(CACHE_ARG_PREFIX));
+    }
+    if (has_prefix(argv[*arg], MANIFEST_ARG_PREFIX)) {
+        return corpus_open_manifest(argv[(*arg)++] + strlen(MANIFEST_ARG_PREFIX), RESULT_CLASS_DESCRIPTION, CLASSIFIER_CLS_CNT);
+    }
+    if (has_prefix(argv[*arg], DIR_ARG_PREFIX)) {
+        if (argc - *arg < cls_cnt) {
+            return NULL;
+        }
+        for (cls = 0; cls < cls_cnt; cls++, (*arg)++) {
+            if (!has_prefix(argv[*arg], DIR_ARG_PREFIX)) {
                 return NULL;
             }
-            f_paths[f + f_offset] = strdup(f_path);
+            sources[cls] = argv[*arg] + strlen(DIR_ARG_PREFIX);
+        }
+        return corpus_create_dirs(sources, cls_cnt);
+    }
+
+    if (argc - *arg < 2 * cls_cnt) {
+        return NULL;
+    }
+    for (cls = 0; cls < cls_cnt; cls++, *arg += 2) {
+        if (!load_count(argv[*arg + 1], &f_counts[cls])) {
+            return NULL;
         }
+        sources[cls] = argv[*arg];
+    }
+
+    return corpus_create_files(DATA_DIR, sources, f_counts, cls_cnt, FILE_SUFFIX);
+}
+
+
+/**
+ * \brief load_learn_corpus Loads the corpus of learnt files given by the input arguments starting at the provided one,
+ *                          either by "counts:<counts-file>" or like any other corpus (see load_corpus).
+ * \param argc Program input arguments count.
+ * \param argv Program input arguments values.
+ * \param arg Pointer to the index of the first argument of the corpus, moved past the arguments of the corpus.
+ * \return Pointer to the corpus of classifier's classes, or NULL if the arguments are not valid
+ *         or the corpus could not be opened.
+ */
+corpus *load_learn_corpus(int argc, char **argv, int *arg) {
+    corpus *c = NULL;
 
-        free(f_path);
-        f_offset += f;
+    if (*arg < argc && has_prefix(argv[*arg], COUNTS_ARG_PREFIX)) {
+        c = corpus_open_counts(argv[(*arg)++] + strlen(COUNTS_ARG_PREFIX));
+    }
+    else {
+        c = load_corpus(argc, argv, arg, CLASSIFIER_CLS_CNT);
+    }
+    if (c && c->cls_cnt != CLASSIFIER_CLS_CNT) {
+        corpus_free(&c);
     }
 
-    return f_paths;
+    return c;
 }
 
 
@@ -228,125 +533,220 @@ char **f_paths_create(const char dir[], const char *f_patterns[], const size_t f
  * \brief load_args Loads program input arguments.
  * \param argc Program input arguments count.
  * \param argv Program input arguments values.
- * \param f_learn_patterns Array of file patterns of files to be learnt.
- * \param f_learn_counts Array of numbers of files of a pattern.
- * \param f_classify_pattern Pointer to a classify pattern.
- * \param f_classify_cnt Pointer to a number of files to be classified.
+ * \param params Pointer to classifier parameters.
+ * \param learn Pointer to where the corpus of files to be learnt will be stored.
+ * \param classify Pointer to where the corpus of files to be classified will be stored.
  * \param f_out Pointer to a classification result file path.
  * \return 1 if all program arguments are provided and valid, else 0.
  */
-int load_args(int argc, char **argv,
-              char *f_learn_patterns[], size_t f_learn_counts[],
-              char **f_classify_pattern, size_t *f_classify_cnt,
-              char **f_out) {
-    if (argc != REQUIRED_ARGS_CNT + 1) {
+int load_args(int argc, char **argv, nbc_params *params, corpus **learn, corpus **classify, char **f_out) {
+    int arg;
+
+    arg = load_options(argc, argv, params);
+    if (!arg) {
         return 0;
     }
-    if (!is_valid_count(argv[2]) || !is_valid_count(argv[4]) || !is_valid_count(argv[6])) {
+
+    *learn = load_learn_corpus(argc, argv, &arg);
+    if (!*learn) {
         return 0;
     }
-
-    f_learn_patterns[SPAM] = argv[1];
-    f_learn_counts[SPAM] = atoi(argv[2]);
-    f_learn_patterns[HAM] = argv[3];
-    f_learn_counts[HAM] = atoi(argv[4]);
-    *f_classify_pattern = argv[5];
-    *f_classify_cnt = atoi(argv[6]);
-    *f_out = argv[7];
+    *classify = load_corpus(argc, argv, &arg, 1);
+    if (!*classify || argc - arg != 1) {
+        return 0;
+    }
+    *f_out = argv[arg];
 
     return 1;
 }
 
 
 /**
- * \brief unload_f_paths Releases the memory held by the arrays of file paths.
- *                       Does not check argument validity.
- * \param f_learn_paths Pointer to an array of file paths to be learnt.
- * \param f_learn_counts Array of numbers of files of a pattern.
- * \param f_classify_paths Pointer to an array of file paths to be classified.
- * \param f_classify_names Pointer to an array of file names (file name without dir prefix) to be printed to the output file.
- * \param f_classify_cnt Number of classified files.
+ * \brief print_hash_collisions Prints the estimated collisions of the classifier's feature hashing.
+ * \param cl Pointer to a learnt classifier using feature hashing.
+ */
+void print_hash_collisions(const nbc *cl) {
+    char message[256];
+    double features_cnt, collisions;
+
+    collisions = nbc_hash_collisions(cl, &features_cnt);
+    if (collisions < 0) {
+        return;
+    }
+
+    if (!features_cnt) {
+        sprintf(message, "Feature hashing: all %lu slots used, estimate unavailable; raise -H.",
+                (unsigned long) cl->dict_size);
+    }
+    else {
+        sprintf(message, "Feature hashing: %lu of %lu slots used, ~%.0f distinct words, ~%.2f %% of words collide.",
+                (unsigned long) cl->dict_size, (unsigned long) 1 << cl->params.hash_bits, features_cnt,
+                100 * collisions);
+    }
+    print_info(message);
+}
+
+
+/**
+ * \brief estimate_corpus_words Returns the number of words of the corpus (not read yet),
+ *                              counted in a cache, else estimated from the size of the texts (if known in advance).
+ * \param c Pointer to a corpus.
+ * \return Number of words, 0 if not known.
+ */
+size_t estimate_corpus_words(corpus *c) {
+    if (corpus_is_cache(c)) {
+        return c->docs_offsets[c->docs_cnt];
+    }
+
+    return corpus_text_size(c) / NBC_BYTES_PER_WORD;
+}
+
+
+/**
+ * \brief reserve_corpus Presizes the classifier for the words of the corpus (see estimate_corpus_words).
+ * \param cl Pointer to a classifier.
+ * \param c Pointer to a corpus.
+ * \return 1 if operation was successful, else 0.
  */
-void unload_f_paths(char **f_learn_paths[], const size_t f_learn_counts[],
-                    char **f_classify_paths[], char **f_classify_names[], const size_t f_classify_cnt) {
-    f_paths_free(f_learn_paths, f_learn_counts[SPAM] + f_learn_counts[HAM]);
-    f_paths_free(f_classify_paths, f_classify_cnt);
-    f_paths_free(f_classify_names, f_classify_cnt);
-    *f_learn_paths = *f_classify_paths = *f_classify_names = NULL;
+int reserve_corpus(nbc *cl, corpus *c) {
+    return nbc_reserve(cl, estimate_corpus_words(c));
 }
 
 
 /**
- * \brief load_f_paths Creates and loads arrays of file paths.
- *                     Does not check argument validity.
- * \param f_learn_paths Pointer to an array of file paths to be learnt.
- * \param f_learn_patterns Array of patterns of files to be learnt.
- * \param f_learn_counts Array of numbers of files of a pattern.
- * \param f_classify_paths Pointer to an array of file paths to be classified.
- * \param f_classify_names Pointer to an array of file names (file name without dir prefix) to be printed to the output file.
- * \param f_classify_pattern Pattern of the classified files.
- * \param f_classify_cnt Number of classified files.
+ * \brief learn_corpus Teaches the classifier the documents of the corpus (all labeled), read one by one,
+ *                     or by the threads of the classifier's parameters at once (see training_learn_corpus).
+ *                     Documents of a pack are learnt from their mapped texts, documents of a cache
+ *                     from their words, no text files are read. Counts of a counts file are learnt at once.
+ *                     Corpus is read twice by a classifier with a sketch (see nbc_sketch_finish).
+ * \param cl Pointer to an untaught classifier.
+ * \param c Pointer to a corpus of documents of the classifier's classes.
  * \return 1 if operation was successful, else 0.
  */
-int load_f_paths(char **f_learn_paths[],  const char *f_learn_patterns[], const size_t f_learn_counts[],
-                 char **f_classify_paths[], char **f_classify_names[], const char f_classify_pattern[], const size_t f_classify_cnt) {
-    *f_learn_paths = f_paths_create(DATA_DIR, f_learn_patterns, CLASSIFIER_CLS_CNT, f_learn_counts, FILE_SUFFIX);
-    *f_classify_paths = f_paths_create(DATA_DIR, &f_classify_pattern, 1, &f_classify_cnt, FILE_SUFFIX);
-    *f_classify_names = f_paths_create(NULL, &f_classify_pattern, 1, &f_classify_cnt, FILE_SUFFIX);
-    if (!f_learn_paths || !f_classify_paths || !f_classify_names) {
-        unload_f_paths(f_learn_paths, f_learn_counts, f_classify_paths, f_classify_names, f_classify_cnt);
+int learn_corpus(nbc *cl, corpus *c) {
+    nbc_vocab *vocab = NULL;
+    corpus_doc doc;
+    int found, pass;
+
+    if (corpus_is_counts(c)) {
+        return nbc_learn_counts(cl, c->counts);
+    }
+    if (cl->params.threads > 1) {
+        return training_learn_corpus(cl, c, estimate_corpus_words(c), cl->params.threads);
+    }
+
+    if (!reserve_corpus(cl, c)) {
         return 0;
     }
+    if (corpus_is_cache(c)) {
+        vocab = nbc_vocab_create(cl, c->words, c->words_cnt);
+        if (!vocab) {
+            return 0;
+        }
+    }
+
+    for (pass = cl->sketch ? 0 : 1; pass < 2; pass++) {
+        while ((found = corpus_next(c, &doc)) == 1) {
+            if (vocab ? !nbc_learn_words(cl, vocab, doc.words, doc.words_cnt, doc.cls) :
+                doc.path ? !nbc_learn_file(cl, doc.path, doc.cls) :
+                !nbc_learn_buffer(cl, doc.text, doc.text_size, doc.cls)) {
+                goto fail;
+            }
+        }
+        if (found == -1 || (!pass && (!corpus_rewind(c) || !nbc_sketch_finish(cl)))) {
+            goto fail;
+        }
+    }
+    if (!nbc_learn_finish(cl)) {
+        goto fail;
+    }
 
+    nbc_vocab_free(&vocab);
     return 1;
+
+fail:
+    nbc_vocab_free(&vocab);
+    return 0;
+}
+
+
+/**
+ * \brief score_doc Computes scores of the document of a corpus for each class.
+ * \param cl Pointer to a learnt classifier.
+ * \param vocab Pointer to a vocabulary of the cache the document belongs to, or NULL if it is a text (file).
+ * \param doc Pointer to a document.
+ * \param scores Array of scores of classes.
+ * \return 1 if operation was successful, else 0.
+ */
+int score_doc(const nbc *cl, nbc_vocab *vocab, const corpus_doc *doc, double scores[]) {
+    if (vocab) {
+        return nbc_score_words(cl, vocab, doc->words, doc->words_cnt, scores);
+    }
+    if (!doc->path) {
+        return nbc_score_buffer(cl, doc->text, doc->text_size, scores);
+    }
+
+    return nbc_score(cl, doc->path, scores);
 }
 
 
 /**
  * \brief process Teaches the classifier provided files, classifies provided files
  *                and outputs the result into provided output file.
- * \param f_learn_paths Array of file paths to be learnt.
- * \param f_learn_counts Array of numbers of file paths to be learnt.
- * \param f_classify_paths Array of file paths to be classified.
- * \param f_classify_names Array of names (file name without dir prefix) to be printed to the output file.
- * \param f_classify_cnt Number of files to be classified.
+ * \param params Pointer to classifier parameters.
+ * \param learn Pointer to a corpus of files to be learnt.
+ * \param classify Pointer to a corpus of files to be classified.
  * \param f_out Output file path.
  * \return 1 if operation was successful, else 0.
  */
-int process(const char *f_learn_paths[], const size_t f_learn_counts[],
-            const char *f_classify_paths[], const char *f_classify_names[], const size_t f_classify_cnt,
-            const char *f_out) {
+int process(const nbc_params *params, corpus *learn, corpus *classify, const char *f_out) {
     nbc *cl = NULL;
+    nbc_vocab *vocab = NULL;
+    double scores[CLASSIFIER_CLS_CNT];
+    corpus_doc doc;
     FILE *fp = NULL;
-    size_t f;
-    int cls;
+    int cls, found;
 
-    if (!f_learn_paths || !f_learn_counts || !f_classify_paths || !f_classify_cnt || !f_out) {
+    if (!learn || !classify || !f_out) {
         return 0;
     }
 
-    cl = nbc_create(CLASSIFIER_CLS_CNT);
-    if (!cl || !nbc_learn(cl, f_learn_paths, f_learn_counts)) {
+    cl = nbc_create(CLASSIFIER_CLS_CNT, params);
+    if (!cl || !learn_corpus(cl, learn)) {
         goto fail;
     }
+    print_hash_collisions(cl);
+    if (corpus_is_cache(classify)) {
+        vocab = nbc_vocab_create(cl, classify->words, classify->words_cnt);
+        if (!vocab) {
+            goto fail;
+        }
+    }
 
     fp = fopen(f_out, "w");
     if (!fp) {
         goto fail;
     }
-    for (f = 0; f < f_classify_cnt; f++) {
-        cls = nbc_classify(cl, f_classify_paths[f]);
+    while ((found = corpus_next(classify, &doc)) == 1) {
+        if (!score_doc(cl, vocab, &doc, scores)) {
+            goto fail;
+        }
+        cls = nbc_classify_scores(cl, scores);
         if (cls == -1) {
             goto fail;
         }
         
-        fprintf(fp, RESULT_LINE_FORMAT, f_classify_names[f], RESULT_CLASS_DESCRIPTION[cls]);
+        fprintf(fp, RESULT_LINE_FORMAT, doc.name, RESULT_CLASS_DESCRIPTION[cls]);
+    }
+    if (found == -1) {
+        goto fail;
     }
 
     if (fclose(fp) == EOF) {
         fp = NULL;
         goto fail;
     }
+    nbc_vocab_free(&vocab);
     nbc_free(&cl);
 
     return 1;
@@ -355,46 +755,1199 @@ fail:
     if (fp) {
         fclose(fp);
     }
+    nbc_vocab_free(&vocab);
     nbc_free(&cl);
     return 0;
 }
 
 
 /**
- * \brief main Processes input arguments, teaches classifier provided files,
- *             classifies provided files, outputs results into provided file.
- * \param argc Program input arguments count.
- * \param argv Program input arguments values.
+ * \brief load_eval_args Loads eval command input arguments.
+ * \param argc Command input arguments count.
+ * \param argv Command input arguments values.
+ * \param params Pointer to classifier parameters.
+ * \param learn Pointer to where the corpus of files to be learnt will be stored.
+ * \param test Pointer to where the corpus of labeled files to be tested will be stored.
+ * \param f_out Pointer to an evaluation result file path.
+ * \return 1 if all command arguments are provided and valid, else 0.
+ */
+int load_eval_args(int argc, char **argv, nbc_params *params, corpus **learn, corpus **test, char **f_out) {
+    int arg;
+
+    arg = load_options(argc, argv, params);
+    if (!arg) {
+        return 0;
+    }
+
+    *learn = load_learn_corpus(argc, argv, &arg);
+    if (!*learn) {
+        return 0;
+    }
+    *test = load_corpus(argc, argv, &arg, CLASSIFIER_CLS_CNT);
+    if (!*test || (*test)->cls_cnt != CLASSIFIER_CLS_CNT || argc - arg != 1) {
+        return 0;
+    }
+    *f_out = argv[arg];
+
+    return 1;
+}
+
+
+/**
+ * \brief evaluate Teaches the classifier provided files, scores provided labeled files once
+ *                 and outputs the evaluation of all spam score thresholds into provided output file.
+ * \param params Pointer to classifier parameters.
+ * \param learn Pointer to a corpus of files to be learnt.
+ * \param test Pointer to a corpus of labeled files to be tested.
+ * \param f_out Output file path.
+ * \return 1 if operation was successful, else 0.
+ */
+int evaluate(const nbc_params *params, corpus *learn, corpus *test, const char *f_out) {
+    nbc *cl = NULL;
+    nbc_vocab *vocab = NULL;
+    vector *scores = NULL;
+    eval_score score;
+    double cls_scores[CLASSIFIER_CLS_CNT];
+    corpus_doc doc;
+    FILE *fp = NULL;
+    int found;
+
+    cl = nbc_create(CLASSIFIER_CLS_CNT, params);
+    if (!cl || !learn_corpus(cl, learn)) {
+        goto fail;
+    }
+    print_hash_collisions(cl);
+    if (corpus_is_cache(test)) {
+        vocab = nbc_vocab_create(cl, test->words, test->words_cnt);
+        if (!vocab) {
+            goto fail;
+        }
+    }
+
+    scores = vector_create(sizeof(eval_score), NULL);
+    if (!scores) {
+        goto fail;
+    }
+    while ((found = corpus_next(test, &doc)) == 1) {
+        if (doc.cls < 0 || !score_doc(cl, vocab, &doc, cls_scores)) {
+            goto fail;
+        }
+        score.margin = cls_scores[SPAM] - cls_scores[HAM];
+        score.positive = doc.cls == SPAM;
+        if (!vector_push_back(scores, &score)) {
+            goto fail;
+        }
+    }
+    if (found == -1) {
+        goto fail;
+    }
+
+    fp = fopen(f_out, "w");
+    if (!fp || !eval_sweep((eval_score *) scores->data, vector_count(scores), fp)) {
+        goto fail;
+    }
+    if (fclose(fp) == EOF) {
+        fp = NULL;
+        goto fail;
+    }
+
+    vector_free(&scores);
+    nbc_vocab_free(&vocab);
+    nbc_free(&cl);
+    return 1;
+
+fail:
+    if (fp) {
+        fclose(fp);
+    }
+    vector_free(&scores);
+    nbc_vocab_free(&vocab);
+    nbc_free(&cl);
+    return 0;
+}
+
+
+/**
+ * \brief run_eval Processes eval command input arguments, teaches classifier provided files,
+ *                 scores provided labeled files, outputs evaluation of thresholds into provided file.
+ * \param argc Command input arguments count.
+ * \param argv Command input arguments values.
  * \return EXIT_SUCCESS if not any problem occured, else EXIT_FAILURE.
  */
-int main(int argc, char **argv) {
-    char *f_learn_patterns[CLASSIFIER_CLS_CNT] = {NULL};
-    char *f_classify_pattern = NULL;
-    size_t f_learn_counts[CLASSIFIER_CLS_CNT] = {0};
-    size_t f_classify_cnt = 0;
-    char **f_learn_paths = NULL, **f_classify_paths = NULL, **f_classify_names = NULL;
+int run_eval(int argc, char **argv) {
+    nbc_params params;
+    corpus *learn = NULL, *test = NULL;
     char *f_out = NULL;
 
-    if (!load_args(argc, argv, f_learn_patterns, f_learn_counts, &f_classify_pattern, &f_classify_cnt, &f_out)) {
+    if (!load_eval_args(argc, argv, &params, &learn, &test, &f_out)) {
         print_err("Invalid arguments count/values.");
         printf("\n");
         print_man();
+        corpus_free(&learn); corpus_free(&test);
         return EXIT_FAILURE;
     }
 
-    if (!load_f_paths(&f_learn_paths, (const char **) f_learn_patterns, f_learn_counts, &f_classify_paths, &f_classify_names, f_classify_pattern, f_classify_cnt)) {
-        goto fail;
+    if (!evaluate(&params, learn, test, f_out)) {
+        print_err("Unexpected error occured during program execution.");
+        corpus_free(&learn); corpus_free(&test);
+        return EXIT_FAILURE;
     }
 
-    if (!process((const char **) f_learn_paths, f_learn_counts, (const char **) f_classify_paths, (const char **) f_classify_names, f_classify_cnt, f_out)) {
-        goto fail;
+    corpus_free(&learn); corpus_free(&test);
+    return EXIT_SUCCESS;
+}
+
+
+/**
+ * \brief load_kfold_args Loads kfold command input arguments.
+ * \param argc Command input arguments count.
+ * \param argv Command input arguments values.
+ * \param params Pointer to classifier parameters.
+ * \param folds_cnt Pointer to a number of folds.
+ * \param c Pointer to where the corpus of labeled files will be stored.
+ * \param f_out Pointer to an evaluation result file path.
+ * \return 1 if all command arguments are provided and valid, else 0.
+ */
+int load_kfold_args(int argc, char **argv, nbc_params *params, size_t *folds_cnt, corpus **c, char **f_out) {
+    int arg;
+
+    /* folds are unlearnt from the counts of tokenized files, which admit every feature
+       and are learnt by one thread (no -m, -M, -j), never placed (no -P) and scored by ids (no -p) */
+    arg = load_options(argc, argv, params);
+    if (!arg || arg >= argc || params->threads > 1 || params->min_count > 1 || params->max_words ||
+        params->placement != NBC_PLACE_DEFAULT || params->parts) {
+        return 0;
+    }
+    if (!load_count(argv[arg++], folds_cnt)) {
+        return 0;
     }
 
-    unload_f_paths(&f_learn_paths, f_learn_counts, &f_classify_paths, &f_classify_names, f_classify_cnt);
-    return EXIT_SUCCESS;
+    *c = load_corpus(argc, argv, &arg, CLASSIFIER_CLS_CNT);
+    if (!*c || (*c)->cls_cnt != CLASSIFIER_CLS_CNT || argc - arg != 1) {
+        return 0;
+    }
+    *f_out = argv[arg];
 
-fail:
-    print_err("Unexpected error occured during program execution.");
-    unload_f_paths(&f_learn_paths, f_learn_counts, &f_classify_paths, &f_classify_names, f_classify_cnt);
-    return EXIT_FAILURE;
+    return *folds_cnt >= 2 && (!(*c)->docs_cnt || *folds_cnt <= (*c)->docs_cnt);
+}
+
+
+/**
+ * \brief cross_validate Tokenizes the labeled files once (reading the corpus), learns all of them
+ *                       and scores the files of each fold by the classifier, which unlearnt that fold.
+ *                       Outputs the evaluation of all spam score thresholds into provided output file.
+ *                       File f belongs to the fold f modulo folds count.
+ * \param params Pointer to classifier parameters.
+ * \param folds_cnt Number of folds.
+ * \param c Pointer to a corpus of labeled files.
+ * \param f_out Output file path.
+ * \return 1 if operation was successful, else 0.
+ */
+int cross_validate(const nbc_params *params, const size_t folds_cnt, corpus *c, const char *f_out) {
+    nbc *cl = NULL;
+    nbc_vocab *vocab = NULL;
+    vector *ids = NULL, *docs_offsets = NULL, *docs_scores = NULL;
+    size_t *ids_offsets = NULL;
+    eval_score *scores = NULL;
+    eval_score score;
+    double cls_scores[CLASSIFIER_CLS_CNT];
+    char message[256];
+    corpus_doc doc;
+    FILE *fp = NULL;
+    size_t f_cnt, f, fold, correct_cnt, offset;
+    int found;
+
+    cl = nbc_create(CLASSIFIER_CLS_CNT, params);
+    ids = vector_create(sizeof(size_t), NULL);
+    docs_offsets = vector_create(sizeof(size_t), NULL);
+    docs_scores = vector_create(sizeof(eval_score), NULL);
+    if (!cl || !ids || !docs_offsets || !docs_scores || !reserve_corpus(cl, c)) {
+        goto fail;
+    }
+    if (corpus_is_cache(c)) {
+        vocab = nbc_vocab_create(cl, c->words, c->words_cnt);
+        if (!vocab) {
+            goto fail;
+        }
+    }
+
+    score.margin = 0;
+    while ((found = corpus_next(c, &doc)) == 1) {
+        offset = vector_count(ids);
+        score.positive = doc.cls == SPAM;
+        if (doc.cls < 0 || !vector_push_back(docs_offsets, &offset) || !vector_push_back(docs_scores, &score)) {
+            goto fail;
+        }
+        if (vocab ? !nbc_tokenize_words(cl, vocab, doc.words, doc.words_cnt, ids) :
+            doc.path ? !nbc_tokenize(cl, doc.path, ids) : !nbc_tokenize_buffer(cl, doc.text, doc.text_size, ids)) {
+            goto fail;
+        }
+    }
+    offset = vector_count(ids);
+    f_cnt = vector_count(docs_scores);
+    if (found == -1 || folds_cnt > f_cnt || !vector_push_back(docs_offsets, &offset)) {
+        goto fail;
+    }
+    ids_offsets = (size_t *) docs_offsets->data;
+    scores = (eval_score *) docs_scores->data;
+
+    for (f = 0; f < f_cnt; f++) {
+        if (!nbc_learn_ids(cl, (size_t *) ids->data + ids_offsets[f], ids_offsets[f + 1] - ids_offsets[f],
+                           scores[f].positive ? SPAM : HAM)) {
+            goto fail;
+        }
+    }
+
+    for (fold = 0; fold < folds_cnt; fold++) {
+        for (f = fold; f < f_cnt; f += folds_cnt) {
+            if (!nbc_unlearn_ids(cl, (size_t *) ids->data + ids_offsets[f], ids_offsets[f + 1] - ids_offsets[f],
+                                 scores[f].positive ? SPAM : HAM)) {
+                goto fail;
+            }
+        }
+        if (!nbc_learn_finish(cl)) {
+            goto fail;
+        }
+
+        correct_cnt = 0;
+        for (f = fold; f < f_cnt; f += folds_cnt) {
+            if (!nbc_score_ids(cl, (size_t *) ids->data + ids_offsets[f], ids_offsets[f + 1] - ids_offsets[f], cls_scores)) {
+                goto fail;
+            }
+            scores[f].margin = cls_scores[SPAM] - cls_scores[HAM];
+            correct_cnt += (scores[f].margin >= 0) == scores[f].positive ? 1 : 0;
+        }
+
+        for (f = fold; f < f_cnt; f += folds_cnt) {
+            if (!nbc_learn_ids(cl, (size_t *) ids->data + ids_offsets[f], ids_offsets[f + 1] - ids_offsets[f],
+                               scores[f].positive ? SPAM : HAM)) {
+                goto fail;
+            }
+        }
+
+        sprintf(message, "Fold %lu/%lu: %lu of %lu files classified correctly.", (unsigned long) fold + 1,
+                (unsigned long) folds_cnt, (unsigned long) correct_cnt, (unsigned long) ((f_cnt - fold - 1) / folds_cnt + 1));
+        print_progress(message);
+    }
+
+    fp = fopen(f_out, "w");
+    if (!fp || !eval_sweep(scores, f_cnt, fp)) {
+        goto fail;
+    }
+    if (fclose(fp) == EOF) {
+        fp = NULL;
+        goto fail;
+    }
+
+    vector_free(&docs_scores); vector_free(&docs_offsets);
+    vector_free(&ids);
+    nbc_vocab_free(&vocab);
+    nbc_free(&cl);
+    return 1;
+
+fail:
+    if (fp) {
+        fclose(fp);
+    }
+    vector_free(&docs_scores); vector_free(&docs_offsets);
+    vector_free(&ids);
+    nbc_vocab_free(&vocab);
+    nbc_free(&cl);
+    return 0;
+}
+
+
+/**
+ * \brief run_kfold Processes kfold command input arguments, cross-validates the classifier on provided files,
+ *                  outputs evaluation of thresholds into provided file.
+ * \param argc Command input arguments count.
+ * \param argv Command input arguments values.
+ * \return EXIT_SUCCESS if not any problem occured, else EXIT_FAILURE.
+ */
+int run_kfold(int argc, char **argv) {
+    nbc_params params;
+    size_t folds_cnt;
+    corpus *c = NULL;
+    char *f_out = NULL;
+
+    if (!load_kfold_args(argc, argv, &params, &folds_cnt, &c, &f_out)) {
+        print_err("Invalid arguments count/values.");
+        printf("\n");
+        print_man();
+        corpus_free(&c);
+        return EXIT_FAILURE;
+    }
+
+    if (!cross_validate(&params, folds_cnt, c, f_out)) {
+        print_err("Unexpected error occured during program execution.");
+        corpus_free(&c);
+        return EXIT_FAILURE;
+    }
+
+    corpus_free(&c);
+    return EXIT_SUCCESS;
+}
+
+
+/**
+ * \brief load_filter_args Loads filter command input arguments.
+ * \param argc Command input arguments count.
+ * \param argv Command input arguments values.
+ * \param params Pointer to classifier parameters.
+ * \param format Pointer to where the format of messages will be stored.
+ * \param learn Pointer to where the corpus of files to be learnt will be stored.
+ * \return 1 if all command arguments are provided and valid, else 0.
+ */
+int load_filter_args(int argc, char **argv, nbc_params *params, messages_format *format, corpus **learn) {
+    int arg;
+
+    arg = load_options(argc, argv, params);
+    if (!arg || arg >= argc) {
+        return 0;
+    }
+
+    if (strcmp(argv[arg], FILTER_FORMAT_MBOX) == 0) {
+        *format = MESSAGES_MBOX;
+    }
+    else if (strcmp(argv[arg], FILTER_FORMAT_FRAMED) == 0) {
+        *format = MESSAGES_FRAMED;
+    }
+    else {
+        return 0;
+    }
+    arg++;
+
+    /* the standard input carries the messages, it cannot list the learnt files too */
+    *learn = load_learn_corpus(argc, argv, &arg);
+    if (!*learn || (*learn)->fp == stdin || arg != argc) {
+        return 0;
+    }
+
+    return 1;
+}
+
+
+/**
+ * \brief filter Teaches the classifier provided files once, then classifies the messages of the standard input
+ *               one by one and writes one verdict line per message to the standard output.
+ *               Verdicts are written in blocks of the output buffer, an empty frame flushes them.
+ * \param params Pointer to classifier parameters.
+ * \param learn Pointer to a corpus of files to be learnt.
+ * \param format Format of the messages.
+ * \return 1 if operation was successful, else 0.
+ */
+int filter(const nbc_params *params, corpus *learn, const messages_format format) {
+    nbc *cl = NULL;
+    messages *m = NULL;
+    double scores[CLASSIFIER_CLS_CNT];
+    const char *text = NULL;
+    size_t size, msg_cnt;
+    int cls, found;
+
+    if (setvbuf(stdin, NULL, _IOFBF, FILTER_BUFFER_SIZE) != 0 ||
+        setvbuf(stdout, NULL, _IOFBF, FILTER_BUFFER_SIZE) != 0) {
+        return 0;
+    }
+
+    cl = nbc_create(CLASSIFIER_CLS_CNT, params);
+    if (!cl || !learn_corpus(cl, learn)) {
+        goto fail;
+    }
+    m = messages_open(stdin, format);
+    if (!m) {
+        goto fail;
+    }
+
+    msg_cnt = 0;
+    while ((found = messages_next(m, &text, &size)) != 0) {
+        if (found == -1) {
+            goto fail;
+        }
+        if (found == 2) {
+            if (fflush(stdout) == EOF) {
+                goto fail;
+            }
+            continue;
+        }
+
+        if (!nbc_score_buffer(cl, text, size, scores)) {
+            goto fail;
+        }
+        cls = nbc_classify_scores(cl, scores);
+        if (printf(FILTER_LINE_FORMAT, (unsigned long) ++msg_cnt, RESULT_CLASS_DESCRIPTION[cls],
+                   scores[SPAM] - scores[HAM]) < 0) {
+            goto fail;
+        }
+    }
+    if (fflush(stdout) == EOF) {
+        goto fail;
+    }
+
+    messages_free(&m);
+    nbc_free(&cl);
+    return 1;
+
+fail:
+    messages_free(&m);
+    nbc_free(&cl);
+    return 0;
+}
+
+
+/**
+ * \brief run_filter Processes filter command input arguments, teaches classifier provided files
+ *                   and classifies the messages of the standard input.
+ * \param argc Command input arguments count.
+ * \param argv Command input arguments values.
+ * \return EXIT_SUCCESS if not any problem occured, else EXIT_FAILURE.
+ */
+int run_filter(int argc, char **argv) {
+    nbc_params params;
+    messages_format format;
+    corpus *learn = NULL;
+
+    if (!load_filter_args(argc, argv, &params, &format, &learn)) {
+        print_err("Invalid arguments count/values.");
+        printf("\n");
+        print_man();
+        corpus_free(&learn);
+        return EXIT_FAILURE;
+    }
+
+    if (!filter(&params, learn, format)) {
+        print_err("Unexpected error occured during program execution.");
+        corpus_free(&learn);
+        return EXIT_FAILURE;
+    }
+
+    corpus_free(&learn);
+    return EXIT_SUCCESS;
+}
+
+
+/**
+ * \brief load_serve_args Loads serve command input arguments.
+ * \param argc Command input arguments count.
+ * \param argv Command input arguments values.
+ * \param source Pointer to where the classifier parameters and the arguments of the corpus will be stored.
+ * \param f_socket Pointer to the socket file path.
+ * \param workers_cnt Pointer to where the number of worker threads will be stored.
+ * \param learn Pointer to where the corpus of files to be learnt will be stored.
+ * \return 1 if all command arguments are provided and valid, else 0.
+ */
+int load_serve_args(int argc, char **argv, serve_source *source, char **f_socket, size_t *workers_cnt, corpus **learn) {
+    int arg;
+
+    /* workers score concurrently, the partitions serve one scoring thread (no -p) */
+    arg = load_options(argc, argv, &source->params);
+    if (!arg || source->params.parts || argc - arg < 2 || !load_count(argv[arg + 1], workers_cnt)) {
+        return 0;
+    }
+    *f_socket = argv[arg];
+    arg += 2;
+
+    source->argc = argc;
+    source->argv = argv;
+    source->arg = arg;
+    *learn = load_learn_corpus(argc, argv, &arg);
+    if (!*learn || arg != argc) {
+        return 0;
+    }
+
+    return 1;
+}
+
+
+/**
+ * \brief reload_model Learns the classifier of the reopened corpus of the serve command (server_loader).
+ *                     Current classifier keeps serving meanwhile and if the reload fails.
+ * \param arg Pointer to the serve source.
+ * \return Pointer to a learnt classifier, or NULL on failure.
+ */
+nbc *reload_model(void *arg) {
+    const serve_source *source = (const serve_source *) arg;
+    corpus *learn = NULL;
+    nbc *cl = NULL;
+    int corpus_arg;
+
+    corpus_arg = source->arg;
+    learn = load_learn_corpus(source->argc, source->argv, &corpus_arg);
+    if (learn) {
+        cl = nbc_create(CLASSIFIER_CLS_CNT, &source->params);
+        if (cl && !learn_corpus(cl, learn)) {
+            nbc_free(&cl);
+        }
+    }
+    corpus_free(&learn);
+
+    if (cl) {
+        print_info("Model reloaded.");
+    }
+    else {
+        print_err("Model could not be reloaded, the current one keeps serving.");
+    }
+    fflush(stdout);
+
+    return cl;
+}
+
+
+/**
+ * \brief serve Teaches the classifier provided files once, then serves classification requests
+ *              over the Unix domain socket until SIGINT or SIGTERM is received.
+ *              The corpus is reopened and learnt again on SIGHUP.
+ * \param source Pointer to the classifier parameters and the arguments of the corpus.
+ * \param learn Pointer to a corpus of files to be learnt, released once it is learnt.
+ * \param f_socket Path to the socket file.
+ * \param workers_cnt Number of worker threads.
+ * \return 1 if operation was successful, else 0.
+ */
+int serve(serve_source *source, corpus *learn, const char *f_socket, const size_t workers_cnt) {
+    nbc *cl = NULL;
+    snapshots *models = NULL;
+    char message[256];
+
+    cl = nbc_create(CLASSIFIER_CLS_CNT, &source->params);
+    if (!cl || !learn_corpus(cl, learn)) {
+        nbc_free(&cl);
+        corpus_free(&learn);
+        return 0;
+    }
+    print_hash_collisions(cl);
+    corpus_free(&learn);
+
+    models = snapshots_create(cl, workers_cnt);
+    if (!models) {
+        return 0;
+    }
+
+    sprintf(message, "Serving on \"%.128s\" with %lu workers.", f_socket, (unsigned long) workers_cnt);
+    print_info(message);
+    fflush(stdout);
+    if (!server_run(models, RESULT_CLASS_DESCRIPTION, f_socket, workers_cnt, reload_model, source)) {
+        snapshots_free(&models);
+        return 0;
+    }
+    print_info("Serving ended.");
+
+    snapshots_free(&models);
+    return 1;
+}
+
+
+/**
+ * \brief run_serve Processes serve command input arguments, teaches classifier provided files
+ *                  and serves classification requests.
+ * \param argc Command input arguments count.
+ * \param argv Command input arguments values.
+ * \return EXIT_SUCCESS if not any problem occured, else EXIT_FAILURE.
+ */
+int run_serve(int argc, char **argv) {
+    serve_source source;
+    corpus *learn = NULL;
+    char *f_socket = NULL;
+    size_t workers_cnt;
+
+    if (!load_serve_args(argc, argv, &source, &f_socket, &workers_cnt, &learn)) {
+        print_err("Invalid arguments count/values.");
+        printf("\n");
+        print_man();
+        corpus_free(&learn);
+        return EXIT_FAILURE;
+    }
+
+    /* the corpus is released by serve once learnt, the model alone is held while serving */
+    if (!serve(&source, learn, f_socket, workers_cnt)) {
+        print_err("Unexpected error occured during program execution.");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+/**
+ * \brief load_texts Loads the non-empty texts of the documents of the corpus (files or a pack) one after another.
+ * \param c Pointer to a corpus, not a cache.
+ * \param texts Vector of chars of the texts.
+ * \param offsets Vector of offsets of the texts, followed by the end of the last one.
+ * \return 1 if operation was successful, else 0.
+ */
+int load_texts(corpus *c, vector *texts, vector *offsets) {
+    corpus_doc doc;
+    FILE *fp = NULL;
+    char buffer[LOADGEN_BUFFER_SIZE];
+    size_t offset, read_cnt;
+    int found;
+
+    offset = 0;
+    if (!vector_push_back(offsets, &offset)) {
+        return 0;
+    }
+
+    while ((found = corpus_next(c, &doc)) == 1) {
+        if (doc.text) {
+            if (!vector_push_back_many(texts, doc.text, doc.text_size)) {
+                return 0;
+            }
+        }
+        else {
+            fp = fopen(doc.path, "rb");
+            if (!fp) {
+                return 0;
+            }
+            while ((read_cnt = fread(buffer, 1, sizeof(buffer), fp)) > 0) {
+                if (!vector_push_back_many(texts, buffer, read_cnt)) {
+                    fclose(fp);
+                    return 0;
+                }
+            }
+            if (ferror(fp)) {
+                fclose(fp);
+                return 0;
+            }
+            fclose(fp);
+        }
+
+        /* empty requests are not answered */
+        if (vector_count(texts) > offset) {
+            offset = vector_count(texts);
+            if (!vector_push_back(offsets, &offset)) {
+                return 0;
+            }
+        }
+    }
+
+    return found == 0 && vector_count(offsets) > 1;
+}
+
+
+/**
+ * \brief run_loadgen Processes loadgen command input arguments, sends the tested files to the serve command
+ *                    and prints the throughput and the latencies.
+ * \param argc Command input arguments count.
+ * \param argv Command input arguments values.
+ * \return EXIT_SUCCESS if not any problem occured, else EXIT_FAILURE.
+ */
+int run_loadgen(int argc, char **argv) {
+    corpus *c = NULL;
+    vector *texts = NULL, *offsets = NULL;
+    loadgen_stats stats;
+    size_t conns_cnt, requests_cnt;
+    char message[256];
+    int arg;
+
+    arg = 4;
+    if (argc < 5 || !load_count(argv[2], &conns_cnt) || !load_count(argv[3], &requests_cnt) ||
+        has_prefix(argv[arg], CACHE_ARG_PREFIX) || !(c = load_corpus(argc, argv, &arg, 1)) || arg != argc) {
+        print_err("Invalid arguments count/values.");
+        printf("\n");
+        print_man();
+        corpus_free(&c);
+        return EXIT_FAILURE;
+    }
+
+    texts = vector_create(sizeof(char), NULL);
+    offsets = vector_create(sizeof(size_t), NULL);
+    if (!texts || !offsets || !load_texts(c, texts, offsets) ||
+        !loadgen_run(argv[1], conns_cnt, requests_cnt, (const char *) texts->data, (const size_t *) offsets->data,
+                     vector_count(offsets) - 1, &stats)) {
+        print_err("Unexpected error occured during program execution.");
+        vector_free(&texts); vector_free(&offsets);
+        corpus_free(&c);
+        return EXIT_FAILURE;
+    }
+
+    sprintf(message, "Load: %lu requests answered, %lu failed in %.3f s, %.0f requests/s.",
+            (unsigned long) stats.requests_cnt, (unsigned long) stats.failed_cnt, stats.seconds,
+            stats.seconds > 0 ? stats.requests_cnt / stats.seconds : 0);
+    print_info(message);
+    sprintf(message, "Latency: p50 %.3f ms, p99 %.3f ms, max %.3f ms.", 1e3 * stats.p50, 1e3 * stats.p99, 1e3 * stats.max);
+    print_info(message);
+
+    vector_free(&texts); vector_free(&offsets);
+    corpus_free(&c);
+    return stats.failed_cnt ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+
+/**
+ * \brief run_bench_counts Counts the words of Zipfian frequencies into the counts shared by 1, 2, 4 ...
+ *                         NBC_MAX_THREADS threads and prints the throughput of each number of threads.
+ * \param tokens_cnt Number of counted words.
+ * \return EXIT_SUCCESS if not any problem occured, else EXIT_FAILURE.
+ */
+int run_bench_counts(const size_t tokens_cnt) {
+    size_t threads_cnt[NBC_MAX_THREADS], runs_cnt, r;
+    double seconds[NBC_MAX_THREADS];
+    char message[256];
+
+    for (runs_cnt = 0; ((size_t) 1 << runs_cnt) <= NBC_MAX_THREADS; runs_cnt++) {
+        threads_cnt[runs_cnt] = (size_t) 1 << runs_cnt;
+    }
+
+    if (!bench_shtab_count(tokens_cnt, threads_cnt, runs_cnt, seconds)) {
+        print_err("Unexpected error occured during program execution.");
+        return EXIT_FAILURE;
+    }
+
+    for (r = 0; r < runs_cnt; r++) {
+        sprintf(message, "Counts: %lu threads counted %lu words in %.3f s, %.2f M words/s, speedup %.2f.",
+                (unsigned long) threads_cnt[r], (unsigned long) tokens_cnt, seconds[r],
+                tokens_cnt / (1e6 * seconds[r]), seconds[0] / seconds[r]);
+        print_info(message);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+/**
+ * \brief run_bench_parts Scores the documents of words of Zipfian frequencies by one thread and by 1, 2, 4 ...
+ *                        NBC_MAX_PARTS partitions of the vocabulary and prints the throughput of each.
+ * \param words_cnt Number of words of the classifier.
+ * \return EXIT_SUCCESS if not any problem occured, else EXIT_FAILURE.
+ */
+int run_bench_parts(const size_t words_cnt) {
+    size_t parts_cnt[NBC_MAX_PARTS + 1], runs_cnt, docs_cnt, r;
+    double seconds[NBC_MAX_PARTS + 1];
+    char message[256];
+
+    parts_cnt[0] = 0;
+    for (runs_cnt = 1; ((size_t) 1 << (runs_cnt - 1)) <= NBC_MAX_PARTS; runs_cnt++) {
+        parts_cnt[runs_cnt] = (size_t) 1 << (runs_cnt - 1);
+    }
+
+    if (!bench_nbc_parts(words_cnt, parts_cnt, runs_cnt, &docs_cnt, seconds)) {
+        print_err("Unexpected error occured during program execution.");
+        return EXIT_FAILURE;
+    }
+
+    for (r = 0; r < runs_cnt; r++) {
+        if (!parts_cnt[r]) {
+            sprintf(message, "Parts: one thread scored %lu documents in %.3f s, %.0f documents/s.",
+                    (unsigned long) docs_cnt, seconds[r], docs_cnt / seconds[r]);
+        }
+        else {
+            sprintf(message, "Parts: %lu partitions scored %lu documents in %.3f s, %.0f documents/s, speedup %.2f.",
+                    (unsigned long) parts_cnt[r], (unsigned long) docs_cnt, seconds[r], docs_cnt / seconds[r],
+                    seconds[0] / seconds[r]);
+        }
+        print_info(message);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+/**
+ * \brief run_bench Processes bench command input arguments, adds the words to a dictionary
+ *                  and prints the histograms of latencies of the additions, rehashing all the entries at once
+ *                  (baseline) and expanding the buckets incrementally (or runs the counts or parts benchmark).
+ * \param argc Command input arguments count.
+ * \param argv Command input arguments values.
+ * \return EXIT_SUCCESS if not any problem occured, else EXIT_FAILURE.
+ */
+int run_bench(int argc, char **argv) {
+    bench_stats stats[2];
+    size_t words_cnt, bin;
+    char message[256];
+
+    if (argc == 3 && strcmp(argv[1], BENCH_COUNTS) == 0 && load_count(argv[2], &words_cnt) && words_cnt) {
+        return run_bench_counts(words_cnt);
+    }
+    if (argc == 3 && strcmp(argv[1], BENCH_PARTS) == 0 && load_count(argv[2], &words_cnt) && words_cnt) {
+        return run_bench_parts(words_cnt);
+    }
+    if (argc != 2 || !load_count(argv[1], &words_cnt)) {
+        print_err("Invalid arguments count/values.");
+        printf("\n");
+        print_man();
+        return EXIT_FAILURE;
+    }
+
+    if (!bench_htab_add(words_cnt, 1, &stats[0]) || !bench_htab_add(words_cnt, 0, &stats[1])) {
+        print_err("Unexpected error occured during program execution.");
+        return EXIT_FAILURE;
+    }
+
+    sprintf(message, "Dictionary (full rehash): %lu words added in %.3f s, max latency %.3f ms.",
+            (unsigned long) stats[0].ops_cnt, stats[0].seconds, 1e3 * stats[0].max);
+    print_info(message);
+    sprintf(message, "Dictionary (incremental): %lu words added in %.3f s, max latency %.3f ms.",
+            (unsigned long) stats[1].ops_cnt, stats[1].seconds, 1e3 * stats[1].max);
+    print_info(message);
+    for (bin = 0; bin < BENCH_HIST_SIZE; bin++) {
+        if (!stats[0].hist[bin] && !stats[1].hist[bin]) {
+            continue;
+        }
+        if (bin == 0) {
+            sprintf(message, "Latency < 1 ns: %lu words (full rehash), %lu words (incremental).",
+                    (unsigned long) stats[0].hist[bin], (unsigned long) stats[1].hist[bin]);
+        }
+        else if (bin == BENCH_HIST_SIZE - 1) {
+            sprintf(message, "Latency >= %lu ns: %lu words (full rehash), %lu words (incremental).",
+                    1UL << (bin - 1), (unsigned long) stats[0].hist[bin], (unsigned long) stats[1].hist[bin]);
+        }
+        else {
+            sprintf(message, "Latency %lu - %lu ns: %lu words (full rehash), %lu words (incremental).",
+                    1UL << (bin - 1), 1UL << bin, (unsigned long) stats[0].hist[bin],
+                    (unsigned long) stats[1].hist[bin]);
+        }
+        print_info(message);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+/**
+ * \brief load_convert_args Loads the input arguments of the commands converting a corpus into a file,
+ *                          the corpus (of any number of classes, not a cache) followed by the output file.
+ * \param argc Command input arguments count.
+ * \param argv Command input arguments values.
+ * \param f_out Pointer to the output file path.
+ * \return Pointer to the corpus, or NULL if the arguments are not valid or the corpus could not be opened.
+ */
+corpus *load_convert_args(int argc, char **argv, char **f_out) {
+    corpus *c = NULL;
+    int arg;
+
+    arg = 1;
+    if (argc < 3 || has_prefix(argv[arg], CACHE_ARG_PREFIX)) {
+        return NULL;
+    }
+    if (has_prefix(argv[arg], MANIFEST_ARG_PREFIX) || has_prefix(argv[arg], PACK_ARG_PREFIX)) {
+        c = load_corpus(argc, argv, &arg, CLASSIFIER_CLS_CNT);
+    }
+    else if (has_prefix(argv[arg], DIR_ARG_PREFIX)) {
+        c = load_corpus(argc, argv, &arg, argc - 2);
+    }
+    else if ((argc - 2) % 2 == 0) {
+        c = load_corpus(argc, argv, &arg, (argc - 2) / 2);
+    }
+    if (!c || argc - arg != 1) {
+        corpus_free(&c);
+        return NULL;
+    }
+    *f_out = argv[arg];
+
+    return c;
+}
+
+
+/**
+ * \brief run_tokenize Processes tokenize command input arguments, tokenizes provided files
+ *                     and writes them into provided corpus cache file.
+ * \param argc Command input arguments count.
+ * \param argv Command input arguments values.
+ * \return EXIT_SUCCESS if not any problem occured, else EXIT_FAILURE.
+ */
+int run_tokenize(int argc, char **argv) {
+    corpus *c = NULL;
+    char *f_out = NULL;
+    char message[256];
+
+    c = load_convert_args(argc, argv, &f_out);
+    if (!c) {
+        print_err("Invalid arguments count/values.");
+        printf("\n");
+        print_man();
+        return EXIT_FAILURE;
+    }
+
+    if (!corpus_write_cache(c, f_out)) {
+        print_err("Unexpected error occured during program execution.");
+        corpus_free(&c);
+        return EXIT_FAILURE;
+    }
+
+    corpus_free(&c);
+    c = corpus_open_cache(f_out);
+    if (!c) {
+        print_err("Unexpected error occured during program execution.");
+        return EXIT_FAILURE;
+    }
+    sprintf(message, "Corpus cache: %lu files, %lu distinct words, %lu words.", (unsigned long) c->docs_cnt,
+            (unsigned long) c->words_cnt, (unsigned long) c->docs_offsets[c->docs_cnt]);
+    print_info(message);
+
+    corpus_free(&c);
+    return EXIT_SUCCESS;
+}
+
+
+/**
+ * \brief run_pack Processes pack command input arguments, packs provided files
+ *                 and writes them into provided corpus pack file.
+ * \param argc Command input arguments count.
+ * \param argv Command input arguments values.
+ * \return EXIT_SUCCESS if not any problem occured, else EXIT_FAILURE.
+ */
+int run_pack(int argc, char **argv) {
+    corpus *c = NULL;
+    char *f_out = NULL;
+    char message[256];
+
+    c = load_convert_args(argc, argv, &f_out);
+    if (!c) {
+        print_err("Invalid arguments count/values.");
+        printf("\n");
+        print_man();
+        return EXIT_FAILURE;
+    }
+
+    if (!corpus_write_pack(c, f_out)) {
+        print_err("Unexpected error occured during program execution.");
+        corpus_free(&c);
+        return EXIT_FAILURE;
+    }
+
+    corpus_free(&c);
+    c = corpus_open_pack(f_out);
+    if (!c) {
+        print_err("Unexpected error occured during program execution.");
+        return EXIT_FAILURE;
+    }
+    sprintf(message, "Corpus pack: %lu files, %lu bytes of texts.", (unsigned long) c->docs_cnt,
+            (unsigned long) c->docs_offsets[c->docs_cnt]);
+    print_info(message);
+
+    corpus_free(&c);
+    return EXIT_SUCCESS;
+}
+
+
+/**
+ * \brief load_shard Loads the shard "<shard>/<shards>" of the corpus (shard from 1 to shards).
+ * \param str String to be loaded.
+ * \param shard Pointer to where the index of the shard (from 0) will be stored.
+ * \param shards_cnt Pointer to where the number of shards will be stored.
+ * \return 1 if the shard is valid, else 0.
+ */
+int load_shard(const char *str, size_t *shard, size_t *shards_cnt) {
+    char number[32];
+    const char *slash = NULL;
+
+    slash = strchr(str, '/');
+    if (!slash || (size_t) (slash - str) >= sizeof(number)) {
+        return 0;
+    }
+    memcpy(number, str, slash - str);
+    number[slash - str] = '\0';
+    if (!load_count(number, shard) || !load_count(slash + 1, shards_cnt) ||
+        *shard == 0 || *shard > *shards_cnt) {
+        return 0;
+    }
+
+    (*shard)--;
+    return 1;
+}
+
+
+/**
+ * \brief load_count_args Loads count command input arguments.
+ * \param argc Command input arguments count.
+ * \param argv Command input arguments values.
+ * \param params Pointer to classifier parameters.
+ * \param shard Pointer to where the index of the counted shard (from 0) will be stored.
+ * \param shards_cnt Pointer to where the number of shards (1 for the whole corpus) will be stored.
+ * \param memory_size Pointer to where the memory budget of the counts in bytes will be stored.
+ * \param c Pointer to where the corpus of files to be counted will be stored.
+ * \param f_out Pointer to the counts file path.
+ * \return 1 if all command arguments are provided and valid, else 0.
+ */
+int load_count_args(int argc, char **argv, nbc_params *params, size_t *shard, size_t *shards_cnt,
+                    size_t *memory_size, corpus **c, char **f_out) {
+    size_t memory_mb;
+    int arg, shard_args;
+
+    *shard = 0;
+    *shards_cnt = 1;
+    shard_args = 0;
+    if (argc > 2 && strcmp(argv[1], COUNT_SHARD_OPTION) == 0) {
+        if (!load_shard(argv[2], shard, shards_cnt)) {
+            return 0;
+        }
+        shard_args = 2;
+    }
+
+    /* counts are exact, the dictionary is bounded once they are learnt */
+    arg = load_options(argc - shard_args, argv + shard_args, params);
+    if (!arg) {
+        return 0;
+    }
+    arg += shard_args;
+    if (params->hash_bits || params->threads > 1 || params->min_count > 1 || params->max_words || params->parts ||
+        arg >= argc || !load_count(argv[arg], &memory_mb) || memory_mb > ((size_t) -1 >> 20)) {
+        return 0;
+    }
+    *memory_size = memory_mb << 20;
+    arg++;
+
+    *c = load_corpus(argc, argv, &arg, CLASSIFIER_CLS_CNT);
+    if (!*c || (*c)->cls_cnt != CLASSIFIER_CLS_CNT || argc - arg != 1) {
+        return 0;
+    }
+    *f_out = argv[arg];
+
+    return 1;
+}
+
+
+/**
+ * \brief print_counts Prints the numbers of files and words of the counts file.
+ * \param f_path Path to the counts file.
+ * \return 1 if the counts file is valid, else 0.
+ */
+int print_counts(const char f_path[]) {
+    counts_file *cf = NULL;
+    char message[256];
+
+    cf = counts_open(f_path);
+    if (!cf) {
+        return 0;
+    }
+    sprintf(message, "Counts file: %lu spam files, %lu ham files, %lu distinct words.",
+            (unsigned long) cf->cls_docs_cnt[SPAM], (unsigned long) cf->cls_docs_cnt[HAM],
+            (unsigned long) cf->header.words_cnt);
+    print_info(message);
+
+    counts_close(&cf);
+    return 1;
+}
+
+
+/**
+ * \brief run_count Processes count command input arguments, counts the words of provided files (of the shard)
+ *                  in the memory budget and writes them into provided counts file.
+ * \param argc Command input arguments count.
+ * \param argv Command input arguments values.
+ * \return EXIT_SUCCESS if not any problem occured, else EXIT_FAILURE.
+ */
+int run_count(int argc, char **argv) {
+    nbc_params params;
+    corpus *c = NULL;
+    char *f_out = NULL;
+    size_t shard, shards_cnt, memory_size;
+
+    if (!load_count_args(argc, argv, &params, &shard, &shards_cnt, &memory_size, &c, &f_out)) {
+        print_err("Invalid arguments count/values.");
+        printf("\n");
+        print_man();
+        corpus_free(&c);
+        return EXIT_FAILURE;
+    }
+
+    if (!training_count_corpus(&params, c, shard, shards_cnt, memory_size, f_out)) {
+        print_err("Unexpected error occured during program execution.");
+        corpus_free(&c);
+        return EXIT_FAILURE;
+    }
+
+    corpus_free(&c);
+    if (!print_counts(f_out)) {
+        print_err("Unexpected error occured during program execution.");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+/**
+ * \brief run_merge Processes merge command input arguments, merges provided counts files (e.g. of shards)
+ *                  into provided counts file.
+ * \param argc Command input arguments count.
+ * \param argv Command input arguments values.
+ * \return EXIT_SUCCESS if not any problem occured, else EXIT_FAILURE.
+ */
+int run_merge(int argc, char **argv) {
+    size_t threads_cnt;
+    int arg;
+
+    threads_cnt = 1;
+    arg = 1;
+    if (argc > 2 && strcmp(argv[1], "-j") == 0) {
+        if (!load_count(argv[2], &threads_cnt) || threads_cnt > COUNTS_MAX_THREADS) {
+            arg = argc;
+        }
+        arg += 2;
+    }
+    if (argc - arg < 2) {
+        print_err("Invalid arguments count/values.");
+        printf("\n");
+        print_man();
+        return EXIT_FAILURE;
+    }
+
+    if (!counts_merge((const char **) argv + arg, argc - arg - 1, argv[argc - 1], threads_cnt) ||
+        !print_counts(argv[argc - 1])) {
+        print_err("Unexpected error occured during program execution.");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+/**
+ * \brief main Processes input arguments, teaches classifier provided files,
+ *             classifies provided files, outputs results into provided file.
+ * \param argc Program input arguments count.
+ * \param argv Program input arguments values.
+ * \return EXIT_SUCCESS if not any problem occured, else EXIT_FAILURE.
+ */
+int main(int argc, char **argv) {
+    nbc_params params;
+    corpus *learn = NULL, *classify = NULL;
+    char *f_out = NULL;
+
+    if (argc > 1 && strcmp(argv[1], CMD_EVAL) == 0) {
+        return run_eval(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], CMD_KFOLD) == 0) {
+        return run_kfold(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], CMD_TOKENIZE) == 0) {
+        return run_tokenize(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], CMD_PACK) == 0) {
+        return run_pack(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], CMD_COUNT) == 0) {
+        return run_count(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], CMD_MERGE) == 0) {
+        return run_merge(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], CMD_FILTER) == 0) {
+        return run_filter(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], CMD_SERVE) == 0) {
+        return run_serve(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], CMD_LOADGEN) == 0) {
+        return run_loadgen(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], CMD_BENCH) == 0) {
+        return run_bench(argc - 1, argv + 1);
+    }
+
+    if (!load_args(argc, argv, &params, &learn, &classify, &f_out)) {
+        print_err("Invalid arguments count/values.");
+        printf("\n");
+        print_man();
+        corpus_free(&learn); corpus_free(&classify);
+        return EXIT_FAILURE;
+    }
+
+    if (!process(&params, learn, classify, f_out)) {
+        print_err("Unexpected error occured during program execution.");
+        corpus_free(&learn); corpus_free(&classify);
+        return EXIT_FAILURE;
+    }
+
+    corpus_free(&learn); corpus_free(&classify);
+    return EXIT_SUCCESS;
 }
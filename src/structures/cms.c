@@ -0,0 +1,172 @@
+/**
+ * \file cms.c
+ * \brief Functions declared in cms.h are implemented in this file.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Counters of a key are chosen by double hashing, the counter of the row r is (h1 + r * h2) mod width,
+ * where h1 is the hash of the key and h2 (odd) is the hash of the key mixed once more.
+ */
+
+
+#include <stdlib.h>
+
+#include "cms.h"
+#include "../utilities/arrays.h"
+#include "../utilities/hashing.h"
+
+
+cms *cms_create(const size_t width, const size_t depth, const unsigned limit) {
+    cms *s = NULL;
+
+    if (!width || !depth || !limit || limit > CMS_MAX_LIMIT) {
+        return NULL;
+    }
+
+    s = (cms *) malloc(sizeof(cms));
+    if (!s) {
+        return NULL;
+    }
+
+    for (s->width = 1; s->width < width; s->width *= 2) {
+        ;
+    }
+    s->depth = depth;
+    s->limit = limit;
+    s->counters = (unsigned char *) array_create(s->width * s->depth, sizeof(unsigned char));
+    if (!s->counters) {
+        free(s);
+        return NULL;
+    }
+
+    return s;
+}
+
+
+void cms_free(cms **s) {
+    if (!s || !(*s)) {
+        return;
+    }
+
+    array_free((void **) &(*s)->counters);
+    free(*s);
+    *s = NULL;
+}
+
+
+/**
+ * \brief cms_counter Returns the counter of the key in the row.
+ *                    Does not check arguments validity.
+ * \param s Pointer to a sketch.
+ * \param hash Hash of the key.
+ * \param step Second hash of the key (odd).
+ * \param row Index of the row.
+ * \return Pointer to the counter.
+ */
+unsigned char *cms_counter(const cms *s, const unsigned long hash, const unsigned long step, const size_t row) {
+    return s->counters + row * s->width + ((size_t) (hash + row * step) & (s->width - 1));
+}
+
+
+/**
+ * \brief cms_step Returns the second hash of the key.
+ * \param hash Hash of the key.
+ * \return Second hash (odd).
+ */
+unsigned long cms_step(const unsigned long hash) {
+    return hash_combine(HASH_COMBINE_GOLDEN, hash) | 1;
+}
+
+
+unsigned cms_add(cms *s, const unsigned long hash) {
+    unsigned char *counter = NULL;
+    unsigned long step;
+    unsigned min;
+    size_t r;
+
+    if (!s) {
+        return 0;
+    }
+
+    step = cms_step(hash);
+    for (r = 0, min = s->limit; r < s->depth; r++) {
+        counter = cms_counter(s, hash, step, r);
+        if (*counter < s->limit) {
+            (*counter)++;
+        }
+        if (*counter < min) {
+            min = *counter;
+        }
+    }
+
+    return min;
+}
+
+
+/**
+ * \brief cms_counter_inc Increments the counter atomically unless it has reached the limit.
+ *                        Does not check arguments validity.
+ * \param counter Pointer to a counter.
+ * \param limit Limit of the counter.
+ * \return Value of the counter after the increment.
+ */
+unsigned cms_counter_inc(unsigned char *counter, const unsigned limit) {
+#if defined(__GNUC__)
+    unsigned char value;
+
+    value = __atomic_load_n(counter, __ATOMIC_RELAXED);
+    while (value < limit && !__atomic_compare_exchange_n(counter, &value, (unsigned char) (value + 1), 1,
+                                                         __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        ;
+    }
+
+    return value < limit ? value + 1U : value;
+#else
+    if (*counter < limit) {
+        (*counter)++;
+    }
+
+    return *counter;
+#endif
+}
+
+
+unsigned cms_add_atomic(cms *s, const unsigned long hash) {
+    unsigned long step;
+    unsigned min, value;
+    size_t r;
+
+    if (!s) {
+        return 0;
+    }
+
+    step = cms_step(hash);
+    for (r = 0, min = s->limit; r < s->depth; r++) {
+        value = cms_counter_inc(cms_counter(s, hash, step, r), s->limit);
+        if (value < min) {
+            min = value;
+        }
+    }
+
+    return min;
+}
+
+
+unsigned cms_estimate(const cms *s, const unsigned long hash) {
+    unsigned long step;
+    unsigned min;
+    size_t r;
+
+    if (!s) {
+        return 0;
+    }
+
+    step = cms_step(hash);
+    for (r = 0, min = s->limit; r < s->depth; r++) {
+        if (*cms_counter(s, hash, step, r) < min) {
+            min = *cms_counter(s, hash, step, r);
+        }
+    }
+
+    return min;
+}
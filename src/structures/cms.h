@@ -0,0 +1,86 @@
+/**
+ * \file cms.h
+ * \brief Header file related to a count-min sketch of frequencies of keys.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Sketch estimates how many times a key (given by its hash) was added in a fixed amount of memory,
+ * however many distinct keys there are. Each of depth rows of width counters counts the keys hashed to a counter,
+ * the estimate is the minimum of the counters of the key, so it is never lower than the true count
+ * (and it is higher only if the counters are shared by other frequent keys).
+ * Counters are bytes saturating at a limit, estimates above the limit are not told apart.
+ * All the counters of the key are incremented, so the counters do not depend on the order of the added keys.
+ */
+
+
+#ifndef CMS_H
+#define CMS_H
+
+
+#include <stddef.h>
+
+
+/** \brief Maximal limit of the counters. */
+#define CMS_MAX_LIMIT 255
+/** \brief Default number of rows of counters. */
+#define CMS_DEF_DEPTH 4
+
+
+/**
+ * \struct cms
+ * \brief Struct representing a count-min sketch.
+ */
+typedef struct cms_ {
+    unsigned char *counters;    /**< Rows of counters, one after another. */
+    size_t width;               /**< Number of counters of a row (a power of two). */
+    size_t depth;               /**< Number of rows. */
+    unsigned limit;             /**< Limit the counters saturate at. */
+} cms;
+
+
+/**
+ * \brief cms_create Creates a sketch of zero counters.
+ * \param width Number of counters of a row, rounded up to a power of two.
+ * \param depth Number of rows.
+ * \param limit Limit the counters saturate at (at most CMS_MAX_LIMIT).
+ * \return Pointer to a new sketch, or NULL on failure.
+ */
+cms *cms_create(const size_t width, const size_t depth, const unsigned limit);
+
+
+/**
+ * \brief cms_free Releases the memory held by the sketch and NULLs the pointer to the sketch.
+ * \param s Pointer to a pointer to a sketch.
+ */
+void cms_free(cms **s);
+
+
+/**
+ * \brief cms_add Adds an occurence of the key and estimates its count.
+ * \param s Pointer to a sketch.
+ * \param hash Hash of the key.
+ * \return Estimated count of the key (including the added occurence), at most the limit.
+ */
+unsigned cms_add(cms *s, const unsigned long hash);
+
+
+/**
+ * \brief cms_add_atomic Adds an occurence of the key and estimates its count like cms_add,
+ *                       but any number of threads may add keys at once (GCC atomic builtins).
+ * \param s Pointer to a sketch.
+ * \param hash Hash of the key.
+ * \return Estimated count of the key (including the added occurence), at most the limit.
+ */
+unsigned cms_add_atomic(cms *s, const unsigned long hash);
+
+
+/**
+ * \brief cms_estimate Estimates the count of the key.
+ * \param s Pointer to a sketch.
+ * \param hash Hash of the key.
+ * \return Estimated count of the key, at most the limit.
+ */
+unsigned cms_estimate(const cms *s, const unsigned long hash);
+
+
+#endif
@@ -4,10 +4,19 @@
  * \version 1, 28-12-2022
  * \author Stanislav Kafara, skafara@students.zcu.cz
  * 
- * Hashtable is implemented as an array (buckets)
- * of linked lists of hashtable links (entries) containing the key-value pair.
- * Hashtable key is a pointer to a copy of the provided key.
- * Hashtable value is a pointer to a copy of the provided value (either a pointer or a direct value).
+ * Hashtable entries are stored in the order of their addition in chunks of H_CHUNK_ENTRIES entries,
+ * an entry is a link (hash of the key, index of the next entry of the bucket, key copy or a pointer to it)
+ * followed by the value copy (either a pointer or a direct value), both aligned.
+ * The entry of an index is in the chunk of index >> H_CHUNK_SHIFT at the offset of its low bits.
+ * Short key copies are stored in the links, the long ones in the chunks of the keys arena,
+ * so an addition allocates nothing unless it starts a new chunk of entries or of keys.
+ * Chunks are never moved, so no addition copies the entries or the keys (the stall of doubling them),
+ * only the array of pointers to the chunks of entries is doubled (one pointer per H_CHUNK_ENTRIES entries).
+ * Buckets hold the indices of the first entries of their linked lists (+ 1, so that 0 means an empty bucket),
+ * full-table passes (freeing, iteration) scan the chunks linearly and never touch the buckets.
+ * Stored hashes are compared before the keys and reused when the buckets are expanded.
+ * While the buckets are being expanded, an item is either in the old buckets (not migrated yet)
+ * or in the new ones, lookups search both.
  */
 
 
@@ -16,79 +25,234 @@
 
 #include "hashtable.h"
 #include "../utilities/arrays.h"
-#include "../utilities/primes.h"
-#include "../utilities/utils.h"
+#include "../utilities/hashing.h"
+
+
+#if defined(__GNUC__)
+/** \brief Prefetches the memory at the address into the cache for reading. */
+#define HTAB_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+/** \brief Prefetches the memory at the address into the cache for reading (not supported by the compiler). */
+#define HTAB_PREFETCH(addr) ((void) (addr))
+#endif
+
+/** \brief Rounds the size up to the alignment of any value type (see htab_align). */
+#define HTAB_ALIGNED(size) (((size) + sizeof(htab_align) - 1) / sizeof(htab_align) * sizeof(htab_align))
+
+/** \brief Hashtable entry (link) of the index. */
+#define HTAB_LINK(ht, index) ((htab_link *) ((ht)->chunks[(index) >> H_CHUNK_SHIFT] + \
+                                            ((index) & (H_CHUNK_ENTRIES - 1)) * (ht)->entry_size))
+
+/** \brief Value copy of the hashtable entry (link). */
+#define HTAB_VALUE(htl) ((void *) ((char *) (htl) + HTAB_ALIGNED(sizeof(htab_link))))
+
+/** \brief Key copy of the hashtable entry (link), inline or in the keys arena. */
+#define HTAB_KEY(htl) ((htl)->key_long ? (htl)->key_long : (htl)->key_inline)
 
 
 /**
- * \brief htab_link_create Creates a new hashtable entry (link) with set copies
- *                         of provided key and value and next set to NULL.
- *                         Does not check arguments validity.
- * \param ht Pointer to a hashtable.
- * \param key Char array to be copied into entry (link).
- * \param value Pointer to the value to be copied into entry (link).
- * \return Pointer to a newly created hashtable entry (link) with aformentioned properties.
+ * \brief Union of the types with the strictest alignment, values are aligned as it is.
  */
-htab_link *htab_link_create(const htab *ht, const char *key, const void *value) {
-    htab_link *new_htl = NULL;
+typedef union htab_align_ {
+    long l;
+    double d;
+    void *p;
+} htab_align;
 
-    new_htl = (htab_link *) malloc(sizeof(htab_link));
-    if (!new_htl) {
-        return NULL;
+
+void *htab_storage_fit(void *arr, size_t *cap, const size_t item_size, const size_t items_cnt, const size_t def_cap) {
+    size_t new_cap;
+
+    if (arr && items_cnt <= *cap) {
+        return arr;
     }
 
-    *((char **) &(new_htl->key)) = strdup(key);
-    if (!new_htl->key) {
-        free(new_htl);
-        return NULL;
+    for (new_cap = arr && *cap ? *cap : def_cap; new_cap < items_cnt; new_cap *= 2) {
+        if (new_cap > (size_t) -1 / 2 / item_size) {
+            return NULL;
+        }
     }
 
-    new_htl->value = (void *) malloc(ht->item_value_size);
-    if (!new_htl->value) {
-        free((void *) new_htl->key);
-        free(new_htl);
-        return NULL;
+    arr = realloc(arr, new_cap * item_size);
+    if (arr) {
+        *cap = new_cap;
     }
-    memcpy(new_htl->value, value, ht->item_value_size);
 
-    new_htl->next = NULL;
+    return arr;
+}
 
-    return new_htl;
+
+int htab_chunks_fit(char ***chunks, size_t *chunks_cnt, size_t *chunks_cap, const size_t entry_size,
+                    const size_t entries_cnt) {
+    char **new_chunks = NULL;
+
+    while (*chunks_cnt * H_CHUNK_ENTRIES < entries_cnt) {
+        new_chunks = (char **) htab_storage_fit(*chunks, chunks_cap, sizeof(char *), *chunks_cnt + 1,
+                                                H_DEF_BUCKETS_CNT);
+        if (!new_chunks) {
+            return 0;
+        }
+        *chunks = new_chunks;
+        (*chunks)[*chunks_cnt] = (char *) malloc(H_CHUNK_ENTRIES * entry_size);
+        if (!(*chunks)[*chunks_cnt]) {
+            return 0;
+        }
+        (*chunks_cnt)++;
+    }
+
+    return 1;
 }
 
 
-/**
- * \brief htab_link_free Releases the memory held by the hashtable entry (link)
- *                       - frees htab_link struct
- *                       -- frees htab_link item value, if htab_item_value_deallocator was provided
- *                       --- frees key (char array copy)
- *                                 and value (copy of the value,
- *                                            where either a pointer or a direct value is stored)
- *                       Does not check arguments validity.
- * \param ht Pointer to a hashtable.
- * \param htl Pointer to a hashtable entry (link).
- */
-void htab_link_free(htab *ht, htab_link *htl) {
-    free((void *) htl->key);
-    if (ht->item_value_deallocator) {
-        (ht->item_value_deallocator)(htl->value);
+void htab_chunks_free(char ***chunks, const size_t chunks_cnt) {
+    size_t c;
+
+    if (!chunks || !(*chunks)) {
+        return;
+    }
+
+    for (c = 0; c < chunks_cnt; c++) {
+        free((*chunks)[c]);
+    }
+    free(*chunks);
+    *chunks = NULL;
+}
+
+
+void htab_keys_init(htab_keys *keys) {
+    if (!keys) {
+        return;
+    }
+
+    keys->first = keys->last = NULL;
+    keys->used = keys->cap = 0;
+}
+
+
+const char *htab_keys_copy(htab_keys *keys, const char *key, const size_t key_size) {
+    htab_keys_chunk *chunk = NULL;
+    char *copy = NULL;
+
+    if (!keys->last || keys->used + key_size > keys->last->size) {
+        chunk = keys->last ? keys->last->next : keys->first;
+        if (!chunk || chunk->size < key_size) {
+            /* a new chunk is linked after the one being filled, the following ones are reused later */
+            chunk = (htab_keys_chunk *) malloc(sizeof(htab_keys_chunk) +
+                                               (key_size > H_KEYS_CHUNK_SIZE ? key_size : H_KEYS_CHUNK_SIZE));
+            if (!chunk) {
+                return NULL;
+            }
+            chunk->size = key_size > H_KEYS_CHUNK_SIZE ? key_size : H_KEYS_CHUNK_SIZE;
+            chunk->next = keys->last ? keys->last->next : keys->first;
+            if (keys->last) {
+                keys->last->next = chunk;
+            }
+            else {
+                keys->first = chunk;
+            }
+            keys->cap += chunk->size;
+        }
+        keys->last = chunk;
+        keys->used = 0;
+    }
+
+    copy = (char *) (keys->last + 1) + keys->used;
+    memcpy(copy, key, key_size);
+    keys->used += key_size;
+
+    return copy;
+}
+
+
+void htab_keys_take_back(htab_keys *keys, const char *copy) {
+    keys->used = (size_t) (copy - (const char *) (keys->last + 1));
+}
+
+
+void htab_keys_rewind(htab_keys *keys) {
+    if (!keys) {
+        return;
     }
-    free(htl->value);
-    free(htl);
+
+    keys->last = keys->first;
+    keys->used = 0;
+}
+
+
+void htab_keys_free(htab_keys *keys) {
+    htab_keys_chunk *chunk = NULL, *next = NULL;
+
+    if (!keys) {
+        return;
+    }
+
+    for (chunk = keys->first; chunk; chunk = next) {
+        next = chunk->next;
+        free(chunk);
+    }
+    htab_keys_init(keys);
 }
 
 
 /**
- * \brief htab_clear_buckets NULLs the buckets of the hashtable.
- *                           Does not check arguments validity.
+ * \brief htab_entry_append Appends a new hashtable entry (link) with set copies
+ *                          of provided key and value and next set to none
+ *                          to the chunks of entries (the key copy to the keys arena, if it is not short).
+ *                          The entry is not added to any bucket.
+ *                          Does not check arguments validity.
  * \param ht Pointer to a hashtable.
+ * \param key Char array to be copied into the keys arena.
+ * \param hash Hash of the key.
+ * \param value Pointer to the value to be copied into entry (link).
+ * \return Pointer to the appended hashtable entry (link) (its index is the items count), NULL on failure.
  */
-void htab_clear_buckets(htab *ht) {
-    array_clear(ht->buckets, ht->buckets_cnt, sizeof(htab_link *));
+htab_link *htab_entry_append(htab *ht, const char *key, const unsigned long hash, const void *value) {
+    htab_link *new_htl = NULL;
+    size_t key_size;
+
+    key_size = strlen(key) + 1;
+    if (!htab_chunks_fit(&ht->chunks, &ht->chunks_cnt, &ht->chunks_cap, ht->entry_size, ht->items_cnt + 1)) {
+        return NULL;
+    }
+    new_htl = HTAB_LINK(ht, ht->items_cnt);
+
+    if (key_size <= H_KEY_INLINE_SIZE) {
+        new_htl->key_long = NULL;
+        memcpy(new_htl->key_inline, key, key_size);
+    }
+    else {
+        new_htl->key_long = htab_keys_copy(&ht->keys, key, key_size);
+        if (!new_htl->key_long) {
+            return NULL;
+        }
+    }
+
+    new_htl->hash = hash;
+    new_htl->next = 0;
+    memcpy(HTAB_VALUE(new_htl), value, ht->item_value_size);
+
+    return new_htl;
 }
 
 
 htab *htab_create(const size_t item_value_size, const htab_item_value_deallocator item_value_deallocator) {
+    return htab_create_with_capacity(item_value_size, item_value_deallocator, 0);
+}
+
+
+size_t htab_buckets_cnt(const size_t items_cnt) {
+    size_t buckets_cnt;
+
+    for (buckets_cnt = H_DEF_BUCKETS_CNT; buckets_cnt * H_ITEMS_PER_BUCKET < items_cnt; buckets_cnt *= 2) {
+        ;
+    }
+
+    return buckets_cnt;
+}
+
+
+htab *htab_create_with_capacity(const size_t item_value_size, const htab_item_value_deallocator item_value_deallocator,
+                                const size_t items_cnt) {
     htab *ht = NULL;
 
     if (item_value_size == 0) {
@@ -100,12 +264,25 @@ htab *htab_create(const size_t item_value_size, const htab_item_value_deallocato
         return NULL;
     }
 
-    ht->buckets_cnt = H_DEF_BUCKETS_CNT;
-    ht->buckets = (htab_link **) array_create(ht->buckets_cnt, sizeof(htab_link *));
+    ht->buckets_cnt = htab_buckets_cnt(items_cnt);
+    ht->buckets = (size_t *) array_create(ht->buckets_cnt, sizeof(size_t));
     if (!ht->buckets) {
         free(ht);
         return NULL;
     }
+    ht->old_buckets = NULL;
+    ht->old_buckets_cnt = ht->migrated_cnt = 0;
+
+    ht->chunks = NULL;
+    ht->chunks_cnt = ht->chunks_cap = 0;
+    ht->entry_size = HTAB_ALIGNED(sizeof(htab_link)) + HTAB_ALIGNED(item_value_size);
+    htab_keys_init(&ht->keys);
+    if (!htab_chunks_fit(&ht->chunks, &ht->chunks_cnt, &ht->chunks_cap, ht->entry_size, items_cnt)) {
+        htab_chunks_free(&ht->chunks, ht->chunks_cnt);
+        array_free((void **) &ht->buckets);
+        free(ht);
+        return NULL;
+    }
 
     ht->items_cnt = 0;
     *((size_t *) &ht->item_value_size) = item_value_size;
@@ -116,73 +293,96 @@ htab *htab_create(const size_t item_value_size, const htab_item_value_deallocato
 
 
 void htab_free(htab **ht) {
-    size_t b;
-    htab_link *htl = NULL, *htl_next = NULL;
+    size_t i;
 
     if (!ht || !(*ht)) {
         return;
     }
 
-    for (b = 0; b < (*ht)->buckets_cnt; b++) {
-        htl = (*ht)->buckets[b];
-        while (htl) {
-            htl_next = htl->next;
-            htab_link_free(*ht, htl);
-            htl = htl_next;
+    if ((*ht)->item_value_deallocator) {
+        for (i = 0; i < (*ht)->items_cnt; i++) {
+            ((*ht)->item_value_deallocator)(HTAB_VALUE(HTAB_LINK(*ht, i)));
         }
     }
-
     array_free((void **) &(*ht)->buckets);
+    if ((*ht)->old_buckets) {
+        array_free((void **) &(*ht)->old_buckets);
+    }
+    htab_chunks_free(&(*ht)->chunks, (*ht)->chunks_cnt);
+    htab_keys_free(&(*ht)->keys);
     free(*ht);
     *ht = NULL;
 }
 
 
+unsigned long htab_hash(const char *key) {
+    if (!key) {
+        return 0;
+    }
+
+    return str_hash(key);
+}
+
+
 /**
- * \brief htab_hcode Computes and returns the hashcode
- *                   of provided char array modulated by provided divisor.
+ * \brief htab_hcode Returns the bucket of the hash of a key.
  *                   Does not check arguments validity.
- * \param key Char array the hashcode to be computed of.
- * \param divisor Number the hashcode to be modulated by.
- * \return Char array hashcode modulated by divisor.
+ * \param hash Hash of a key.
+ * \param buckets_cnt Buckets count (a power of two).
+ * \return Index of the bucket.
  */
-size_t htab_hcode(const char *key, const size_t divisor) {
-    size_t key_len, c;
-    size_t hcode;
-    
-    key_len = strlen(key);
-    for (c = 0, hcode = 0; c < key_len; c++) {
-        hcode = (hcode * 256 + key[c]) % divisor;
+size_t htab_hcode(const unsigned long hash, const size_t buckets_cnt) {
+    return hash & (buckets_cnt - 1);
+}
+
+
+/**
+ * \brief htab_chain_find Searches for the hashtable entry (link) with provided key and its hash
+ *                        in the linked list of hashtable entries (links) of a bucket.
+ *                        Does not check arguments validity.
+ * \param ht Pointer to a hashtable.
+ * \param head Bucket head (index of the first hashtable entry (link) of the bucket + 1, 0 if empty).
+ * \param key Key of an item to be searched for.
+ * \param hash Hash of the key.
+ * \return Pointer to a hashtable item (link) having the same key if found, else NULL.
+ */
+htab_link *htab_chain_find(const htab *ht, size_t head, const char *key, const unsigned long hash) {
+    htab_link *htl = NULL;
+
+    while (head) {
+        htl = HTAB_LINK(ht, head - 1);
+        if (htl->hash == hash && strcmp(key, HTAB_KEY(htl)) == 0) {
+            return htl;
+        }
+
+        head = htl->next;
     }
 
-    return hcode;
+    return NULL;
 }
 
 
 /**
- * \brief htab_link_find Searches for the item with provided key in the hashtable
+ * \brief htab_link_find Searches for the item with provided key and its hash in the hashtable
  *                       and if found, returns a pointer to the hashtable entry (link).
  * \param ht Pointer to a hashtable.
  * \param key Key of an item to be searched for in the hashtable.
+ * \param hash Hash of the key.
  * \return Pointer to a hashtable item (link) having the same key if found, else NULL.
  */
-htab_link *htab_link_find(const htab *ht, const char *key) {
+htab_link *htab_link_find(const htab *ht, const char *key, const unsigned long hash) {
     htab_link *htl = NULL;
 
     if (!ht || !key) {
         return NULL;
     }
 
-    htl = ht->buckets[htab_hcode(key, ht->buckets_cnt)];
-    while (htl) {
-        if (strcmp(key, htl->key) == 0) {
-            return htl;
-        }
-
-        htl = htl->next;
+    htl = htab_chain_find(ht, ht->buckets[htab_hcode(hash, ht->buckets_cnt)], key, hash);
+    if (!htl && ht->old_buckets) {
+        htl = htab_chain_find(ht, ht->old_buckets[htab_hcode(hash, ht->old_buckets_cnt)], key, hash);
     }
 
-    return NULL;
+    return htl;
 }
 
 
@@ -195,8 +395,26 @@ size_t htab_items_cnt(const htab *ht) {
 }
 
 
+const char *htab_key_at(const htab *ht, const size_t index) {
+    if (!ht || index >= ht->items_cnt) {
+        return NULL;
+    }
+
+    return HTAB_KEY(HTAB_LINK(ht, index));
+}
+
+
+void *htab_value_at(const htab *ht, const size_t index) {
+    if (!ht || index >= ht->items_cnt) {
+        return NULL;
+    }
+
+    return HTAB_VALUE(HTAB_LINK(ht, index));
+}
+
+
 int htab_contains(const htab *ht, const char *key) {
-    if (!htab_link_find(ht, key)) {
+    if (!htab_link_find(ht, key, htab_hash(key))) {
         return 0;
     }
 
@@ -205,14 +423,67 @@ int htab_contains(const htab *ht, const char *key) {
 
 
 void *htab_ptrget(const htab *ht, const char *key) {
+    return htab_ptrget_hashed(ht, key, htab_hash(key));
+}
+
+
+void *htab_ptrget_hashed(const htab *ht, const char *key, const unsigned long hash) {
     htab_link *htl = NULL;
-    
-    htl = htab_link_find(ht, key);
+
+    htl = htab_link_find(ht, key, hash);
     if (!htl) {
         return NULL;
     }
 
-    return htl->value;
+    return HTAB_VALUE(htl);
+}
+
+
+size_t htab_ptrget_batch(const htab *ht, const char *keys[], const unsigned long hashes[], const size_t cnt,
+                         void *values[]) {
+    size_t heads[H_BATCH_SIZE];
+    htab_link *htl = NULL;
+    size_t start, batch_cnt, i, found;
+
+    if (!ht || (!keys && cnt) || (!hashes && cnt) || (!values && cnt)) {
+        return 0;
+    }
+
+    found = 0;
+    for (start = 0; start < cnt; start += batch_cnt) {
+        batch_cnt = cnt - start < H_BATCH_SIZE ? cnt - start : H_BATCH_SIZE;
+
+        /* every step is prefetched for the whole batch before it is taken for any key */
+        for (i = 0; i < batch_cnt; i++) {
+            HTAB_PREFETCH(&ht->buckets[htab_hcode(hashes[start + i], ht->buckets_cnt)]);
+        }
+        for (i = 0; i < batch_cnt; i++) {
+            heads[i] = ht->buckets[htab_hcode(hashes[start + i], ht->buckets_cnt)];
+            if (heads[i]) {
+                HTAB_PREFETCH(HTAB_LINK(ht, heads[i] - 1));
+            }
+        }
+        for (i = 0; i < batch_cnt; i++) {
+            if (heads[i]) {
+                htl = HTAB_LINK(ht, heads[i] - 1);
+                if (htl->hash == hashes[start + i] && htl->key_long) {
+                    HTAB_PREFETCH(htl->key_long);
+                }
+            }
+        }
+
+        for (i = 0; i < batch_cnt; i++) {
+            htl = htab_chain_find(ht, heads[i], keys[start + i], hashes[start + i]);
+            if (!htl && ht->old_buckets) {
+                htl = htab_chain_find(ht, ht->old_buckets[htab_hcode(hashes[start + i], ht->old_buckets_cnt)],
+                                      keys[start + i], hashes[start + i]);
+            }
+            values[start + i] = htl ? HTAB_VALUE(htl) : NULL;
+            found += htl != NULL;
+        }
+    }
+
+    return found;
 }
 
 
@@ -224,109 +495,169 @@ int htab_get(const htab *ht, const char *key, void *dest) {
         return 0;
     }
 
-    htl = htab_link_find(ht, key);
+    htl = htab_link_find(ht, key, htab_hash(key));
     if (!htl) {
         return 0;
     }
 
-    memcpy(dest, htl->value, ht->item_value_size);
+    memcpy(dest, HTAB_VALUE(htl), ht->item_value_size);
     return 1;
 }
 
 
-int htab_add_link(htab *ht, htab_link *new_htl);
 /**
- * \brief htab_expand_buckets Expands hashtable buckets.
- *                            - creates new buckets
- *                            - adds all hashtable entries (links) to new buckets
- *                            - frees old buckets
+ * \brief htab_bucket_push Pushes the hashtable entry (link) to the front of its bucket.
+ *                         Does not check arguments validity.
+ * \param buckets Buckets of a hashtable.
+ * \param buckets_cnt Buckets count.
+ * \param htl Pointer to the hashtable entry (link).
+ * \param index Index of the hashtable entry (link).
+ */
+void htab_bucket_push(size_t *buckets, const size_t buckets_cnt, htab_link *htl, const size_t index) {
+    size_t hcode;
+
+    hcode = htab_hcode(htl->hash, buckets_cnt);
+    htl->next = buckets[hcode];
+    buckets[hcode] = index + 1;
+}
+
+
+/**
+ * \brief htab_migrate_buckets Migrates the hashtable entries (links) of the next old buckets to the buckets.
+ *                             Frees the old buckets once all of them are migrated.
+ *                             Does not check arguments validity.
+ * \param ht Pointer to a hashtable being expanded.
+ * \param cnt Maximal number of old buckets to be migrated.
+ */
+void htab_migrate_buckets(htab *ht, const size_t cnt) {
+    htab_link *htl = NULL;
+    size_t b, head, head_next;
+
+    for (b = 0; b < cnt && ht->migrated_cnt < ht->old_buckets_cnt; b++, ht->migrated_cnt++) {
+        head = ht->old_buckets[ht->migrated_cnt];
+        while (head) {
+            htl = HTAB_LINK(ht, head - 1);
+            head_next = htl->next;
+            htab_bucket_push(ht->buckets, ht->buckets_cnt, htl, head - 1);
+            head = head_next;
+        }
+        ht->old_buckets[ht->migrated_cnt] = 0;
+    }
+
+    if (ht->migrated_cnt == ht->old_buckets_cnt) {
+        array_free((void **) &ht->old_buckets);
+        ht->old_buckets = NULL;
+        ht->old_buckets_cnt = ht->migrated_cnt = 0;
+    }
+}
+
+
+/**
+ * \brief htab_expand_buckets Starts the expansion of hashtable buckets.
+ *                            - finishes the previous expansion, if it is still in progress
+ *                            - creates new buckets, the current ones become the old buckets
+ *                            Entries (links) of the old buckets are migrated by the following additions
+ *                            (see htab_migrate_buckets).
  *                            Does not check arguments validity.
  * \param ht Pointer to a hashtable.
- * \param new_cnt New buckets count.
+ * \param new_cnt New buckets count (a power of two).
  * \return 1 if the operation was successful, else 0.
  */
 int htab_expand_buckets(htab *ht, const size_t new_cnt) {
-    htab_link **old_buckets = NULL;
-    htab_link *htl = NULL, *htl_next = NULL;
-    size_t old_buckets_cnt;
-    size_t old_items_cnt;
-    size_t b;
-    
-    old_buckets = ht->buckets;
-    old_buckets_cnt = ht->buckets_cnt;
-
-    ht->buckets = (htab_link **) array_create(new_cnt, sizeof(htab_link *));
-    if (!ht->buckets) {
-        ht->buckets = old_buckets;
+    size_t *new_buckets = NULL;
+
+    if (ht->old_buckets) {
+        htab_migrate_buckets(ht, ht->old_buckets_cnt);
+    }
+
+    new_buckets = (size_t *) array_create(new_cnt, sizeof(size_t));
+    if (!new_buckets) {
         return 0;
     }
-    
+
+    ht->old_buckets = ht->buckets;
+    ht->old_buckets_cnt = ht->buckets_cnt;
+    ht->migrated_cnt = 0;
+    ht->buckets = new_buckets;
     ht->buckets_cnt = new_cnt;
-    
-    old_items_cnt = ht->items_cnt;
-    ht->items_cnt = 0;
-    for (b = 0; b < old_buckets_cnt; b++) {
-        htl = old_buckets[b];
-        while (htl) {
-            htl_next = htl->next;
-            if (!htab_add_link(ht, htl)) {
-                array_free((void **) &ht->buckets);
-                ht->buckets = old_buckets;
-                ht->buckets_cnt = old_buckets_cnt;
-                ht->items_cnt = old_items_cnt;
-                return 0;
-            }
-            htl = htl_next;
-        }
-    }
-    array_free((void **) &old_buckets);
 
     return 1;
 }
 
 
 /**
- * \brief htab_add_link Adds the provided hashtable entry (link) to the hashtable.
- *                      Requests hashtable buckets expansion if neccessary.
+ * \brief htab_add_link Adds the appended hashtable entry (link) (see htab_entry_append) to the hashtable.
+ *                      Requests hashtable buckets expansion if neccessary
+ *                      and migrates the next old buckets, if the expansion is in progress.
  *                      Does not check arguments validity.
  * \param ht Pointer to a hashtable.
- * \param new_htl Pointer to the hashtable entry (link).
+ * \param new_htl Pointer to the appended hashtable entry (link).
  * \return 1 if the operation was successful, else 0.
  */
 int htab_add_link(htab *ht, htab_link *new_htl) {
-    size_t hcode;
-
     if (ht->items_cnt == ht->buckets_cnt * H_ITEMS_PER_BUCKET) {
-        if (!htab_expand_buckets(ht, next_prime((2 * ht->buckets_cnt) + 1))) {
+        if (!htab_expand_buckets(ht, 2 * ht->buckets_cnt)) {
             return 0;
         }
     }
+    if (ht->old_buckets) {
+        htab_migrate_buckets(ht, H_REHASH_STEP);
+    }
 
-    hcode = htab_hcode(new_htl->key, ht->buckets_cnt);
+    htab_bucket_push(ht->buckets, ht->buckets_cnt, new_htl, ht->items_cnt);
+    ht->items_cnt++;
 
-    new_htl->next = ht->buckets[hcode];
-    ht->buckets[hcode] = new_htl;
+    return 1;
+}
 
-    ht->items_cnt++;
+
+int htab_reserve(htab *ht, const size_t items_cnt) {
+    size_t buckets_cnt;
+
+    if (!ht) {
+        return 0;
+    }
+
+    if (!htab_chunks_fit(&ht->chunks, &ht->chunks_cnt, &ht->chunks_cap, ht->entry_size, items_cnt)) {
+        return 0;
+    }
+
+    buckets_cnt = htab_buckets_cnt(items_cnt);
+    if (buckets_cnt <= ht->buckets_cnt) {
+        return 1;
+    }
+
+    if (!htab_expand_buckets(ht, buckets_cnt)) {
+        return 0;
+    }
+    htab_migrate_buckets(ht, ht->old_buckets_cnt);
 
     return 1;
 }
 
 
 int htab_add(htab *ht, const char *key, const void *value) {
+    return htab_add_hashed(ht, key, htab_hash(key), value);
+}
+
+
+int htab_add_hashed(htab *ht, const char *key, const unsigned long hash, const void *value) {
     htab_link *new_htl = NULL;
 
     if (!ht || !key || !value) {
         return 0;
     }
 
-    new_htl = htab_link_create(ht, key, value);
+    new_htl = htab_entry_append(ht, key, hash, value);
     if (!new_htl) {
         return 0;
     }
 
     if (!htab_add_link(ht, new_htl)) {
-        htab_link_free(ht, new_htl);
+        /* the entry is not counted, only its key copy is taken back */
+        if (new_htl->key_long) {
+            htab_keys_take_back(&ht->keys, new_htl->key_long);
+        }
         return 0;
     }
 
@@ -334,24 +665,6 @@ int htab_add(htab *ht, const char *key, const void *value) {
 }
 
 
-/**
- * \brief htl_iter_set_next_nonempty_bucket Sets next hashtable entry (link) to the first hashtable entry (link)
- *                                          in current bucket, if there is any,
- *                                          otherwise iterates through buckets,
- *                                          until finds a bucket having a hashtable entry (link).
- *                                          Does not check arguments validity.
- * \param it Pointer to an iterator.
- */
-void htl_iter_set_next_nonempty_bucket(htl_iter *it) {
-    for (; it->bucket_curr < it->ht->buckets_cnt; it->bucket_curr++) {
-        if (it->ht->buckets[it->bucket_curr]) {
-            it->htl_next = it->ht->buckets[it->bucket_curr];
-            break;
-        }
-    }
-}
-
-
 htl_iter *htl_iter_create(const htab *ht) {
     htl_iter *it = NULL;
 
@@ -364,13 +677,22 @@ htl_iter *htl_iter_create(const htab *ht) {
         return NULL;
     }
 
-    it->ht = ht;
-    htl_iter_reset(it);
+    htl_iter_init(it, ht);
 
     return it;
 }
 
 
+void htl_iter_init(htl_iter *it, const htab *ht) {
+    if (!it) {
+        return;
+    }
+
+    it->ht = ht;
+    it->next = 0;
+}
+
+
 void htl_iter_free(htl_iter **it) {
     if (!it || !(*it)) {
         return;
@@ -382,33 +704,39 @@ void htl_iter_free(htl_iter **it) {
 
 
 int htl_iter_has_next(const htl_iter *it) {
-    if (!it) {
+    if (!it || !it->ht) {
         return 0;
     }
 
-    if (!it->htl_next) {
-        return 0;
-    }
-    return 1;
+    return it->next < it->ht->items_cnt;
 }
 
 
 htab_link *htl_iter_next(htl_iter *it) {
-    htab_link *htl_tmp = NULL;
+    if (!htl_iter_has_next(it)) {
+        return NULL;
+    }
+
+    it->next++;
+    return HTAB_LINK(it->ht, it->next - 1);
+}
+
 
-    if (!it || !htl_iter_has_next(it)) {
+const char *htl_key(const htab *ht, const htab_link *htl) {
+    if (!ht || !htl) {
         return NULL;
     }
 
-    htl_tmp = it->htl_next;
-    
-    it->htl_next = it->htl_next->next;
-    if (!it->htl_next) {
-        it->bucket_curr++;
-        htl_iter_set_next_nonempty_bucket(it);
+    return HTAB_KEY(htl);
+}
+
+
+void *htl_value(const htab *ht, const htab_link *htl) {
+    if (!ht || !htl) {
+        return NULL;
     }
-    
-    return htl_tmp;
+
+    return HTAB_VALUE(htl);
 }
 
 
@@ -417,7 +745,5 @@ void htl_iter_reset(htl_iter *it) {
         return;
     }
 
-    it->bucket_curr = 0;
-    it->htl_next = NULL;
-    htl_iter_set_next_nonempty_bucket(it);
+    it->next = 0;
 }
@@ -5,10 +5,21 @@
  * \author Stanislav Kafara, skafara@students.zcu.cz
  *
  * Used for manipulation with a hashtable.
- * Hashtable is implemented as an array (buckets)
- * of linked lists of hashtable links (entries) containing the key-value pair.
- * Hashtable key is a pointer to a copy of the provided key.
- * Hashtable value is a pointer to a copy of the provided value (either a pointer or a direct value).
+ * Hashtable entries are stored in the order of their addition in chunks of H_CHUNK_ENTRIES entries,
+ * an entry contains the hash of the key, the key copy (inline if it is short) and the value copy (inline).
+ * Hashtable buckets only index the entries: each bucket is a linked list of entries chained by their indices.
+ * Hashtable key is a copy of the provided key stored in the entry if it fits in H_KEY_INLINE_SIZE,
+ * else in the keys arena (chunks of '\0' terminated keys), so comparing a short key touches only its entry.
+ * Keys and values of the entries are accessed by htl_key and htl_value (they are not members of htab_link).
+ * Hashtable value is a copy of the provided value (either a pointer or a direct value).
+ * Entries are iterated through (and can be accessed by their index) by a linear scan of the chunks.
+ * Chunks of the entries and of the keys are never moved, an addition allocates at most one of each,
+ * so the pointers to the keys and values stay valid until the hashtable is freed.
+ * Callers knowing the hashes of the keys (htab_hash) pass them to the _hashed functions,
+ * batches of keys are looked up at once with their memory accesses overlapped (prefetched).
+ * Buckets count is a power of two and it is doubled incrementally: the entries of the old buckets
+ * are migrated to the new ones a few buckets per added item, so no addition rehashes the whole hashtable
+ * (nor copies the entries or the keys, only the array of pointers to the chunks of the entries is reallocated).
  */
 
 
@@ -16,10 +27,22 @@
 #define HASHTABLE_H
 
 
-/** \brief Hashtable default buckets count. */
-#define H_DEF_BUCKETS_CNT 5
+/** \brief Hashtable default buckets count (a power of two). */
+#define H_DEF_BUCKETS_CNT 8
 /** \brief Hashtable average items count per basket. */
 #define H_ITEMS_PER_BUCKET 5
+/** \brief Number of old buckets migrated per added item while the buckets are being expanded. */
+#define H_REHASH_STEP 2
+/** \brief Number of keys of a batch whose lookups proceed together, step by step. */
+#define H_BATCH_SIZE 16
+/** \brief Binary logarithm of the number of entries of a chunk of hashtable entries. */
+#define H_CHUNK_SHIFT 10
+/** \brief Number of entries of a chunk of hashtable entries. */
+#define H_CHUNK_ENTRIES ((size_t) 1 << H_CHUNK_SHIFT)
+/** \brief Size of a chunk of the keys arena (a longer key gets a chunk of its own size). */
+#define H_KEYS_CHUNK_SIZE 65536
+/** \brief Size of the key copy stored in a hashtable entry, longer keys (with the '\0') go to the keys arena. */
+#define H_KEY_INLINE_SIZE 16
 
 
 /**
@@ -31,23 +54,55 @@ typedef void (*htab_item_value_deallocator)(void **value);
 
 /**
  * \struct htab_link
- * \brief Struct representing an entry (link) in a hashtable.
+ * \brief Struct representing an entry (link) in a hashtable, the value copy follows it in the entries array.
  */
 typedef struct htab_link_ {
-    const char *key;            /**< char pointer to copy of the key: Key. */
-    void *value;                /**< void pointer to copy of the value
-                                     (either a pointer or a direct value): Value. */
-    struct htab_link_ *next;    /**< Reference to next entry (link). */
+    unsigned long hash;         /**< Hash of the key. */
+    size_t next;                /**< Index of the next entry (link) of the bucket + 1, 0 if it is the last one. */
+    const char *key_long;       /**< Copy of the key in the keys arena, NULL if it is inline. */
+    char key_inline[H_KEY_INLINE_SIZE]; /**< Copy of the key, if it is short enough. */
 } htab_link;
 
 
+/**
+ * \struct htab_keys_chunk
+ * \brief Struct representing a chunk of a keys arena, the copies of the keys follow it.
+ */
+typedef struct htab_keys_chunk_ {
+    struct htab_keys_chunk_ *next;  /**< Next chunk, NULL if it is the last one. */
+    size_t size;                    /**< Size of the chunk (without this header). */
+} htab_keys_chunk;
+
+
+/**
+ * \struct htab_keys
+ * \brief Struct representing a keys arena: a list of chunks of '\0' terminated copies of the long keys.
+ */
+typedef struct htab_keys_ {
+    htab_keys_chunk *first;         /**< First chunk, NULL if none is allocated. */
+    htab_keys_chunk *last;          /**< Chunk being filled, NULL if none is allocated. */
+    size_t used;                    /**< Size used of the chunk being filled. */
+    size_t cap;                     /**< Size of all the chunks. */
+} htab_keys;
+
+
 /**
  * \struct htab
  * \brief Struct representing a hashtable.
  */
 typedef struct htab_ {
-    htab_link **buckets;            /**< array of pointers to htab_links: Hashtable buckets. */
+    size_t *buckets;                /**< array of bucket heads (index of the first entry + 1, 0 if empty):
+                                         Hashtable buckets. */
     size_t buckets_cnt;             /**< Hashtable buckets count. */
+    size_t *old_buckets;            /**< Buckets being migrated to the buckets (expansion in progress), else NULL. */
+    size_t old_buckets_cnt;         /**< Old buckets count. */
+    size_t migrated_cnt;            /**< Number of old buckets already migrated. */
+    char **chunks;                  /**< Chunks of H_CHUNK_ENTRIES entries (links followed by value copies)
+                                         in addition order. */
+    size_t chunks_cnt;              /**< Number of allocated chunks. */
+    size_t chunks_cap;              /**< Capacity of the array of chunks. */
+    size_t entry_size;              /**< Size of an entry (link and value copy, both aligned). */
+    htab_keys keys;                 /**< Keys arena. */
     size_t items_cnt;               /**< Hashtable items count. */
     const size_t item_value_size;   /**< Hashtable item value size. */
     const htab_item_value_deallocator item_value_deallocator; /**< Hashtable item value deallocator. */
@@ -56,15 +111,110 @@ typedef struct htab_ {
 
 /**
  * \struct htl_iter
- * \brief Struct representing an iterator over hashtable entries (links).
+ * \brief Struct representing an iterator over hashtable entries (links) in the order of their addition.
  */
 typedef struct htl_iter_ {
     const htab *ht;         /**< Pointer to a hashtable to be iterated through. */
-    size_t bucket_curr;     /**< Bucket of the next hashtable entry (link). */
-    htab_link *htl_next;    /**< Pointer to the next hashtable entry (link). */
+    size_t next;            /**< Index of the next hashtable entry (link). */
 } htl_iter;
 
 
+/**
+ * \brief htab_buckets_cnt Returns the buckets count of a hashtable holding the items count without expansion
+ *                         (shared with the type-specialized hashtables, see htab_typed.h).
+ * \param items_cnt Number of items.
+ * \return Buckets count (a power of two, at least H_DEF_BUCKETS_CNT).
+ */
+size_t htab_buckets_cnt(const size_t items_cnt);
+
+
+/**
+ * \brief htab_storage_fit Grows the capacity of an array (e.g. the chunks of entries) of a hashtable,
+ *                         doubling it until the provided number of items fits in
+ *                         (shared with the type-specialized hashtables, see htab_typed.h).
+ *                         Does not check arguments validity.
+ * \param arr Array (NULL if not allocated yet).
+ * \param cap Pointer to the array capacity (number of items), updated if the array grows.
+ * \param item_size Size of an item.
+ * \param items_cnt Number of items the array has to hold.
+ * \param def_cap Capacity of a newly allocated array.
+ * \return Array holding the items count (possibly moved), NULL on failure (the array is left untouched).
+ */
+void *htab_storage_fit(void *arr, size_t *cap, const size_t item_size, const size_t items_cnt, const size_t def_cap);
+
+
+/**
+ * \brief htab_chunks_fit Allocates the chunks of entries of a hashtable until the provided number of entries fits in
+ *                        (shared with the type-specialized hashtables, see htab_typed.h).
+ *                        The chunks are never moved, only the array of pointers to them grows (doubling it).
+ *                        Does not check arguments validity.
+ * \param chunks Pointer to the array of chunks (NULL if not allocated yet), updated if the array grows.
+ * \param chunks_cnt Pointer to the number of allocated chunks.
+ * \param chunks_cap Pointer to the capacity of the array of chunks.
+ * \param entry_size Size of an entry.
+ * \param entries_cnt Number of entries the chunks have to hold.
+ * \return 1 if the operation was successful, else 0 (the chunks allocated already are kept).
+ */
+int htab_chunks_fit(char ***chunks, size_t *chunks_cnt, size_t *chunks_cap, const size_t entry_size,
+                    const size_t entries_cnt);
+
+
+/**
+ * \brief htab_chunks_free Releases the memory held by the chunks of entries of a hashtable
+ *                         (shared with the type-specialized hashtables, see htab_typed.h).
+ * \param chunks Pointer to the array of chunks, NULLed.
+ * \param chunks_cnt Number of allocated chunks.
+ */
+void htab_chunks_free(char ***chunks, const size_t chunks_cnt);
+
+
+/**
+ * \brief htab_keys_init Initializes an empty keys arena
+ *                       (shared with the type-specialized hashtables, see htab_typed.h).
+ * \param keys Pointer to a keys arena.
+ */
+void htab_keys_init(htab_keys *keys);
+
+
+/**
+ * \brief htab_keys_copy Copies the key to the keys arena, to the chunk being filled if it fits in,
+ *                       else to the next (allocated or reused) chunk
+ *                       (shared with the type-specialized hashtables, see htab_typed.h).
+ *                       Does not check arguments validity.
+ * \param keys Pointer to a keys arena.
+ * \param key Key.
+ * \param key_size Size of the key (with the '\0').
+ * \return Pointer to the copy of the key, NULL on failure.
+ */
+const char *htab_keys_copy(htab_keys *keys, const char *key, const size_t key_size);
+
+
+/**
+ * \brief htab_keys_take_back Takes back the last copy of a key made by htab_keys_copy
+ *                            (shared with the type-specialized hashtables, see htab_typed.h).
+ *                            Does not check arguments validity.
+ * \param keys Pointer to a keys arena.
+ * \param copy Pointer to the last copy of a key.
+ */
+void htab_keys_take_back(htab_keys *keys, const char *copy);
+
+
+/**
+ * \brief htab_keys_rewind Empties the keys arena, keeping its chunks for the next copies
+ *                         (shared with the type-specialized hashtables, see htab_typed.h).
+ * \param keys Pointer to a keys arena.
+ */
+void htab_keys_rewind(htab_keys *keys);
+
+
+/**
+ * \brief htab_keys_free Releases the memory held by the chunks of the keys arena and empties it
+ *                       (shared with the type-specialized hashtables, see htab_typed.h).
+ * \param keys Pointer to a keys arena.
+ */
+void htab_keys_free(htab_keys *keys);
+
+
 /**
  * \brief htab_create Creates an empty hashtable with default buckets count
  *                    ready to work with items with values of provided size.
@@ -75,15 +225,35 @@ typedef struct htl_iter_ {
 htab *htab_create(const size_t item_value_size, const htab_item_value_deallocator item_value_deallocator);
 
 
+/**
+ * \brief htab_create_with_capacity Creates an empty hashtable with buckets for the provided items count
+ *                                  ready to work with items with values of provided size (see htab_reserve).
+ * \param item_value_size Size of hashtable item value.
+ * \param item_value_deallocator Pointer to a function that frees hashtable item values, when hashtable is freed.
+ * \param items_cnt Number of items the hashtable will hold without expanding its buckets.
+ * \return Pointer to a new empty hashtable with aformentioned properties.
+ */
+htab *htab_create_with_capacity(const size_t item_value_size, const htab_item_value_deallocator item_value_deallocator,
+                                const size_t items_cnt);
+
+
+/**
+ * \brief htab_reserve Expands the hashtable buckets and allocates the chunks of entries at once,
+ *                     so that the hashtable holds the provided items count without expanding them again.
+ *                     Buckets and entries are never shrunk.
+ * \param ht Pointer to a hashtable.
+ * \param items_cnt Number of items.
+ * \return 1 if the operation was successful, else 0.
+ */
+int htab_reserve(htab *ht, const size_t items_cnt);
+
+
 /**
  * \brief htab_free Releases the memory held by the hashtable
  *                  - frees htab struct
- *                  -- frees each htab_link struct in buckets
- *                  --- frees htab_link key (char array copy)
- *                                      and value (copy of the value,
- *                                                 where either a pointer or a direct value is stored)
- *                  ---- frees htab_link item value, if htab_item_value_deallocator was provided
- *                       and NULLs the pointer to the hashtable.
+ *                  -- frees buckets, chunks of entries and keys arena
+ *                  --- frees each item value, if htab_item_value_deallocator was provided
+ *                      and NULLs the pointer to the hashtable.
  * \param ht Pointer to a pointer to a hashtable.
  */
 void htab_free(htab **ht);
@@ -97,6 +267,32 @@ void htab_free(htab **ht);
 size_t htab_items_cnt(const htab *ht);
 
 
+/**
+ * \brief htab_key_at Returns the key of the hashtable item of provided index (order of addition).
+ * \param ht Pointer to a hashtable.
+ * \param index Index of the item.
+ * \return Pointer to the key if the index is valid, else NULL.
+ */
+const char *htab_key_at(const htab *ht, const size_t index);
+
+
+/**
+ * \brief htab_value_at Returns a pointer to the value of the hashtable item of provided index (order of addition).
+ * \param ht Pointer to a hashtable.
+ * \param index Index of the item.
+ * \return Pointer to the item value if the index is valid, else NULL.
+ */
+void *htab_value_at(const htab *ht, const size_t index);
+
+
+/**
+ * \brief htab_hash Computes the hash of the key used by the hashtable.
+ * \param key Key.
+ * \return Hash of the key.
+ */
+unsigned long htab_hash(const char *key);
+
+
 /**
  * \brief htab_contains Checks whether an item with provided key is present in the hashtable.
  * \param ht Pointer to a hashtable.
@@ -116,6 +312,33 @@ int htab_contains(const htab *ht, const char *key);
 void *htab_ptrget(const htab *ht, const char *key);
 
 
+/**
+ * \brief htab_ptrget_hashed Searches for the item with provided key and its hash in the hashtable
+ *                           and if found, returns a pointer to the item value.
+ * \param ht Pointer to a hashtable.
+ * \param key Key of an item to be searched for in the hashtable.
+ * \param hash Hash of the key (htab_hash).
+ * \return Pointer to the item value if the hashtable contains an item with provided key, else NULL.
+ */
+void *htab_ptrget_hashed(const htab *ht, const char *key, const unsigned long hash);
+
+
+/**
+ * \brief htab_ptrget_batch Searches for the items with provided keys and their hashes in the hashtable.
+ *                          Keys are looked up in batches of H_BATCH_SIZE, each step (bucket, entry, long key)
+ *                          is prefetched for all keys of a batch before any of them is accessed,
+ *                          so that the cache misses of the keys overlap.
+ * \param ht Pointer to a hashtable.
+ * \param keys Keys of items to be searched for in the hashtable.
+ * \param hashes Hashes of the keys (htab_hash).
+ * \param cnt Number of the keys.
+ * \param values Array of cnt items, where the pointers to the item values (NULL if not found) will be stored.
+ * \return Number of found keys.
+ */
+size_t htab_ptrget_batch(const htab *ht, const char *keys[], const unsigned long hashes[], const size_t cnt,
+                         void *values[]);
+
+
 /**
  * \brief htab_get Searches for the item with provided key in the hashtable
  *                 and if found, copies the item value to destination.
@@ -130,7 +353,7 @@ int htab_get(const htab *ht, const char *key, void *dest);
 /**
  * \brief htab_add Adds an hashtable entry (link) to the hashtable.
  *                 Copies the provided key and value (either a pointer or a direct value) to the entry,
- *                 which is then added to the hashtable.
+ *                 which is then appended to the entries and added to its bucket.
  * \param ht Pointer to a hashtable.
  * \param key Key to be copied and added to the hashtable.
  * \param value Pointer to the value to be copied and added to the hashtable.
@@ -139,6 +362,17 @@ int htab_get(const htab *ht, const char *key, void *dest);
 int htab_add(htab *ht, const char *key, const void *value);
 
 
+/**
+ * \brief htab_add_hashed Adds an hashtable entry (link) of the key and its hash to the hashtable (see htab_add).
+ * \param ht Pointer to a hashtable.
+ * \param key Key to be copied and added to the hashtable.
+ * \param hash Hash of the key (htab_hash).
+ * \param value Pointer to the value to be copied and added to the hashtable.
+ * \return 1 if the operation was successful, else 0.
+ */
+int htab_add_hashed(htab *ht, const char *key, const unsigned long hash, const void *value);
+
+
 /**
  * \brief htl_iter_create Creates an iterator over entries (links) of provided hashtable.
  * \param ht Pointer to a hashtable to be iterated through.
@@ -147,6 +381,14 @@ int htab_add(htab *ht, const char *key, const void *value);
 htl_iter *htl_iter_create(const htab *ht);
 
 
+/**
+ * \brief htl_iter_init Initializes an (e.g. automatic) iterator over entries (links) of provided hashtable.
+ * \param it Pointer to an iterator.
+ * \param ht Pointer to a hashtable to be iterated through.
+ */
+void htl_iter_init(htl_iter *it, const htab *ht);
+
+
 /**
  * \brief htl_iter_free Releases the memory held by the hashtable iterator
  *                      - frees htl_iter struct
@@ -172,6 +414,24 @@ int htl_iter_has_next(const htl_iter *it);
 htab_link *htl_iter_next(htl_iter *it);
 
 
+/**
+ * \brief htl_key Returns the key of the hashtable entry (link).
+ * \param ht Pointer to a hashtable of the entry.
+ * \param htl Pointer to a hashtable entry (link).
+ * \return Pointer to the key.
+ */
+const char *htl_key(const htab *ht, const htab_link *htl);
+
+
+/**
+ * \brief htl_value Returns a pointer to the value of the hashtable entry (link).
+ * \param ht Pointer to a hashtable of the entry.
+ * \param htl Pointer to a hashtable entry (link).
+ * \return Pointer to the item value.
+ */
+void *htl_value(const htab *ht, const htab_link *htl);
+
+
 /**
  * \brief htl_iter_reset Returns the iterator to the beginning.
  */
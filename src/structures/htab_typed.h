@@ -0,0 +1,409 @@
+/**
+ * \file htab_typed.h
+ * \brief Header file related to type-specialized hashtables (macro templates).
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * HTAB_TYPED_DECLARE(name, T) declares and HTAB_TYPED_DEFINE(name, T) defines a hashtable
+ * mapping char array keys to values of type T (a scalar type, values are passed and stored by value).
+ * It is the generic hashtable (see hashtable.h) with the value type known at compile time:
+ * entries are structs of the link and the value, so values are assigned (not copied by their size)
+ * and entries are indexed by their constant size, there is no value deallocator,
+ * keys are hashed by str_hash (htab_hash) called directly.
+ * Entries are stored in the order of their addition in chunks of H_CHUNK_ENTRIES entries, short keys in the entries
+ * and the long ones in the chunks of the keys arena (see H_KEY_INLINE_SIZE),
+ * buckets are linked lists of entries chained by their indices (index + 1, 0 ends the list),
+ * they are doubled incrementally (see hashtable.h).
+ * Chunks are never moved, so the pointers to the values stay valid until the hashtable is cleared or freed.
+ *
+ * Generated for the prefix name:
+ *  - name_entry, name: entry and hashtable structs,
+ *  - name_create(items_cnt): creates an empty hashtable holding items_cnt items without expansion,
+ *  - name_free(&ht): frees the hashtable and NULLs the pointer,
+ *  - name_items_cnt(ht): items count,
+ *  - name_key_at(ht, index), name_hash_at(ht, index): key and its hash of the item of the index (addition order),
+ *  - name_reserve(ht, items_cnt): expands buckets and allocates the chunks of entries at once (see htab_reserve),
+ *  - name_ptrget(ht, key), name_ptrget_hashed(ht, key, hash): pointer to the value of the key or NULL,
+ *  - name_ptrget_batch(ht, keys, hashes, cnt, values): batched lookup (see htab_ptrget_batch),
+ *  - name_add(ht, key, value), name_add_hashed(ht, key, hash, value): adds the key (not present yet),
+ *  - name_clear(ht): removes all the items, keeping the chunks of the entries and keys for the next ones.
+ * Functions return 1 (0) on success (failure) like their generic counterparts.
+ * The translation unit defining a hashtable includes stdlib.h, string.h, arrays.h and hashing.h first.
+ */
+
+
+#ifndef HTAB_TYPED_H
+#define HTAB_TYPED_H
+
+
+#include <stddef.h>
+
+#include "hashtable.h"
+
+
+#if defined(__GNUC__)
+/** \brief Prefetches the memory at the address into the cache for reading. */
+#define HTAB_TYPED_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+/** \brief Prefetches the memory at the address into the cache for reading (not supported by the compiler). */
+#define HTAB_TYPED_PREFETCH(addr) ((void) (addr))
+#endif
+
+/** \brief Returns the bucket of the hash of a key (buckets count is a power of two). */
+#define HTAB_TYPED_HCODE(hash, buckets_cnt) ((size_t) ((hash) & ((buckets_cnt) - 1)))
+
+/** \brief Returns the key copy of an entry, inline or in the keys arena. */
+#define HTAB_TYPED_KEY(e) ((e)->key_long ? (e)->key_long : (e)->key_inline)
+
+/** \brief Returns the entry of the index of the hashtable name, in its chunk at the offset of the low bits. */
+#define HTAB_TYPED_ENTRY(name, ht, index) ((name##_entry *) (ht)->chunks[(index) >> H_CHUNK_SHIFT] + \
+                                           ((index) & (H_CHUNK_ENTRIES - 1)))
+
+
+/**
+ * \brief Declares the type-specialized hashtable name with values of type T (structs and functions).
+ */
+#define HTAB_TYPED_DECLARE(name, T) \
+typedef struct name##_entry_ { \
+    unsigned long hash;         /* Hash of the key. */ \
+    size_t next;                /* Index of the next entry of the bucket + 1, 0 if it is the last one. */ \
+    const char *key_long;       /* Copy of the key in the keys arena, NULL if it is inline. */ \
+    char key_inline[H_KEY_INLINE_SIZE]; /* Copy of the key, if it is short enough. */ \
+    T value;                    /* Value. */ \
+} name##_entry; \
+\
+typedef struct name##_ { \
+    size_t *buckets;            /* Bucket heads (index of the first entry + 1, 0 if empty). */ \
+    size_t buckets_cnt;         /* Buckets count. */ \
+    size_t *old_buckets;        /* Buckets being migrated to the buckets (expansion in progress), else NULL. */ \
+    size_t old_buckets_cnt;     /* Old buckets count. */ \
+    size_t migrated_cnt;        /* Number of old buckets already migrated. */ \
+    char **chunks;              /* Chunks of H_CHUNK_ENTRIES entries in addition order. */ \
+    size_t chunks_cnt;          /* Number of allocated chunks. */ \
+    size_t chunks_cap;          /* Capacity of the array of chunks. */ \
+    htab_keys keys;             /* Keys arena. */ \
+    size_t items_cnt;           /* Items count. */ \
+} name; \
+\
+name *name##_create(const size_t items_cnt); \
+void name##_free(name **ht); \
+size_t name##_items_cnt(const name *ht); \
+const char *name##_key_at(const name *ht, const size_t index); \
+unsigned long name##_hash_at(const name *ht, const size_t index); \
+int name##_reserve(name *ht, const size_t items_cnt); \
+T *name##_ptrget(const name *ht, const char *key); \
+T *name##_ptrget_hashed(const name *ht, const char *key, const unsigned long hash); \
+size_t name##_ptrget_batch(const name *ht, const char *keys[], const unsigned long hashes[], const size_t cnt, \
+                           T *values[]); \
+int name##_add(name *ht, const char *key, const T value); \
+int name##_add_hashed(name *ht, const char *key, const unsigned long hash, const T value); \
+void name##_clear(name *ht);
+
+
+/**
+ * \brief Defines the functions of the type-specialized hashtable name with values of type T
+ *        (declared by HTAB_TYPED_DECLARE), once per program.
+ */
+#define HTAB_TYPED_DEFINE(name, T) \
+name *name##_create(const size_t items_cnt) { \
+    name *ht = NULL; \
+\
+    ht = (name *) malloc(sizeof(name)); \
+    if (!ht) { \
+        return NULL; \
+    } \
+\
+    ht->buckets_cnt = htab_buckets_cnt(items_cnt); \
+    ht->buckets = (size_t *) array_create(ht->buckets_cnt, sizeof(size_t)); \
+    if (!ht->buckets) { \
+        free(ht); \
+        return NULL; \
+    } \
+    ht->old_buckets = NULL; \
+    ht->old_buckets_cnt = ht->migrated_cnt = 0; \
+\
+    ht->chunks = NULL; \
+    ht->chunks_cnt = ht->chunks_cap = 0; \
+    htab_keys_init(&ht->keys); \
+    if (!htab_chunks_fit(&ht->chunks, &ht->chunks_cnt, &ht->chunks_cap, sizeof(name##_entry), items_cnt)) { \
+        htab_chunks_free(&ht->chunks, ht->chunks_cnt); \
+        array_free((void **) &ht->buckets); \
+        free(ht); \
+        return NULL; \
+    } \
+\
+    ht->items_cnt = 0; \
+\
+    return ht; \
+} \
+\
+void name##_free(name **ht) { \
+    if (!ht || !(*ht)) { \
+        return; \
+    } \
+\
+    array_free((void **) &(*ht)->buckets); \
+    if ((*ht)->old_buckets) { \
+        array_free((void **) &(*ht)->old_buckets); \
+    } \
+    htab_chunks_free(&(*ht)->chunks, (*ht)->chunks_cnt); \
+    htab_keys_free(&(*ht)->keys); \
+    free(*ht); \
+    *ht = NULL; \
+} \
+\
+size_t name##_items_cnt(const name *ht) { \
+    if (!ht) { \
+        return 0; \
+    } \
+\
+    return ht->items_cnt; \
+} \
+\
+const char *name##_key_at(const name *ht, const size_t index) { \
+    if (!ht || index >= ht->items_cnt) { \
+        return NULL; \
+    } \
+\
+    return HTAB_TYPED_KEY(HTAB_TYPED_ENTRY(name, ht, index)); \
+} \
+\
+unsigned long name##_hash_at(const name *ht, const size_t index) { \
+    if (!ht || index >= ht->items_cnt) { \
+        return 0; \
+    } \
+\
+    return HTAB_TYPED_ENTRY(name, ht, index)->hash; \
+} \
+\
+/* searches the bucket (its head) for the entry of the key, does not check arguments validity */ \
+name##_entry *name##_chain_find(const name *ht, size_t head, const char *key, const unsigned long hash) { \
+    name##_entry *e = NULL; \
+\
+    while (head) { \
+        e = HTAB_TYPED_ENTRY(name, ht, head - 1); \
+        if (e->hash == hash && strcmp(key, HTAB_TYPED_KEY(e)) == 0) { \
+            return e; \
+        } \
+\
+        head = e->next; \
+    } \
+\
+    return NULL; \
+} \
+\
+T *name##_ptrget_hashed(const name *ht, const char *key, const unsigned long hash) { \
+    name##_entry *e = NULL; \
+\
+    if (!ht || !key) { \
+        return NULL; \
+    } \
+\
+    e = name##_chain_find(ht, ht->buckets[HTAB_TYPED_HCODE(hash, ht->buckets_cnt)], key, hash); \
+    if (!e && ht->old_buckets) { \
+        e = name##_chain_find(ht, ht->old_buckets[HTAB_TYPED_HCODE(hash, ht->old_buckets_cnt)], key, hash); \
+    } \
+\
+    return e ? &e->value : NULL; \
+} \
+\
+T *name##_ptrget(const name *ht, const char *key) { \
+    if (!key) { \
+        return NULL; \
+    } \
+\
+    return name##_ptrget_hashed(ht, key, str_hash(key)); \
+} \
+\
+size_t name##_ptrget_batch(const name *ht, const char *keys[], const unsigned long hashes[], const size_t cnt, \
+                           T *values[]) { \
+    size_t heads[H_BATCH_SIZE]; \
+    name##_entry *e = NULL; \
+    size_t start, batch_cnt, i, found; \
+\
+    if (!ht || (!keys && cnt) || (!hashes && cnt) || (!values && cnt)) { \
+        return 0; \
+    } \
+\
+    found = 0; \
+    for (start = 0; start < cnt; start += batch_cnt) { \
+        batch_cnt = cnt - start < H_BATCH_SIZE ? cnt - start : H_BATCH_SIZE; \
+\
+        /* every step is prefetched for the whole batch before it is taken for any key */ \
+        for (i = 0; i < batch_cnt; i++) { \
+            HTAB_TYPED_PREFETCH(&ht->buckets[HTAB_TYPED_HCODE(hashes[start + i], ht->buckets_cnt)]); \
+        } \
+        for (i = 0; i < batch_cnt; i++) { \
+            heads[i] = ht->buckets[HTAB_TYPED_HCODE(hashes[start + i], ht->buckets_cnt)]; \
+            if (heads[i]) { \
+                HTAB_TYPED_PREFETCH(HTAB_TYPED_ENTRY(name, ht, heads[i] - 1)); \
+            } \
+        } \
+        for (i = 0; i < batch_cnt; i++) { \
+            e = heads[i] ? HTAB_TYPED_ENTRY(name, ht, heads[i] - 1) : NULL; \
+            if (e && e->hash == hashes[start + i] && e->key_long) { \
+                HTAB_TYPED_PREFETCH(e->key_long); \
+            } \
+        } \
+\
+        for (i = 0; i < batch_cnt; i++) { \
+            e = name##_chain_find(ht, heads[i], keys[start + i], hashes[start + i]); \
+            if (!e && ht->old_buckets) { \
+                e = name##_chain_find(ht, ht->old_buckets[HTAB_TYPED_HCODE(hashes[start + i], ht->old_buckets_cnt)], \
+                                      keys[start + i], hashes[start + i]); \
+            } \
+            values[start + i] = e ? &e->value : NULL; \
+            found += e != NULL; \
+        } \
+    } \
+\
+    return found; \
+} \
+\
+/* pushes the entry of the index to the front of its bucket, does not check arguments validity */ \
+void name##_bucket_push(size_t *buckets, const size_t buckets_cnt, name##_entry *e, const size_t index) { \
+    size_t hcode; \
+\
+    hcode = HTAB_TYPED_HCODE(e->hash, buckets_cnt); \
+    e->next = buckets[hcode]; \
+    buckets[hcode] = index + 1; \
+} \
+\
+/* migrates the next (at most cnt) old buckets, frees them once migrated (see htab_migrate_buckets) */ \
+void name##_migrate_buckets(name *ht, const size_t cnt) { \
+    name##_entry *e = NULL; \
+    size_t b, head, head_next; \
+\
+    for (b = 0; b < cnt && ht->migrated_cnt < ht->old_buckets_cnt; b++, ht->migrated_cnt++) { \
+        head = ht->old_buckets[ht->migrated_cnt]; \
+        while (head) { \
+            e = HTAB_TYPED_ENTRY(name, ht, head - 1); \
+            head_next = e->next; \
+            name##_bucket_push(ht->buckets, ht->buckets_cnt, e, head - 1); \
+            head = head_next; \
+        } \
+        ht->old_buckets[ht->migrated_cnt] = 0; \
+    } \
+\
+    if (ht->migrated_cnt == ht->old_buckets_cnt) { \
+        array_free((void **) &ht->old_buckets); \
+        ht->old_buckets = NULL; \
+        ht->old_buckets_cnt = ht->migrated_cnt = 0; \
+    } \
+} \
+\
+/* starts the expansion of the buckets (see htab_expand_buckets) */ \
+int name##_expand_buckets(name *ht, const size_t new_cnt) { \
+    size_t *new_buckets = NULL; \
+\
+    if (ht->old_buckets) { \
+        name##_migrate_buckets(ht, ht->old_buckets_cnt); \
+    } \
+\
+    new_buckets = (size_t *) array_create(new_cnt, sizeof(size_t)); \
+    if (!new_buckets) { \
+        return 0; \
+    } \
+\
+    ht->old_buckets = ht->buckets; \
+    ht->old_buckets_cnt = ht->buckets_cnt; \
+    ht->migrated_cnt = 0; \
+    ht->buckets = new_buckets; \
+    ht->buckets_cnt = new_cnt; \
+\
+    return 1; \
+} \
+\
+int name##_reserve(name *ht, const size_t items_cnt) { \
+    size_t buckets_cnt; \
+\
+    if (!ht) { \
+        return 0; \
+    } \
+\
+    if (!htab_chunks_fit(&ht->chunks, &ht->chunks_cnt, &ht->chunks_cap, sizeof(name##_entry), items_cnt)) { \
+        return 0; \
+    } \
+\
+    buckets_cnt = htab_buckets_cnt(items_cnt); \
+    if (buckets_cnt <= ht->buckets_cnt) { \
+        return 1; \
+    } \
+\
+    if (!name##_expand_buckets(ht, buckets_cnt)) { \
+        return 0; \
+    } \
+    name##_migrate_buckets(ht, ht->old_buckets_cnt); \
+\
+    return 1; \
+} \
+\
+int name##_add_hashed(name *ht, const char *key, const unsigned long hash, const T value) { \
+    name##_entry *new_e = NULL; \
+    size_t key_size; \
+\
+    if (!ht || !key) { \
+        return 0; \
+    } \
+\
+    if (ht->items_cnt == ht->buckets_cnt * H_ITEMS_PER_BUCKET && \
+        !name##_expand_buckets(ht, 2 * ht->buckets_cnt)) { \
+        return 0; \
+    } \
+\
+    key_size = strlen(key) + 1; \
+    if (!htab_chunks_fit(&ht->chunks, &ht->chunks_cnt, &ht->chunks_cap, sizeof(name##_entry), ht->items_cnt + 1)) { \
+        return 0; \
+    } \
+    new_e = HTAB_TYPED_ENTRY(name, ht, ht->items_cnt); \
+    if (key_size <= H_KEY_INLINE_SIZE) { \
+        new_e->key_long = NULL; \
+        memcpy(new_e->key_inline, key, key_size); \
+    } \
+    else { \
+        new_e->key_long = htab_keys_copy(&ht->keys, key, key_size); \
+        if (!new_e->key_long) { \
+            return 0; \
+        } \
+    } \
+\
+    if (ht->old_buckets) { \
+        name##_migrate_buckets(ht, H_REHASH_STEP); \
+    } \
+\
+    new_e->hash = hash; \
+    new_e->value = value; \
+    name##_bucket_push(ht->buckets, ht->buckets_cnt, new_e, ht->items_cnt); \
+    ht->items_cnt++; \
+\
+    return 1; \
+} \
+\
+int name##_add(name *ht, const char *key, const T value) { \
+    if (!key) { \
+        return 0; \
+    } \
+\
+    return name##_add_hashed(ht, key, str_hash(key), value); \
+} \
+\
+void name##_clear(name *ht) { \
+    size_t i; \
+\
+    if (!ht) { \
+        return; \
+    } \
+\
+    /* only the buckets of the items are emptied, so clearing a few items of large buckets costs a few steps */ \
+    if (ht->old_buckets) { \
+        name##_migrate_buckets(ht, ht->old_buckets_cnt); \
+    } \
+    for (i = 0; i < ht->items_cnt; i++) { \
+        ht->buckets[HTAB_TYPED_HCODE(HTAB_TYPED_ENTRY(name, ht, i)->hash, ht->buckets_cnt)] = 0; \
+    } \
+    ht->items_cnt = 0; \
+    htab_keys_rewind(&ht->keys); \
+}
+
+
+#endif
@@ -0,0 +1,19 @@
+/**
+ * \file htabs.c
+ * \brief Functions of the type-specialized hashtables declared in htabs.h are defined in this file.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "htabs.h"
+#include "../utilities/arrays.h"
+#include "../utilities/hashing.h"
+
+
+HTAB_TYPED_DEFINE(htab_size, size_t)
+
+HTAB_TYPED_DEFINE(htab_uint, unsigned)
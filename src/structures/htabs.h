@@ -0,0 +1,27 @@
+/**
+ * \file htabs.h
+ * \brief Header file of the type-specialized hashtables used by the classifier and the corpus.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Instances of the hashtable template (see htab_typed.h):
+ *  - htab_size: key -> size_t (word identifiers of the classifier dictionary),
+ *  - htab_uint: key -> unsigned (word indices of the corpus cache vocabulary).
+ */
+
+
+#ifndef HTABS_H
+#define HTABS_H
+
+
+#include <stddef.h>
+
+#include "htab_typed.h"
+
+
+HTAB_TYPED_DECLARE(htab_size, size_t)
+
+HTAB_TYPED_DECLARE(htab_uint, unsigned)
+
+
+#endif
@@ -0,0 +1,302 @@
+/**
+ * \file shtab.c
+ * \brief Functions declared in shtab.h are implemented in this file.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Shard is a hashtable of keys to indices of their rows, rows are allocated in chunks of SHTAB_CHUNK_ROWS,
+ * pointers to the chunks are kept in an array, which grows under the lock of the shard.
+ * Shards are locked by POSIX mutexes on Unix, elsewhere the table is meant to be used by one thread only.
+ */
+
+
+#if defined(__unix__)
+#define _POSIX_C_SOURCE 200112L
+#define SHTAB_PTHREADS
+#endif
+
+#include <stdlib.h>
+
+#ifdef SHTAB_PTHREADS
+#include <pthread.h>
+#endif
+
+#include "shtab.h"
+#include "../utilities/arrays.h"
+
+
+/** \brief Size of a shard (a multiple of the cache line size), shards do not share cache lines. */
+#define SHTAB_SHARD_SIZE 128
+
+
+/**
+ * \struct shtab_shard_state
+ * \brief Struct representing the state of a shard.
+ */
+typedef struct shtab_shard_state_ {
+#ifdef SHTAB_PTHREADS
+    pthread_mutex_t lock;       /**< Lock of the shard. */
+#endif
+    htab_size *index;           /**< Indices of rows of the keys of the shard. */
+    size_t **chunks;            /**< Chunks of SHTAB_CHUNK_ROWS rows. */
+    size_t chunks_cnt;          /**< Number of allocated chunks. */
+    size_t chunks_cap;          /**< Capacity of the array of chunks. */
+} shtab_shard_state;
+
+
+/**
+ * \struct shtab_shard
+ * \brief Struct representing a shard padded to SHTAB_SHARD_SIZE.
+ */
+typedef struct shtab_shard_ {
+    shtab_shard_state s;                                        /**< State of the shard. */
+    char padding[SHTAB_SHARD_SIZE - sizeof(shtab_shard_state)];
+} shtab_shard;
+
+
+/**
+ * \brief shtab_shard_lock Locks the shard.
+ * \param shard Pointer to a shard.
+ */
+void shtab_shard_lock(shtab_shard *shard) {
+#ifdef SHTAB_PTHREADS
+    pthread_mutex_lock(&shard->s.lock);
+#else
+    (void) shard;
+#endif
+}
+
+
+/**
+ * \brief shtab_shard_unlock Unlocks the shard.
+ * \param shard Pointer to a shard.
+ */
+void shtab_shard_unlock(shtab_shard *shard) {
+#ifdef SHTAB_PTHREADS
+    pthread_mutex_unlock(&shard->s.lock);
+#else
+    (void) shard;
+#endif
+}
+
+
+shtab *shtab_create(const size_t row_len, const size_t shards_cnt, const size_t items_cnt) {
+    shtab *st = NULL;
+    size_t s;
+
+    if (!row_len || !shards_cnt || shards_cnt > SHTAB_MAX_SHARDS) {
+        return NULL;
+    }
+
+    st = (shtab *) malloc(sizeof(shtab));
+    if (!st) {
+        return NULL;
+    }
+
+    for (st->shards_cnt = 1; st->shards_cnt < shards_cnt; st->shards_cnt *= 2) {
+        ;
+    }
+    st->row_len = row_len;
+    st->shards = (shtab_shard *) array_create_aligned(st->shards_cnt, sizeof(shtab_shard), SHTAB_SHARD_SIZE);
+    if (!st->shards) {
+        free(st);
+        return NULL;
+    }
+
+    for (s = 0; s < st->shards_cnt; s++) {
+        st->shards[s].s.index = htab_size_create(items_cnt / st->shards_cnt);
+        if (!st->shards[s].s.index) {
+            goto fail;
+        }
+#ifdef SHTAB_PTHREADS
+        if (pthread_mutex_init(&st->shards[s].s.lock, NULL) != 0) {
+            htab_size_free(&st->shards[s].s.index);
+            goto fail;
+        }
+#endif
+    }
+
+    return st;
+
+fail:
+    /* shards are cleared, only the ones before the failed one are initialized */
+    st->shards_cnt = s;
+    shtab_free(&st);
+    return NULL;
+}
+
+
+void shtab_free(shtab **st) {
+    shtab_shard *shard = NULL;
+    size_t s, c;
+
+    if (!st || !(*st)) {
+        return;
+    }
+
+    for (s = 0; s < (*st)->shards_cnt; s++) {
+        shard = &(*st)->shards[s];
+        for (c = 0; c < shard->s.chunks_cnt; c++) {
+            array_free((void **) &shard->s.chunks[c]);
+        }
+        free(shard->s.chunks);
+        htab_size_free(&shard->s.index);
+#ifdef SHTAB_PTHREADS
+        pthread_mutex_destroy(&shard->s.lock);
+#endif
+    }
+    array_free_aligned((void **) &(*st)->shards);
+    free(*st);
+    *st = NULL;
+}
+
+
+/**
+ * \brief shtab_shard_of Returns the shard of the hash of a key.
+ *                       Does not check arguments validity.
+ * \param st Pointer to a table.
+ * \param hash Hash of a key.
+ * \return Pointer to the shard.
+ */
+shtab_shard *shtab_shard_of(const shtab *st, const unsigned long hash) {
+    return &st->shards[(size_t) (hash >> SHTAB_SHARD_SHIFT) & (st->shards_cnt - 1)];
+}
+
+
+/**
+ * \brief shtab_shard_row Returns the row of the index of the shard.
+ *                        Does not check arguments validity.
+ * \param st Pointer to a table.
+ * \param shard Pointer to a shard.
+ * \param index Index of the row (of an allocated chunk).
+ * \return Pointer to the row.
+ */
+size_t *shtab_shard_row(const shtab *st, const shtab_shard *shard, const size_t index) {
+    return shard->s.chunks[index / SHTAB_CHUNK_ROWS] + (index % SHTAB_CHUNK_ROWS) * st->row_len;
+}
+
+
+/**
+ * \brief shtab_shard_add Adds the key with a row of zero counts to the shard, the shard must be locked.
+ *                        Does not check arguments validity.
+ * \param st Pointer to a table.
+ * \param shard Pointer to a shard.
+ * \param key Key.
+ * \param hash Hash of the key.
+ * \return Pointer to the row of the key, or NULL on failure.
+ */
+size_t *shtab_shard_add(const shtab *st, shtab_shard *shard, const char *key, const unsigned long hash) {
+    size_t **new_chunks = NULL;
+    size_t index;
+
+    index = htab_size_items_cnt(shard->s.index);
+    if (index == shard->s.chunks_cnt * SHTAB_CHUNK_ROWS) {
+        new_chunks = (size_t **) htab_storage_fit(shard->s.chunks, &shard->s.chunks_cap, sizeof(size_t *),
+                                                  shard->s.chunks_cnt + 1, H_DEF_BUCKETS_CNT);
+        if (!new_chunks) {
+            return NULL;
+        }
+        shard->s.chunks = new_chunks;
+        shard->s.chunks[shard->s.chunks_cnt] = (size_t *) array_create(SHTAB_CHUNK_ROWS * st->row_len,
+                                                                       sizeof(size_t));
+        if (!shard->s.chunks[shard->s.chunks_cnt]) {
+            return NULL;
+        }
+        shard->s.chunks_cnt++;
+    }
+
+    if (!htab_size_add_hashed(shard->s.index, key, hash, index)) {
+        return NULL;
+    }
+
+    return shtab_shard_row(st, shard, index);
+}
+
+
+size_t *shtab_row(shtab *st, const char *key, const unsigned long hash) {
+    shtab_shard *shard = NULL;
+    size_t *index = NULL, *row = NULL;
+
+    if (!st || !key) {
+        return NULL;
+    }
+
+    shard = shtab_shard_of(st, hash);
+    shtab_shard_lock(shard);
+    index = htab_size_ptrget_hashed(shard->s.index, key, hash);
+    row = index ? shtab_shard_row(st, shard, *index) : shtab_shard_add(st, shard, key, hash);
+    shtab_shard_unlock(shard);
+
+    return row;
+}
+
+
+size_t *shtab_row_find(shtab *st, const char *key, const unsigned long hash) {
+    shtab_shard *shard = NULL;
+    size_t *index = NULL, *row = NULL;
+
+    if (!st || !key) {
+        return NULL;
+    }
+
+    shard = shtab_shard_of(st, hash);
+    shtab_shard_lock(shard);
+    index = htab_size_ptrget_hashed(shard->s.index, key, hash);
+    row = index ? shtab_shard_row(st, shard, *index) : NULL;
+    shtab_shard_unlock(shard);
+
+    return row;
+}
+
+
+size_t shtab_row_add(size_t row[], const size_t col, const size_t cnt) {
+#if defined(__GNUC__)
+    return __atomic_fetch_add(&row[col], cnt, __ATOMIC_RELAXED);
+#else
+    row[col] += cnt;
+    return row[col] - cnt;
+#endif
+}
+
+
+size_t shtab_items_cnt(const shtab *st) {
+    size_t s, items_cnt;
+
+    if (!st) {
+        return 0;
+    }
+
+    for (s = 0, items_cnt = 0; s < st->shards_cnt; s++) {
+        items_cnt += htab_size_items_cnt(st->shards[s].s.index);
+    }
+
+    return items_cnt;
+}
+
+
+size_t shtab_shard_items_cnt(const shtab *st, const size_t shard) {
+    if (!st || shard >= st->shards_cnt) {
+        return 0;
+    }
+
+    return htab_size_items_cnt(st->shards[shard].s.index);
+}
+
+
+const char *shtab_key_at(const shtab *st, const size_t shard, const size_t index, unsigned long *hash) {
+    if (!st || shard >= st->shards_cnt || !hash) {
+        return NULL;
+    }
+
+    *hash = htab_size_hash_at(st->shards[shard].s.index, index);
+    return htab_size_key_at(st->shards[shard].s.index, index);
+}
+
+
+size_t *shtab_row_at(const shtab *st, const size_t shard, const size_t index) {
+    if (!st || shard >= st->shards_cnt || index >= htab_size_items_cnt(st->shards[shard].s.index)) {
+        return NULL;
+    }
+
+    return shtab_shard_row(st, &st->shards[shard], index);
+}
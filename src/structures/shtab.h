@@ -0,0 +1,133 @@
+/**
+ * \file shtab.h
+ * \brief Header file related to a sharded concurrent table of rows of counts.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Table maps char array keys to rows of counts (row_len size_t counts, zero when the key is added)
+ * and it is updated by any number of threads at once.
+ * Keys are split into shards (hashtables of their own) by the high bits of their hashes,
+ * each shard is guarded by its own lock (striped locks), so threads adding different keys rarely wait.
+ * Rows are allocated in chunks which never move, so a row found (or added) under the lock of its shard
+ * is then updated without it, by atomic increments (GCC atomic builtins).
+ * Rows of a shard are indexed in the order of addition of their keys (see shtab_key_at, shtab_row_at),
+ * the table is read so only when no thread updates it.
+ */
+
+
+#ifndef SHTAB_H
+#define SHTAB_H
+
+
+#include <stddef.h>
+
+#include "htabs.h"
+
+
+/** \brief Maximal number of shards. */
+#define SHTAB_MAX_SHARDS 256
+/** \brief Number of rows of a chunk. */
+#define SHTAB_CHUNK_ROWS 1024
+/** \brief Hash bits below the ones selecting the shard (the low bits select the buckets of a shard). */
+#define SHTAB_SHARD_SHIFT 24
+
+
+/**
+ * \struct shtab
+ * \brief Struct representing a sharded concurrent table of rows of counts.
+ */
+typedef struct shtab_ {
+    struct shtab_shard_ *shards;    /**< Shards (defined in shtab.c), each one on its own cache lines. */
+    size_t shards_cnt;              /**< Number of shards (a power of two). */
+    size_t row_len;                 /**< Number of counts of a row. */
+} shtab;
+
+
+/**
+ * \brief shtab_create Creates an empty table of rows of counts.
+ * \param row_len Number of counts of a row.
+ * \param shards_cnt Number of shards, rounded up to a power of two (at most SHTAB_MAX_SHARDS).
+ * \param items_cnt Number of keys the table will hold without expanding the hashtables of the shards.
+ * \return Pointer to a new empty table, or NULL on failure.
+ */
+shtab *shtab_create(const size_t row_len, const size_t shards_cnt, const size_t items_cnt);
+
+
+/**
+ * \brief shtab_free Releases the memory held by the table and NULLs the pointer to the table.
+ * \param st Pointer to a pointer to a table.
+ */
+void shtab_free(shtab **st);
+
+
+/**
+ * \brief shtab_row Finds the row of the key, adds the key with a row of zero counts if it is not there yet.
+ *                  Thread-safe, only the shard of the key is locked.
+ * \param st Pointer to a table.
+ * \param key Key.
+ * \param hash Hash of the key (htab_hash).
+ * \return Pointer to the row of counts of the key (valid until the table is freed), or NULL on failure.
+ */
+size_t *shtab_row(shtab *st, const char *key, const unsigned long hash);
+
+
+/**
+ * \brief shtab_row_find Finds the row of the key, the key is not added.
+ *                       Thread-safe, only the shard of the key is locked.
+ * \param st Pointer to a table.
+ * \param key Key.
+ * \param hash Hash of the key (htab_hash).
+ * \return Pointer to the row of counts of the key (valid until the table is freed), or NULL if it is not there.
+ */
+size_t *shtab_row_find(shtab *st, const char *key, const unsigned long hash);
+
+
+/**
+ * \brief shtab_row_add Adds to a count of a row atomically.
+ * \param row Row of counts (see shtab_row).
+ * \param col Index of the count.
+ * \param cnt Number to be added.
+ * \return Count before the addition.
+ */
+size_t shtab_row_add(size_t row[], const size_t col, const size_t cnt);
+
+
+/**
+ * \brief shtab_items_cnt Returns the number of keys of the table (not to be called while it is updated).
+ * \param st Pointer to a table.
+ * \return Number of keys.
+ */
+size_t shtab_items_cnt(const shtab *st);
+
+
+/**
+ * \brief shtab_shard_items_cnt Returns the number of keys of the shard (not to be called while it is updated).
+ * \param st Pointer to a table.
+ * \param shard Index of the shard.
+ * \return Number of keys of the shard.
+ */
+size_t shtab_shard_items_cnt(const shtab *st, const size_t shard);
+
+
+/**
+ * \brief shtab_key_at Returns the key of the index (order of addition) of the shard.
+ * \param st Pointer to a table.
+ * \param shard Index of the shard.
+ * \param index Index of the key in the shard.
+ * \param hash Pointer to where the hash of the key will be stored.
+ * \return Pointer to the key, or NULL if the index is not valid.
+ */
+const char *shtab_key_at(const shtab *st, const size_t shard, const size_t index, unsigned long *hash);
+
+
+/**
+ * \brief shtab_row_at Returns the row of the key of the index (order of addition) of the shard.
+ * \param st Pointer to a table.
+ * \param shard Index of the shard.
+ * \param index Index of the key in the shard.
+ * \return Pointer to the row of counts, or NULL if the index is not valid.
+ */
+size_t *shtab_row_at(const shtab *st, const size_t shard, const size_t index);
+
+
+#endif
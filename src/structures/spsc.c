@@ -0,0 +1,157 @@
+/**
+ * \file spsc.c
+ * \brief Functions declared in spsc.h are implemented in this file.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Indices only grow (they wrap around at SIZE_MAX, which the masking and the subtractions tolerate),
+ * the queue holds tail - head items, the item of the index i lies in the slot i & mask of the ring.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "spsc.h"
+#include "../utilities/arrays.h"
+
+
+/**
+ * \brief spsc_load Loads the index written by the other thread (acquire).
+ * \param index Pointer to an index.
+ * \return Value of the index.
+ */
+size_t spsc_load(const size_t *index) {
+#if defined(__GNUC__)
+    return __atomic_load_n(index, __ATOMIC_ACQUIRE);
+#else
+    return *index;
+#endif
+}
+
+
+/**
+ * \brief spsc_store Stores the index read by the other thread (release).
+ * \param index Pointer to an index.
+ * \param value Value of the index.
+ */
+void spsc_store(size_t *index, const size_t value) {
+#if defined(__GNUC__)
+    __atomic_store_n(index, value, __ATOMIC_RELEASE);
+#else
+    *index = value;
+#endif
+}
+
+
+/**
+ * \brief spsc_copy Copies items between the ring and an array, wrapping around the end of the ring.
+ *                  Does not check arguments validity.
+ * \param q Pointer to a queue.
+ * \param index Index of the first item in the ring.
+ * \param arr Array of items.
+ * \param cnt Number of items.
+ * \param to_ring Flag whether the items are copied to the ring (else from the ring).
+ */
+void spsc_copy(spsc *q, const size_t index, char *arr, const size_t cnt, const int to_ring) {
+    size_t slot, first;
+
+    slot = index & q->mask;
+    first = q->mask + 1 - slot < cnt ? q->mask + 1 - slot : cnt;
+    if (to_ring) {
+        memcpy(q->items + slot * q->item_size, arr, first * q->item_size);
+        memcpy(q->items, arr + first * q->item_size, (cnt - first) * q->item_size);
+    }
+    else {
+        memcpy(arr, q->items + slot * q->item_size, first * q->item_size);
+        memcpy(arr + first * q->item_size, q->items, (cnt - first) * q->item_size);
+    }
+}
+
+
+spsc *spsc_create(const size_t item_size, const size_t capacity) {
+    spsc *q = NULL;
+    size_t cap;
+
+    if (!item_size || !capacity) {
+        return NULL;
+    }
+
+    q = (spsc *) array_create_aligned(1, sizeof(spsc), SPSC_LINE_SIZE);
+    if (!q) {
+        return NULL;
+    }
+
+    for (cap = 1; cap < capacity; cap *= 2) {
+        ;
+    }
+    q->tail.index = q->tail.other = 0;
+    q->head.index = q->head.other = 0;
+    q->item_size = item_size;
+    q->mask = cap - 1;
+    q->items = (char *) array_create_aligned(cap, item_size, SPSC_LINE_SIZE);
+    if (!q->items) {
+        array_free_aligned((void **) &q);
+        return NULL;
+    }
+
+    return q;
+}
+
+
+void spsc_free(spsc **q) {
+    if (!q || !(*q)) {
+        return;
+    }
+
+    array_free_aligned((void **) &(*q)->items);
+    array_free_aligned((void **) q);
+}
+
+
+size_t spsc_push(spsc *q, const void *items, const size_t cnt) {
+    size_t free_cnt, pushed;
+
+    if (!q || !items) {
+        return 0;
+    }
+
+    free_cnt = q->mask + 1 - (q->tail.index - q->tail.other);
+    if (free_cnt < cnt) {
+        q->tail.other = spsc_load(&q->head.index);
+        free_cnt = q->mask + 1 - (q->tail.index - q->tail.other);
+    }
+    pushed = free_cnt < cnt ? free_cnt : cnt;
+    if (!pushed) {
+        return 0;
+    }
+
+    spsc_copy(q, q->tail.index, (char *) items, pushed, 1);
+    spsc_store(&q->tail.index, q->tail.index + pushed);
+
+    return pushed;
+}
+
+
+size_t spsc_pop(spsc *q, void *items, const size_t max) {
+    size_t held, popped;
+
+    if (!q || !items) {
+        return 0;
+    }
+
+    held = q->head.other - q->head.index;
+    if (held < max) {
+        q->head.other = spsc_load(&q->tail.index);
+        held = q->head.other - q->head.index;
+    }
+    popped = held < max ? held : max;
+    if (!popped) {
+        return 0;
+    }
+
+    spsc_copy(q, q->head.index, (char *) items, popped, 0);
+    spsc_store(&q->head.index, q->head.index + popped);
+
+    return popped;
+}
@@ -0,0 +1,87 @@
+/**
+ * \file spsc.h
+ * \brief Header file related to a lock-free single-producer single-consumer queue.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Queue is a ring of a power of two of items of a fixed size, written by one thread and read by another one
+ * without any locks. Items are pushed and popped in batches, each batch is published by one release store
+ * of the index of the producer (or of the consumer), read by an acquire load of the other thread
+ * (GCC atomic builtins, elsewhere the queue is meant to be used by one thread only).
+ * Indices of the producer and of the consumer lie on cache lines of their own, each thread keeps
+ * a copy of the index of the other one and loads it again only when the queue seems full (empty).
+ */
+
+
+#ifndef SPSC_H
+#define SPSC_H
+
+
+#include <stddef.h>
+
+
+/** \brief Size of the padding of the indices (a multiple of the cache line size). */
+#define SPSC_LINE_SIZE 64
+
+
+/**
+ * \struct spsc_end
+ * \brief Struct representing the indices of one end of a queue, padded to SPSC_LINE_SIZE.
+ */
+typedef struct spsc_end_ {
+    size_t index;                                       /**< Number of items pushed (popped) by the end. */
+    size_t other;                                       /**< Copy of the index of the other end. */
+    char padding[SPSC_LINE_SIZE - 2 * sizeof(size_t)];
+} spsc_end;
+
+
+/**
+ * \struct spsc
+ * \brief Struct representing a lock-free single-producer single-consumer queue.
+ */
+typedef struct spsc_ {
+    spsc_end tail;              /**< End of the producer. */
+    spsc_end head;              /**< End of the consumer. */
+    char *items;                /**< Ring of items. */
+    size_t item_size;           /**< Size of an item. */
+    size_t mask;                /**< Capacity of the ring minus one. */
+} spsc;
+
+
+/**
+ * \brief spsc_create Creates an empty queue.
+ * \param item_size Size of an item.
+ * \param capacity Maximal number of items of the queue, rounded up to a power of two.
+ * \return Pointer to a new empty queue, or NULL on failure.
+ */
+spsc *spsc_create(const size_t item_size, const size_t capacity);
+
+
+/**
+ * \brief spsc_free Releases the memory held by the queue and NULLs the pointer to the queue.
+ * \param q Pointer to a pointer to a queue.
+ */
+void spsc_free(spsc **q);
+
+
+/**
+ * \brief spsc_push Pushes as many of the items as fit in the queue, called by the producer only.
+ * \param q Pointer to a queue.
+ * \param items Array of items.
+ * \param cnt Number of items.
+ * \return Number of the pushed items (the first ones).
+ */
+size_t spsc_push(spsc *q, const void *items, const size_t cnt);
+
+
+/**
+ * \brief spsc_pop Pops at most the provided number of items, called by the consumer only.
+ * \param q Pointer to a queue.
+ * \param items Array where the popped items will be stored.
+ * \param max Maximal number of popped items.
+ * \return Number of the popped items.
+ */
+size_t spsc_pop(spsc *q, void *items, const size_t max);
+
+
+#endif
@@ -45,6 +45,32 @@ int vector_shrink(vector *v) {
 }
 
 
+int vector_resize(vector *v, const size_t count) {
+    size_t capacity;
+
+    if (!v) {
+        return 0;
+    }
+
+    capacity = vector_capacity(v) ? vector_capacity(v) : VECTOR_INIT_CAPACITY;
+    while (capacity < count) {
+        capacity *= VECTOR_CAPACITY_MULT;
+    }
+    if (capacity != vector_capacity(v)) {
+        if (!vector_realloc(v, capacity)) {
+            return 0;
+        }
+    }
+
+    if (count > v->count) {
+        memset((char *) v->data + (v->count * v->item_size), 0, (count - v->count) * v->item_size);
+    }
+    v->count = count;
+
+    return 1;
+}
+
+
 int vector_init(vector *v, const size_t item_size, const vector_item_deallocator deallocator) {
     if (!v || item_size == 0) {
         return 0;
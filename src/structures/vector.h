@@ -110,6 +110,17 @@ int vector_is_empty(const vector *v);
 int vector_realloc(vector *v, const size_t capacity);
 
 
+/**
+ * \brief vector_resize Sets the actual count of items in the vector.
+ *                      Grows the vector capacity if neccessary and sets the newly added items to 0.
+ *                      Items above the new count are not freed.
+ * \param v Pointer to a vector.
+ * \param count New count of items.
+ * \return 1 if operation was successful, else 0.
+ */
+int vector_resize(vector *v, const size_t count);
+
+
 /**
  * \brief vector_shrink Shrinks the vector capacity
  *                      to the actual count of items in the vector.
@@ -0,0 +1,131 @@
+/**
+ * \file tokenizer.c
+ * \brief Functions declared in tokenizer.h are implemented in this file.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Words of a document are separated by whitespace (runs of spaces, line breaks, tabs ...).
+ * Documents are read either from a file stream, or from a memory buffer (e.g. a mapped pack or a raw message),
+ * words are split the same way in both cases, so the lines of a raw message are split the same way
+ * as their text normalized to one line of words separated by single spaces.
+ */
+
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "tokenizer.h"
+#include "structures/vector.h"
+
+
+char *f_next_str(FILE *fp) {
+    vector *v = NULL;
+    char *str = NULL;
+    char ch;
+    int c;
+
+    if (!fp) {
+        return NULL;
+    }
+
+    v = vector_create(sizeof(char), NULL);
+    if (!v) {
+        return NULL;
+    }
+
+    do {
+        c = fgetc(fp);
+    } while (c != EOF && isspace(c));
+
+    while (c != EOF && !isspace(c)) {
+        ch = (char) c;
+        if (!vector_push_back(v, &ch)) {
+            goto fail;
+        }
+
+        c = fgetc(fp);
+    }
+
+    if (!vector_count(v)) {
+        goto fail;
+    }
+
+    ch = '\x00';
+    if (!vector_push_back(v, &ch) || !vector_shrink(v)) {
+        goto fail;
+    }
+
+    str = (char *) vector_give_up_data(v);
+
+    vector_free(&v);
+    return str;
+
+fail:
+    vector_free(&v);
+    return NULL;
+}
+
+
+char *b_next_str(const char *buf, const size_t size, size_t *pos) {
+    const char *start = NULL, *end = NULL;
+    char *str = NULL;
+
+    if (!buf || !pos || *pos >= size) {
+        return NULL;
+    }
+
+    for (start = buf + *pos; start < buf + size && isspace((unsigned char) *start); start++) {
+        ;
+    }
+    if (start == buf + size) {
+        *pos = size;
+        return NULL;
+    }
+    for (end = start; end < buf + size && !isspace((unsigned char) *end); end++) {
+        ;
+    }
+
+    str = (char *) malloc(end - start + 1);
+    if (!str) {
+        return NULL;
+    }
+    memcpy(str, start, end - start);
+    str[end - start] = '\0';
+
+    *pos = (size_t) (end - buf);
+    return str;
+}
+
+
+void tokens_file(tokens *t, FILE *fp) {
+    if (!t) {
+        return;
+    }
+
+    t->fp = fp;
+    t->buf = NULL;
+    t->size = t->pos = 0;
+}
+
+
+void tokens_buffer(tokens *t, const char *buf, const size_t size) {
+    if (!t) {
+        return;
+    }
+
+    t->fp = NULL;
+    t->buf = buf;
+    t->size = size;
+    t->pos = 0;
+}
+
+
+char *tokens_next(tokens *t) {
+    if (!t) {
+        return NULL;
+    }
+
+    return t->fp ? f_next_str(t->fp) : b_next_str(t->buf, t->size, &t->pos);
+}
@@ -0,0 +1,84 @@
+/**
+ * \file tokenizer.h
+ * \brief Header file related to splitting of documents to words.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Words of a document are separated by whitespace (runs of spaces, line breaks, tabs ...).
+ * Documents are read either from a file stream, or from a memory buffer (e.g. a mapped pack or a raw message),
+ * words are split the same way in both cases, so the lines of a raw message are split the same way
+ * as their text normalized to one line of words separated by single spaces.
+ */
+
+
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+
+#include <stdio.h>
+
+
+/**
+ * \struct tokens
+ * \brief Struct representing a source of words of a document, a file stream or a memory buffer.
+ */
+typedef struct tokens_ {
+    FILE *fp;           /**< File handle, or NULL if the words are read from the buffer. */
+    const char *buf;    /**< Buffer holding the document. */
+    size_t size;        /**< Size of the buffer. */
+    size_t pos;         /**< Position of the next char of the buffer. */
+} tokens;
+
+
+/**
+ * \brief f_next_str Reads next string (a run of non-whitespace chars) from the file stream,
+ *                   skipping the whitespace before it.
+ *                   Allocates a memory for the string and returns the pointer to the string.
+ *                   Allocated memory must later be released.
+ * \param fp File handle.
+ * \return Pointer to the newly allocated memory, where the string is stored,
+ *         or NULL if there is not any more.
+ */
+char *f_next_str(FILE *fp);
+
+
+/**
+ * \brief b_next_str Reads next string from the buffer the same way as f_next_str reads it from a file.
+ *                   Allocated memory must later be released.
+ * \param buf Buffer.
+ * \param size Size of the buffer.
+ * \param pos Pointer to the position of the next char of the buffer, moved past the string.
+ * \return Pointer to the newly allocated memory, where the string is stored,
+ *         or NULL if there is not any more.
+ */
+char *b_next_str(const char *buf, const size_t size, size_t *pos);
+
+
+/**
+ * \brief tokens_file Sets the source of words to the file stream.
+ * \param t Pointer to a source of words.
+ * \param fp File handle.
+ */
+void tokens_file(tokens *t, FILE *fp);
+
+
+/**
+ * \brief tokens_buffer Sets the source of words to the memory buffer.
+ * \param t Pointer to a source of words.
+ * \param buf Buffer, which must outlive the source.
+ * \param size Size of the buffer.
+ */
+void tokens_buffer(tokens *t, const char *buf, const size_t size);
+
+
+/**
+ * \brief tokens_next Reads next string from the source of words (see f_next_str).
+ *                    Allocated memory must later be released.
+ * \param t Pointer to a source of words.
+ * \return Pointer to the newly allocated memory, where the string is stored,
+ *         or NULL if there is not any more.
+ */
+char *tokens_next(tokens *t);
+
+
+#endif
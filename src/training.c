@@ -0,0 +1,326 @@
+/**
+ * \file training.c
+ * \brief Functions declared in training.h are implemented in this file.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Documents are taken from the corpus under a lock (reading the corpus is not thread-safe),
+ * they are learnt without it.
+ * Counted documents are learnt by a classifier, which is written to a run and replaced
+ * by an untaught one whenever its counts hold the memory budget.
+ */
+
+
+#if defined(__unix__)
+#define _POSIX_C_SOURCE 200112L
+#define TRAINING_PTHREADS
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef TRAINING_PTHREADS
+#include <pthread.h>
+#endif
+
+#include "training.h"
+#include "counts.h"
+#include "structures/vector.h"
+#include "utilities/utils.h"
+
+
+/**
+ * \struct training
+ * \brief Struct representing a learning of a corpus shared by its threads.
+ */
+typedef struct training_ {
+    const nbc *cl;              /**< Classifier being taught. */
+    nbc_shared *sh;             /**< Counts shared by the threads. */
+    corpus *c;                  /**< Corpus being learnt. */
+#ifdef TRAINING_PTHREADS
+    pthread_mutex_t lock;       /**< Lock of the corpus and of the failure flag. */
+#endif
+    int failed;                 /**< Flag whether reading or learning of a document failed. */
+} training;
+
+
+/**
+ * \brief training_lock Locks the corpus of the learning.
+ * \param tr Pointer to a learning.
+ */
+void training_lock(training *tr) {
+#ifdef TRAINING_PTHREADS
+    pthread_mutex_lock(&tr->lock);
+#else
+    (void) tr;
+#endif
+}
+
+
+/**
+ * \brief training_unlock Unlocks the corpus of the learning.
+ * \param tr Pointer to a learning.
+ */
+void training_unlock(training *tr) {
+#ifdef TRAINING_PTHREADS
+    pthread_mutex_unlock(&tr->lock);
+#else
+    (void) tr;
+#endif
+}
+
+
+/**
+ * \brief training_next Reads the next document of the corpus, unless the learning has failed.
+ *                      Path of a text file document is copied, the other strings of documents stay valid
+ *                      (mapped pack or cache).
+ * \param tr Pointer to a learning.
+ * \param doc Pointer to where the document will be stored.
+ * \param path Pointer to where the copied path (or NULL) will be stored, to be freed by the caller.
+ * \return 1 if a document was read, 0 if there are no more documents (or the learning has failed), -1 on failure.
+ */
+int training_next(training *tr, corpus_doc *doc, char **path) {
+    int found;
+
+    *path = NULL;
+    training_lock(tr);
+    found = tr->failed ? 0 : corpus_next(tr->c, doc);
+    if (found == 1 && doc->path) {
+        *path = strdup(doc->path);
+        if (!(*path)) {
+            found = -1;
+        }
+    }
+    if (found == -1) {
+        tr->failed = 1;
+    }
+    training_unlock(tr);
+
+    return found;
+}
+
+
+/**
+ * \brief training_run Learns the documents of the corpus until there are none left,
+ *                     reusing a scratch of its own for all of them.
+ * \param arg Pointer to a learning.
+ * \return NULL.
+ */
+void *training_run(void *arg) {
+    training *tr = (training *) arg;
+    nbc_shared_scratch *scratch = NULL;
+    corpus_doc doc;
+    char *path = NULL;
+    int learnt;
+
+    scratch = nbc_shared_scratch_create(tr->cl);
+    learnt = scratch != NULL;
+    while (learnt && training_next(tr, &doc, &path) == 1) {
+        if (corpus_is_cache(tr->c)) {
+            learnt = nbc_shared_learn_words(tr->cl, tr->sh, scratch, tr->c->words, doc.words, doc.words_cnt, doc.cls);
+        }
+        else {
+            learnt = path ? nbc_shared_learn_file(tr->cl, tr->sh, scratch, path, doc.cls) :
+                     nbc_shared_learn_buffer(tr->cl, tr->sh, scratch, doc.text, doc.text_size, doc.cls);
+        }
+        free(path);
+    }
+    if (!learnt) {
+        training_lock(tr);
+        tr->failed = 1;
+        training_unlock(tr);
+    }
+
+    nbc_shared_scratch_free(&scratch);
+    return NULL;
+}
+
+
+/**
+ * \brief training_pass Learns the documents of the corpus by the threads until there are none left.
+ * \param tr Pointer to a learning.
+ * \param threads_cnt Number of threads.
+ * \return 1 if all the documents were learnt, else 0.
+ */
+int training_pass(training *tr, const size_t threads_cnt) {
+#ifdef TRAINING_PTHREADS
+    pthread_t *threads = NULL;
+    size_t t, started;
+
+    threads = (pthread_t *) malloc(threads_cnt * sizeof(pthread_t));
+    if (!threads) {
+        return 0;
+    }
+
+    for (started = 0; started < threads_cnt; started++) {
+        if (pthread_create(&threads[started], NULL, training_run, tr) != 0) {
+            break;
+        }
+    }
+    /* documents are learnt by the calling thread if no thread could be started */
+    if (!started) {
+        training_run(tr);
+    }
+    for (t = 0; t < started; t++) {
+        pthread_join(threads[t], NULL);
+    }
+
+    free(threads);
+#else
+    (void) threads_cnt;
+    training_run(tr);
+#endif
+
+    return !tr->failed;
+}
+
+
+int training_learn_corpus(nbc *cl, corpus *c, const size_t words_cnt, const size_t threads_cnt) {
+    training tr;
+    int learnt;
+
+    if (!cl || !c || !threads_cnt) {
+        return 0;
+    }
+
+    tr.cl = cl;
+    tr.c = c;
+    tr.failed = 0;
+    tr.sh = nbc_shared_create(cl, words_cnt);
+    if (!tr.sh) {
+        return 0;
+    }
+#ifdef TRAINING_PTHREADS
+    if (pthread_mutex_init(&tr.lock, NULL) != 0) {
+        nbc_shared_free(&tr.sh);
+        return 0;
+    }
+#endif
+
+    /* dictionary of frequent features only learns the corpus twice, counting it by the sketch first (see nbc_sketch_finish) */
+    learnt = training_pass(&tr, threads_cnt);
+    if (learnt && cl->sketch) {
+        learnt = corpus_rewind(c) && nbc_sketch_finish(cl) && training_pass(&tr, threads_cnt);
+    }
+
+#ifdef TRAINING_PTHREADS
+    pthread_mutex_destroy(&tr.lock);
+#endif
+
+    if (!learnt || !nbc_shared_finish(cl, tr.sh)) {
+        nbc_shared_free(&tr.sh);
+        return 0;
+    }
+
+    nbc_shared_free(&tr.sh);
+    return 1;
+}
+
+
+/**
+ * \brief training_counts_reset Replaces the counting classifier (and the vocabulary of a cache) by an untaught one.
+ * \param params Pointer to parameters of the classifier.
+ * \param c Pointer to a corpus.
+ * \param cl Pointer to a pointer to a classifier (or NULL), where the new one will be stored.
+ * \param vocab Pointer to a pointer to a vocabulary (or NULL), where the new one (of a cache) will be stored.
+ * \return 1 if operation was successful, else 0.
+ */
+int training_counts_reset(const nbc_params *params, corpus *c, nbc **cl, nbc_vocab **vocab) {
+    nbc_vocab_free(vocab);
+    nbc_free(cl);
+
+    *cl = nbc_create(c->cls_cnt, params);
+    if (!(*cl)) {
+        return 0;
+    }
+    if (corpus_is_cache(c)) {
+        *vocab = nbc_vocab_create(*cl, c->words, c->words_cnt);
+        if (!(*vocab)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+/**
+ * \brief training_spill Writes the counts of the counting classifier to the next run.
+ * \param cl Pointer to a classifier.
+ * \param runs Vector of paths to the runs written so far (of char * items), where the new one will be appended.
+ * \param f_path Path to the counts file.
+ * \return 1 if operation was successful, else 0.
+ */
+int training_spill(const nbc *cl, vector *runs, const char f_path[]) {
+    char *run = NULL;
+
+    run = (char *) malloc(strlen(f_path) + 32);
+    if (!run) {
+        return 0;
+    }
+    sprintf(run, "%s.run%lu", f_path, (unsigned long) vector_count(runs));
+    if (!vector_push_back(runs, &run)) {
+        free(run);
+        return 0;
+    }
+
+    return nbc_write_counts(cl, run);
+}
+
+
+int training_count_corpus(const nbc_params *params, corpus *c, const size_t shard, const size_t shards_cnt,
+                          const size_t memory_size, const char f_path[]) {
+    nbc_params count_params;
+    nbc *cl = NULL;
+    nbc_vocab *vocab = NULL;
+    vector *runs = NULL;
+    char *run = NULL;
+    corpus_doc doc;
+    size_t d, r;
+    int found, counted;
+
+    if (!params || params->hash_bits || !c || corpus_is_counts(c) || shard >= shards_cnt || !f_path) {
+        return 0;
+    }
+
+    count_params = *params;
+    count_params.threads = 1;
+    count_params.min_count = 1;
+    count_params.max_words = 0;
+    runs = vector_create(sizeof(char *), NULL);
+    found = runs && training_counts_reset(&count_params, c, &cl, &vocab) ? 1 : -1;
+
+    for (d = 0; found == 1 && (found = corpus_next(c, &doc)) == 1; d++) {
+        if (d % shards_cnt != shard) {
+            continue;
+        }
+        if (vocab ? !nbc_learn_words(cl, vocab, doc.words, doc.words_cnt, doc.cls) :
+            doc.path ? !nbc_learn_file(cl, doc.path, doc.cls) :
+            !nbc_learn_buffer(cl, doc.text, doc.text_size, doc.cls)) {
+            found = -1;
+        }
+        else if (nbc_counts_size(cl) >= memory_size &&
+                 (!training_spill(cl, runs, f_path) || !training_counts_reset(&count_params, c, &cl, &vocab))) {
+            found = -1;
+        }
+    }
+
+    /* counts held in memory all the time are written at once */
+    counted = 0;
+    if (found == 0) {
+        counted = vector_is_empty(runs) ? nbc_write_counts(cl, f_path) :
+                  training_spill(cl, runs, f_path) &&
+                  counts_merge((const char **) vector_at(runs, 0), vector_count(runs), f_path, 1);
+    }
+
+    for (r = 0; runs && r < vector_count(runs); r++) {
+        run = *((char **) vector_at(runs, r));
+        remove(run);
+        free(run);
+    }
+    vector_free(&runs);
+    nbc_vocab_free(&vocab);
+    nbc_free(&cl);
+    return counted;
+}
@@ -0,0 +1,61 @@
+/**
+ * \file training.h
+ * \brief Header file related to learning a corpus by several threads at once or in a bounded memory.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Threads take the documents of the corpus one by one and count their words into counts
+ * shared by all of them (see nbc_shared), so the memory of the counts does not grow with the number of threads.
+ * Threads are POSIX threads on Unix, elsewhere the documents are learnt by the calling thread only.
+ * Counts of a corpus too large to be held in memory are spilled to disk in sorted runs
+ * whenever they reach a memory budget, the runs are merged into one counts file (see counts.h).
+ * Corpus may be counted in shards (e.g. by several machines), whose counts files are merged into the counts
+ * of the whole corpus.
+ */
+
+
+#ifndef TRAINING_H
+#define TRAINING_H
+
+
+#include <stddef.h>
+
+#include "classifier.h"
+#include "corpus.h"
+
+
+/**
+ * \brief training_learn_corpus Teaches the untaught classifier the documents of the corpus (all labeled)
+ *                              by the threads, then finishes its learning. Corpus is read twice
+ *                              by a classifier with a sketch (see nbc_sketch_finish).
+ * \param cl Pointer to an untaught classifier.
+ * \param c Pointer to a corpus of documents of the classifier's classes.
+ * \param words_cnt Total number of words of the documents (a hint, 0 if not known).
+ * \param threads_cnt Number of threads.
+ * \return 1 if operation was successful, else 0.
+ */
+int training_learn_corpus(nbc *cl, corpus *c, const size_t words_cnt, const size_t threads_cnt);
+
+
+/**
+ * \brief training_count_corpus Counts the words of the documents of the shard of the corpus (all labeled)
+ *                              into the counts file, which is learnt by a classifier later (see nbc_learn_counts).
+ *                              Shard holds every shards_cnt-th document of the corpus, counts files of all
+ *                              the shards merged (see counts_merge) are the counts of the whole corpus.
+ *                              Counts are spilled to the runs "<counts-file>.run<number>" whenever they hold
+ *                              the memory budget, the runs are merged into the counts file and removed.
+ *                              Counts are exact, bounds of the dictionary of the parameters apply
+ *                              once the counts file is learnt.
+ * \param params Pointer to parameters of the classifiers counting the words (not using feature hashing).
+ * \param c Pointer to a corpus of documents.
+ * \param shard Index of the shard (documents of the index shard mod shards_cnt).
+ * \param shards_cnt Number of shards (1 for the whole corpus).
+ * \param memory_size Memory budget of the counts in bytes.
+ * \param f_path Path to the counts file.
+ * \return 1 if operation was successful, else 0.
+ */
+int training_count_corpus(const nbc_params *params, corpus *c, const size_t shard, const size_t shards_cnt,
+                          const size_t memory_size, const char f_path[]);
+
+
+#endif
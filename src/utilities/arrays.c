@@ -19,13 +19,12 @@ void *array_create(const size_t item_cnt, const size_t item_size) {
         return NULL;
     }
 
-    arr = malloc(item_cnt * item_size);
+    /* large zeroed blocks come from the system already zeroed, pages are touched lazily */
+    arr = calloc(item_cnt, item_size);
     if (!arr) {
         return NULL;
     }
 
-    array_clear(arr, item_cnt, item_size);
-    
     return arr;
 }
 
@@ -40,6 +39,42 @@ void array_free(void **arr) {
 }
 
 
+void *array_create_aligned(const size_t item_cnt, const size_t item_size, const size_t alignment) {
+    char *block = NULL, *arr = NULL;
+
+    if (item_cnt == 0 || item_size == 0 || alignment == 0) {
+        return NULL;
+    }
+
+    /* pointer to the allocated block is kept right before the aligned array */
+    block = (char *) malloc(item_cnt * item_size + alignment - 1 + sizeof(void *));
+    if (!block) {
+        return NULL;
+    }
+
+    arr = block + sizeof(void *);
+    arr += (alignment - (size_t) arr % alignment) % alignment;
+    memcpy(arr - sizeof(void *), &block, sizeof(void *));
+
+    array_clear(arr, item_cnt, item_size);
+
+    return arr;
+}
+
+
+void array_free_aligned(void **arr) {
+    void *block = NULL;
+
+    if (!arr || !(*arr)) {
+        return;
+    }
+
+    memcpy(&block, (char *) *arr - sizeof(void *), sizeof(void *));
+    free(block);
+    *arr = NULL;
+}
+
+
 void array_clear(void *arr, const size_t item_cnt, const size_t item_size) {
     if (!arr) {
         return;
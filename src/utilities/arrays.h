@@ -36,6 +36,24 @@ void *array_create(const size_t item_cnt, const size_t item_size);
 void array_free(void **arr);
 
 
+/**
+ * \brief array_create_aligned Creates an empty array of provided size aligned to provided number of bytes.
+ *                             Array must be released using array_free_aligned.
+ * \param item_cnt Array item count.
+ * \param item_size Size of an item.
+ * \param alignment Alignment of the array, a power of 2.
+ * \return Pointer to the created array.
+ */
+void *array_create_aligned(const size_t item_cnt, const size_t item_size, const size_t alignment);
+
+
+/**
+ * \brief array_free_aligned Releases the memory held by the aligned array and NULLs the pointer to it.
+ * \param arr Pointer to a pointer to an array created by array_create_aligned.
+ */
+void array_free_aligned(void **arr);
+
+
 /**
  * \brief array_clear Sets the arrays item to 0.
  * \param arr Array to be cleared.
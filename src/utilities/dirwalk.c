@@ -0,0 +1,204 @@
+/**
+ * \file dirwalk.c
+ * \brief Functions declared in dirwalk.h are implemented in this file.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Regular files of a directory tree (e.g. a maildir) are visited one by one in the directory order,
+ * holding only one open directory per tree level. Entries starting with '.' are skipped.
+ * Walking is supported on POSIX systems only.
+ */
+
+
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200112L
+#define DIRWALK_POSIX
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef DIRWALK_POSIX
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#endif
+
+#include "dirwalk.h"
+#include "../structures/vector.h"
+
+
+#ifdef DIRWALK_POSIX
+
+/**
+ * \struct dirwalk_level
+ * \brief Struct representing an open directory of a walk.
+ */
+typedef struct dirwalk_level_ {
+    DIR *dir;           /**< Open directory. */
+    size_t path_len;    /**< Length of the path to the directory. */
+} dirwalk_level;
+
+
+struct dirwalk_ {
+    vector *levels;     /**< Open directories from the root one (of dirwalk_level items). */
+    vector *path;       /**< Path to the last visited entry ('\0' terminated chars). */
+};
+
+
+/**
+ * \brief dirwalk_path_set Sets the path of the walk to the directory path followed by the entry name.
+ *                        Does not check arguments validity.
+ * \param w Pointer to a walk.
+ * \param dir_len Length of the path to the directory.
+ * \param name Name of the entry, or NULL for the directory itself.
+ * \return 1 if operation was successful, else 0.
+ */
+int dirwalk_path_set(dirwalk *w, const size_t dir_len, const char name[]) {
+    const char sep = '/', end = '\0';
+
+    w->path->count = dir_len;
+    if (name && (!vector_push_back(w->path, &sep) || !vector_push_back_many(w->path, name, strlen(name)))) {
+        return 0;
+    }
+
+    return vector_push_back(w->path, &end);
+}
+
+
+/**
+ * \brief dirwalk_push Opens the directory at the path of the walk as the deepest level.
+ *                     Does not check arguments validity.
+ * \param w Pointer to a walk.
+ * \return 1 if operation was successful, else 0.
+ */
+int dirwalk_push(dirwalk *w) {
+    dirwalk_level level;
+
+    level.path_len = vector_count(w->path) - 1;
+    level.dir = opendir((char *) w->path->data);
+    if (!level.dir) {
+        return 0;
+    }
+    if (!vector_push_back(w->levels, &level)) {
+        closedir(level.dir);
+        return 0;
+    }
+
+    return 1;
+}
+
+
+dirwalk *dirwalk_open(const char dir[]) {
+    dirwalk *w = NULL;
+    size_t dir_len;
+
+    if (!dir || !(*dir)) {
+        return NULL;
+    }
+
+    w = (dirwalk *) malloc(sizeof(dirwalk));
+    if (!w) {
+        return NULL;
+    }
+    w->levels = vector_create(sizeof(dirwalk_level), NULL);
+    w->path = vector_create(sizeof(char), NULL);
+    if (!w->levels || !w->path) {
+        goto fail;
+    }
+
+    dir_len = strlen(dir);
+    while (dir_len > 1 && dir[dir_len - 1] == '/') {
+        dir_len--;
+    }
+    if (!vector_push_back_many(w->path, dir, dir_len) || !dirwalk_path_set(w, dir_len, NULL) || !dirwalk_push(w)) {
+        goto fail;
+    }
+
+    return w;
+
+fail:
+    dirwalk_close(&w);
+    return NULL;
+}
+
+
+int dirwalk_next(dirwalk *w, const char **f_path) {
+    dirwalk_level *level = NULL;
+    struct dirent *entry = NULL;
+    struct stat st;
+
+    if (!w || !f_path) {
+        return -1;
+    }
+
+    while (vector_count(w->levels)) {
+        level = (dirwalk_level *) vector_at(w->levels, vector_count(w->levels) - 1);
+        entry = readdir(level->dir);
+        if (!entry) {
+            closedir(level->dir);
+            w->levels->count--;
+            continue;
+        }
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+
+        if (!dirwalk_path_set(w, level->path_len, entry->d_name) || stat((char *) w->path->data, &st) == -1) {
+            return -1;
+        }
+        if (S_ISDIR(st.st_mode)) {
+            if (!dirwalk_push(w)) {
+                return -1;
+            }
+        }
+        else if (S_ISREG(st.st_mode)) {
+            *f_path = (char *) w->path->data;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+void dirwalk_close(dirwalk **w) {
+    size_t l;
+
+    if (!w || !(*w)) {
+        return;
+    }
+
+    for (l = 0; (*w)->levels && l < vector_count((*w)->levels); l++) {
+        closedir(((dirwalk_level *) vector_at((*w)->levels, l))->dir);
+    }
+    vector_free(&(*w)->levels);
+    vector_free(&(*w)->path);
+    free(*w);
+    *w = NULL;
+}
+
+#else
+
+struct dirwalk_ {
+    int unused;     /**< Walking is not supported. */
+};
+
+
+dirwalk *dirwalk_open(const char dir[]) {
+    (void) dir;
+    return NULL;
+}
+
+
+int dirwalk_next(dirwalk *w, const char **f_path) {
+    (void) w; (void) f_path;
+    return -1;
+}
+
+
+void dirwalk_close(dirwalk **w) {
+    (void) w;
+}
+
+#endif
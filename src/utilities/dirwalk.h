@@ -0,0 +1,49 @@
+/**
+ * \file dirwalk.h
+ * \brief Header file related to recursive walking of directory trees.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Regular files of a directory tree (e.g. a maildir) are visited one by one in the directory order,
+ * holding only one open directory per tree level. Entries starting with '.' are skipped.
+ * Walking is supported on POSIX systems only.
+ */
+
+
+#ifndef DIRWALK_H
+#define DIRWALK_H
+
+
+/**
+ * \struct dirwalk
+ * \brief Struct representing a walk through a directory tree.
+ */
+typedef struct dirwalk_ dirwalk;
+
+
+/**
+ * \brief dirwalk_open Starts the walk through the directory tree.
+ * \param dir Path to the root directory.
+ * \return Pointer to a walk, or NULL if the directory could not be opened.
+ */
+dirwalk *dirwalk_open(const char dir[]);
+
+
+/**
+ * \brief dirwalk_next Finds the next regular file of the directory tree.
+ * \param w Pointer to a walk.
+ * \param f_path Pointer to where the pointer to the path to the file will be stored,
+ *               the path is valid until the next call.
+ * \return 1 if the next file was found, 0 if there is not any more, -1 on failure.
+ */
+int dirwalk_next(dirwalk *w, const char **f_path);
+
+
+/**
+ * \brief dirwalk_close Closes the open directories of the walk, releases its memory and NULLs the pointer to it.
+ * \param w Pointer to a pointer to a walk.
+ */
+void dirwalk_close(dirwalk **w);
+
+
+#endif
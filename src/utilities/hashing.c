@@ -0,0 +1,27 @@
+/**
+ * \file hashing.c
+ * \brief Functions declared in hashing.h are implemented in this file.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ */
+
+
+#include "hashing.h"
+
+
+unsigned long str_hash(const char *str) {
+    unsigned long hash;
+
+    hash = HASH_FNV_OFFSET;
+    for (; *str; str++) {
+        hash ^= (unsigned char) *str;
+        hash *= HASH_FNV_PRIME;
+    }
+
+    return hash;
+}
+
+
+unsigned long hash_combine(const unsigned long seed, const unsigned long hash) {
+    return seed ^ (hash + HASH_COMBINE_GOLDEN + (seed << 6) + (seed >> 2));
+}
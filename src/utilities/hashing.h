@@ -0,0 +1,54 @@
+/**
+ * \file hashing.h
+ * \brief Header file related to hashing of strings.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Strings are hashed using the FNV-1a hash function,
+ * 64-bit where unsigned long is wide enough, else 32-bit.
+ * Hashes of sequences of strings are combined from hashes of the strings.
+ */
+
+
+#ifndef HASHING_H
+#define HASHING_H
+
+
+#include <limits.h>
+
+
+#if ULONG_MAX > 0xFFFFFFFFUL
+/** \brief FNV-1a offset basis. */
+#define HASH_FNV_OFFSET 0xCBF29CE484222325UL
+/** \brief FNV-1a prime. */
+#define HASH_FNV_PRIME 0x100000001B3UL
+#else
+/** \brief FNV-1a offset basis. */
+#define HASH_FNV_OFFSET 0x811C9DC5UL
+/** \brief FNV-1a prime. */
+#define HASH_FNV_PRIME 0x01000193UL
+#endif
+
+/** \brief Golden ratio constant mixed into combined hashes. */
+#define HASH_COMBINE_GOLDEN 0x9E3779B9UL
+
+
+/**
+ * \brief str_hash Computes the hash of the provided string.
+ * \param str String to be hashed.
+ * \return Hash of the string.
+ */
+unsigned long str_hash(const char *str);
+
+
+/**
+ * \brief hash_combine Combines the hash into the seed hash.
+ *                     Combination depends on the order, so it can hash sequences of hashes.
+ * \param seed Seed hash.
+ * \param hash Hash to be combined into the seed.
+ * \return Combined hash.
+ */
+unsigned long hash_combine(const unsigned long seed, const unsigned long hash);
+
+
+#endif
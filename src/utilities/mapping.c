@@ -0,0 +1,141 @@
+/**
+ * \file mapping.c
+ * \brief Functions declared in mapping.h are implemented in this file.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Files are mapped read-only using mmap on POSIX systems,
+ * elsewhere they are read into an allocated memory.
+ */
+
+
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200112L
+#define MAPPING_MMAP
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#ifdef MAPPING_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "mapping.h"
+
+
+#ifdef MAPPING_MMAP
+
+void *f_map(const char f_path[], size_t *size) {
+    struct stat st;
+    void *data = NULL;
+    int fd;
+
+    if (!f_path || !size) {
+        return NULL;
+    }
+
+    fd = open(f_path, O_RDONLY);
+    if (fd == -1) {
+        return NULL;
+    }
+    if (fstat(fd, &st) == -1 || st.st_size == 0) {
+        close(fd);
+        return NULL;
+    }
+
+    data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return NULL;
+    }
+
+    *size = st.st_size;
+    return data;
+}
+
+
+void f_unmap(void *data, const size_t size) {
+    if (!data) {
+        return;
+    }
+
+    munmap(data, size);
+}
+
+
+size_t f_size(const char f_path[]) {
+    struct stat st;
+
+    if (!f_path || stat(f_path, &st) == -1 || !S_ISREG(st.st_mode)) {
+        return 0;
+    }
+
+    return st.st_size;
+}
+
+#else
+
+void *f_map(const char f_path[], size_t *size) {
+    FILE *fp = NULL;
+    char *data = NULL;
+    long f_size;
+
+    if (!f_path || !size) {
+        return NULL;
+    }
+
+    fp = fopen(f_path, "rb");
+    if (!fp) {
+        return NULL;
+    }
+    if (fseek(fp, 0, SEEK_END) != 0 || (f_size = ftell(fp)) <= 0 || fseek(fp, 0, SEEK_SET) != 0) {
+        fclose(fp);
+        return NULL;
+    }
+
+    data = (char *) malloc(f_size);
+    if (!data || fread(data, 1, f_size, fp) != (size_t) f_size) {
+        free(data);
+        fclose(fp);
+        return NULL;
+    }
+
+    fclose(fp);
+    *size = f_size;
+    return data;
+}
+
+
+void f_unmap(void *data, const size_t size) {
+    (void) size;
+    free(data);
+}
+
+
+size_t f_size(const char f_path[]) {
+    FILE *fp = NULL;
+    long size;
+
+    if (!f_path) {
+        return 0;
+    }
+
+    fp = fopen(f_path, "rb");
+    if (!fp) {
+        return 0;
+    }
+    if (fseek(fp, 0, SEEK_END) != 0 || (size = ftell(fp)) <= 0) {
+        fclose(fp);
+        return 0;
+    }
+
+    fclose(fp);
+    return size;
+}
+
+#endif
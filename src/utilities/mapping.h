@@ -0,0 +1,45 @@
+/**
+ * \file mapping.h
+ * \brief Header file related to mapping of files into memory.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Files are mapped read-only using mmap on POSIX systems,
+ * elsewhere they are read into an allocated memory.
+ */
+
+
+#ifndef MAPPING_H
+#define MAPPING_H
+
+
+#include <stddef.h>
+
+
+/**
+ * \brief f_map Maps the whole file into memory for reading.
+ *              Mapped memory must later be released using f_unmap.
+ * \param f_path Path to the file.
+ * \param size Pointer to where the size of the file will be stored.
+ * \return Pointer to the mapped file contents, or NULL if the file could not be mapped or is empty.
+ */
+void *f_map(const char f_path[], size_t *size);
+
+
+/**
+ * \brief f_unmap Releases the memory of the mapped file.
+ * \param data Pointer to the mapped file contents.
+ * \param size Size of the file.
+ */
+void f_unmap(void *data, const size_t size);
+
+
+/**
+ * \brief f_size Finds out the size of the file without reading it.
+ * \param f_path Path to the file.
+ * \return Size of the file, or 0 if the file is empty or its size could not be found out.
+ */
+size_t f_size(const char f_path[]);
+
+
+#endif
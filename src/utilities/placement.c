@@ -0,0 +1,261 @@
+/**
+ * \file placement.c
+ * \brief Functions declared in placement.h are implemented in this file.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Nodes and their processors are read from sysfs, threads are pinned by sched_setaffinity
+ * and the memory policies are set by the mbind system call (no libnuma is needed) on Linux,
+ * elsewhere the memory is allocated aligned and the threads are not pinned.
+ */
+
+
+#if defined(__linux__)
+#define _GNU_SOURCE
+#define PLACEMENT_LINUX
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef PLACEMENT_LINUX
+#include <limits.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+#include "placement.h"
+#include "arrays.h"
+
+
+#ifdef PLACEMENT_LINUX
+
+/** \brief Maximal size of the list of processors of a node. */
+#define PLACE_LIST_SIZE 4096
+/** \brief Memory policy preferring the allocation on a node (MPOL_PREFERRED of linux/mempolicy.h). */
+#define PLACE_MPOL_PREFERRED 1
+/** \brief Memory policy interleaving the allocation over nodes (MPOL_INTERLEAVE of linux/mempolicy.h). */
+#define PLACE_MPOL_INTERLEAVE 3
+/** \brief Number of bits of an item of a node mask. */
+#define PLACE_MASK_BITS (sizeof(unsigned long) * CHAR_BIT)
+
+
+/**
+ * \brief place_node_cpus Reads the list of processors of the node of the Linux id (e.g. "0-3,8-11").
+ * \param id Linux id of the node.
+ * \param list Buffer of PLACE_LIST_SIZE chars.
+ * \return 1 if the node exists and has processors, else 0.
+ */
+int place_node_cpus(const size_t id, char list[]) {
+    char path[64];
+    FILE *fp = NULL;
+    int read;
+
+    sprintf(path, "/sys/devices/system/node/node%lu/cpulist", (unsigned long) id);
+    fp = fopen(path, "r");
+    if (!fp) {
+        return 0;
+    }
+    read = fgets(list, PLACE_LIST_SIZE, fp) != NULL;
+    fclose(fp);
+
+    return read && list[0] >= '0' && list[0] <= '9';
+}
+
+
+/**
+ * \brief place_node_id Finds out the Linux id of the node.
+ * \param node Node.
+ * \param list Buffer of PLACE_LIST_SIZE chars, where the list of processors of the node will be stored.
+ * \param id Pointer to where the Linux id of the node will be stored.
+ * \return 1 if the node was found, else 0.
+ */
+int place_node_id(const size_t node, char list[], size_t *id) {
+    size_t found;
+
+    for (*id = 0, found = 0; *id < PLACE_MAX_NODES; (*id)++) {
+        if (place_node_cpus(*id, list) && found++ == node) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+/**
+ * \brief place_mbind Sets the memory policy of the memory.
+ * \param addr Pointer to memory mapped by place_alloc.
+ * \param size Size of the memory.
+ * \param mode Memory policy.
+ * \param mask Node mask of PLACE_MAX_NODES bits.
+ * \return 1 if the policy was set, else 0.
+ */
+int place_mbind(void *addr, const size_t size, const int mode, const unsigned long mask[]) {
+#ifdef SYS_mbind
+    size_t len;
+
+    len = (size + PLACE_HUGE_SIZE - 1) / PLACE_HUGE_SIZE * PLACE_HUGE_SIZE;
+    return syscall(SYS_mbind, addr, len, mode, mask, (unsigned long) PLACE_MAX_NODES + 1, 0UL) == 0;
+#else
+    (void) addr; (void) size; (void) mode; (void) mask;
+    return 0;
+#endif
+}
+
+
+size_t place_nodes_cnt() {
+    char list[PLACE_LIST_SIZE];
+    size_t id, nodes_cnt;
+
+    for (id = 0, nodes_cnt = 0; id < PLACE_MAX_NODES; id++) {
+        nodes_cnt += place_node_cpus(id, list);
+    }
+
+    return nodes_cnt ? nodes_cnt : 1;
+}
+
+
+int place_pin(const size_t node) {
+    char list[PLACE_LIST_SIZE], *pos = NULL;
+    cpu_set_t cpus;
+    unsigned long first, last;
+    size_t id;
+
+    if (!place_node_id(node, list, &id)) {
+        return 0;
+    }
+
+    CPU_ZERO(&cpus);
+    for (pos = list; *pos >= '0' && *pos <= '9'; ) {
+        first = last = strtoul(pos, &pos, 10);
+        if (*pos == '-') {
+            last = strtoul(pos + 1, &pos, 10);
+        }
+        for ( ; first <= last && first < CPU_SETSIZE; first++) {
+            CPU_SET(first, &cpus);
+        }
+        if (*pos == ',') {
+            pos++;
+        }
+    }
+
+    return sched_setaffinity(0, sizeof(cpus), &cpus) == 0;
+}
+
+
+void *place_alloc(const size_t size) {
+    char *data = NULL, *aligned = NULL;
+    size_t len;
+
+    if (!size) {
+        return NULL;
+    }
+
+    /* one more huge page is mapped, so that a whole aligned range of them is left after unmapping the rest */
+    len = (size + PLACE_HUGE_SIZE - 1) / PLACE_HUGE_SIZE * PLACE_HUGE_SIZE;
+    data = (char *) mmap(NULL, len + PLACE_HUGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == (char *) MAP_FAILED) {
+        return NULL;
+    }
+    aligned = data + (PLACE_HUGE_SIZE - (size_t) data % PLACE_HUGE_SIZE) % PLACE_HUGE_SIZE;
+    if (aligned > data) {
+        munmap(data, aligned - data);
+    }
+    if (aligned + len < data + len + PLACE_HUGE_SIZE) {
+        munmap(aligned + len, data + len + PLACE_HUGE_SIZE - (aligned + len));
+    }
+
+#ifdef MADV_HUGEPAGE
+    madvise(aligned, len, MADV_HUGEPAGE);
+#endif
+
+    return aligned;
+}
+
+
+void place_free(void *addr, const size_t size) {
+    if (!addr) {
+        return;
+    }
+
+    munmap(addr, (size + PLACE_HUGE_SIZE - 1) / PLACE_HUGE_SIZE * PLACE_HUGE_SIZE);
+}
+
+
+int place_bind(void *addr, const size_t size, const size_t node) {
+    char list[PLACE_LIST_SIZE];
+    unsigned long mask[PLACE_MAX_NODES / PLACE_MASK_BITS + 1];
+    size_t id;
+
+    if (!addr || !place_node_id(node, list, &id)) {
+        return 0;
+    }
+
+    memset(mask, 0, sizeof(mask));
+    mask[id / PLACE_MASK_BITS] |= 1UL << (id % PLACE_MASK_BITS);
+    return place_mbind(addr, size, PLACE_MPOL_PREFERRED, mask);
+}
+
+
+int place_interleave(void *addr, const size_t size) {
+    char list[PLACE_LIST_SIZE];
+    unsigned long mask[PLACE_MAX_NODES / PLACE_MASK_BITS + 1];
+    size_t id;
+
+    if (!addr) {
+        return 0;
+    }
+
+    memset(mask, 0, sizeof(mask));
+    for (id = 0; id < PLACE_MAX_NODES; id++) {
+        if (place_node_cpus(id, list)) {
+            mask[id / PLACE_MASK_BITS] |= 1UL << (id % PLACE_MASK_BITS);
+        }
+    }
+    return place_mbind(addr, size, PLACE_MPOL_INTERLEAVE, mask);
+}
+
+#else
+
+size_t place_nodes_cnt() {
+    return 1;
+}
+
+
+int place_pin(const size_t node) {
+    (void) node;
+
+    return 0;
+}
+
+
+void *place_alloc(const size_t size) {
+    return array_create_aligned(size, 1, PLACE_HUGE_SIZE);
+}
+
+
+void place_free(void *addr, const size_t size) {
+    (void) size;
+
+    array_free_aligned(&addr);
+}
+
+
+int place_bind(void *addr, const size_t size, const size_t node) {
+    (void) addr; (void) size; (void) node;
+
+    return 0;
+}
+
+
+int place_interleave(void *addr, const size_t size) {
+    (void) addr; (void) size;
+
+    return 0;
+}
+
+#endif
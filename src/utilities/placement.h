@@ -0,0 +1,81 @@
+/**
+ * \file placement.h
+ * \brief Header file related to placement of memory and threads on the NUMA nodes.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Nodes are the NUMA nodes having processors, numbered 0 ... place_nodes_cnt() - 1 (their Linux ids may differ).
+ * Memory is mapped in whole huge pages, advised to be backed by transparent huge pages,
+ * and its pages may be bound to a node or interleaved over the nodes before they are touched.
+ * Placement is advisory, a host not supporting it (or another system than Linux) has one node,
+ * memory which is merely allocated and threads which run anywhere.
+ */
+
+
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+
+#include <stddef.h>
+
+
+/** \brief Maximal number of NUMA nodes. */
+#define PLACE_MAX_NODES 64
+/** \brief Size of a huge page, placed memory is aligned to it. */
+#define PLACE_HUGE_SIZE ((size_t) 2 * 1024 * 1024)
+
+
+/**
+ * \brief place_nodes_cnt Finds out the number of the NUMA nodes having processors.
+ * \return Number of nodes (1 if it could not be found out).
+ */
+size_t place_nodes_cnt();
+
+
+/**
+ * \brief place_pin Pins the calling thread to the processors of the node.
+ * \param node Node.
+ * \return 1 if the thread was pinned, else 0.
+ */
+int place_pin(const size_t node);
+
+
+/**
+ * \brief place_alloc Maps zeroed memory aligned to PLACE_HUGE_SIZE, advised to be backed by huge pages.
+ *                    Memory must later be released using place_free.
+ * \param size Size of the memory.
+ * \return Pointer to the memory, or NULL on failure.
+ */
+void *place_alloc(const size_t size);
+
+
+/**
+ * \brief place_free Releases the memory mapped by place_alloc.
+ * \param addr Pointer to the memory.
+ * \param size Size of the memory.
+ */
+void place_free(void *addr, const size_t size);
+
+
+/**
+ * \brief place_bind Makes the pages of the memory, which were not touched yet, be allocated on the node
+ *                   (or elsewhere when the node is out of memory).
+ * \param addr Pointer to memory mapped by place_alloc.
+ * \param size Size of the memory.
+ * \param node Node.
+ * \return 1 if the policy was set, else 0.
+ */
+int place_bind(void *addr, const size_t size, const size_t node);
+
+
+/**
+ * \brief place_interleave Makes the pages of the memory, which were not touched yet, be allocated
+ *                         on all the nodes in turn.
+ * \param addr Pointer to memory mapped by place_alloc.
+ * \param size Size of the memory.
+ * \return 1 if the policy was set, else 0.
+ */
+int place_interleave(void *addr, const size_t size);
+
+
+#endif
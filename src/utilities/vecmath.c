@@ -0,0 +1,119 @@
+/**
+ * \file vecmath.c
+ * \brief Functions declared in vecmath.h are implemented in this file.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Uses AVX or SSE2 instructions if the compiler targets them (e.g. -mavx, -march=native),
+ * else plain loops.
+ */
+
+
+#include "vecmath.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+size_t vec_padded(const size_t cnt) {
+    return (cnt + VEC_WIDTH - 1) / VEC_WIDTH * VEC_WIDTH;
+}
+
+
+void vec_add(double *dest, const double *src, const size_t cnt) {
+    size_t i;
+
+#if defined(__AVX__)
+    for (i = 0; i < cnt; i += VEC_WIDTH) {
+        _mm256_store_pd(dest + i, _mm256_add_pd(_mm256_load_pd(dest + i), _mm256_load_pd(src + i)));
+    }
+#elif defined(__SSE2__)
+    for (i = 0; i < cnt; i += VEC_WIDTH) {
+        _mm_store_pd(dest + i, _mm_add_pd(_mm_load_pd(dest + i), _mm_load_pd(src + i)));
+    }
+#else
+    for (i = 0; i < cnt; i++) {
+        dest[i] += src[i];
+    }
+#endif
+}
+
+
+size_t vec_argmax(const double *arr, const size_t cnt) {
+    double max;
+    size_t i, vec_cnt;
+#if defined(__AVX__)
+    double maxs[VEC_WIDTH];
+    __m256d max_vec;
+    int mask;
+#elif defined(__SSE2__)
+    double maxs[VEC_WIDTH];
+    __m128d max_vec;
+    int mask;
+#endif
+
+#if defined(__AVX__) || defined(__SSE2__)
+    vec_cnt = cnt / VEC_WIDTH * VEC_WIDTH;
+#else
+    vec_cnt = 0;
+#endif
+    max = arr[0];
+
+#if defined(__AVX__)
+    if (vec_cnt) {
+        max_vec = _mm256_loadu_pd(arr);
+        for (i = VEC_WIDTH; i < vec_cnt; i += VEC_WIDTH) {
+            max_vec = _mm256_max_pd(max_vec, _mm256_loadu_pd(arr + i));
+        }
+        _mm256_storeu_pd(maxs, max_vec);
+        for (i = 0; i < VEC_WIDTH; i++) {
+            max = maxs[i] > max ? maxs[i] : max;
+        }
+    }
+#elif defined(__SSE2__)
+    if (vec_cnt) {
+        max_vec = _mm_loadu_pd(arr);
+        for (i = VEC_WIDTH; i < vec_cnt; i += VEC_WIDTH) {
+            max_vec = _mm_max_pd(max_vec, _mm_loadu_pd(arr + i));
+        }
+        _mm_storeu_pd(maxs, max_vec);
+        for (i = 0; i < VEC_WIDTH; i++) {
+            max = maxs[i] > max ? maxs[i] : max;
+        }
+    }
+#endif
+    for (i = vec_cnt; i < cnt; i++) {
+        max = arr[i] > max ? arr[i] : max;
+    }
+
+    /* first item equal to the maximum */
+#if defined(__AVX__)
+    max_vec = _mm256_set1_pd(max);
+    for (i = 0; i < vec_cnt; i += VEC_WIDTH) {
+        mask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(arr + i), max_vec, _CMP_EQ_OQ));
+        if (mask) {
+            break;
+        }
+    }
+#elif defined(__SSE2__)
+    max_vec = _mm_set1_pd(max);
+    for (i = 0; i < vec_cnt; i += VEC_WIDTH) {
+        mask = _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(arr + i), max_vec));
+        if (mask) {
+            break;
+        }
+    }
+#else
+    i = 0;
+#endif
+    for (; i < cnt; i++) {
+        if (arr[i] == max) {
+            return i;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+/**
+ * \file vecmath.h
+ * \brief Header file related to vectorized arithmetic on arrays of doubles.
+ * \version 1, 18-10-2026
+ * \author Stanislav Kafara, skafara@students.zcu.cz
+ *
+ * Uses AVX or SSE2 instructions if the compiler targets them (e.g. -mavx, -march=native),
+ * else plain loops.
+ */
+
+
+#ifndef VECMATH_H
+#define VECMATH_H
+
+
+#include <stddef.h>
+
+
+#if defined(__AVX__)
+/** \brief Number of doubles in a vector register. */
+#define VEC_WIDTH 4
+#elif defined(__SSE2__)
+#define VEC_WIDTH 2
+#else
+#define VEC_WIDTH 1
+#endif
+
+/** \brief Alignment (in bytes) of arrays passed to vec_add. */
+#define VEC_ALIGNMENT (VEC_WIDTH * sizeof(double))
+
+
+/**
+ * \brief vec_padded Rounds the number of doubles up to a multiple of VEC_WIDTH.
+ * \param cnt Number of doubles.
+ * \return Padded number of doubles.
+ */
+size_t vec_padded(const size_t cnt);
+
+
+/**
+ * \brief vec_add Adds the source array to the destination array item by item.
+ *                Does not check arguments validity.
+ * \param dest Destination array aligned to VEC_ALIGNMENT.
+ * \param src Source array aligned to VEC_ALIGNMENT.
+ * \param cnt Number of items, a multiple of VEC_WIDTH.
+ */
+void vec_add(double *dest, const double *src, const size_t cnt);
+
+
+/**
+ * \brief vec_argmax Finds out the index of the first greatest item of the array.
+ *                   Does not check arguments validity.
+ * \param arr Array of doubles (of any alignment).
+ * \param cnt Number of items, greater than 0.
+ * \return Index of the first greatest item.
+ */
+size_t vec_argmax(const double *arr, const size_t cnt);
+
+
+#endif
@@ -0,0 +1,122 @@
+/*
+ * Regression test of the buffer API (libspamid): words of a raw message are separated by any whitespace,
+ * so a message of several lines is learnt and scored the same as its text normalized to one line.
+ * Run by: buffer_lines (returns EXIT_SUCCESS if the scores are the same, else EXIT_FAILURE).
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/classifier.h"
+
+
+#define CLS_CNT 2
+
+
+/* learnt messages of both classes, each also in its one-line form */
+const char *learnt_lines[] = {
+    "Buy cheap\npills now\r\n\r\nlimited   offer\t today\n",
+    "meeting\ntomorrow at noon\r\nplease bring\tthe report\n",
+    "  cheap offer\n\nbuy now",
+    "report of the\nmeeting attached"
+};
+const char *learnt_one_line[] = {
+    "Buy cheap pills now limited offer today",
+    "meeting tomorrow at noon please bring the report",
+    "cheap offer buy now",
+    "report of the meeting attached"
+};
+const int learnt_cls[] = {0, 1, 0, 1};
+
+/* scored message and its one-line form */
+const char *scored_lines = "hello\nbuy cheap\r\n\tpills at the\n\nmeeting  ";
+const char *scored_one_line = "hello buy cheap pills at the meeting";
+
+
+/*
+ * Learns the messages (of several lines or their one-line forms) by a new classifier.
+ */
+nbc *learn(const nbc_params *params, const char *messages[]) {
+    nbc *cl = NULL;
+    size_t i;
+
+    cl = nbc_create(CLS_CNT, params);
+    if (!cl) {
+        return NULL;
+    }
+
+    for (i = 0; i < sizeof(learnt_cls) / sizeof(learnt_cls[0]); i++) {
+        if (!nbc_learn_buffer(cl, messages[i], strlen(messages[i]), learnt_cls[i])) {
+            nbc_free(&cl);
+            return NULL;
+        }
+    }
+    if (!nbc_learn_finish(cl)) {
+        nbc_free(&cl);
+        return NULL;
+    }
+
+    return cl;
+}
+
+
+/*
+ * Checks that the scores of both forms of the scored message by both classifiers are the same.
+ */
+int check(const char *name, const nbc_params *params) {
+    nbc *cl_lines = NULL, *cl_one_line = NULL;
+    double scores[4][CLS_CNT];
+    int same, i, cls;
+
+    cl_lines = learn(params, learnt_lines);
+    cl_one_line = learn(params, learnt_one_line);
+    same = cl_lines && cl_one_line &&
+           nbc_score_buffer(cl_lines, scored_lines, strlen(scored_lines), scores[0]) &&
+           nbc_score_buffer(cl_lines, scored_one_line, strlen(scored_one_line), scores[1]) &&
+           nbc_score_buffer(cl_one_line, scored_lines, strlen(scored_lines), scores[2]) &&
+           nbc_score_buffer(cl_one_line, scored_one_line, strlen(scored_one_line), scores[3]);
+
+    for (i = 1; same && i < 4; i++) {
+        for (cls = 0; cls < CLS_CNT; cls++) {
+            same = same && scores[i][cls] == scores[0][cls];
+        }
+    }
+    if (!same) {
+        fprintf(stderr, "buffer_lines: %s: message of several lines scored differently from its one line\n", name);
+    }
+
+    nbc_free(&cl_lines);
+    nbc_free(&cl_one_line);
+    return same;
+}
+
+
+int main(void) {
+    nbc_params params;
+    int passed;
+
+    params.model = NBC_MULTINOMIAL;
+    params.hash_bits = 0;
+    params.ngram = 1;
+    params.threads = 1;
+    params.min_count = 1;
+    params.max_words = 0;
+    params.placement = NBC_PLACE_DEFAULT;
+    params.parts = 0;
+    passed = check("multinomial", &params);
+
+    params.model = NBC_BERNOULLI;
+    passed = check("bernoulli", &params) && passed;
+
+    params.model = NBC_MULTINOMIAL;
+    params.ngram = 2;
+    passed = check("bigrams", &params) && passed;
+
+    params.ngram = 1;
+    params.parts = 2;
+    passed = check("partitions", &params) && passed;
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,46 @@
+# Regression test of counting corpus shards (count -s) and merging their counts files (merge):
+# the merged counts file must be the same as the counts file of all the files counted at once,
+# with the shards spilling sorted runs (0 MiB of counts) and without.
+# Run in the directory of data/ by: cmake -DSPAMID=<spamid.exe> -DOUT_DIR=<dir> -P count_shards.cmake
+
+foreach(options "" "-n 2")
+    separate_arguments(args UNIX_COMMAND "${options}")
+    foreach(memory_mb 0 64)
+        set(shard_files "")
+        foreach(shard 1 2 3)
+            execute_process(
+                COMMAND ${SPAMID} count -s ${shard}/3 ${args} ${memory_mb} spam 380 ham 380
+                        ${OUT_DIR}/count_shards_${shard}.counts
+                RESULT_VARIABLE result
+                OUTPUT_QUIET)
+            if(NOT result EQUAL 0)
+                message(FATAL_ERROR "spamid count -s ${shard}/3 ${options} ${memory_mb} failed: ${result}")
+            endif()
+            list(APPEND shard_files ${OUT_DIR}/count_shards_${shard}.counts)
+        endforeach()
+
+        execute_process(
+            COMMAND ${SPAMID} merge -j 3 ${shard_files} ${OUT_DIR}/count_shards_merged.counts
+            RESULT_VARIABLE result
+            OUTPUT_QUIET)
+        if(NOT result EQUAL 0)
+            message(FATAL_ERROR "spamid merge -j 3 ${options} failed: ${result}")
+        endif()
+
+        execute_process(
+            COMMAND ${SPAMID} count ${args} 64 spam 380 ham 380 ${OUT_DIR}/count_shards_all.counts
+            RESULT_VARIABLE result
+            OUTPUT_QUIET)
+        if(NOT result EQUAL 0)
+            message(FATAL_ERROR "spamid count ${options} failed: ${result}")
+        endif()
+
+        execute_process(
+            COMMAND ${CMAKE_COMMAND} -E compare_files ${OUT_DIR}/count_shards_merged.counts
+                    ${OUT_DIR}/count_shards_all.counts
+            RESULT_VARIABLE result)
+        if(NOT result EQUAL 0)
+            message(FATAL_ERROR "merged shards differ from the counts of all the files: ${options} ${memory_mb}")
+        endif()
+    endforeach()
+endforeach()
@@ -0,0 +1,25 @@
+# Regression test of learning by threads (-j) with a bounded dictionary (-m, -M):
+# classifiers learnt by one thread and by several threads must be the same,
+# so their evaluations of the same tested files must be the same too.
+# Run in the directory of data/ by: cmake -DSPAMID=<spamid.exe> -DOUT_DIR=<dir> -P learn_threads.cmake
+
+foreach(options "-m 3" "-M 2000" "-m 2 -M 1000" "-b -m 3" "-b -n 2 -m 2 -M 3000" "-n 3 -m 4")
+    separate_arguments(args UNIX_COMMAND "${options}")
+    foreach(jobs 1 4)
+        execute_process(
+            COMMAND ${SPAMID} eval ${args} -j ${jobs} spam 380 ham 380 test-spam 100 test-ham 100
+                    ${OUT_DIR}/learn_threads_j${jobs}.txt
+            RESULT_VARIABLE result
+            OUTPUT_QUIET)
+        if(NOT result EQUAL 0)
+            message(FATAL_ERROR "spamid eval ${options} -j ${jobs} failed: ${result}")
+        endif()
+    endforeach()
+
+    execute_process(
+        COMMAND ${CMAKE_COMMAND} -E compare_files ${OUT_DIR}/learn_threads_j1.txt ${OUT_DIR}/learn_threads_j4.txt
+        RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "classifiers learnt by 1 and 4 threads differ: ${options}")
+    endif()
+endforeach()